@@ -7,6 +7,7 @@
 #include <Lumos/Scene/SceneManager.h>
 #include <Lumos/Core/Engine.h>
 #include <Lumos/Graphics/Renderers/RenderGraph.h>
+#include <Lumos/Scripting/Lua/LuaManager.h>
 #include <Lumos/Graphics/GBuffer.h>
 #include <Lumos/ImGui/ImGuiHelpers.h>
 #include <imgui/imgui.h>
@@ -34,6 +35,12 @@ namespace Lumos
 					ImGui::TreePop();
 				}
 
+				if(ImGui::TreeNode("Scripts"))
+				{
+					LuaManager::Get().OnImGui();
+					ImGui::TreePop();
+				}
+
 				auto renderGraph = Application::Get().GetRenderGraph();
 				if(ImGui::TreeNode("RenderGraph"))
 				{
@@ -71,7 +78,8 @@ namespace Lumos
 
 						ImGui::TreePop();
 					}
-					if(ImGui::TreeNode("Position Texture"))
+					bool thinGBuffer = Application::Get().GetRenderGraph()->GetGBuffer()->GetLayout() == Graphics::GBufferLayout::THIN;
+					if(ImGui::TreeNode(thinGBuffer ? "Emissive Texture" : "Position Texture"))
 					{
 						ImGuiHelpers::Image(Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(Graphics::SCREENTEX_POSITION), Maths::Vector2(128.0f, 128.0f));
 						ImGuiHelpers::Tooltip(Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(Graphics::SCREENTEX_POSITION), Maths::Vector2(256.0f, 256.0f));
@@ -1,7 +1,10 @@
 #include "Editor.h"
 #include "AssetWindow.h"
+#include "ThumbnailCache.h"
 #include <Lumos/Core/OS/FileSystem.h>
 #include <Lumos/Core/Profiler.h>
+#include <Lumos/Utilities/AssetDatabase.h>
+#include <Lumos/ImGui/ImGuiHelpers.h>
 
 #if __has_include(<filesystem>)
 #	include <filesystem>
@@ -47,6 +50,16 @@ namespace Lumos
 	void AssetWindow::OnImGui()
 	{
 		LUMOS_PROFILE_FUNCTION();
+
+		//Listings are re-read whenever the asset database picks up a change on disk
+		auto database = m_Editor->GetAssetDatabase();
+		if(database && database->GetVersion() != m_AssetVersion)
+		{
+			m_AssetVersion = database->GetVersion();
+			m_BaseProjectDir = ReadDirectory(m_BaseDirPath);
+			m_CurrentDir = ReadDirectory(m_CurrentDirPath);
+		}
+
 		ImGui::Begin(m_SimpleName.c_str());
 		{
 			ImGui::Columns(2, "AB", true);            
@@ -315,7 +328,17 @@ namespace Lumos
 
 		auto fileID = GetParsedAssetID(m_CurrentDir[dirIndex].fileType);
 
-		ImGui::Button(m_Editor->GetIconFontIcon(m_CurrentDir[dirIndex].absolutePath));
+		//Thumbnails are only requested for cells on screen
+		Graphics::Texture2D* thumbnail = nullptr;
+		const ImVec2 thumbnailSize(64.0f, 64.0f);
+		AssetRecord record;
+		if(ImGui::IsRectVisible(thumbnailSize) && m_Editor->GetThumbnailCache() && m_Editor->GetAssetDatabase() && m_Editor->GetAssetDatabase()->GetRecord(m_CurrentDir[dirIndex].absolutePath, record))
+			thumbnail = m_Editor->GetThumbnailCache()->GetThumbnail(record);
+
+		if(thumbnail)
+			ImGuiHelpers::Image(thumbnail, Maths::Vector2(thumbnailSize.x, thumbnailSize.y));
+		else
+			ImGui::Button(m_Editor->GetIconFontIcon(m_CurrentDir[dirIndex].absolutePath));
 		auto fname = m_CurrentDir[dirIndex].filename;
 		auto newFname = StripExtras(fname);
 
@@ -397,36 +420,23 @@ namespace Lumos
 	std::vector<DirectoryInformation> AssetWindow::GetFsContents(const std::string& path)
 	{
 		LUMOS_PROFILE_FUNCTION();
-		std::vector<DirectoryInformation> dInfo;
-
-		for(const auto& entry : std::filesystem::directory_iterator(path))
-		{
-			bool isDir = std::filesystem::is_directory(entry);
-			auto test = std::vector<std::string>();
-			const char del = *m_Delimiter.c_str();
-
-			auto dir_data = ParseFilename(entry.path().string(), del, test);
-			auto fileExt = ParseFiletype(dir_data);
-
-			if(isDir)
-			{
-				DirectoryInformation d(dir_data, fileExt, entry.path().string(), false);
-				dInfo.push_back(d);
-			}
-			else
-			{
-				DirectoryInformation d(dir_data, fileExt, entry.path().string(), true);
-				dInfo.push_back(d);
-			}
-		}
-
-		return dInfo;
+		return ReadDirectory(path);
 	}
 
 	std::vector<DirectoryInformation> AssetWindow::ReadDirectory(const std::string& path)
 	{
+		LUMOS_PROFILE_FUNCTION();
 		std::vector<DirectoryInformation> dInfo;
 
+		//Served from the index once the first scan is done, the file system is only walked before that
+		auto database = Editor::GetEditor()->GetAssetDatabase();
+		if(database && database->IsReady())
+		{
+			for(auto& record : database->GetDirectory(path))
+				dInfo.emplace_back(record.Name, ParseFiletype(record.Name), record.Path, record.Type != AssetType::Directory);
+			return dInfo;
+		}
+
 		for(const auto& entry : std::filesystem::directory_iterator(path))
 		{
 			bool isDir = std::filesystem::is_directory(entry);
@@ -504,7 +514,15 @@ namespace Lumos
 
 	std::vector<std::string> AssetWindow::SearchFiles(const std::string& query)
 	{
-		return std::vector<std::string>();
+		LUMOS_PROFILE_FUNCTION();
+		std::vector<std::string> results;
+		auto database = Editor::GetEditor()->GetAssetDatabase();
+		if(!database)
+			return results;
+
+		for(auto& record : database->Search(query))
+			results.push_back(record.Path);
+		return results;
 	}
 
 	bool AssetWindow::MoveFile(const std::string& filePath, const std::string& movePath)
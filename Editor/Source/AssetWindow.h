@@ -93,5 +93,6 @@ namespace Lumos
 
 		std::vector<DirectoryInformation> m_CurrentDir;
 		std::vector<DirectoryInformation> m_BaseProjectDir;
+		uint64_t m_AssetVersion = 0;
 	};
 }
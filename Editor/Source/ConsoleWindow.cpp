@@ -1,15 +1,86 @@
 #include "ConsoleWindow.h"
+#include "Editor.h"
 #include <Lumos/ImGui/IconsMaterialDesignIcons.h>
 #include <Lumos/ImGui/ImGuiHelpers.h>
 #include <Lumos/Core/Profiler.h>
 
+#include <atomic>
+#include <string_view>
+
+#define MESSAGE_QUEUE_CAPACITY 256
+
 namespace Lumos
 {
+	namespace
+	{
+		//Bounded queue between the logging threads and the console. Each slot's sequence number says whether it is
+		//free for the next producer or holds a message for the consumer, so neither side takes a lock
+		class MessageQueue
+		{
+		public:
+			MessageQueue()
+			{
+				for(uint32_t i = 0; i < MESSAGE_QUEUE_CAPACITY; i++)
+					m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+			}
+
+			bool Push(const ConsoleWindow::Message& message)
+			{
+				uint32_t position = m_Head.load(std::memory_order_relaxed);
+				while(true)
+				{
+					Slot& slot = m_Slots[position % MESSAGE_QUEUE_CAPACITY];
+					const int32_t difference = int32_t(slot.Sequence.load(std::memory_order_acquire) - position);
+					if(difference == 0)
+					{
+						if(m_Head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						{
+							slot.Entry = message;
+							slot.Sequence.store(position + 1, std::memory_order_release);
+							return true;
+						}
+					}
+					else if(difference < 0)
+						return false; //Full
+					else
+						position = m_Head.load(std::memory_order_relaxed);
+				}
+			}
+
+			//Only called from the main thread
+			bool Pop(ConsoleWindow::Message& message)
+			{
+				Slot& slot = m_Slots[m_Tail % MESSAGE_QUEUE_CAPACITY];
+				if(int32_t(slot.Sequence.load(std::memory_order_acquire) - (m_Tail + 1)) < 0)
+					return false;
+
+				message = slot.Entry;
+				slot.Sequence.store(m_Tail + MESSAGE_QUEUE_CAPACITY, std::memory_order_release);
+				m_Tail++;
+				return true;
+			}
+
+		private:
+			struct Slot
+			{
+				std::atomic<uint32_t> Sequence;
+				ConsoleWindow::Message Entry;
+			};
+
+			Slot m_Slots[MESSAGE_QUEUE_CAPACITY];
+			alignas(64) std::atomic<uint32_t> m_Head = { 0 };
+			alignas(64) uint32_t m_Tail = 0;
+		};
+
+		MessageQueue s_MessageQueue;
+		std::atomic<uint32_t> s_DroppedMessages = { 0 };
+	}
+
 	uint32_t ConsoleWindow::s_MessageBufferRenderFilter = 0;
 	uint16_t ConsoleWindow::s_MessageBufferCapacity = 200;
 	uint16_t ConsoleWindow::s_MessageBufferSize = 0;
 	uint16_t ConsoleWindow::s_MessageBufferBegin = 0;
-	std::vector<Ref<ConsoleWindow::Message>> ConsoleWindow::s_MessageBuffer = std::vector<Ref<ConsoleWindow::Message>>(200);
+	std::vector<ConsoleWindow::Message> ConsoleWindow::s_MessageBuffer = std::vector<ConsoleWindow::Message>(200);
 	bool ConsoleWindow::s_AllowScrollingToBottom = true;
 	bool ConsoleWindow::s_RequestScrollToBottom = false;
 
@@ -19,43 +90,43 @@ namespace Lumos
 		m_Name = ICON_MDI_VIEW_LIST " Console###console";
 		m_SimpleName = "Console";
         s_MessageBufferRenderFilter = Message::Level::Trace | Message::Level::Info | Message::Level::Debug | Message::Level::Warn | Message::Level::Error | Message::Level::Critical;
+		m_VisibleMessages.reserve(s_MessageBufferCapacity);
 	}
 
-	void ConsoleWindow::AddMessage(const Ref<Message>& message)
+	bool ConsoleWindow::AddMessage(const Message& message)
+	{
+		if(message.m_Level == 0)
+			return true;
+
+		if(!s_MessageQueue.Push(message))
+		{
+			s_DroppedMessages.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		return true;
+	}
+
+	void ConsoleWindow::ProcessMessages()
 	{
 		LUMOS_PROFILE_FUNCTION();
-		if(message->m_Level == 0)
-			return;
-		
-		auto messageStart = s_MessageBuffer.begin() + s_MessageBufferBegin;
-			if(*messageStart) // If contains old message here
-			{
-				for(auto messIt = messageStart; messIt != s_MessageBuffer.end(); messIt++)
-				{
-					if (message->GetMessageID() == (*messIt)->GetMessageID())
-					{
-						(*messIt)->IncreaseCount();
-						return;
-                    }
-				}
-			}
+		Message message;
+		while(s_MessageQueue.Pop(message))
+			StoreMessage(message);
+	}
 
-			if(s_MessageBufferBegin != 0) // Skipped first messages in vector
+	void ConsoleWindow::StoreMessage(const Message& message)
+	{
+		for(uint16_t i = 0; i < s_MessageBufferSize; i++)
+		{
+			if(s_MessageBuffer[i].GetMessageID() == message.GetMessageID())
 			{
-			for(auto messIt = s_MessageBuffer.begin(); messIt != messageStart; messIt++)
-				{
-				if(*messIt)
-					{
-					if (message->GetMessageID() == (*messIt)->GetMessageID())
-					{
-						(*messIt)->IncreaseCount();
-						return;
-                    }
-					}
-				}
+				s_MessageBuffer[i].IncreaseCount();
+				return;
 			}
+		}
 
-		*(s_MessageBuffer.begin() + s_MessageBufferBegin) = message;
+		s_MessageBuffer[s_MessageBufferBegin] = message;
 		if(++s_MessageBufferBegin == s_MessageBufferCapacity)
 			s_MessageBufferBegin = 0;
 		if(s_MessageBufferSize < s_MessageBufferCapacity)
@@ -68,9 +139,9 @@ namespace Lumos
 	void ConsoleWindow::Flush()
 	{
 		LUMOS_PROFILE_FUNCTION();
-		for(auto message = s_MessageBuffer.begin(); message != s_MessageBuffer.end(); message++)
-			(*message) = nullptr;
 		s_MessageBufferBegin = 0;
+		s_MessageBufferSize = 0;
+		s_DroppedMessages = 0;
 	}
 
 	void ConsoleWindow::OnImGui()
@@ -100,6 +171,16 @@ namespace Lumos
 			// Checkbox for scrolling lock
 			ImGui::Checkbox("Scroll to bottom", &s_AllowScrollingToBottom);
 
+			// Messages below this level are rejected by the logger before they are formatted
+			static const char* captureLevels[] = { "Trace", "Debug", "Info", "Warning", "Error", "Critical" };
+			int captureLevel = int(Debug::Log::GetCoreLogger()->level());
+			if(ImGui::Combo("Capture level", &captureLevel, captureLevels, IM_ARRAYSIZE(captureLevels)))
+				Debug::Log::GetCoreLogger()->set_level(spdlog::level::level_enum(captureLevel));
+
+			bool logToFile = m_Editor->GetLogToFile();
+			if(ImGui::Checkbox("Log to file", &logToFile))
+				m_Editor->SetLogToFile(logToFile);
+
 			// Button to clear the console
 			if(ImGui::Button("Clear console"))
 				Flush();
@@ -147,44 +228,32 @@ namespace Lumos
 		LUMOS_PROFILE_FUNCTION();
 		ImGui::BeginChild("ScrollRegion", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
 		{
-			auto messageStart = s_MessageBuffer.begin() + s_MessageBufferBegin;
-			if(*messageStart) // If contains old message here
+			// Oldest first, only the rows in view are drawn
+			m_VisibleMessages.clear();
+			const uint16_t oldest = (s_MessageBufferBegin + s_MessageBufferCapacity - s_MessageBufferSize) % s_MessageBufferCapacity;
+			for(uint16_t i = 0; i < s_MessageBufferSize; i++)
 			{
-				for(auto message = messageStart; message != s_MessageBuffer.end(); message++)
-				{
-					if(Filter.IsActive())
-					{
-						if(Filter.PassFilter((*message)->m_Message.c_str()))
-						{
-                            (*message)->OnImGUIRender();
-						}
-					}
-					else
-					{
-						(*message)->OnImGUIRender();
-                    }
-				}
+				const uint16_t index = (oldest + i) % s_MessageBufferCapacity;
+				const Message& message = s_MessageBuffer[index];
+				if((s_MessageBufferRenderFilter & message.m_Level) && (!Filter.IsActive() || Filter.PassFilter(message.m_Message)))
+					m_VisibleMessages.push_back(index);
 			}
 
-			if(s_MessageBufferBegin != 0) // Skipped first messages in vector
+			ImGuiListClipper clipper;
+			clipper.Begin(int(m_VisibleMessages.size()));
+			while(clipper.Step())
 			{
-				for(auto message = s_MessageBuffer.begin(); message != messageStart; message++)
-				{
-					if(*message)
-					{
-						if(Filter.IsActive())
-						{
-							if(Filter.PassFilter((*message)->m_Message.c_str()))
-							{
-								(*message)->OnImGUIRender();
-							}
-						}
-						else
-						{
-							(*message)->OnImGUIRender();
-						}
-					}
-				}
+				for(int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+					s_MessageBuffer[m_VisibleMessages[i]].OnImGUIRender();
+			}
+			clipper.End();
+
+			const uint32_t dropped = s_DroppedMessages.load(std::memory_order_relaxed);
+			if(dropped > 0)
+			{
+				ImGui::PushStyleColor(ImGuiCol_Text, Message::GetRenderColour(Message::Level::Warn));
+				ImGui::Text("%u messages dropped, the console could not keep up", dropped);
+				ImGui::PopStyleColor();
 			}
 
 			if(s_RequestScrollToBottom && ImGui::GetScrollMaxY() > 0)
@@ -196,53 +265,54 @@ namespace Lumos
 		ImGui::EndChild();
 	}
 
-	ConsoleWindow::Message::Message(const std::string& message, Level level, const std::string& source, int threadID)
-		: m_Message(message)
-		, m_Level(level)
-		, m_Source(source)
+	ConsoleWindow::Message::Message(const char* message, size_t length, Level level, const char* file, const char* function, int line, int threadID)
+		: m_Level(level)
+		, m_File(file)
+		, m_Function(function)
+		, m_Line(line)
 		, m_ThreadID(threadID)
-		, m_MessageID(std::hash<std::string>()(message))
 	{
+		length = std::min(length, size_t(MaxLength - 1));
+		memcpy(m_Message, message, length);
+		m_Message[length] = '\0';
+		m_MessageID = std::hash<std::string_view>()(std::string_view(m_Message, length));
 	}
 
 	void ConsoleWindow::Message::OnImGUIRender()
 	{
 		LUMOS_PROFILE_FUNCTION();
-        if(s_MessageBufferRenderFilter & m_Level)
-		{
-			ImGui::PushID(this);
-			ImGui::PushStyleColor(ImGuiCol_Text, GetRenderColour(m_Level));
-			auto levelIcon = GetLevelIcon(m_Level);
-			ImGui::TextUnformatted(levelIcon);
-            ImGui::PopStyleColor();
-            ImGui::SameLine();
-            ImGui::TextUnformatted(m_Message.c_str());
+		ImGui::PushID(this);
+		ImGui::PushStyleColor(ImGuiCol_Text, GetRenderColour(m_Level));
+		auto levelIcon = GetLevelIcon(m_Level);
+		ImGui::TextUnformatted(levelIcon);
+        ImGui::PopStyleColor();
+        ImGui::SameLine();
+        ImGui::TextUnformatted(m_Message);
 
-			if (ImGui::BeginPopupContextWindow())
-			{
-				if (ImGui::MenuItem("Copy"))
-				{
-					ImGui::SetClipboardText(m_Message.c_str());
-				}
-				
-				ImGui::EndPopup();
-			}
-			
-			if(ImGui::IsItemHovered())
-			{
-				ImGui::BeginTooltip();
-				ImGui::TextUnformatted(m_Source.c_str());
-				ImGui::EndTooltip();
-			}
-			
-			if (m_Count > 1)
+		if (ImGui::BeginPopupContextItem("MessageContext"))
+		{
+			if (ImGui::MenuItem("Copy"))
 			{
-				ImGui::SameLine(ImGui::GetContentRegionAvail().x - (m_Count > 99 ? 35 : 28));
-				ImGui::Text("%d", m_Count);
+				ImGui::SetClipboardText(m_Message);
 			}
 			
-			ImGui::PopID();
+			ImGui::EndPopup();
 		}
+		
+		if(ImGui::IsItemHovered())
+		{
+			ImGui::BeginTooltip();
+			ImGui::Text("File : %s | Function : %s | Line : %d", m_File ? m_File : "", m_Function ? m_Function : "", m_Line);
+			ImGui::EndTooltip();
+		}
+		
+		if (m_Count > 1)
+		{
+			ImGui::SameLine(ImGui::GetContentRegionAvail().x - (m_Count > 99 ? 35 : 28));
+			ImGui::Text("%d", m_Count);
+		}
+		
+		ImGui::PopID();
 	}
 	
 	const char* ConsoleWindow::Message::GetLevelIcon(Level level)
@@ -25,7 +25,11 @@ namespace Lumos
 			};
 
 		public:
-			Message(const std::string& message = "", Level level = Level::Trace, const std::string& source = "", int threadID = 0);
+			//Fixed size so queueing a message never allocates, longer lines are truncated
+			static const uint32_t MaxLength = 512;
+
+			Message() = default;
+			Message(const char* message, size_t length, Level level = Level::Trace, const char* file = nullptr, const char* function = nullptr, int line = 0, int threadID = 0);
 			void OnImGUIRender();
 			void IncreaseCount() { m_Count++; };
 			size_t GetMessageID() const { return m_MessageID; }
@@ -35,12 +39,15 @@ namespace Lumos
             static Maths::Colour GetRenderColour(Level level);
 			
 		public:
-			const std::string m_Message;
-			const Level m_Level;
-			const std::string m_Source;
-			const int m_ThreadID;
+			char m_Message[MaxLength];
+			Level m_Level = Level::Trace;
+			//Point at the __FILE__ and function name literals from the log call, only formatted when hovered
+			const char* m_File = nullptr;
+			const char* m_Function = nullptr;
+			int m_Line = 0;
+			int m_ThreadID = 0;
 			int m_Count = 1;
-			size_t m_MessageID;
+			size_t m_MessageID = 0;
 		};
 
 		ConsoleWindow();
@@ -48,9 +55,15 @@ namespace Lumos
 		static void Flush();
 		void OnImGui() override;
 
-		static void AddMessage(const Ref<Message>& message);
+		//Safe to call from any thread, it never blocks or allocates. Returns false and drops the message when
+		//the queue is full because the console has not drained it yet
+		static bool AddMessage(const Message& message);
+
+		//Moves queued messages into the history, called every frame so nothing is dropped while the window is closed
+		static void ProcessMessages();
 
 	private:
+		static void StoreMessage(const Message& message);
 		void ImGuiRenderHeader();
 		void ImGuiRenderMessages();
 
@@ -58,10 +71,11 @@ namespace Lumos
 		static uint16_t s_MessageBufferCapacity;
 		static uint16_t s_MessageBufferSize;
 		static uint16_t s_MessageBufferBegin;
-		static std::vector<Ref<Message>> s_MessageBuffer;
+		static std::vector<Message> s_MessageBuffer;
 		static bool s_AllowScrollingToBottom;
 		static bool s_RequestScrollToBottom;
 		static uint32_t s_MessageBufferRenderFilter;
+		std::vector<uint16_t> m_VisibleMessages;
 		ImGuiTextFilter Filter;
 	};
 }
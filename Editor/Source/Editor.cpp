@@ -8,15 +8,23 @@
 #include "TextEditWindow.h"
 #include "AssetWindow.h"
 #include "ImGUIConsoleSink.h"
+#include "ThumbnailCache.h"
 
 #include <Lumos/Graphics/Camera/EditorCamera.h>
 #include <Lumos/Utilities/Timer.h>
+#include <Lumos/Maths/BatchMaths.h>
+#include <Lumos/Graphics/Particles/ParticleSystem.h>
 #include <Lumos/Core/Application.h>
 #include <Lumos/Core/OS/Input.h>
 #include <Lumos/Core/OS/FileSystem.h>
 #include <Lumos/Core/OS/OS.h>
 #include <Lumos/Core/Version.h>
 #include <Lumos/Core/Engine.h>
+#include <Lumos/Core/VFS.h>
+#include <Lumos/Core/StringUtilities.h>
+#include <Lumos/Utilities/AssetDatabase.h>
+#include <Lumos/Graphics/ShaderCompiler.h>
+#include <Lumos/Utilities/AssetManager.h>
 #include <Lumos/Scene/Scene.h>
 #include <Lumos/Scene/SceneManager.h>
 #include <Lumos/Scene/Entity.h>
@@ -38,6 +46,7 @@
 #include <Lumos/Graphics/Renderers/DebugRenderer.h>
 #include <Lumos/Graphics/Model.h>
 #include <Lumos/Graphics/Environment.h>
+#include <Lumos/Graphics/Terrain/ChunkedTerrain.h>
 #include <Lumos/Scene/EntityFactory.h>
 #include <Lumos/ImGui/IconsMaterialDesignIcons.h>
 
@@ -74,6 +83,9 @@ namespace Lumos
     {
         SaveEditorSettings();
 
+        m_ThumbnailCache.reset();
+        m_ShaderCompiler.reset();
+        m_AssetDatabase.reset();
         m_GridRenderer.reset();
         m_PreviewRenderer.reset();
         m_PreviewTexture.reset();
@@ -91,10 +103,7 @@ namespace Lumos
         Application::SetEditorState(EditorState::Preview);
 		Application::Get().GetWindow()->SetEventCallback(BIND_EVENT_FN(Editor::OnEvent));
 
-#ifdef LUMOS_PLATFORM_IOS
-        m_TempSceneSaveFilePath = OS::Instance()->GetAssetPath();
-#else
-        m_TempSceneSaveFilePath = ROOT_DIR"/bin/";
+#ifndef LUMOS_PLATFORM_IOS
 		const char* ini[] = {ROOT_DIR "/Editor.ini", ROOT_DIR "/Editor/Editor.ini"};
 		bool fileFound = false;
 		std::string filePath;
@@ -164,6 +173,14 @@ namespace Lumos
 			window->SetEditor(this);
         
         CreateGridRenderer();
+
+#ifndef LUMOS_PLATFORM_IOS
+		//Indexed in the background, the asset window reads the index and changed files are hot reloaded
+		m_AssetDatabase = CreateUniqueRef<AssetDatabase>(std::vector<std::string> { ROOT_DIR "/Sandbox/Assets", ROOT_DIR "/Lumos/Assets/Shaders" }, ROOT_DIR "/Editor/AssetCache.bin");
+		m_AssetDatabase->SetChangedCallback(BIND_EVENT_FN(Editor::OnAssetChanged));
+		m_ThumbnailCache = CreateUniqueRef<ThumbnailCache>(ROOT_DIR "/Editor/Thumbnails");
+		m_ShaderCompiler = CreateUniqueRef<Graphics::ShaderCompiler>(ROOT_DIR "/Editor/ShaderCache");
+#endif
         
 		m_ShowImGuiDemo = false;
         
@@ -221,6 +238,7 @@ namespace Lumos
 	void Editor::OnImGui()
 	{
 		LUMOS_PROFILE_FUNCTION();
+		ConsoleWindow::ProcessMessages();
 		DrawMenuBar();
         
 		BeginDockSpace(m_FullScreenOnPlay && Application::Get().GetEditorState() == EditorState::Play);
@@ -484,7 +502,8 @@ namespace Lumos
 				if(ImGui::MenuItem("Terrain"))
 				{
 					auto entity = scene->CreateEntity("Terrain");
-					entity.AddComponent<Graphics::Model>(Ref<Graphics::Mesh>(Graphics::CreatePrimative(Graphics::PrimitiveType::Terrain)),Graphics::PrimitiveType::Terrain);
+					entity.AddComponent<Maths::Transform>();
+					entity.AddComponent<Graphics::ChunkedTerrain>();
 				}
                 
 				if(ImGui::MenuItem("Light Cube"))
@@ -501,6 +520,14 @@ namespace Lumos
 				{
 					RecompileShaders();
 				}
+				if(ImGui::MenuItem("Benchmark Batch Maths"))
+				{
+					Maths::Batch::RunBenchmarks();
+				}
+				if(ImGui::MenuItem("Benchmark Particles"))
+				{
+					ParticleSystem::RunBenchmark();
+				}
 				ImGui::EndMenu();
 			}
 			
@@ -1081,6 +1108,9 @@ namespace Lumos
 		LUMOS_PROFILE_FUNCTION();
         
         Application::OnUpdate(ts);
+
+		if(m_AssetDatabase)
+			m_AssetDatabase->Update();
         
         if(Application::Get().GetEditorState() == EditorState::Preview)
         {
@@ -1535,6 +1565,10 @@ namespace Lumos
         
 		if(Application::Get().GetEditorState() == EditorState::Preview && m_ShowGrid && !m_EditorCamera->IsOrthographic())
 			Draw3DGrid();
+
+		//A couple of milliseconds a frame so browsing a large folder never stalls the editor
+		if(m_ThumbnailCache)
+			m_ThumbnailCache->OnRender(2.0f);
 	}
     
 	void Editor::DrawPreview()
@@ -1616,6 +1650,7 @@ namespace Lumos
 		m_IniFile.SetOrAdd("PhysicsDebugDrawFlags", Application::Get().GetSystem<LumosPhysicsEngine>()->GetDebugDrawFlags());
 		m_IniFile.SetOrAdd("PhysicsDebugDrawFlags2D", Application::Get().GetSystem<B2PhysicsEngine>()->GetDebugDrawFlags());
 		m_IniFile.SetOrAdd("Theme", (int)m_Theme);
+		m_IniFile.SetOrAdd("LogToFile", GetLogToFile());
 		m_IniFile.Rewrite();
 	}
     
@@ -1633,6 +1668,7 @@ namespace Lumos
 		m_IniFile.Add("PhysicsDebugDrawFlags", 0);
 		m_IniFile.Set("PhysicsDebugDrawFlags2D", 0);
 		m_IniFile.Set("Theme", (int)m_Theme);
+		m_IniFile.Add("LogToFile", false);
 		m_IniFile.Rewrite();
 	}
     
@@ -1650,9 +1686,26 @@ namespace Lumos
 		m_Theme = ImGuiHelpers::Theme(m_IniFile.GetOrDefault("Theme", (int)m_Theme));
 		Application::Get().GetSystem<LumosPhysicsEngine>()->SetDebugDrawFlags(m_IniFile.GetOrDefault("PhysicsDebugDrawFlags", 0));
 		Application::Get().GetSystem<B2PhysicsEngine>()->SetDebugDrawFlags(m_IniFile.GetOrDefault("PhysicsDebugDrawFlags2D", 0));
+		SetLogToFile(m_IniFile.GetOrDefault("LogToFile", false));
 		
 		ImGuiHelpers::SetTheme(m_Theme);
 	}
+
+	void Editor::SetLogToFile(bool logToFile)
+	{
+		if(logToFile == GetLogToFile())
+			return;
+
+		if(logToFile)
+		{
+			m_LogFileSink = Debug::Log::AddFileSink(ROOT_DIR "/Editor/LumosLog.txt");
+		}
+		else
+		{
+			Debug::Log::RemoveSink(m_LogFileSink);
+			m_LogFileSink = nullptr;
+		}
+	}
     
 	const char* Editor::GetIconFontIcon(const std::string& filePath)
 	{ 
@@ -1688,19 +1741,159 @@ namespace Lumos
 		return m_GridRenderer;
 	}
     
+	void Editor::OnAssetChanged(const AssetRecord& record)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		auto resolvesTo = [&record](const std::string& path)
+		{
+			std::string physicalPath;
+			return !path.empty() && VFS::Get()->ResolvePhysicalPath(path, physicalPath) && AssetDatabase::NormalisePath(physicalPath) == record.Path;
+		};
+
+		auto& registry = Application::Get().GetSceneManager()->GetCurrentScene()->GetRegistry();
+
+		switch(record.Type)
+		{
+		case AssetType::Shader:
+		{
+			//Sources are compiled in the background, writing the SPIR-V comes back here as a change of its own
+			const std::string extension = StringUtilities::GetFilePathExtension(record.Name);
+			if(extension != "shader" && extension != "spv")
+			{
+				if(m_ShaderCompiler)
+					m_ShaderCompiler->Compile(record.Path);
+				break;
+			}
+
+			//Only the shaders that are the changed file, or list it as a stage
+			auto& shaderLibrary = Application::Get().GetShaderLibrary();
+			std::vector<Ref<Graphics::Shader>> shaders;
+			for(auto& [name, resource] : shaderLibrary->GetResources())
+			{
+				std::string physicalPath;
+				if(!VFS::Get()->ResolvePhysicalPath(name, physicalPath))
+					continue;
+
+				if(resolvesTo(name) || (extension == "spv" && StringUtilities::StringContains(FileSystem::ReadTextFile(physicalPath), "/" + record.Name)))
+					shaders.push_back(resource.data);
+			}
+
+			//Everything keeps rendering with the current version until the new one has loaded
+			bool layoutChanged = false;
+			for(auto& shader : shaders)
+			{
+				LUMOS_LOG_INFO("Reloading shader {0}", shader->GetName());
+				switch(shader->Reload())
+				{
+				case Graphics::ShaderReloadResult::FAILED:
+					LUMOS_LOG_ERROR("Failed to reload shader {0}, keeping the previous version", shader->GetName());
+					break;
+				case Graphics::ShaderReloadResult::RELOADED:
+					Graphics::Pipeline::ShaderReloaded(shader.get());
+					break;
+				case Graphics::ShaderReloadResult::LAYOUT_CHANGED:
+					layoutChanged = true;
+					break;
+				}
+			}
+
+			if(!layoutChanged)
+				break;
+
+			//Descriptor sets were made for the old layout, the renderers have to build new ones
+			Application::Get().ReloadRenderers();
+
+			m_GridRenderer.reset();
+			CreateGridRenderer();
+			m_PreviewRenderer.reset();
+			m_PreviewTexture.reset();
+			if(m_ThumbnailCache)
+				m_ThumbnailCache->ResetRenderer();
+
+			for(auto& window : m_Windows)
+			{
+				if(window->GetSimpleName() == "Scene")
+					static_cast<SceneWindow*>(window.get())->InvalidateRenderTargets();
+			}
+			break;
+		}
+		case AssetType::Texture:
+		{
+			std::unordered_set<Graphics::Material*> materials;
+			auto modelView = registry.view<Graphics::Model>();
+			for(auto entity : modelView)
+			{
+				for(auto& mesh : modelView.get<Graphics::Model>(entity).GetMeshes())
+				{
+					if(mesh->GetMaterial())
+						materials.insert(mesh->GetMaterial().get());
+				}
+			}
+
+			for(auto material : materials)
+			{
+				//Copied, the setters replace the textures the paths come from
+				const Graphics::PBRMataterialTextures textures = material->GetTextures();
+				if(textures.albedo && resolvesTo(textures.albedo->GetFilepath()))
+					material->SetAlbedoTexture(textures.albedo->GetFilepath());
+				if(textures.normal && resolvesTo(textures.normal->GetFilepath()))
+					material->SetNormalTexture(textures.normal->GetFilepath());
+				if(textures.metallic && resolvesTo(textures.metallic->GetFilepath()))
+					material->SetMetallicTexture(textures.metallic->GetFilepath());
+				if(textures.roughness && resolvesTo(textures.roughness->GetFilepath()))
+					material->SetRoughnessTexture(textures.roughness->GetFilepath());
+				if(textures.ao && resolvesTo(textures.ao->GetFilepath()))
+					material->SetAOTexture(textures.ao->GetFilepath());
+				if(textures.emissive && resolvesTo(textures.emissive->GetFilepath()))
+					material->SetEmissiveTexture(textures.emissive->GetFilepath());
+			}
+
+			auto spriteView = registry.view<Graphics::Sprite>();
+			for(auto entity : spriteView)
+			{
+				auto& sprite = spriteView.get<Graphics::Sprite>(entity);
+				if(!sprite.GetTexture() || !resolvesTo(sprite.GetTexture()->GetFilepath()))
+					continue;
+
+				const std::string filePath = sprite.GetTexture()->GetFilepath();
+				sprite.SetTextureFromFile(filePath);
+			}
+			break;
+		}
+		case AssetType::Model:
+		{
+			auto modelView = registry.view<Graphics::Model>();
+			for(auto entity : modelView)
+			{
+				auto& model = modelView.get<Graphics::Model>(entity);
+				if(model.GetPrimitiveType() != Graphics::PrimitiveType::File || !resolvesTo(model.GetFilePath()))
+					continue;
+
+				LUMOS_LOG_INFO("Reloading model {0}", model.GetFilePath());
+				const std::string filePath = model.GetFilePath();
+				model = Graphics::Model(filePath);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
 	void Editor::CacheScene()
 	{
 		LUMOS_PROFILE_FUNCTION();
-		Application::Get().GetCurrentScene()->Serialise(m_TempSceneSaveFilePath, false);
+		m_SceneSnapshot = Application::Get().GetCurrentScene()->CreateSnapshot();
 	}
     
 	void Editor::LoadCachedScene()
 	{
 		LUMOS_PROFILE_FUNCTION();
         
-        if(FileSystem::FileExists(m_TempSceneSaveFilePath + Application::Get().GetCurrentScene()->GetSceneName() + ".lsn"))
+        //Only valid for the scene that was playing, a scene switch during play loads the new scene from disk
+        if(m_SceneSnapshot && m_SceneSnapshot->SceneName == Application::Get().GetCurrentScene()->GetSceneName())
         {
-            Application::Get().GetCurrentScene()->Deserialise(m_TempSceneSaveFilePath, false);
+            Application::Get().GetCurrentScene()->RestoreSnapshot(*m_SceneSnapshot);
         }
         else
         {
@@ -1711,6 +1904,7 @@ namespace Lumos
                 Application::Get().GetCurrentScene()->Deserialise(newPath, false);
             }
         }
+        m_SceneSnapshot.reset();
 	}
     
 }
@@ -20,6 +20,10 @@ namespace Lumos
 #define BIND_FILEBROWSER_FN(fn) [this](auto&&... args) -> decltype(auto) { return this->fn(std::forward<decltype(args)>(args)...); }
 
 	class Scene;
+	struct SceneSnapshot;
+	struct AssetRecord;
+	class AssetDatabase;
+	class ThumbnailCache;
 	class Event;
 	class WindowCloseEvent;
 	class WindowResizeEvent;
@@ -30,6 +34,7 @@ namespace Lumos
 		class Texture2D;
 		class GridRenderer;
 		class ForwardRenderer;
+		class ShaderCompiler;
         class GridRenderer;
 		class Mesh;
 	}
@@ -198,10 +203,28 @@ namespace Lumos
 		void CacheScene();
 		void LoadCachedScene();
 
+		AssetDatabase* GetAssetDatabase() const
+		{
+			return m_AssetDatabase.get();
+		}
+
+		ThumbnailCache* GetThumbnailCache() const
+		{
+			return m_ThumbnailCache.get();
+		}
+
+		bool GetLogToFile() const
+		{
+			return m_LogFileSink != nullptr;
+		}
+
+		void SetLogToFile(bool logToFile);
+
 	protected:
 	
 		NONCOPYABLE(Editor)
 	    bool OnWindowResize(WindowResizeEvent& e);
+		void OnAssetChanged(const AssetRecord& record);
 
 		Application* m_Application;
 
@@ -245,7 +268,11 @@ namespace Lumos
 		Ref<Graphics::Texture2D> m_PreviewTexture;
 		Ref<Graphics::Mesh> m_PreviewSphere;
         Ref<Graphics::GridRenderer> m_GridRenderer;
-		std::string m_TempSceneSaveFilePath;
+		UniqueRef<SceneSnapshot> m_SceneSnapshot;
+		UniqueRef<AssetDatabase> m_AssetDatabase;
+		UniqueRef<ThumbnailCache> m_ThumbnailCache;
+		UniqueRef<Graphics::ShaderCompiler> m_ShaderCompiler;
+		spdlog::sink_ptr m_LogFileSink;
 
 		IniFile m_IniFile;
 		
@@ -24,334 +24,414 @@
 namespace Lumos
 {
 	HierarchyWindow::HierarchyWindow()
-		: m_HadRecentDroppedEntity(entt::null)
-        , m_DoubleClicked(entt::null)
+		: m_DoubleClicked(entt::null)
 	{
 		m_Name = "Hierarchy###hierarchy";
 		m_SimpleName = "Hierarchy";
 	}
 
-	void HierarchyWindow::DrawNode(entt::entity node, entt::registry& registry)
+	HierarchyWindow::~HierarchyWindow()
 	{
-		LUMOS_PROFILE_FUNCTION();
-		bool show = true;
+		SetRegistry(nullptr);
+	}
 
-		if(!registry.valid(node))
+	void HierarchyWindow::SetRegistry(entt::registry* registry)
+	{
+		if(registry == m_Registry)
 			return;
 
-		const auto nameComponent = registry.try_get<NameComponent>(node);
-		std::string name = nameComponent ? nameComponent->name : StringUtilities::ToString(entt::to_integral(node));
+		if(m_Registry)
+		{
+			m_Registry->on_construct<Hierarchy>().disconnect(*this);
+			m_Registry->on_update<Hierarchy>().disconnect(*this);
+			m_Registry->on_destroy<Hierarchy>().disconnect(*this);
+			m_Registry->on_construct<NameComponent>().disconnect(*this);
+			m_Registry->on_update<NameComponent>().disconnect(*this);
+			m_Registry->on_destroy<NameComponent>().disconnect(*this);
+		}
+
+		m_Registry = registry;
+		m_NameIndex.clear();
+		m_OpenNodes.clear();
+		m_TreeDirty = true;
+
+		if(m_Registry)
+		{
+			m_Registry->on_construct<Hierarchy>().connect<&HierarchyWindow::OnHierarchyChanged>(*this);
+			m_Registry->on_update<Hierarchy>().connect<&HierarchyWindow::OnHierarchyChanged>(*this);
+			m_Registry->on_destroy<Hierarchy>().connect<&HierarchyWindow::OnHierarchyChanged>(*this);
+			m_Registry->on_construct<NameComponent>().connect<&HierarchyWindow::OnNameChanged>(*this);
+			m_Registry->on_update<NameComponent>().connect<&HierarchyWindow::OnNameChanged>(*this);
+			m_Registry->on_destroy<NameComponent>().connect<&HierarchyWindow::OnNameDestroy>(*this);
+
+			auto view = m_Registry->view<NameComponent>();
+			for(auto entity : view)
+				m_NameIndex[entity] = view.get(entity).name;
+		}
+	}
+
+	void HierarchyWindow::OnHierarchyChanged(entt::registry& registry, entt::entity entity)
+	{
+		m_TreeDirty = true;
+	}
+
+	void HierarchyWindow::OnNameChanged(entt::registry& registry, entt::entity entity)
+	{
+		m_NameIndex[entity] = registry.get<NameComponent>(entity).name;
+		m_RowsDirty = true;
+	}
+
+	void HierarchyWindow::OnNameDestroy(entt::registry& registry, entt::entity entity)
+	{
+		m_NameIndex.erase(entity);
+		m_RowsDirty = true;
+	}
+
+	const std::string& HierarchyWindow::GetEntityName(entt::entity entity)
+	{
+		auto it = m_NameIndex.find(entity);
+		if(it != m_NameIndex.end())
+			return it->second;
+
+		m_UnnamedEntityName = StringUtilities::ToString(entt::to_integral(entity));
+		return m_UnnamedEntityName;
+	}
+
+	void HierarchyWindow::RebuildTree(entt::registry& registry)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_Tree.clear();
+
+		registry.each([&](auto entity)
+			{
+				auto hierarchyComponent = registry.try_get<Hierarchy>(entity);
+				if(!hierarchyComponent || hierarchyComponent->Parent() == entt::null)
+					AddTreeNode(entity, 0, 0, true, registry);
+			});
+
+		for(auto it = m_OpenNodes.begin(); it != m_OpenNodes.end();)
+		{
+			if(registry.valid(*it))
+				++it;
+			else
+				it = m_OpenNodes.erase(it);
+		}
+
+		m_EntityCount = registry.alive();
+		m_TreeDirty = false;
+		m_RowsDirty = true;
+	}
+
+	void HierarchyWindow::AddTreeNode(entt::entity entity, uint32_t depth, uint32_t treeLines, bool lastChild, entt::registry& registry)
+	{
+		auto hierarchyComponent = registry.try_get<Hierarchy>(entity);
+		entt::entity child = hierarchyComponent ? hierarchyComponent->First() : entt::null;
+		m_Tree.push_back({ entity, depth, treeLines, child != entt::null && registry.valid(child), lastChild });
+
+		//The line this node hangs from carries on past its children while it has later siblings
+		if(depth > 0 && depth <= 32 && !lastChild)
+			treeLines |= 1u << (depth - 1);
+
+		while(child != entt::null && registry.valid(child))
+		{
+			auto childHierarchyComponent = registry.try_get<Hierarchy>(child);
+			entt::entity next = childHierarchyComponent ? childHierarchyComponent->Next() : entt::null;
+			AddTreeNode(child, depth + 1, treeLines, next == entt::null || !registry.valid(next), registry);
+			child = next;
+		}
+	}
+
+	void HierarchyWindow::RebuildRows()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_Rows.clear();
+		m_FilterText = m_HierarchyFilter.InputBuf;
+		m_RowsDirty = false;
 
+		//Matches are listed flat, in tree order
 		if(m_HierarchyFilter.IsActive())
 		{
-			if(!m_HierarchyFilter.PassFilter(name.c_str()))
+			for(auto& node : m_Tree)
 			{
-				show = false;
+				if(m_HierarchyFilter.PassFilter(GetEntityName(node.Entity).c_str()))
+					m_Rows.push_back({ node.Entity, 0, 0, false, true });
 			}
+			return;
 		}
 
-		if(show)
+		//Skip everything below a collapsed node
+		uint32_t collapsedDepth = UINT32_MAX;
+		for(auto& node : m_Tree)
 		{
-			auto hierarchyComponent = registry.try_get<Hierarchy>(node);
-			bool noChildren = true;
+			if(node.Depth > collapsedDepth)
+				continue;
 
-			if(hierarchyComponent != nullptr && hierarchyComponent->First() != entt::null)
-				noChildren = false;
+			collapsedDepth = UINT32_MAX;
+			m_Rows.push_back(node);
 
-			ImGuiTreeNodeFlags nodeFlags = ((m_Editor->GetSelected() == node) ? ImGuiTreeNodeFlags_Selected : 0);
+			if(node.HasChildren && m_OpenNodes.find(node.Entity) == m_OpenNodes.end())
+				collapsedDepth = node.Depth;
+		}
+	}
 
-			nodeFlags |= ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_FramePadding;
+	void HierarchyWindow::DrawNode(const HierarchyRow& row, entt::registry& registry)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		entt::entity node = row.Entity;
 
-			if(noChildren)
-			{
-				nodeFlags |= ImGuiTreeNodeFlags_Leaf;
-			}
-            
-			auto activeComponent = registry.try_get<ActiveComponent>(node);
-			bool active = activeComponent ? activeComponent->active : true;
+		//Destroyed since the rows were built, they are rebuilt next frame
+		if(!registry.valid(node))
+		{
+			m_TreeDirty = true;
+			return;
+		}
 
-			if(!active)
-				ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
+		const std::string& name = GetEntityName(node);
 
-			bool doubleClicked = false;
-			if(node == m_DoubleClicked)
-			{
-				doubleClicked = true;
-			}
+		const float SmallOffsetX = 6.0f;
+		const float levelWidth = ImGui::GetStyle().IndentSpacing + 10.0f;
+		const float indent = float(row.Depth) * levelWidth;
+		const ImVec2 rowStart = ImGui::GetCursorScreenPos();
 
-			if(doubleClicked)
-				ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, {1.0f, 2.0f});
+		if(row.Depth > 0)
+		{
+			const ImColor TreeLineColor = ImColor(128, 128, 128, 128);
+			ImDrawList* drawList = ImGui::GetWindowDrawList();
+			const float rowEnd = rowStart.y + ImGui::GetFrameHeightWithSpacing();
+			const float midpoint = rowStart.y + ImGui::GetFrameHeight() * 0.5f;
+			auto lineX = [&](uint32_t level) { return rowStart.x + float(level) * levelWidth + ImGui::GetStyle().IndentSpacing + SmallOffsetX; };
 
-			if(m_HadRecentDroppedEntity == node)
+			for(uint32_t level = 0; level + 1 < row.Depth && level < 32; level++)
 			{
-				ImGui::SetNextItemOpen(true);
-				m_HadRecentDroppedEntity = entt::null;
+				if(row.TreeLines & (1u << level))
+					drawList->AddLine(ImVec2(lineX(level), rowStart.y), ImVec2(lineX(level), rowEnd), TreeLineColor);
 			}
 
-			std::string icon = ICON_MDI_CUBE_OUTLINE;
-			auto& iconMap = m_Editor->GetComponentIconMap();
+			//Shorter when the row has an arrow to line up with
+			const float x = lineX(row.Depth - 1);
+			const float HorizontalTreeLineSize = row.HasChildren ? 8.0f : 16.0f;
+			drawList->AddLine(ImVec2(x, rowStart.y), ImVec2(x, row.LastChild ? midpoint : rowEnd), TreeLineColor);
+			drawList->AddLine(ImVec2(x, midpoint), ImVec2(x + HorizontalTreeLineSize, midpoint), TreeLineColor);
+		}
 
-			if(registry.has<Camera>(node))
-			{
-				if(iconMap.find(typeid(Camera).hash_code()) != iconMap.end())
-					icon = iconMap[typeid(Camera).hash_code()];
-			}
-			else if(registry.has<SoundComponent>(node))
-			{
-				if(iconMap.find(typeid(SoundComponent).hash_code()) != iconMap.end())
-					icon = iconMap[typeid(SoundComponent).hash_code()];
-			}
-			else if(registry.has<Physics2DComponent>(node))
-			{
-				if(iconMap.find(typeid(Physics2DComponent).hash_code()) != iconMap.end())
-					icon = iconMap[typeid(Physics2DComponent).hash_code()];
-			}
-			else if(registry.has<Graphics::Light>(node))
-			{
-				if(iconMap.find(typeid(Graphics::Light).hash_code()) != iconMap.end())
-					icon = iconMap[typeid(Graphics::Light).hash_code()];
-			}
-			else if(registry.has<Graphics::Environment>(node))
-			{
-				if(iconMap.find(typeid(Graphics::Environment).hash_code()) != iconMap.end())
-					icon = iconMap[typeid(Graphics::Environment).hash_code()];
-			}
-            else if(registry.has<Graphics::Sprite>(node))
-            {
-                if(iconMap.find(typeid(Graphics::Sprite).hash_code()) != iconMap.end())
-                    icon = iconMap[typeid(Graphics::Sprite).hash_code()];
-            }
+		if(indent > 0.0f)
+			ImGui::Indent(indent);
 
-			bool nodeOpen = ImGui::TreeNodeEx((void*)(intptr_t)entt::to_integral(node), nodeFlags, (icon + " %s").c_str(), doubleClicked ? "" : (name).c_str());
+		//Children are separate rows so the node never pushes onto the tree stack
+		ImGuiTreeNodeFlags nodeFlags = ((m_Editor->GetSelected() == node) ? ImGuiTreeNodeFlags_Selected : 0);
+		nodeFlags |= ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_FramePadding | ImGuiTreeNodeFlags_NoTreePushOnOpen;
 
-			if(doubleClicked)
-			{
-				ImGui::SameLine();
-				static char objName[INPUT_BUF_SIZE];
-				strcpy(objName, name.c_str());
-
-				ImGui::PushItemWidth(-1);
-				if(ImGui::InputText("##Name", objName, IM_ARRAYSIZE(objName), 0))
-					registry.get_or_emplace<NameComponent>(node).name = objName;
-				ImGui::PopStyleVar();
-			}
-#if 0
-            ImGui::SameLine(ImGui::GetWindowContentRegionMax().x - 22.0f);
-            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.7f, 0.7f, 0.7f, 0.0f));
-            if(ImGui::Button(active ? ICON_MDI_EYE : ICON_MDI_EYE_OFF))
-            {
-                auto& activeComponent = registry.get_or_emplace<ActiveComponent>(node);
-
-                activeComponent.active = !active;
-            }
-            ImGui::PopStyleColor();
-#endif
-
-			if(!active)
-				ImGui::PopStyleColor();
-
-			bool deleteEntity = false;
-			if(ImGui::BeginPopupContextItem(name.c_str()))
-			{
-				if(ImGui::Selectable("Copy"))
-					m_Editor->SetCopiedEntity(node);
+		if(!row.HasChildren)
+		{
+			nodeFlags |= ImGuiTreeNodeFlags_Leaf;
+		}
 
-				if(ImGui::Selectable("Cut"))
-					m_Editor->SetCopiedEntity(node, true);
+		auto activeComponent = registry.try_get<ActiveComponent>(node);
+		bool active = activeComponent ? activeComponent->active : true;
 
-				if(m_Editor->GetCopiedEntity() != entt::null && registry.valid(m_Editor->GetCopiedEntity()))
-				{
-					if(ImGui::Selectable("Paste"))
-					{
-                        auto scene = Application::Get().GetSceneManager()->GetCurrentScene();
-                        Entity copiedEntity = {m_Editor->GetCopiedEntity(), scene};
-                        if(!copiedEntity.Valid())
-                        {
-                            m_Editor->SetCopiedEntity(entt::null);
-                        }
-                        else
-                        {
-                            scene->DuplicateEntity(copiedEntity, {node, scene});
-                            
-                            if(m_Editor->GetCutCopyEntity())
-                                deleteEntity = true;
-                        }
-					}
-				}
-				else
-				{
-					ImGui::TextDisabled("Paste");
-				}
+		if(!active)
+			ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
 
-				ImGui::Separator();
+		bool doubleClicked = false;
+		if(node == m_DoubleClicked)
+		{
+			doubleClicked = true;
+		}
 
-				if (ImGui::Selectable("Duplicate")) 
-				{
-					auto scene = Application::Get().GetSceneManager()->GetCurrentScene();
-					scene->DuplicateEntity({node , scene});
-				}
-				if(ImGui::Selectable("Delete"))
-					deleteEntity = true;
-				if(m_Editor->GetSelected() == node)
-					m_Editor->SetSelected(entt::null);
-				ImGui::Separator();
-				if(ImGui::Selectable("Rename"))
-					m_DoubleClicked = node;
-                ImGui::Separator();
+		if(doubleClicked)
+			ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, {1.0f, 2.0f});
 
-                if (ImGui::Selectable("Add Child"))
-                {
-                    auto scene = Application::Get().GetSceneManager()->GetCurrentScene();
-                    auto child = scene->CreateEntity();
-                    child.SetParent({ node, scene});
-                }
-				ImGui::EndPopup();
-			}
+		std::string icon = ICON_MDI_CUBE_OUTLINE;
+		auto& iconMap = m_Editor->GetComponentIconMap();
 
-			if(!doubleClicked && ImGui::BeginDragDropSource(ImGuiDragDropFlags_None))
-			{
-				auto ptr = node;
-				ImGui::SetDragDropPayload("Drag_Entity", &ptr, sizeof(entt::entity*));
-				ImGui::Text(ICON_MDI_ARROW_UP);
-				ImGui::EndDragDropSource();
-			}
+		if(registry.has<Camera>(node))
+		{
+			if(iconMap.find(typeid(Camera).hash_code()) != iconMap.end())
+				icon = iconMap[typeid(Camera).hash_code()];
+		}
+		else if(registry.has<SoundComponent>(node))
+		{
+			if(iconMap.find(typeid(SoundComponent).hash_code()) != iconMap.end())
+				icon = iconMap[typeid(SoundComponent).hash_code()];
+		}
+		else if(registry.has<Physics2DComponent>(node))
+		{
+			if(iconMap.find(typeid(Physics2DComponent).hash_code()) != iconMap.end())
+				icon = iconMap[typeid(Physics2DComponent).hash_code()];
+		}
+		else if(registry.has<Graphics::Light>(node))
+		{
+			if(iconMap.find(typeid(Graphics::Light).hash_code()) != iconMap.end())
+				icon = iconMap[typeid(Graphics::Light).hash_code()];
+		}
+		else if(registry.has<Graphics::Environment>(node))
+		{
+			if(iconMap.find(typeid(Graphics::Environment).hash_code()) != iconMap.end())
+				icon = iconMap[typeid(Graphics::Environment).hash_code()];
+		}
+		else if(registry.has<Graphics::Sprite>(node))
+		{
+			if(iconMap.find(typeid(Graphics::Sprite).hash_code()) != iconMap.end())
+				icon = iconMap[typeid(Graphics::Sprite).hash_code()];
+		}
 
-			const ImGuiPayload* payload = ImGui::GetDragDropPayload();
-			if(payload != NULL && payload->IsDataType("Drag_Entity"))
-			{
-				bool acceptable;
+		const bool wasOpen = m_OpenNodes.find(node) != m_OpenNodes.end();
+		if(row.HasChildren)
+			ImGui::SetNextItemOpen(wasOpen);
 
-				LUMOS_ASSERT(payload->DataSize == sizeof(entt::entity*), "Error ImGUI drag entity");
-				auto entity = *reinterpret_cast<entt::entity*>(payload->Data);
-				auto hierarchyComponent = registry.try_get<Hierarchy>(entity);
-				if(hierarchyComponent != nullptr)
-				{
-					acceptable = entity != node && (!IsParentOfEntity(entity, node, registry)) && (hierarchyComponent->Parent() != node);
-				}
-				else
-					acceptable = entity != node;
+		bool nodeOpen = ImGui::TreeNodeEx((void*)(intptr_t)entt::to_integral(node), nodeFlags, (icon + " %s").c_str(), doubleClicked ? "" : name.c_str());
 
-				if(ImGui::BeginDragDropTarget())
+		if(row.HasChildren && nodeOpen != wasOpen)
+		{
+			if(nodeOpen)
+				m_OpenNodes.insert(node);
+			else
+				m_OpenNodes.erase(node);
+			m_RowsDirty = true;
+		}
+
+		if(doubleClicked)
+		{
+			ImGui::SameLine();
+			static char objName[INPUT_BUF_SIZE];
+			strcpy(objName, name.c_str());
+
+			ImGui::PushItemWidth(-1);
+			if(ImGui::InputText("##Name", objName, IM_ARRAYSIZE(objName), 0))
+				registry.emplace_or_replace<NameComponent>(node, objName);
+			ImGui::PopStyleVar();
+		}
+
+		if(!active)
+			ImGui::PopStyleColor();
+
+		bool deleteEntity = false;
+		if(ImGui::BeginPopupContextItem(name.c_str()))
+		{
+			if(ImGui::Selectable("Copy"))
+				m_Editor->SetCopiedEntity(node);
+
+			if(ImGui::Selectable("Cut"))
+				m_Editor->SetCopiedEntity(node, true);
+
+			if(m_Editor->GetCopiedEntity() != entt::null && registry.valid(m_Editor->GetCopiedEntity()))
+			{
+				if(ImGui::Selectable("Paste"))
 				{
-					// Drop directly on to node and append to the end of it's children list.
-					if(ImGui::AcceptDragDropPayload("Drag_Entity"))
+					auto scene = Application::Get().GetSceneManager()->GetCurrentScene();
+					Entity copiedEntity = {m_Editor->GetCopiedEntity(), scene};
+					if(!copiedEntity.Valid())
 					{
-						if(acceptable)
-						{
-							if(hierarchyComponent)
-								Hierarchy::Reparent(entity, node, registry, *hierarchyComponent);
-							else
-							{
-								registry.emplace<Hierarchy>(entity, node);
-							}
-							m_HadRecentDroppedEntity = node;
-						}
+						m_Editor->SetCopiedEntity(entt::null);
 					}
+					else
+					{
+						scene->DuplicateEntity(copiedEntity, {node, scene});
 
-					ImGui::EndDragDropTarget();
+						if(m_Editor->GetCutCopyEntity())
+							deleteEntity = true;
+					}
 				}
-
-				if(m_Editor->GetSelected() == entity)
-					m_Editor->SetSelected(entt::null);
+			}
+			else
+			{
+				ImGui::TextDisabled("Paste");
 			}
 
-			if(ImGui::IsItemClicked() && !deleteEntity)
-				m_Editor->SetSelected(node);
-			else if(m_DoubleClicked == node && ImGui::IsMouseClicked(0) && !ImGui::IsItemHovered(ImGuiHoveredFlags_None))
-				m_DoubleClicked = entt::null;
+			ImGui::Separator();
 
-			if(ImGui::IsMouseDoubleClicked(0) && ImGui::IsItemHovered(ImGuiHoveredFlags_None))
+			if (ImGui::Selectable("Duplicate")) 
 			{
-				m_DoubleClicked = node;
-				if(Application::Get().GetEditorState() == EditorState::Preview)
-				{
-					auto transform = registry.try_get<Maths::Transform>(node);
-					if(transform)
-						m_Editor->FocusCamera(transform->GetWorldPosition(), 2.0f, 2.0f);
-				}
+				auto scene = Application::Get().GetSceneManager()->GetCurrentScene();
+				scene->DuplicateEntity({node , scene});
 			}
+			if(ImGui::Selectable("Delete"))
+				deleteEntity = true;
+			if(m_Editor->GetSelected() == node)
+				m_Editor->SetSelected(entt::null);
+			ImGui::Separator();
+			if(ImGui::Selectable("Rename"))
+				m_DoubleClicked = node;
+			ImGui::Separator();
 
-			if(deleteEntity)
+			if (ImGui::Selectable("Add Child"))
 			{
-				DestroyEntity(node, registry);
-				if(nodeOpen)
-					ImGui::TreePop();
-				return;
+				auto scene = Application::Get().GetSceneManager()->GetCurrentScene();
+				auto child = scene->CreateEntity();
+				child.SetParent({ node, scene});
+				m_OpenNodes.insert(node);
 			}
-			
-			if(m_SelectUp)
+			ImGui::EndPopup();
+		}
+
+		if(!doubleClicked && ImGui::BeginDragDropSource(ImGuiDragDropFlags_None))
+		{
+			auto ptr = node;
+			ImGui::SetDragDropPayload("Drag_Entity", &ptr, sizeof(entt::entity*));
+			ImGui::Text(ICON_MDI_ARROW_UP);
+			ImGui::EndDragDropSource();
+		}
+
+		const ImGuiPayload* payload = ImGui::GetDragDropPayload();
+		if(payload != NULL && payload->IsDataType("Drag_Entity"))
+		{
+			bool acceptable;
+
+			LUMOS_ASSERT(payload->DataSize == sizeof(entt::entity*), "Error ImGUI drag entity");
+			auto entity = *reinterpret_cast<entt::entity*>(payload->Data);
+			auto hierarchyComponent = registry.try_get<Hierarchy>(entity);
+			if(hierarchyComponent != nullptr)
 			{
-					if(m_Editor->GetSelected() == node && registry.valid(m_CurrentPrevious))
-				{
-					m_SelectUp = false;
-					m_Editor->SetSelected(m_CurrentPrevious);
-					   }
+				acceptable = entity != node && (!IsParentOfEntity(entity, node, registry)) && (hierarchyComponent->Parent() != node);
 			}
-			
-			if(m_SelectDown)
+			else
+				acceptable = entity != node;
+
+			if(ImGui::BeginDragDropTarget())
 			{
-				if(registry.valid(m_CurrentPrevious) && m_CurrentPrevious == m_Editor->GetSelected())
+				// Drop directly on to node and append to the end of it's children list.
+				if(ImGui::AcceptDragDropPayload("Drag_Entity"))
 				{
-					m_SelectDown = false;
-					m_Editor->SetSelected(node);
+					if(acceptable)
+					{
+						if(hierarchyComponent)
+							Hierarchy::Reparent(entity, node, registry, *hierarchyComponent);
+						else
+						{
+							registry.emplace<Hierarchy>(entity, node);
+						}
+						m_OpenNodes.insert(node);
+					}
 				}
-			}
-			
-			m_CurrentPrevious = node;
 
-			if(nodeOpen == false)
-			{
-				return;
+				ImGui::EndDragDropTarget();
 			}
 
-            const ImColor TreeLineColor = ImColor(128, 128, 128, 128);
-            const float SmallOffsetX = 6.0f;
-            ImDrawList* drawList = ImGui::GetWindowDrawList();
+			if(m_Editor->GetSelected() == entity)
+				m_Editor->SetSelected(entt::null);
+		}
 
-            ImVec2 verticalLineStart = ImGui::GetCursorScreenPos();
-            verticalLineStart.x += SmallOffsetX; //to nicely line up with the arrow symbol
-            ImVec2 verticalLineEnd = verticalLineStart;
-            
-			if(!noChildren)
+		if(ImGui::IsItemClicked() && !deleteEntity)
+			m_Editor->SetSelected(node);
+		else if(m_DoubleClicked == node && ImGui::IsMouseClicked(0) && !ImGui::IsItemHovered(ImGuiHoveredFlags_None))
+			m_DoubleClicked = entt::null;
+
+		if(ImGui::IsMouseDoubleClicked(0) && ImGui::IsItemHovered(ImGuiHoveredFlags_None))
+		{
+			m_DoubleClicked = node;
+			if(Application::Get().GetEditorState() == EditorState::Preview)
 			{
-				entt::entity child = hierarchyComponent->First();
-				while(child != entt::null && registry.valid(child))
-				{
-                    float HorizontalTreeLineSize = 16.0f; //chosen arbitrarily
-                    auto currentPos = ImGui::GetCursorScreenPos();
-					ImGui::Indent(10.0f);
-                    
-                    auto childHerarchyComponent = registry.try_get<Hierarchy>(child);
-
-                    if(childHerarchyComponent)
-                    {
-                        entt::entity firstChild = childHerarchyComponent->First();
-                        if(firstChild != entt::null && registry.valid(firstChild))
-                        {
-                            HorizontalTreeLineSize *= 0.5f;
-                        }
-                    }
-					DrawNode(child, registry);
-					ImGui::Unindent(10.0f);
-                    
-                    const ImRect childRect = ImRect(currentPos, currentPos + ImVec2(0.0f, ImGui::GetFontSize() + ImGui::GetStyle().FramePadding.y));
-                    
-                    const float midpoint = (childRect.Min.y + childRect.Max.y) / 2.0f;
-                    drawList->AddLine(ImVec2(verticalLineStart.x, midpoint), ImVec2(verticalLineStart.x + HorizontalTreeLineSize, midpoint), TreeLineColor);
-                    verticalLineEnd.y = midpoint;
-                
-                    if(registry.valid(child))
-                    {
-                        auto hierarchyComponent = registry.try_get<Hierarchy>(child);
-                        child = hierarchyComponent ? hierarchyComponent->Next() : entt::null;
-                    }
-				}
+				auto transform = registry.try_get<Maths::Transform>(node);
+				if(transform)
+					m_Editor->FocusCamera(transform->GetWorldPosition(), 2.0f, 2.0f);
 			}
-            
-            drawList->AddLine(verticalLineStart, verticalLineEnd, TreeLineColor);
-
-			ImGui::TreePop();
 		}
+
+		if(indent > 0.0f)
+			ImGui::Unindent(indent);
+
+		if(deleteEntity)
+			DestroyEntity(node, registry);
 	}
 
 	void HierarchyWindow::DestroyEntity(entt::entity entity, entt::registry& registry)
@@ -400,7 +480,6 @@ namespace Lumos
 	{
 		LUMOS_PROFILE_FUNCTION();
 		auto flags = ImGuiWindowFlags_NoCollapse;
-		m_CurrentPrevious = entt::null;
 		m_SelectUp = false;
 		m_SelectDown = false;
 		
@@ -411,6 +490,7 @@ namespace Lumos
 		{
 			auto scene = Application::Get().GetSceneManager()->GetCurrentScene();
 			auto& registry = scene->GetRegistry();
+			SetRegistry(&registry);
 			
 			if(scene->GetHasCppClass())
 			{
@@ -501,15 +581,40 @@ namespace Lumos
 
 				ImGui::Indent();
 
-				registry.each([&](auto entity) {
-					if(registry.valid(entity))
-					{
-						auto hierarchyComponent = registry.try_get<Hierarchy>(entity);
+				//Entities created or destroyed without a Hierarchy or NameComponent don't signal anything
+				if(registry.alive() != m_EntityCount)
+					m_TreeDirty = true;
+				if(m_TreeDirty)
+					RebuildTree(registry);
+				if(m_RowsDirty || m_FilterText != m_HierarchyFilter.InputBuf)
+					RebuildRows();
+
+				ImGuiListClipper clipper;
+				clipper.Begin(int(m_Rows.size()));
+				while(clipper.Step())
+				{
+					for(int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+						DrawNode(m_Rows[i], registry);
+				}
 
-						if(!hierarchyComponent || hierarchyComponent->Parent() == entt::null)
-							DrawNode(entity, registry);
+				if(m_SelectUp || m_SelectDown)
+				{
+					for(size_t i = 0; i < m_Rows.size(); i++)
+					{
+						if(m_Rows[i].Entity != m_Editor->GetSelected())
+							continue;
+
+						size_t next = i;
+						if(m_SelectUp && i > 0)
+							next = i - 1;
+						else if(m_SelectDown && i + 1 < m_Rows.size())
+							next = i + 1;
+
+						if(registry.valid(m_Rows[next].Entity))
+							m_Editor->SetSelected(m_Rows[next].Entity);
+						break;
 					}
-				});
+				}
 
 				//Only supports one scene
 				ImVec2 min_space = ImGui::GetWindowContentRegionMin();
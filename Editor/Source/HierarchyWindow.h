@@ -4,6 +4,9 @@
 
 #include <entt/entity/fwd.hpp>
 #include <imgui/imgui.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace Lumos
 {
@@ -11,20 +14,50 @@ namespace Lumos
 	{
 	public:
 		HierarchyWindow();
-		~HierarchyWindow() = default;
+		~HierarchyWindow();
 
-        void DrawNode(entt::entity node, entt::registry& registry);
 		void OnImGui() override;
 
 		void DestroyEntity(entt::entity entity, entt::registry& registry);
 		bool IsParentOfEntity(entt::entity entity, entt::entity child, entt::registry& registry);
 		
 	private:
+		//One line of the flattened tree. TreeLines has a bit set for each ancestor level whose line runs past this row
+		struct HierarchyRow
+		{
+			entt::entity Entity;
+			uint32_t Depth;
+			uint32_t TreeLines;
+			bool HasChildren;
+			bool LastChild;
+		};
+
+		void DrawNode(const HierarchyRow& row, entt::registry& registry);
+
+		void SetRegistry(entt::registry* registry);
+		void RebuildTree(entt::registry& registry);
+		void AddTreeNode(entt::entity entity, uint32_t depth, uint32_t treeLines, bool lastChild, entt::registry& registry);
+		void RebuildRows();
+		const std::string& GetEntityName(entt::entity entity);
+
+		void OnHierarchyChanged(entt::registry& registry, entt::entity entity);
+		void OnNameChanged(entt::registry& registry, entt::entity entity);
+		void OnNameDestroy(entt::registry& registry, entt::entity entity);
+
 		ImGuiTextFilter m_HierarchyFilter;
+		std::string m_FilterText;
 		entt::entity m_DoubleClicked;
-		entt::entity m_HadRecentDroppedEntity;
-		entt::entity m_CurrentPrevious;
 		bool m_SelectUp;
 		bool m_SelectDown;
+
+		entt::registry* m_Registry = nullptr;
+		std::vector<HierarchyRow> m_Tree; //Every entity in draw order, rebuilt when the Hierarchy components change
+		std::vector<HierarchyRow> m_Rows; //What is left of m_Tree after collapsing and filtering
+		std::unordered_map<entt::entity, std::string> m_NameIndex;
+		std::unordered_set<entt::entity> m_OpenNodes;
+		std::string m_UnnamedEntityName;
+		size_t m_EntityCount = 0;
+		bool m_TreeDirty = true;
+		bool m_RowsDirty = true;
 	};
 }
@@ -2,6 +2,7 @@
 
 #include "ConsoleWindow.h"
 #include <spdlog/sinks/base_sink.h>
+#include <spdlog/details/os.h>
 
 namespace Lumos
 {
@@ -16,13 +17,16 @@ namespace Lumos
 		virtual ~ImGuiConsoleSink() = default;
 
 		// SPDLog sink interface
+		// Runs on the logging thread. Only the timestamp and message are copied into the console's queue, the
+		// source location is kept as pointers and formatted when the message is hovered
 		void sink_it_(const spdlog::details::log_msg& msg) override
 		{
-			spdlog::memory_buf_t formatted;
-			spdlog::sinks::base_sink<Mutex>::formatter_->format(msg, formatted);
-			std::string source = fmt::format("File : {0} | Function : {1} | Line : {2}", msg.source.filename, msg.source.funcname, msg.source.line);
-			auto message = CreateRef<ConsoleWindow::Message>(fmt::to_string(formatted), GetMessageLevel(msg.level), source, static_cast<int>(msg.thread_id));
-			ConsoleWindow::AddMessage(message);
+			char text[ConsoleWindow::Message::MaxLength];
+			const std::tm time = spdlog::details::os::localtime(spdlog::log_clock::to_time_t(msg.time));
+			int length = snprintf(text, sizeof(text), "[%02d:%02d:%02d] %.*s", time.tm_hour, time.tm_min, time.tm_sec, int(msg.payload.size()), msg.payload.data());
+			length = std::min(std::max(length, 0), int(sizeof(text)) - 1);
+
+			ConsoleWindow::AddMessage(ConsoleWindow::Message(text, size_t(length), GetMessageLevel(msg.level), msg.source.filename, msg.source.funcname, msg.source.line, static_cast<int>(msg.thread_id)));
 		}
 
 		static ConsoleWindow::Message::Level GetMessageLevel(const spdlog::level::level_enum level)
@@ -45,9 +49,9 @@ namespace Lumos
 			return ConsoleWindow::Message::Level::Trace;
 		}
 
+		// Nothing is buffered here, and the console history is only cleared by the user
 		void flush_() override
 		{
-			ConsoleWindow::Flush();
 		};
 	};
 }
@@ -9,6 +9,9 @@
 #include <Lumos/Graphics/Camera/Camera.h>
 #include <Lumos/Graphics/Sprite.h>
 #include <Lumos/Graphics/AnimatedSprite.h>
+#include <Lumos/Graphics/Animation/Animator.h>
+#include <Lumos/Graphics/Particles/ParticleEmitter.h>
+#include <Lumos/Graphics/Terrain/ChunkedTerrain.h>
 #include <Lumos/Graphics/Model.h>
 #include <Lumos/Graphics/Mesh.h>
 #include <Lumos/Graphics/MeshFactory.h>
@@ -807,6 +810,17 @@ end
         ImGui::PopItemWidth();
         ImGui::NextColumn();
         
+        ImGui::AlignTextToFramePadding();
+        ImGui::TextUnformatted("Static");
+        ImGui::NextColumn();
+        ImGui::PushItemWidth(-1);
+        bool isStatic = sprite.IsStatic();
+        if(ImGui::Checkbox("##Static", &isStatic))
+            sprite.SetStatic(isStatic);
+        
+        ImGui::PopItemWidth();
+        ImGui::NextColumn();
+        
         if (ImGui::TreeNode("Texture"))
         {
             ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(2, 2));
@@ -1887,6 +1901,410 @@ end
         if(controllerComp.GetController())
             controllerComp.GetController()->OnImGui();
 
+		ImGui::Columns(1);
+		ImGui::Separator();
+		ImGui::PopStyleVar();
+	}
+	template<>
+	void ComponentEditorWidget<Lumos::Graphics::ParticleEmitter>(entt::registry& reg, entt::registry::entity_type e)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		using namespace Lumos;
+		auto& emitter = reg.get<Lumos::Graphics::ParticleEmitter>(e);
+
+		ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(2, 2));
+		ImGui::Columns(2);
+		ImGui::Separator();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Emitting");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		bool emitting = emitter.GetEmitting();
+		if(ImGui::Checkbox("##Emitting", &emitting))
+			emitter.SetEmitting(emitting);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Render Mode");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		const char* renderModes[] = { "Billboard", "Sprite" };
+		int renderMode = int(emitter.GetRenderMode());
+		if(ImGui::Combo("##RenderMode", &renderMode, renderModes, IM_ARRAYSIZE(renderModes)))
+			emitter.SetRenderMode(Graphics::ParticleEmitter::RenderMode(renderMode));
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Max Particles");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		int maxParticles = int(emitter.GetMaxParticles());
+		if(ImGui::DragInt("##MaxParticles", &maxParticles, 10.0f, 0, 4000000))
+			emitter.SetMaxParticles(uint32_t(Maths::Max(maxParticles, 0)));
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Emission Rate");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		float rate = emitter.GetEmissionRate();
+		if(ImGui::DragFloat("##EmissionRate", &rate, 1.0f, 0.0f, 1000000.0f))
+			emitter.SetEmissionRate(rate);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Life Time");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		float lifeTime[2] = { emitter.GetMinLifeTime(), emitter.GetMaxLifeTime() };
+		if(ImGui::DragFloat2("##LifeTime", lifeTime, 0.01f, 0.01f, 100.0f))
+			emitter.SetLifeTime(lifeTime[0], lifeTime[1]);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Spawn Extent");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		auto extent = emitter.GetSpawnExtent();
+		if(ImGui::DragFloat3("##SpawnExtent", Maths::ValuePointer(extent), 0.1f, 0.0f, 1000.0f))
+			emitter.SetSpawnExtent(extent);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Velocity");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		auto velocity = emitter.GetVelocity();
+		if(ImGui::DragFloat3("##Velocity", Maths::ValuePointer(velocity), 0.1f))
+			emitter.SetVelocity(velocity);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Velocity Spread");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		auto spread = emitter.GetVelocitySpread();
+		if(ImGui::DragFloat3("##VelocitySpread", Maths::ValuePointer(spread), 0.1f, 0.0f, 1000.0f))
+			emitter.SetVelocitySpread(spread);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Gravity");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		auto gravity = emitter.GetGravity();
+		if(ImGui::DragFloat3("##Gravity", Maths::ValuePointer(gravity), 0.1f))
+			emitter.SetGravity(gravity);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Start Colour");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		auto startColour = emitter.GetStartColour();
+		if(ImGui::ColorEdit4("##StartColour", Maths::ValuePointer(startColour)))
+			emitter.SetStartColour(startColour);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("End Colour");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		auto endColour = emitter.GetEndColour();
+		if(ImGui::ColorEdit4("##EndColour", Maths::ValuePointer(endColour)))
+			emitter.SetEndColour(endColour);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Start Size");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		float startSize = emitter.GetStartSize();
+		if(ImGui::DragFloat("##StartSize", &startSize, 0.01f, 0.0f, 100.0f))
+			emitter.SetStartSize(startSize);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("End Size");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		float endSize = emitter.GetEndSize();
+		if(ImGui::DragFloat("##EndSize", &endSize, 0.01f, 0.0f, 100.0f))
+			emitter.SetEndSize(endSize);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Particles");
+		ImGui::NextColumn();
+		ImGui::Text("%u", emitter.GetParticleCount());
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Texture");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		bool flipImage = Graphics::GraphicsContext::GetContext()->FlipImGUITexture();
+		auto tex = emitter.GetTexture();
+		if(tex)
+		{
+			if(ImGui::ImageButton(tex->GetHandle(), ImVec2(64, 64), ImVec2(0.0f, flipImage ? 1.0f : 0.0f), ImVec2(1.0f, flipImage ? 0.0f : 1.0f)))
+			{
+				Lumos::Editor::GetEditor()->GetFileBrowserWindow().Open();
+				Lumos::Editor::GetEditor()->GetFileBrowserWindow().SetCallback(std::bind(&Lumos::Graphics::ParticleEmitter::SetTextureFromFile, &emitter, std::placeholders::_1));
+			}
+		}
+		else
+		{
+			if(ImGui::Button("Empty", ImVec2(64, 64)))
+			{
+				Lumos::Editor::GetEditor()->GetFileBrowserWindow().Open();
+				Lumos::Editor::GetEditor()->GetFileBrowserWindow().SetCallback(std::bind(&Lumos::Graphics::ParticleEmitter::SetTextureFromFile, &emitter, std::placeholders::_1));
+			}
+		}
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::Columns(1);
+		ImGui::Separator();
+
+		if(ImGui::Button("Burst"))
+			emitter.Burst(Maths::Max(emitter.GetMaxParticles() / 4, 1u));
+		ImGui::SameLine();
+		if(ImGui::Button("Clear"))
+			emitter.Clear();
+
+		ImGui::PopStyleVar();
+	}
+
+	template<>
+	void ComponentEditorWidget<Lumos::Graphics::ChunkedTerrain>(entt::registry& reg, entt::registry::entity_type e)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		using namespace Lumos;
+		auto& terrain = reg.get<Lumos::Graphics::ChunkedTerrain>(e);
+
+		ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(2, 2));
+		ImGui::Columns(2);
+		ImGui::Separator();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Chunk Size");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		float chunkSize = terrain.GetChunkSize();
+		if(ImGui::DragFloat("##ChunkSize", &chunkSize, 1.0f, 1.0f, 1024.0f))
+			terrain.SetChunkSize(chunkSize);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Chunk Resolution");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		int resolution = int(terrain.GetChunkResolution());
+		if(ImGui::DragInt("##ChunkResolution", &resolution, 1.0f, 2, 128))
+			terrain.SetChunkResolution(uint32_t(Maths::Max(resolution, 2)));
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("LOD Levels");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		int levels = int(terrain.GetLODLevels());
+		if(ImGui::DragInt("##LODLevels", &levels, 0.1f, 1, 12))
+			terrain.SetLODLevels(uint32_t(Maths::Max(levels, 1)));
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("LOD Distance");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		float lodDistance = terrain.GetLODDistance();
+		if(ImGui::DragFloat("##LODDistance", &lodDistance, 0.05f, 0.5f, 16.0f))
+			terrain.SetLODDistance(lodDistance);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("View Distance");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		float viewDistance = terrain.GetViewDistance();
+		if(ImGui::DragFloat("##ViewDistance", &viewDistance, 10.0f, 1.0f, 100000.0f))
+			terrain.SetViewDistance(viewDistance);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Height Scale");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		float heightScale = terrain.GetHeightScale();
+		if(ImGui::DragFloat("##HeightScale", &heightScale, 1.0f))
+			terrain.SetHeightScale(heightScale);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Texture Scale");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		float textureScale = terrain.GetTextureScale();
+		if(ImGui::DragFloat("##TextureScale", &textureScale, 0.001f, 0.0f, 10.0f))
+			terrain.SetTextureScale(textureScale);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Noise Offset");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		auto noiseOffset = terrain.GetNoiseOffset();
+		if(ImGui::InputFloat2("##NoiseOffset", Maths::ValuePointer(noiseOffset)))
+			terrain.SetNoiseOffset(noiseOffset);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Memory Budget (MB)");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		int budget = int(terrain.GetMemoryBudget());
+		if(ImGui::DragInt("##MemoryBudget", &budget, 1.0f, 1, 4096))
+			terrain.SetMemoryBudget(uint32_t(Maths::Max(budget, 1)));
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Chunks");
+		ImGui::NextColumn();
+		ImGui::Text("%u visible, %u cached", uint32_t(terrain.GetVisibleChunks().size()), terrain.GetCachedChunkCount());
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Memory");
+		ImGui::NextColumn();
+		ImGui::Text("%.1f MB", float(terrain.GetMemoryUsage()) / (1024.0f * 1024.0f));
+		ImGui::NextColumn();
+
+		ImGui::Columns(1);
+		ImGui::Separator();
+		ImGui::PopStyleVar();
+	}
+
+	template<>
+	void ComponentEditorWidget<Lumos::Graphics::Animator>(entt::registry& reg, entt::registry::entity_type e)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		auto& animator = reg.get<Lumos::Graphics::Animator>(e);
+		auto model = reg.try_get<Lumos::Graphics::Model>(e);
+
+		ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(2, 2));
+		ImGui::Columns(2);
+		ImGui::Separator();
+
+		if(!model || !model->GetSkeleton())
+		{
+			ImGui::TextUnformatted("No skinned model");
+			ImGui::Columns(1);
+			ImGui::Separator();
+			ImGui::PopStyleVar();
+			return;
+		}
+
+		auto& clips = model->GetAnimations();
+		static float blendDuration = 0.25f;
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Clip");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		int32_t currentClip = animator.GetClip();
+		const char* currentName = currentClip >= 0 && currentClip < int32_t(clips.size()) ? clips[currentClip]->GetName().c_str() : "None";
+		if(ImGui::BeginCombo("##Clip", currentName, 0))
+		{
+			for(int32_t n = 0; n < int32_t(clips.size()); n++)
+			{
+				bool is_selected = n == currentClip;
+				if(ImGui::Selectable(clips[n]->GetName().c_str(), is_selected))
+					animator.Play(n, blendDuration);
+				if(is_selected)
+					ImGui::SetItemDefaultFocus();
+			}
+			ImGui::EndCombo();
+		}
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Blend Duration");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::DragFloat("##BlendDuration", &blendDuration, 0.01f, 0.0f, 5.0f);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Speed");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		float speed = animator.GetSpeed();
+		if(ImGui::DragFloat("##Speed", &speed, 0.01f, -10.0f, 10.0f))
+			animator.SetSpeed(speed);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Loop");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		bool loop = animator.GetLoop();
+		if(ImGui::Checkbox("##Loop", &loop))
+			animator.SetLoop(loop);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		if(currentClip >= 0 && currentClip < int32_t(clips.size()))
+		{
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Time");
+			ImGui::NextColumn();
+			ImGui::PushItemWidth(-1);
+			float time = animator.GetTime();
+			if(ImGui::SliderFloat("##Time", &time, 0.0f, clips[currentClip]->GetDuration()))
+				animator.SetTime(time);
+			ImGui::PopItemWidth();
+			ImGui::NextColumn();
+
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Clip Memory");
+			ImGui::NextColumn();
+			ImGui::Text("%.1f KB", clips[currentClip]->GetMemorySize() / 1024.0f);
+			ImGui::NextColumn();
+		}
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Joints");
+		ImGui::NextColumn();
+		ImGui::Text("%u", model->GetSkeleton()->GetJointCount());
+		ImGui::NextColumn();
+
 		ImGui::Columns(1);
 		ImGui::Separator();
 		ImGui::PopStyleVar();
@@ -1926,12 +2344,15 @@ namespace Lumos
 	}
 		TRIVIAL_COMPONENT(Maths::Transform, "Transform");
 		TRIVIAL_COMPONENT(Graphics::Model, "Model");
+		TRIVIAL_COMPONENT(Graphics::Animator, "Animator");
 		TRIVIAL_COMPONENT(Camera, "Camera");
 		TRIVIAL_COMPONENT(Physics3DComponent, "Physics3D");
 		TRIVIAL_COMPONENT(Physics2DComponent, "Physics2D");
 		TRIVIAL_COMPONENT(SoundComponent, "Sound");
 		TRIVIAL_COMPONENT(Graphics::AnimatedSprite, "Animated Sprite");
 		TRIVIAL_COMPONENT(Graphics::Sprite, "Sprite");
+		TRIVIAL_COMPONENT(Graphics::ParticleEmitter, "Particle Emitter");
+		TRIVIAL_COMPONENT(Graphics::ChunkedTerrain, "Terrain");
 		TRIVIAL_COMPONENT(Graphics::Light, "Light");
 		TRIVIAL_COMPONENT(LuaScriptComponent, "LuaScript");
 		TRIVIAL_COMPONENT(Graphics::Environment, "Environment");
@@ -2008,7 +2429,7 @@ namespace Lumos
             
 			ImGui::PushItemWidth(-1);
 			if(ImGui::InputText("##Name", objName, IM_ARRAYSIZE(objName), 0))
-				registry.get_or_emplace<NameComponent>(selected).name = objName;
+				registry.emplace_or_replace<NameComponent>(selected, objName);
 
 			ImGui::Separator();
 
@@ -276,9 +276,9 @@ namespace Lumos
 				else
 					ImGui::TextUnformatted("Mouse Position: <invalid>");
 				
-				ImGui::Text("Num Rendered Objects %u", stats.NumRenderedObjects);
-				ImGui::Text("Num Shadow Objects %u", stats.NumShadowObjects);
-				ImGui::Text("Num Draw Calls  %u", stats.NumDrawCalls);
+				ImGui::Text("Num Rendered Objects %u", stats.NumRenderedObjects.load());
+				ImGui::Text("Num Shadow Objects %u", stats.NumShadowObjects.load());
+				ImGui::Text("Num Draw Calls  %u", stats.NumDrawCalls.load());
 				ImGui::Text("Used GPU Memory : %.1f mb | Total : %.1f mb", stats.UsedGPUMemory * 0.000001f, stats.TotalGPUMemory * 0.000001f);
 				
 				if(ImGui::BeginPopupContextWindow())
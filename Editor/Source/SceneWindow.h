@@ -28,6 +28,13 @@ namespace Lumos
 		void DrawGizmos(float width, float height, float xpos, float ypos, Scene* scene);
 
 		void Resize(uint32_t width, uint32_t height);
+
+		//Forces the next Resize to rebuild the view texture and retarget the renderers
+		void InvalidateRenderTargets()
+		{
+			m_Width = 0;
+			m_Height = 0;
+		}
 	private:
 
 		template<typename T>
@@ -0,0 +1,289 @@
+#include "Editor.h"
+#include "ThumbnailCache.h"
+#include <Lumos/Core/OS/FileSystem.h>
+#include <Lumos/Core/Profiler.h>
+#include <Lumos/Core/VFS.h>
+#include <Lumos/Utilities/AssetDatabase.h>
+#include <Lumos/Utilities/Timer.h>
+#include <Lumos/Graphics/Model.h>
+#include <Lumos/Graphics/Mesh.h>
+#include <Lumos/Graphics/API/Texture.h>
+#include <Lumos/Graphics/Renderers/ForwardRenderer.h>
+
+#include <stb_image.h>
+#include <stb_image_write.h>
+
+#include <filesystem>
+
+#define THUMBNAIL_SIZE 128
+
+//Thumbnails not drawn for this many frames can be freed, by then no frame in flight still samples them
+#define THUMBNAIL_EVICT_FRAMES 8
+#define THUMBNAIL_MAX_CACHED 512
+
+namespace Lumos
+{
+	ThumbnailCache::ThumbnailCache(const std::string& cachePath)
+		: m_CachePath(cachePath)
+	{
+		std::error_code error;
+		std::filesystem::create_directories(m_CachePath, error);
+
+		m_Thread = std::thread(&ThumbnailCache::Run, this);
+	}
+
+	ThumbnailCache::~ThumbnailCache()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Quit = true;
+		}
+		m_Condition.notify_one();
+
+		if(m_Thread.joinable())
+			m_Thread.join();
+	}
+
+	Graphics::Texture2D* ThumbnailCache::GetThumbnail(const AssetRecord& record)
+	{
+		if(record.Type != AssetType::Texture && record.Type != AssetType::Model)
+			return nullptr;
+
+		auto it = m_Thumbnails.find(record.Hash);
+		if(it != m_Thumbnails.end())
+		{
+			it->second.LastUsedFrame = m_Frame;
+			return it->second.Texture.get();
+		}
+
+		Thumbnail& thumbnail = m_Thumbnails[record.Hash];
+		thumbnail.LastUsedFrame = m_Frame;
+
+		if(record.Type == AssetType::Model)
+		{
+			m_ModelRequests.push_back({ record.Hash, record.Path });
+			return nullptr;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_ImageRequests.push_back({ record.Hash, record.Path });
+		}
+		m_Condition.notify_one();
+
+		return nullptr;
+	}
+
+	void ThumbnailCache::OnRender(float budgetMilliseconds)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_Frame++;
+		Timer timer;
+
+		while(timer.GetElapsedMS() < budgetMilliseconds)
+		{
+			Image image;
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if(m_Images.empty())
+					break;
+
+				image = std::move(m_Images.front());
+				m_Images.pop_front();
+			}
+
+			auto it = m_Thumbnails.find(image.Hash);
+			if(it == m_Thumbnails.end())
+				continue;
+
+			it->second.Pending = false;
+			if(!image.Pixels.empty())
+				it->second.Texture = Ref<Graphics::Texture2D>(Graphics::Texture2D::CreateFromSource(THUMBNAIL_SIZE, THUMBNAIL_SIZE, image.Pixels.data(), Graphics::TextureParameters(Graphics::TextureFilter::LINEAR, Graphics::TextureFilter::LINEAR)));
+		}
+
+		//Newest first, those are the cells on screen now
+		while(!m_ModelRequests.empty() && timer.GetElapsedMS() < budgetMilliseconds)
+		{
+			const Request request = m_ModelRequests.back();
+			m_ModelRequests.pop_back();
+
+			auto it = m_Thumbnails.find(request.Hash);
+			if(it == m_Thumbnails.end())
+				continue;
+
+			//Scrolled out of view before its turn, drop it so it is queued again when it comes back
+			if(it->second.LastUsedFrame + 1 < m_Frame)
+			{
+				m_Thumbnails.erase(it);
+				continue;
+			}
+
+			it->second.Pending = false;
+			it->second.Texture = RenderModel(request.Path);
+		}
+
+		Evict();
+	}
+
+	void ThumbnailCache::ResetRenderer()
+	{
+		m_Renderer.reset();
+	}
+
+	void ThumbnailCache::Run()
+	{
+		while(true)
+		{
+			Request request;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Condition.wait(lock, [this] { return m_Quit || !m_ImageRequests.empty(); });
+				if(m_Quit)
+					return;
+
+				//Newest first, those are the cells on screen now
+				request = std::move(m_ImageRequests.back());
+				m_ImageRequests.pop_back();
+			}
+
+			Image image;
+			image.Hash = request.Hash;
+			if(!LoadImage(request, image.Pixels))
+				image.Pixels.clear();
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Images.push_back(std::move(image));
+		}
+	}
+
+	bool ThumbnailCache::LoadImage(const Request& request, std::vector<uint8_t>& pixels)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		const std::string cacheFile = GetCacheFilePath(request.Hash);
+
+		int width = 0, height = 0, channels = 0;
+		if(FileSystem::FileExists(cacheFile))
+		{
+			stbi_uc* cached = stbi_load(cacheFile.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+			if(cached && width == THUMBNAIL_SIZE && height == THUMBNAIL_SIZE)
+			{
+				pixels.assign(cached, cached + THUMBNAIL_SIZE * THUMBNAIL_SIZE * 4);
+				stbi_image_free(cached);
+				return true;
+			}
+
+			stbi_image_free(cached);
+		}
+
+		if(stbi_is_hdr(request.Path.c_str()))
+			return false;
+
+		stbi_uc* source = stbi_load(request.Path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if(!source)
+			return false;
+
+		//Box filtered into a square, the longer side fills it and the rest stays transparent
+		const float scale = float(std::max(width, height)) / float(THUMBNAIL_SIZE);
+		const int scaledWidth = std::max(1, int(width / scale));
+		const int scaledHeight = std::max(1, int(height / scale));
+		const int offsetX = (THUMBNAIL_SIZE - scaledWidth) / 2;
+		const int offsetY = (THUMBNAIL_SIZE - scaledHeight) / 2;
+
+		pixels.assign(THUMBNAIL_SIZE * THUMBNAIL_SIZE * 4, 0);
+		for(int y = 0; y < scaledHeight; y++)
+		{
+			const int sourceY0 = int(y * scale);
+			const int sourceY1 = std::min(height, std::max(sourceY0 + 1, int((y + 1) * scale)));
+
+			for(int x = 0; x < scaledWidth; x++)
+			{
+				const int sourceX0 = int(x * scale);
+				const int sourceX1 = std::min(width, std::max(sourceX0 + 1, int((x + 1) * scale)));
+
+				uint32_t sum[4] = { 0, 0, 0, 0 };
+				for(int sy = sourceY0; sy < sourceY1; sy++)
+				{
+					const stbi_uc* row = source + (size_t(sy) * width + sourceX0) * 4;
+					for(int sx = sourceX0; sx < sourceX1; sx++, row += 4)
+					{
+						sum[0] += row[0];
+						sum[1] += row[1];
+						sum[2] += row[2];
+						sum[3] += row[3];
+					}
+				}
+
+				const uint32_t count = uint32_t((sourceY1 - sourceY0) * (sourceX1 - sourceX0));
+				uint8_t* pixel = &pixels[(size_t(y + offsetY) * THUMBNAIL_SIZE + x + offsetX) * 4];
+				for(int c = 0; c < 4; c++)
+					pixel[c] = uint8_t(sum[c] / count);
+			}
+		}
+
+		stbi_image_free(source);
+
+		stbi_write_png(cacheFile.c_str(), THUMBNAIL_SIZE, THUMBNAIL_SIZE, 4, pixels.data(), THUMBNAIL_SIZE * 4);
+		return true;
+	}
+
+	Ref<Graphics::Texture2D> ThumbnailCache::RenderModel(const std::string& path)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		Graphics::Model model(path);
+		if(model.GetMeshes().empty())
+			return nullptr;
+
+		Maths::BoundingBox bounds;
+		for(auto& mesh : model.GetMeshes())
+			bounds.Merge(*mesh->GetBoundingBox());
+
+		if(!m_Renderer)
+			m_Renderer = CreateRef<Graphics::ForwardRenderer>(THUMBNAIL_SIZE, THUMBNAIL_SIZE, false);
+
+		auto texture = Ref<Graphics::Texture2D>(Graphics::Texture2D::Create());
+		texture->BuildTexture(Graphics::TextureFormat::RGBA8, THUMBNAIL_SIZE, THUMBNAIL_SIZE, false, false, false);
+		m_Renderer->SetRenderTarget(texture.get(), true);
+
+		//Framed from above and to the side, far enough back for the bounding sphere to fit the view
+		const float fov = 45.0f;
+		const float radius = std::max(bounds.Size().Length() * 0.5f, 0.001f);
+		const float distance = radius / std::sin(Maths::ToRadians(fov * 0.5f));
+		const Maths::Quaternion orientation = Maths::Quaternion::EulerAnglesToQuaternion(-25.0f, 35.0f, 0.0f);
+		const Maths::Vector3 position = bounds.Center() + orientation * Maths::Vector3(0.0f, 0.0f, distance);
+
+		const Maths::Matrix4 proj = Maths::Matrix4::Perspective(distance - radius * 1.1f > 0.01f ? distance - radius * 1.1f : 0.01f, distance + radius * 1.1f, 1.0f, fov);
+		const Maths::Matrix4 view = Maths::Matrix3x4(position, orientation, Maths::Vector3(1.0f)).Inverse().ToMatrix4();
+
+		m_Renderer->Begin();
+		m_Renderer->BeginScene(proj, view);
+		const size_t meshCount = std::min(model.GetMeshes().size(), size_t(MAX_OBJECTS));
+		for(size_t i = 0; i < meshCount; i++)
+			m_Renderer->SubmitMesh(model.GetMeshes()[i].get(), nullptr, Maths::Matrix4(), Maths::Matrix4());
+		m_Renderer->SetSystemUniforms(m_Renderer->GetShader().get());
+		m_Renderer->Present();
+		m_Renderer->End();
+
+		return texture;
+	}
+
+	void ThumbnailCache::Evict()
+	{
+		if(m_Thumbnails.size() <= THUMBNAIL_MAX_CACHED)
+			return;
+
+		for(auto it = m_Thumbnails.begin(); it != m_Thumbnails.end();)
+		{
+			if(!it->second.Pending && it->second.LastUsedFrame + THUMBNAIL_EVICT_FRAMES < m_Frame)
+				it = m_Thumbnails.erase(it);
+			else
+				++it;
+		}
+	}
+
+	std::string ThumbnailCache::GetCacheFilePath(uint64_t hash) const
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.png", (unsigned long long)hash);
+		return m_CachePath + "/" + name;
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+
+namespace Lumos
+{
+	struct AssetRecord;
+
+	namespace Graphics
+	{
+		class Texture2D;
+		class ForwardRenderer;
+	}
+
+	//Previews for the asset window, keyed by content hash so edited files get new ones.
+	//Images are decoded, shrunk and written to the disk cache as png on a worker thread, models are rendered
+	//offscreen on the main thread. Both are only requested for visible cells and finished within a per frame budget
+	class ThumbnailCache
+	{
+	public:
+		ThumbnailCache(const std::string& cachePath);
+		~ThumbnailCache();
+
+		//Returns nullptr until the thumbnail is ready, or if the asset has none
+		Graphics::Texture2D* GetThumbnail(const AssetRecord& record);
+
+		//Uploads finished images and renders queued models until the budget is spent
+		void OnRender(float budgetMilliseconds);
+
+		//The offscreen renderer is rebuilt when shaders are reloaded
+		void ResetRenderer();
+
+	private:
+		struct Thumbnail
+		{
+			Ref<Graphics::Texture2D> Texture;
+			uint64_t LastUsedFrame = 0;
+			bool Pending = true;
+		};
+
+		struct Request
+		{
+			uint64_t Hash;
+			std::string Path;
+		};
+
+		struct Image
+		{
+			uint64_t Hash;
+			std::vector<uint8_t> Pixels;
+		};
+
+		void Run();
+		bool LoadImage(const Request& request, std::vector<uint8_t>& pixels);
+		Ref<Graphics::Texture2D> RenderModel(const std::string& path);
+		void Evict();
+
+		std::string GetCacheFilePath(uint64_t hash) const;
+
+		std::string m_CachePath;
+		std::unordered_map<uint64_t, Thumbnail> m_Thumbnails;
+		std::vector<Request> m_ModelRequests;
+		uint64_t m_Frame = 0;
+
+		Ref<Graphics::ForwardRenderer> m_Renderer;
+
+		//Shared with the worker thread
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		std::deque<Request> m_ImageRequests;
+		std::deque<Image> m_Images;
+		bool m_Quit = false;
+
+		std::thread m_Thread;
+	};
+}
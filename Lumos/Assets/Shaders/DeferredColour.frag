@@ -32,7 +32,7 @@ layout(set = 1,binding = 6) uniform UniformMaterialData
 } materialProperties;
 
 layout(location = 0) out vec4 outColor;
-layout(location = 1) out vec4 outPosition;
+layout(location = 1) out vec4 outEmissive;
 layout(location = 2) out vec4 outNormal;
 layout(location = 3) out vec4 outPBR;
 
@@ -80,6 +80,19 @@ vec3 GetEmissive()
 	return (1.0 - materialProperties.usingEmissiveMap) * materialProperties.emissiveColour.rgb + materialProperties.usingEmissiveMap * GammaCorrectTextureRGB(texture(u_EmissiveMap, fragTexCoord));
 }
 
+// Octahedral normal encoding, maps the unit sphere onto [-1, 1]^2
+vec2 OctWrap(vec2 v)
+{
+	return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 EncodeNormal(vec3 n)
+{
+	n /= (abs(n.x) + abs(n.y) + abs(n.z));
+	n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+	return n.xy;
+}
+
 vec3 GetNormalFromMap()
 {
 	if (materialProperties.usingNormalMap < 0.1)
@@ -131,11 +144,7 @@ void main()
 	float ao		= GetAO();
 
     outColor    = texColour;
-	outPosition = fragPosition;
-	outNormal   = vec4(GetNormalFromMap(),1.0);
-	outPBR      = vec4(metallic,roughness, ao, 1.0);
-
-	outPosition.w = emissive.x;
-	outNormal.w   = emissive.y;
-	outPBR.w      = emissive.z;
+	outEmissive = vec4(emissive, 1.0);
+	outNormal   = vec4(EncodeNormal(GetNormalFromMap()), 0.0, 0.0);
+	outPBR      = vec4(metallic, roughness, ao, 1.0);
 }
\ No newline at end of file
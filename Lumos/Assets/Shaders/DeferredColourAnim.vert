@@ -7,16 +7,16 @@ layout(set = 0,binding = 0) uniform UniformBufferObject
 	mat4 projView;
 } ubo;
 
-const int MAX_BONES = 100;
-
-layout(set = 0,binding = 1) uniform UniformBufferObjectAnim
+//Skinning matrices of every animated model, each model's joints start at boneOffset
+layout(set = 0,binding = 1) readonly buffer BoneTransforms
 {    
-	mat4 BoneTransforms[MAX_BONES];
-} boneUbo;
+	mat4 bones[];
+} boneBuffer;
 
 layout(push_constant) uniform PushConsts
 {
 	mat4 transform;
+	uint boneOffset;
 } pushConsts;
 
 layout(location = 0) in vec3 inPosition;
@@ -40,16 +40,17 @@ out gl_PerVertex
 
 void main() 
 {
-    mat4 boneTransform = boneUbo.BoneTransforms[int(inBoneIndices[0])] * inBoneWeights[0];
-    boneTransform += boneUbo.BoneTransforms[int(inBoneIndices[1])] * inBoneWeights[1];
-    boneTransform += boneUbo.BoneTransforms[int(inBoneIndices[2])] * inBoneWeights[2];
-    boneTransform += boneUbo.BoneTransforms[int(inBoneIndices[3])] * inBoneWeights[3];
+    uint offset = pushConsts.boneOffset;
+    mat4 boneTransform = boneBuffer.bones[offset + uint(inBoneIndices[0])] * inBoneWeights[0];
+    boneTransform += boneBuffer.bones[offset + uint(inBoneIndices[1])] * inBoneWeights[1];
+    boneTransform += boneBuffer.bones[offset + uint(inBoneIndices[2])] * inBoneWeights[2];
+    boneTransform += boneBuffer.bones[offset + uint(inBoneIndices[3])] * inBoneWeights[3];
 
-	fragPosition = vec4(inPosition * mat3(pushConsts.transform) * mat3(boneTransform), 1.0);
+	fragPosition = vec4(inPosition, 1.0) * boneTransform * pushConsts.transform;
     gl_Position = fragPosition * ubo.projView;
     
     fragColor = inColor;
 	fragTexCoord = inTexCoord;
-    fragNormal = normalize(inNormal) * transpose(inverse(mat3(pushConsts.transform) * mat3(boneTransform)));
+    fragNormal = normalize(inNormal) * transpose(inverse(mat3(boneTransform) * mat3(pushConsts.transform)));
     fragTangent = inTangent;
 }
\ No newline at end of file
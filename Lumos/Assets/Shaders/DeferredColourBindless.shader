@@ -0,0 +1,7 @@
+#shader vertex
+CompiledSPV/DeferredColourBindless.vert.spv
+#shader end
+
+#shader fragment
+CompiledSPV/DeferredColourBindless.frag.spv
+#shader end
@@ -0,0 +1,7 @@
+#shader vertex
+CompiledSPV/DeferredColourIndirect.vert.spv
+#shader end
+
+#shader fragment
+CompiledSPV/DeferredColour.frag.spv
+#shader end
\ No newline at end of file
@@ -0,0 +1,7 @@
+#shader vertex
+CompiledSPV/DeferredColourIndirectBindless.vert.spv
+#shader end
+
+#shader fragment
+CompiledSPV/DeferredColourBindless.frag.spv
+#shader end
\ No newline at end of file
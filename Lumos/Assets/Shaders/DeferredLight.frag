@@ -6,7 +6,7 @@ layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
 
 layout(set = 1, binding = 0) uniform sampler2D uColourSampler;
-layout(set = 1, binding = 1) uniform sampler2D uPositionSampler;
+layout(set = 1, binding = 1) uniform sampler2D uPositionSampler; // Emissive when using the thin layout
 layout(set = 1, binding = 2) uniform sampler2D uNormalSampler;
 layout(set = 1, binding = 3) uniform sampler2D uPBRSampler;
 layout(set = 1, binding = 4) uniform sampler2D uPreintegratedFG;
@@ -15,9 +15,11 @@ layout(set = 1, binding = 6) uniform samplerCube uIrradianceMap;
 layout(set = 1, binding = 7) uniform sampler2DArray uShadowMap;
 layout(set = 1, binding = 8) uniform sampler2D uDepthSampler;
 
-#define MAX_LIGHTS 32
 #define MAX_SHADOWMAPS 4
 
+#define GBUFFER_LAYOUT_THIN 0
+#define GBUFFER_LAYOUT_LEGACY 1
+
 struct Light
 {
 	vec4 colour;
@@ -31,12 +33,14 @@ struct Light
 
 layout(std140, binding = 0) uniform UniformBufferLight
 {
-	Light lights[MAX_LIGHTS]; //64 bytes * 32
+	ivec4 clusterSize; // x, y, z = cluster counts, w = directional light count
+	vec4 clusterDepthParams; // x = slice scale, y = slice bias, z = near, w = far
 	mat4 uShadowTransform[MAX_SHADOWMAPS]; //64 * 4 = 256
 
 	mat4 viewMatrix; //64
 	mat4 lightView; //64
 	mat4 biasMat; //64
+	mat4 invViewProj; //64
 	vec4 cameraPosition; //16
 	vec4 uSplitDepths[MAX_SHADOWMAPS]; //4 * 16 = 64
 	float lightSize;
@@ -48,8 +52,25 @@ layout(std140, binding = 0) uniform UniformBufferLight
 	int mode; // 4
 	int cubemapMipLevels; // 4
 	float initialBias;
+	int gbufferLayout; // 4
 } ubo;
 
+// Directional lights first, then point and spot lights referenced by the clusters
+layout(std430, set = 0, binding = 1) readonly buffer LightBuffer
+{
+	Light lights[];
+} lightBuffer;
+
+layout(std430, set = 0, binding = 2) readonly buffer LightClusterBuffer
+{
+	uvec2 clusters[]; // x = offset into lightIndices, y = count
+} clusterBuffer;
+
+layout(std430, set = 0, binding = 3) readonly buffer LightIndexBuffer
+{
+	uint lightIndices[];
+} lightIndexBuffer;
+
 #define PI 3.1415926535897932384626433832795
 #define GAMMA 2.2
 
@@ -409,80 +430,103 @@ float CalculateShadow(vec3 wsPos, int cascadeIndex, float bias, vec3 lightDirect
 	}
 }
 
-vec3 Lighting(vec3 F0, vec3 wsPos, Material material)
+float WindowFalloff(float dist, float radius)
 {
-	vec3 result = vec3(0.0);
+	// Smoothly reaches zero at the light radius so cluster bounds don't show
+	float ratio = dist / max(radius, 0.0001);
+	float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+	return window * window;
+}
 
-	for(int i = 0; i < ubo.lightCount; i++)
+vec3 EvaluateLight(Light light, vec3 F0, vec3 wsPos, Material material)
+{
+	float value = 0.0;
+
+	if(light.type == 2.0)
 	{
-		Light light = ubo.lights[i];
+	    // Vector to light
+		vec3 L = light.position.xyz - wsPos;
+		// Distance from light to fragment position
+		float dist = length(L);
 
-		float value = 0.0;
+		// Light to fragment
+		L = normalize(L);
 
-		if(light.type == 2.0)
-		{
-		    // Vector to light
-			vec3 L = light.position.xyz - wsPos;
-			// Distance from light to fragment position
-			float dist = length(L);
+		// Attenuation
+		float atten = light.radius / (pow(dist, 2.0) + 1.0) * WindowFalloff(dist, light.radius);
 
-			// Light to fragment
-			L = normalize(L);
+		value = atten;
 
-			// Attenuation
-			float atten = light.radius / (pow(dist, 2.0) + 1.0);
+		light.direction = vec4(L,1.0);
+	}
+	else if (light.type == 1.0)
+	{
+		vec3 L = light.position.xyz - wsPos;
+		float cutoffAngle   = 1.0f - light.angle;      
+		float dist          = length(L);
+		L = normalize(L);
+		float theta         = dot(L.xyz, light.direction.xyz);
+		float epsilon       = cutoffAngle - cutoffAngle * 0.9f;
+		float attenuation 	= ((theta - cutoffAngle) / epsilon); // atteunate when approaching the outer cone
+		attenuation         *= light.radius / (pow(dist, 2.0) + 1.0) * WindowFalloff(dist, light.radius);
+		//float intensity 	= attenuation * attenuation;
+		
+		
+		// Erase light if there is no need to compute it
+		//intensity *= step(theta, cutoffAngle);
 
-			value = atten;
+		value = clamp(attenuation, 0.0, 1.0);
+	}
+	else
+	{
+		float bias = ubo.initialBias;
+		bias = bias + (bias * tan(acos(clamp(dot(material.Normal, light.direction.xyz), 0.0, 1.0))) * 0.5);
+		
+		int cascadeIndex = CalculateCascadeIndex(wsPos);
+		value = CalculateShadow(wsPos,cascadeIndex, bias, light.direction.xyz, material.Normal);
+	}
 
-			light.direction = vec4(L,1.0);
-		}
-		else if (light.type == 1.0)
-		{
-			vec3 L = light.position.xyz - wsPos;
-			float cutoffAngle   = 1.0f - light.angle;      
-			float dist          = length(L);
-			L = normalize(L);
-			float theta         = dot(L.xyz, light.direction.xyz);
-			float epsilon       = cutoffAngle - cutoffAngle * 0.9f;
-			float attenuation 	= ((theta - cutoffAngle) / epsilon); // atteunate when approaching the outer cone
-			attenuation         *= light.radius / (pow(dist, 2.0) + 1.0);//saturate(1.0f - dist / light.range);
-			//float intensity 	= attenuation * attenuation;
-			
-			
-			// Erase light if there is no need to compute it
-			//intensity *= step(theta, cutoffAngle);
-
-			value = clamp(attenuation, 0.0, 1.0);
-		}
-		else
-		{
-			float bias = ubo.initialBias;
-			bias = bias + (bias * tan(acos(clamp(dot(material.Normal, light.direction.xyz), 0.0, 1.0))) * 0.5);
-			
-			int cascadeIndex = CalculateCascadeIndex(wsPos);
-			value = CalculateShadow(wsPos,cascadeIndex, bias, light.direction.xyz, material.Normal);
-		}
+	vec3 Li = light.direction.xyz;
+	vec3 Lradiance = light.colour.xyz * light.intensity;
+	vec3 Lh = normalize(Li + material.View);
 
-		vec3 Li = light.direction.xyz;
-		vec3 Lradiance = light.colour.xyz * light.intensity;
-		vec3 Lh = normalize(Li + material.View);
+	// Calculate angles between surface normal and various light vectors.
+	float cosLi = max(0.0, dot(material.Normal, Li));
+	float cosLh = max(0.0, dot(material.Normal, Lh));
 
-		// Calculate angles between surface normal and various light vectors.
-		float cosLi = max(0.0, dot(material.Normal, Li));
-		float cosLh = max(0.0, dot(material.Normal, Lh));
+	vec3 F = fresnelSchlick(F0, max(0.0, dot(Lh, material.View)));
+	float D = ndfGGX(cosLh, material.Roughness);
+	float G = gaSchlickGGX(cosLi, material.NDotV, material.Roughness);
 
-		vec3 F = fresnelSchlick(F0, max(0.0, dot(Lh, material.View)));
-		float D = ndfGGX(cosLh, material.Roughness);
-		float G = gaSchlickGGX(cosLi, material.NDotV, material.Roughness);
+	vec3 kd = (1.0 - F) * (1.0 - material.Metallic.x);
+	vec3 diffuseBRDF = kd * material.Albedo.xyz;
 
-		vec3 kd = (1.0 - F) * (1.0 - material.Metallic.x);
-		vec3 diffuseBRDF = kd * material.Albedo.xyz;
+	// Cook-Torrance
+	vec3 specularBRDF = (F * D * G) / max(Epsilon, 4.0 * cosLi * material.NDotV);
 
-		// Cook-Torrance
-		vec3 specularBRDF = (F * D * G) / max(Epsilon, 4.0 * cosLi * material.NDotV);
+	return (diffuseBRDF + specularBRDF) * Lradiance * cosLi * value * material.AO;
+}
+
+int GetClusterIndex(vec2 uv, vec3 wsPos)
+{
+	float viewDepth = -(vec4(wsPos, 1.0) * ubo.viewMatrix).z;
+	int slice = int(log(max(viewDepth, 0.0001)) * ubo.clusterDepthParams.x + ubo.clusterDepthParams.y);
+	ivec3 cluster = clamp(ivec3(ivec2(uv * vec2(ubo.clusterSize.xy)), slice), ivec3(0), ubo.clusterSize.xyz - 1);
+	return cluster.x + cluster.y * ubo.clusterSize.x + cluster.z * ubo.clusterSize.x * ubo.clusterSize.y;
+}
+
+vec3 Lighting(vec3 F0, vec3 wsPos, Material material)
+{
+	vec3 result = vec3(0.0);
+
+	for(int i = 0; i < ubo.clusterSize.w; i++)
+		result += EvaluateLight(lightBuffer.lights[i], F0, wsPos, material);
+
+	uvec2 cluster = clusterBuffer.clusters[GetClusterIndex(fragTexCoord, wsPos)];
+
+	for(uint i = 0; i < cluster.y; i++)
+		result += EvaluateLight(lightBuffer.lights[lightIndexBuffer.lightIndices[cluster.x + i]], F0, wsPos, material);
 
-		result += (diffuseBRDF + specularBRDF) * Lradiance * cosLi * value * material.AO;
-	}
 	return result;
 }
 
@@ -525,6 +569,22 @@ float Attentuate( vec3 lightData, float dist )
 	return max(att * damping, 0.0);
 }
 
+vec3 DecodeNormal(vec2 f)
+{
+	vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+	float t = clamp(-n.z, 0.0, 1.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
+// invViewProj also remaps the sampled depth into the api's clip space depth range
+vec3 ReconstructWorldPosition(vec2 uv, float depth)
+{
+	vec4 wsPos = vec4(uv * 2.0 - 1.0, depth, 1.0) * ubo.invViewProj;
+	return wsPos.xyz / wsPos.w;
+}
+
 layout(location = 0) out vec4 outColor;
 
 void main()
@@ -541,9 +601,22 @@ void main()
     vec3  spec      = vec3(pbrTex.x);
 
 	float roughness = pbrTex.y;
-	vec3 emissive	= vec3(positionTex.w, normalTex.w, pbrTex.w);
-    vec3 wsPos      = positionTex.xyz;
-	vec3 normal		= normalize(normalTex.xyz);
+	vec3 emissive;
+	vec3 wsPos;
+	vec3 normal;
+
+	if(ubo.gbufferLayout == GBUFFER_LAYOUT_THIN)
+	{
+		emissive = positionTex.xyz;
+		wsPos    = ReconstructWorldPosition(fragTexCoord, texture(uDepthSampler, fragTexCoord).r);
+		normal   = DecodeNormal(normalTex.xy);
+	}
+	else
+	{
+		emissive = vec3(positionTex.w, normalTex.w, pbrTex.w);
+		wsPos    = positionTex.xyz;
+		normal   = normalize(normalTex.xyz);
+	}
 
 	Material material;
     material.Albedo    = colourTex;
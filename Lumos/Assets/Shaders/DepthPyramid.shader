@@ -0,0 +1,3 @@
+#shader compute
+CompiledSPV/DepthPyramid.comp.spv
+#shader end
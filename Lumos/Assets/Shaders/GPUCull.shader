@@ -0,0 +1,3 @@
+#shader compute
+CompiledSPV/GPUCull.comp.spv
+#shader end
@@ -0,0 +1,19 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(set = 1, binding = 0) uniform sampler2D u_Texture;
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) in vec4 fragColour;
+
+layout(location = 0) out vec4 outColour;
+
+void main()
+{
+	vec4 colour = fragColour * texture(u_Texture, fragTexCoord);
+	if(colour.a < 0.01)
+		discard;
+
+	outColour = colour;
+}
@@ -0,0 +1,7 @@
+#shader vertex
+CompiledSPV/Particle.vert.spv
+#shader end
+
+#shader fragment
+CompiledSPV/Particle.frag.spv
+#shader end
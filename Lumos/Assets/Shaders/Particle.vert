@@ -0,0 +1,47 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(set = 0,binding = 0) uniform UniformBufferObject
+{
+	mat4 projView;
+	vec4 cameraRight;
+	vec4 cameraUp;
+} ubo;
+
+//xyz position, w normalised age. Every visible emitter's particles back to back
+layout(set = 0,binding = 1) readonly buffer ParticleInstances
+{
+	vec4 particles[];
+} particleBuffer;
+
+layout(push_constant) uniform PushConsts
+{
+	vec4 startColour;
+	vec4 endColour;
+	vec2 size;
+	uint instanceOffset;
+} pushConsts;
+
+layout(location = 0) in vec2 inCorner;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) out vec4 fragColour;
+
+out gl_PerVertex
+{
+	vec4 gl_Position;
+};
+
+void main()
+{
+	vec4 particle = particleBuffer.particles[pushConsts.instanceOffset + gl_InstanceIndex];
+	float age = clamp(particle.w, 0.0, 1.0);
+	float size = mix(pushConsts.size.x, pushConsts.size.y, age);
+
+	vec3 position = particle.xyz + (ubo.cameraRight.xyz * inCorner.x + ubo.cameraUp.xyz * inCorner.y) * size;
+	gl_Position = vec4(position, 1.0) * ubo.projView;
+
+	fragTexCoord = vec2(inCorner.x + 0.5, 0.5 - inCorner.y);
+	fragColour = mix(pushConsts.startColour, pushConsts.endColour, age);
+}
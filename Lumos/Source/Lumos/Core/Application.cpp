@@ -7,6 +7,7 @@
 
 #include "Graphics/API/Renderer.h"
 #include "Graphics/API/GraphicsContext.h"
+#include "Graphics/API/Pipeline.h"
 #include "Graphics/Renderers/RenderGraph.h"
 #include "Graphics/Camera/Camera.h"
 #include "Graphics/Material.h"
@@ -17,6 +18,7 @@
 #include "Graphics/Renderers/ShadowRenderer.h"
 #include "Graphics/Renderers/GridRenderer.h"
 #include "Graphics/Renderers/SkyboxRenderer.h"
+#include "Graphics/Renderers/ParticleRenderer.h"
 
 #include "Maths/Transform.h"
 
@@ -36,6 +38,8 @@
 #include "Audio/Sound.h"
 #include "Physics/B2PhysicsEngine/B2PhysicsEngine.h"
 #include "Physics/LumosPhysicsEngine/LumosPhysicsEngine.h"
+#include "Graphics/Animation/AnimationSystem.h"
+#include "Graphics/Particles/ParticleSystem.h"
 
 #include <cereal/archives/json.hpp>
 #include <imgui/imgui.h>
@@ -156,6 +160,8 @@ namespace Lumos
 
 		m_SystemManager->RegisterSystem<LumosPhysicsEngine>();
 		m_SystemManager->RegisterSystem<B2PhysicsEngine>();
+		m_SystemManager->RegisterSystem<AnimationSystem>();
+		m_SystemManager->RegisterSystem<ParticleSystem>();
 		
 		Application::Get().GetSystem<LumosPhysicsEngine>()->SetPaused(false);
 		Application::Get().GetSystem<B2PhysicsEngine>()->SetPaused(false);
@@ -165,7 +171,16 @@ namespace Lumos
         m_SceneManager->LoadCurrentList();
 
 		m_CurrentState = AppState::Running;
-            
+
+		CreateRenderers();
+	}
+
+	void Application::CreateRenderers()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		uint32_t screenWidth = m_Window->GetWidth();
+		uint32_t screenHeight = m_Window->GetHeight();
+
 //#ifndef LUMOS_PLATFORM_IOS //Need to disable for A12 and earlier
         auto shadowRenderer = new Graphics::ShadowRenderer();
         Application::Get().GetRenderGraph()->SetShadowRenderer(shadowRenderer);
@@ -174,11 +189,23 @@ namespace Lumos
         
         m_RenderGraph->AddRenderer(new Graphics::DeferredRenderer(screenWidth, screenHeight));
         m_RenderGraph->AddRenderer(new Graphics::SkyboxRenderer(screenWidth, screenHeight));
+        m_RenderGraph->AddRenderer(new Graphics::ParticleRenderer(screenWidth, screenHeight));
         m_RenderGraph->AddRenderer(new Graphics::Renderer2D(screenWidth, screenHeight, false, false, true));
         
         m_RenderGraph->EnableDebugRenderer(true);
 	}
 
+	void Application::ReloadRenderers()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		Graphics::GraphicsContext::GetContext()->WaitIdle();
+
+		//Renderers fetch their shaders and build their pipelines in Init, cached pipelines still reference the old shaders
+		m_RenderGraph->ClearRenderers();
+		Graphics::Pipeline::ClearCache();
+		CreateRenderers();
+	}
+
 	void Application::Quit()
 	{
 		LUMOS_PROFILE_FUNCTION();
@@ -187,6 +214,10 @@ namespace Lumos
 		Engine::Release();
 		Input::Release();
 
+		//Physics may still be stepping the last frame's scene
+		GetSystem<LumosPhysicsEngine>()->SetPaused(true);
+		GetSystem<B2PhysicsEngine>()->SetPaused(true);
+
 		m_ShaderLibrary.reset();
 		m_SceneManager.reset();
 		m_RenderGraph.reset();
@@ -244,6 +275,12 @@ namespace Lumos
 				m_Updates++;
 			}
 
+			if(GetEditorState() != EditorState::Paused && GetEditorState() != EditorState::Preview)
+			{
+				LUMOS_PROFILE_SCOPE("Application::LateUpdate");
+				m_SystemManager->OnLateUpdate(ts, m_SceneManager->GetCurrentScene());
+			}
+
 			if(!m_Minimized)
 			{
 				LUMOS_PROFILE_SCOPE("Application::Render");
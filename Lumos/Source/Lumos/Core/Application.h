@@ -130,6 +130,9 @@ namespace Lumos
         
         Ref<ShaderLibrary>& GetShaderLibrary();
 
+		//Recreates the render graph's renderers so they pick up shaders reloaded in the shader library
+		void ReloadRenderers();
+
 		static Application& Get()
 		{
 			return *s_Instance;
@@ -258,6 +261,7 @@ namespace Lumos
 
 	private:
 		bool OnWindowClose(WindowCloseEvent& e);
+		void CreateRenderers();
 		
 		//Start proj saving
 		uint32_t Width, Height;
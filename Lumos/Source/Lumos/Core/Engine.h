@@ -4,6 +4,8 @@
 #include "Utilities/TimeStep.h"
 #include "Utilities/TSingleton.h"
 
+#include <atomic>
+
 namespace Lumos
 {
     class LUMOS_EXPORT Engine : public ThreadSafeSingleton<Engine>
@@ -23,13 +25,30 @@ namespace Lumos
 		{
 			uint32_t UpdatesPerSecond;
 			uint32_t FramesPerSecond;
-			uint32_t NumRenderedObjects = 0;
-			uint32_t NumShadowObjects = 0;
-			uint32_t NumDrawCalls = 0;
+			//Counted from render workers while they record command buffers
+			std::atomic<uint32_t> NumRenderedObjects = { 0 };
+			std::atomic<uint32_t> NumShadowObjects = { 0 };
+			std::atomic<uint32_t> NumDrawCalls = { 0 };
 			float FrameTime = 0.0f;
 			float UsedGPUMemory = 0.0f;
 			float UsedRam = 0.0f;
 			float TotalGPUMemory = 0.0f;
+
+			Stats() = default;
+			Stats(const Stats& other) { *this = other; }
+			Stats& operator=(const Stats& other)
+			{
+				UpdatesPerSecond = other.UpdatesPerSecond;
+				FramesPerSecond = other.FramesPerSecond;
+				NumRenderedObjects = other.NumRenderedObjects.load();
+				NumShadowObjects = other.NumShadowObjects.load();
+				NumDrawCalls = other.NumDrawCalls.load();
+				FrameTime = other.FrameTime;
+				UsedGPUMemory = other.UsedGPUMemory;
+				UsedRam = other.UsedRam;
+				TotalGPUMemory = other.TotalGPUMemory;
+				return *this;
+			}
 		};
 		
 		void ResetStats() 
@@ -1,42 +1,66 @@
 #include "Precompiled.h"
 #include "LMLog.h"
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+//Messages queued for the logging thread, the oldest are dropped when it falls behind so callers never block
+#define LOG_QUEUE_SIZE 8192
+
 namespace Lumos::Debug
 {
     std::shared_ptr<spdlog::logger> Log::s_CoreLogger;
+    std::shared_ptr<spdlog::sinks::dist_sink_mt> Log::s_Sinks;
     std::vector<spdlog::sink_ptr> sinks;
     
     void Log::OnInit()
     {
         sinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>()); // debug
 		//sinks.emplace_back(std::make_shared<ImGuiConsoleSink_mt>()); // ImGuiConsole
-        
-#ifndef LUMOS_PLATFORM_IOS
-        //auto logFileSink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>("LumosLog.txt", 1048576 * 5, 3);
-        //sinks.emplace_back(logFileSink); // Log file
-#endif
+
+		// Sinks added later go through here, it locks so they can be added and removed while the logging thread runs
+		s_Sinks = std::make_shared<spdlog::sinks::dist_sink_mt>();
+		sinks.emplace_back(s_Sinks);
         
 		// create the loggers
-        s_CoreLogger = std::make_shared<spdlog::logger>("Lumos", begin(sinks), end(sinks));
+		// Sinks run on a single background thread, logging only formats the message and queues it
+		spdlog::init_thread_pool(LOG_QUEUE_SIZE, 1);
+        s_CoreLogger = std::make_shared<spdlog::async_logger>("Lumos", begin(sinks), end(sinks), spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
 		spdlog::register_logger(s_CoreLogger);
         
 		// configure the loggers
 		spdlog::set_pattern("%^[%T] %v%$");
 		s_CoreLogger->set_level(spdlog::level::trace);
+		s_CoreLogger->flush_on(spdlog::level::err);
     }
 
     void Log::AddSink(spdlog::sink_ptr& sink)
     {
-        s_CoreLogger->sinks().push_back(sink);
-        s_CoreLogger->set_pattern("%^[%T] %v%$");
+        sink->set_pattern("%^[%T] %v%$");
+        s_Sinks->add_sink(sink);
+    }
+
+    void Log::RemoveSink(spdlog::sink_ptr& sink)
+    {
+        s_Sinks->remove_sink(sink);
     }
     
+    spdlog::sink_ptr Log::AddFileSink(const std::string& filePath, size_t maxFileSize, size_t maxFiles)
+    {
+#ifndef LUMOS_PLATFORM_IOS
+        spdlog::sink_ptr sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(filePath, maxFileSize, maxFiles);
+        AddSink(sink);
+        return sink;
+#else
+        return nullptr;
+#endif
+    }
+
 	void Log::OnRelease()
 	{
 		s_CoreLogger.reset();
+		s_Sinks.reset();
 		spdlog::shutdown();
 	}
 }
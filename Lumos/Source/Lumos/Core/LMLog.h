@@ -10,6 +10,7 @@
 #pragma warning(push, 0)
 #include <spdlog/spdlog.h>
 #include <spdlog/fmt/ostr.h>
+#include <spdlog/sinks/dist_sink.h>
 #pragma warning(pop)
 
 // Core log macros
@@ -32,8 +33,13 @@ namespace Lumos
 			inline static std::shared_ptr<spdlog::logger>& GetCoreLogger() { return s_CoreLogger; }
             
             static void AddSink(spdlog::sink_ptr& sink);
+			static void RemoveSink(spdlog::sink_ptr& sink);
+
+			//Rotating log files, written on the logging thread like every other sink
+			static spdlog::sink_ptr AddFileSink(const std::string& filePath, size_t maxFileSize = 1048576 * 5, size_t maxFiles = 3);
 		private:
 			static std::shared_ptr<spdlog::logger> s_CoreLogger;
+			static std::shared_ptr<spdlog::sinks::dist_sink_mt> s_Sinks;
 		};
 	}
 }
@@ -250,6 +250,13 @@ namespace Lumos
 
 		return string;
 	}
+
+	std::string ToLower(const std::string& string)
+	{
+		std::string lower = string;
+		std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+		return lower;
+	}
 	
 	std::string Demangle(const std::string& string)
 	{
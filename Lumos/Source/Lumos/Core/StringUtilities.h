@@ -57,6 +57,7 @@ namespace Lumos
         std::string& BackSlashesToSlashes(std::string& string);
         std::string& SlashesToBackSlashes(std::string& string);
 		std::string& RemoveSpaces(std::string& string);
+		std::string ToLower(const std::string& string);
 		std::string Demangle(const std::string& string);
 	}
 }
@@ -27,6 +27,8 @@ namespace Lumos
 			static CommandBuffer* Create();
 
 			virtual bool Init(bool primary) = 0;
+			//Secondary buffer allocated from the command pool of a worker slot. Buffers from one slot must not be recorded on two threads at once
+			virtual bool InitSecondary(uint32_t workerIndex) = 0;
 			virtual void Unload() = 0;
 			virtual void BeginRecording() = 0;
 			virtual void BeginRecordingSecondary(RenderPass* renderPass, Framebuffer* framebuffer) = 0;
@@ -15,7 +15,8 @@ namespace Lumos
 		{
 			UNIFORM_BUFFER,
 			UNIFORM_BUFFER_DYNAMIC,
-			IMAGE_SAMPLER
+			IMAGE_SAMPLER,
+			STORAGE_BUFFER
 		};
 
 		enum class Format
@@ -70,6 +71,8 @@ namespace Lumos
 			uint32_t layoutIndex;
 			Shader* shader;
 			uint32_t count = 1;
+			//Only valid for the frame it was created in, for sets rebuilt every frame
+			bool transient = false;
 		};
 
 		struct BufferInfo
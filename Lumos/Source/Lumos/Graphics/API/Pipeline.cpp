@@ -20,7 +20,7 @@ namespace Lumos
         Ref<Pipeline> Pipeline::Get(const PipelineInfo& pipelineInfo)
         {
             size_t hash = 0;
-            HashCombine(hash, pipelineInfo.shader.get(), pipelineInfo.cullMode, pipelineInfo.depthBiasEnabled, pipelineInfo.drawType, pipelineInfo.polygonMode,  pipelineInfo.transparencyEnabled, pipelineInfo.renderpass.get());
+            HashCombine(hash, pipelineInfo.shader.get(), pipelineInfo.cullMode, pipelineInfo.depthBiasEnabled, pipelineInfo.drawType, pipelineInfo.polygonMode,  pipelineInfo.transparencyEnabled, pipelineInfo.depthWriteEnabled, pipelineInfo.renderpass.get());
             
             const auto& vertexLayout = pipelineInfo.vertexBufferLayout.GetLayout();
             HashCombine(hash, pipelineInfo.vertexBufferLayout.GetStride(), vertexLayout.size() );
@@ -46,6 +46,15 @@ namespace Lumos
             m_PipelineCache.clear();
         }
     
+        void Pipeline::ShaderReloaded(Shader* shader)
+        {
+            for(auto& [ key, value ] : m_PipelineCache)
+            {
+                if(value && value->GetShader() == shader)
+                    value->OnShaderReloaded();
+            }
+        }
+    
         void Pipeline::DeleteUnusedCache()
         {
             for (const auto & [ key, value ] : m_PipelineCache)
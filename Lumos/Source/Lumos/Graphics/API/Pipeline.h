@@ -29,6 +29,7 @@ namespace Lumos
 			POINT
 		};
 
+		//Only the shader is used for compute pipelines
 		struct PipelineInfo
 		{
             Ref<RenderPass> renderpass;
@@ -41,6 +42,7 @@ namespace Lumos
 
 			bool transparencyEnabled;
 			bool depthBiasEnabled;
+			bool depthWriteEnabled = true;
 		};
     
 		class LUMOS_EXPORT Pipeline
@@ -51,6 +53,9 @@ namespace Lumos
             static void ClearCache();
             static void DeleteUnusedCache();
 
+			//Rebuilds the cached pipelines that use a shader after it was reloaded in place
+			static void ShaderReloaded(Shader* shader);
+
 			virtual ~Pipeline() = default;
 
             virtual void Bind(CommandBuffer* cmdBuffer) = 0;
@@ -58,6 +63,9 @@ namespace Lumos
 			virtual DescriptorSet* GetDescriptorSet() const = 0;
 			virtual Shader* GetShader() const = 0;
 
+			//Pipelines that bake the shader stages in recreate themselves here, the rest bind the shader when drawing
+			virtual void OnShaderReloaded() {}
+
 		protected:
 			static Pipeline* (*CreateFunc)(const PipelineInfo&);
         };
@@ -9,7 +9,9 @@ namespace Lumos
 		class DescriptorSet;
 		class Swapchain;
 		class IndexBuffer;
+		class UniformBuffer;
 		class Mesh;
+		struct PushConstant;
 
 		enum RendererBufferType
 		{
@@ -82,6 +84,9 @@ namespace Lumos
 			float MaxAnisotropy = 0.0f;
 			int MaxTextureUnits = 0;
 			int UniformBufferOffsetAlignment = 0;
+			bool SupportsIndirectDraw = false; //Compute shaders and indirect draws with a first instance
+			bool SupportsBindless = false; //Partially bound texture arrays indexed per draw, MAX_BINDLESS_TEXTURES per stage
+			bool SupportsParallelRecording = false; //Secondary command buffers can be recorded on worker threads
 		};
 
 		class LUMOS_EXPORT Renderer
@@ -103,10 +108,14 @@ namespace Lumos
 			virtual void PresentInternal() = 0;
 			virtual void PresentInternal(Graphics::CommandBuffer* cmdBuffer) = 0;
 			virtual void BindDescriptorSetsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, uint32_t dynamicOffset, std::vector<Graphics::DescriptorSet*>& descriptorSets) = 0;
+			virtual void PushConstantsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, std::vector<Graphics::PushConstant>& pushConstants) = 0;
 
 			virtual const std::string& GetTitleInternal() const = 0;
 			virtual void DrawIndexedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start) const = 0;
+			virtual void DrawIndexedInstancedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount) const = 0;
 			virtual void DrawInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, DataType datayType, void* indices) const = 0;
+			virtual void DrawIndexedIndirectInternal(CommandBuffer* commandBuffer, DrawType type, UniformBuffer* argumentBuffer, uint32_t offset, uint32_t drawCount, uint32_t stride) const = 0;
+			virtual void DispatchInternal(CommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const = 0;
 			virtual Graphics::Swapchain* GetSwapchainInternal() const = 0;
 
 			inline static void Present()
@@ -121,6 +130,11 @@ namespace Lumos
 			{
 				s_Instance->BindDescriptorSetsInternal(pipeline, cmdBuffer, dynamicOffset, descriptorSets);
 			}
+			//Pushed straight into the command buffer, unlike DescriptorSet::SetPushConstants nothing shared is written, so it is safe from workers
+			inline static void PushConstants(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, std::vector<Graphics::PushConstant>& pushConstants)
+			{
+				s_Instance->PushConstantsInternal(pipeline, cmdBuffer, pushConstants);
+			}
 			inline static void Draw(CommandBuffer* commandBuffer, DrawType type, uint32_t count, DataType datayType = DataType::UNSIGNED_INT, void* indices = nullptr)
 			{
 				s_Instance->DrawInternal(commandBuffer, type, count, datayType, indices);
@@ -129,6 +143,21 @@ namespace Lumos
 			{
 				s_Instance->DrawIndexedInternal(commandBuffer, type, count, start);
 			}
+			//Draws the bound index buffer instanceCount times, shaders read per instance data with gl_InstanceIndex
+			inline static void DrawIndexedInstanced(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount)
+			{
+				s_Instance->DrawIndexedInstancedInternal(commandBuffer, type, count, instanceCount);
+			}
+			//Arguments are read from the buffer on the gpu, see Dispatch
+			inline static void DrawIndexedIndirect(CommandBuffer* commandBuffer, DrawType type, UniformBuffer* argumentBuffer, uint32_t offset, uint32_t drawCount, uint32_t stride)
+			{
+				s_Instance->DrawIndexedIndirectInternal(commandBuffer, type, argumentBuffer, offset, drawCount, stride);
+			}
+			//Must be recorded outside a renderpass. Writes are visible to later dispatches, indirect draws and vertex shaders
+			inline static void Dispatch(CommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1)
+			{
+				s_Instance->DispatchInternal(commandBuffer, groupCountX, groupCountY, groupCountZ);
+			}
 			inline static const std::string& GetTitle()
 			{
 				return s_Instance->GetTitleInternal();
@@ -36,6 +36,15 @@ namespace Lumos
 			}
 		};
 
+		//Renderers only need to recreate their descriptor sets when the layout changed, otherwise rebuilding
+		//the pipelines that use the shader is enough
+		enum class ShaderReloadResult
+		{
+			FAILED,
+			RELOADED,
+			LAYOUT_CHANGED
+		};
+
 		template<typename Key>
 		using HashType = typename std::conditional<std::is_enum<Key>::value, ShaderEnumClassHash, std::hash<Key>>::type;
 
@@ -59,6 +68,10 @@ namespace Lumos
 
 			virtual void* GetHandle() const = 0;
 
+			//Rebuilds from the files on disk in place, so everything holding the shader uses the new version.
+			//The current version is kept if the new one fails to load
+			virtual ShaderReloadResult Reload() = 0;
+
 		public:
 			static Shader* CreateFromFile(const std::string& filepath);
 
@@ -34,6 +34,7 @@ namespace Lumos
 			RGBA16,
 			RGB32,
 			RGBA32,
+			RG16,
 			RGB,
 			RGBA,
 			DEPTH,
@@ -0,0 +1,233 @@
+#include "Precompiled.h"
+#include "AnimationClip.h"
+
+namespace Lumos::Graphics
+{
+	static const float SNorm16Scale = 32767.0f;
+	static const float UNorm16Max = 65535.0f;
+
+	//Decoding reads four values at a time, the frame data is padded so the last three component track can't read past the end
+	static const uint32_t FrameDataPadding = 4;
+
+	static inline Maths::Vector4 DecodeRotation(const uint16_t* data)
+	{
+#ifdef LUMOS_SSE
+		__m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+		__m128i extended = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+		Maths::Vector4 result;
+		_mm_storeu_ps(&result.x, _mm_mul_ps(_mm_cvtepi32_ps(extended), _mm_set1_ps(1.0f / SNorm16Scale)));
+		return result;
+#else
+		return Maths::Vector4(int16_t(data[0]), int16_t(data[1]), int16_t(data[2]), int16_t(data[3])) * (1.0f / SNorm16Scale);
+#endif
+	}
+
+	static inline Maths::Vector4 DecodeRanged(const uint16_t* data, const Maths::Vector4& min, const Maths::Vector4& scale)
+	{
+#ifdef LUMOS_SSE
+		__m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+		__m128 value = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+		Maths::Vector4 result;
+		_mm_storeu_ps(&result.x, _mm_add_ps(_mm_loadu_ps(&min.x), _mm_mul_ps(value, _mm_loadu_ps(&scale.x))));
+		return result;
+#else
+		return min + Maths::Vector4(float(data[0]), float(data[1]), float(data[2]), 0.0f) * scale;
+#endif
+	}
+
+	static inline uint16_t EncodeSNorm(float value)
+	{
+		return uint16_t(int16_t(Maths::RoundToInt(Maths::Clamp(value, -1.0f, 1.0f) * SNorm16Scale)));
+	}
+
+	static inline uint16_t EncodeUNorm(float value, float min, float scale)
+	{
+		return uint16_t(Maths::Clamp(Maths::RoundToInt((value - min) / scale), 0, int(UNorm16Max)));
+	}
+
+	static bool IsConstant(const std::vector<Maths::Vector3>& values, float epsilon)
+	{
+		for(auto& value : values)
+		{
+			if(!value.Equals(values.front(), epsilon))
+				return false;
+		}
+		return true;
+	}
+
+	static bool IsConstant(const std::vector<Maths::Quaternion>& values, float epsilon)
+	{
+		for(auto& value : values)
+		{
+			if(Maths::Abs(value.DotProduct(values.front())) < 1.0f - epsilon)
+				return false;
+		}
+		return true;
+	}
+
+	AnimationClip::AnimationClip(const std::string& name, float sampleRate, uint32_t frameCount, const std::vector<JointTrack>& tracks)
+		: m_Name(name)
+		, m_SampleRate(sampleRate)
+		, m_FrameCount(Maths::Max(frameCount, 1u))
+		, m_JointCount(uint32_t(tracks.size()))
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_Duration = float(m_FrameCount - 1) / m_SampleRate;
+
+		m_RotationTracks.resize(m_JointCount, -1);
+		m_TranslationTracks.resize(m_JointCount, -1);
+		m_ScaleTracks.resize(m_JointCount, -1);
+		m_Constant.Resize(m_JointCount);
+
+		uint32_t rotationCount = 0, translationCount = 0, scaleCount = 0;
+
+		for(uint32_t joint = 0; joint < m_JointCount; joint++)
+		{
+			const JointTrack& track = tracks[joint];
+			LUMOS_ASSERT(track.Rotations.size() >= m_FrameCount && track.Translations.size() >= m_FrameCount && track.Scales.size() >= m_FrameCount, "Animation track is missing frames");
+
+			const Maths::Vector3& t = track.Translations.front();
+			const Maths::Vector3& s = track.Scales.front();
+			m_Constant.Rotations[joint] = track.Rotations.front().Normalized();
+			m_Constant.Translations[joint] = Maths::Vector4(t.x, t.y, t.z, 0.0f);
+			m_Constant.Scales[joint] = Maths::Vector4(s.x, s.y, s.z, 0.0f);
+
+			if(!IsConstant(track.Rotations, 1e-6f))
+				m_RotationTracks[joint] = int32_t(rotationCount++);
+			if(!IsConstant(track.Translations, 1e-5f))
+				m_TranslationTracks[joint] = int32_t(translationCount++);
+			if(!IsConstant(track.Scales, 1e-5f))
+				m_ScaleTracks[joint] = int32_t(scaleCount++);
+		}
+
+		m_TranslationOffset = rotationCount * 4;
+		m_ScaleOffset = m_TranslationOffset + translationCount * 3;
+		m_FrameStride = m_ScaleOffset + scaleCount * 3;
+		m_FrameData.resize(m_FrameStride * m_FrameCount + FrameDataPadding, 0);
+		m_TranslationRanges.resize(translationCount);
+		m_ScaleRanges.resize(scaleCount);
+
+		auto computeRange = [this](const std::vector<Maths::Vector3>& values, Range& range)
+		{
+			Maths::Vector3 min = values.front(), max = values.front();
+			for(uint32_t frame = 0; frame < m_FrameCount; frame++)
+			{
+				min = Maths::VectorMin(min, values[frame]);
+				max = Maths::VectorMax(max, values[frame]);
+			}
+
+			Maths::Vector3 scale = (max - min) / UNorm16Max;
+			range.Min = Maths::Vector4(min.x, min.y, min.z, 0.0f);
+			range.Scale = Maths::Vector4(Maths::Max(scale.x, Maths::M_EPSILON), Maths::Max(scale.y, Maths::M_EPSILON), Maths::Max(scale.z, Maths::M_EPSILON), 0.0f);
+		};
+
+		auto encodeRanged = [](uint16_t* out, const Maths::Vector3& value, const Range& range)
+		{
+			out[0] = EncodeUNorm(value.x, range.Min.x, range.Scale.x);
+			out[1] = EncodeUNorm(value.y, range.Min.y, range.Scale.y);
+			out[2] = EncodeUNorm(value.z, range.Min.z, range.Scale.z);
+		};
+
+		for(uint32_t joint = 0; joint < m_JointCount; joint++)
+		{
+			const JointTrack& track = tracks[joint];
+
+			if(m_RotationTracks[joint] >= 0)
+			{
+				//Keep neighbouring keys in the same hemisphere so interpolation takes the short way
+				Maths::Quaternion previous = track.Rotations.front();
+				for(uint32_t frame = 0; frame < m_FrameCount; frame++)
+				{
+					Maths::Quaternion q = track.Rotations[frame].Normalized();
+					if(q.DotProduct(previous) < 0.0f)
+						q = -q;
+					previous = q;
+
+					uint16_t* out = &m_FrameData[frame * m_FrameStride + m_RotationTracks[joint] * 4];
+					out[0] = EncodeSNorm(q.w);
+					out[1] = EncodeSNorm(q.x);
+					out[2] = EncodeSNorm(q.y);
+					out[3] = EncodeSNorm(q.z);
+				}
+			}
+
+			if(m_TranslationTracks[joint] >= 0)
+			{
+				Range& range = m_TranslationRanges[m_TranslationTracks[joint]];
+				computeRange(track.Translations, range);
+				for(uint32_t frame = 0; frame < m_FrameCount; frame++)
+					encodeRanged(&m_FrameData[frame * m_FrameStride + m_TranslationOffset + m_TranslationTracks[joint] * 3], track.Translations[frame], range);
+			}
+
+			if(m_ScaleTracks[joint] >= 0)
+			{
+				Range& range = m_ScaleRanges[m_ScaleTracks[joint]];
+				computeRange(track.Scales, range);
+				for(uint32_t frame = 0; frame < m_FrameCount; frame++)
+					encodeRanged(&m_FrameData[frame * m_FrameStride + m_ScaleOffset + m_ScaleTracks[joint] * 3], track.Scales[frame], range);
+			}
+		}
+	}
+
+	size_t AnimationClip::GetMemorySize() const
+	{
+		return m_FrameData.size() * sizeof(uint16_t) + (m_TranslationRanges.size() + m_ScaleRanges.size()) * sizeof(Range)
+			+ m_JointCount * (3 * sizeof(int32_t) + sizeof(Maths::Quaternion) + 2 * sizeof(Maths::Vector4));
+	}
+
+	void AnimationClip::Sample(float time, bool loop, LocalPose& pose) const
+	{
+		const uint32_t jointCount = Maths::Min(m_JointCount, pose.GetJointCount());
+		const float lastFrame = float(m_FrameCount - 1);
+
+		float frame = time * m_SampleRate;
+		if(loop && lastFrame > 0.0f)
+		{
+			frame = fmodf(frame, lastFrame);
+			if(frame < 0.0f)
+				frame += lastFrame;
+		}
+		else
+			frame = Maths::Clamp(frame, 0.0f, lastFrame);
+
+		const uint32_t frame0 = Maths::Min(uint32_t(frame), m_FrameCount - 1);
+		const uint32_t frame1 = Maths::Min(frame0 + 1, m_FrameCount - 1);
+		const float alpha = frame - float(frame0);
+
+		const uint16_t* a = &m_FrameData[frame0 * m_FrameStride];
+		const uint16_t* b = &m_FrameData[frame1 * m_FrameStride];
+
+		for(uint32_t joint = 0; joint < jointCount; joint++)
+		{
+			const int32_t rotation = m_RotationTracks[joint];
+			if(rotation >= 0)
+			{
+				Maths::Vector4 qa = DecodeRotation(a + rotation * 4);
+				Maths::Vector4 qb = DecodeRotation(b + rotation * 4);
+				pose.Rotations[joint] = PoseUtilities::Nlerp(Maths::Quaternion(qa.x, qa.y, qa.z, qa.w), Maths::Quaternion(qb.x, qb.y, qb.z, qb.w), alpha);
+			}
+			else
+				pose.Rotations[joint] = m_Constant.Rotations[joint];
+
+			const int32_t translation = m_TranslationTracks[joint];
+			if(translation >= 0)
+			{
+				const Range& range = m_TranslationRanges[translation];
+				const uint32_t offset = m_TranslationOffset + translation * 3;
+				pose.Translations[joint] = DecodeRanged(a + offset, range.Min, range.Scale).Lerp(DecodeRanged(b + offset, range.Min, range.Scale), alpha);
+			}
+			else
+				pose.Translations[joint] = m_Constant.Translations[joint];
+
+			const int32_t scale = m_ScaleTracks[joint];
+			if(scale >= 0)
+			{
+				const Range& range = m_ScaleRanges[scale];
+				const uint32_t offset = m_ScaleOffset + scale * 3;
+				pose.Scales[joint] = DecodeRanged(a + offset, range.Min, range.Scale).Lerp(DecodeRanged(b + offset, range.Min, range.Scale), alpha);
+			}
+			else
+				pose.Scales[joint] = m_Constant.Scales[joint];
+		}
+	}
+}
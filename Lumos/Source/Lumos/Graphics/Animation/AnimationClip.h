@@ -0,0 +1,64 @@
+#pragma once
+#include "Pose.h"
+
+namespace Lumos::Graphics
+{
+	//Joint animation resampled at a fixed rate and quantized to 16 bits per component.
+	//Rotations are stored as four snorm16 values, translations and scales as unorm16 within the track's range.
+	//Tracks that don't change are stored once instead of per frame, and all animated values for a frame sit
+	//in one contiguous block so sampling touches two blocks.
+	class LUMOS_EXPORT AnimationClip
+	{
+	public:
+		//Uncompressed keys for one joint at every frame, filled by the model loaders
+		struct JointTrack
+		{
+			std::vector<Maths::Vector3> Translations;
+			std::vector<Maths::Quaternion> Rotations;
+			std::vector<Maths::Vector3> Scales;
+		};
+
+		static constexpr float DefaultSampleRate = 30.0f;
+
+		//tracks holds one entry per skeleton joint, each with frameCount keys
+		AnimationClip(const std::string& name, float sampleRate, uint32_t frameCount, const std::vector<JointTrack>& tracks);
+		~AnimationClip() = default;
+
+		//Writes every joint of pose, which must already be sized for the skeleton
+		void Sample(float time, bool loop, LocalPose& pose) const;
+
+		const std::string& GetName() const { return m_Name; }
+		float GetDuration() const { return m_Duration; }
+		uint32_t GetFrameCount() const { return m_FrameCount; }
+		uint32_t GetJointCount() const { return m_JointCount; }
+		size_t GetMemorySize() const;
+
+	private:
+		struct Range
+		{
+			Maths::Vector4 Min;
+			Maths::Vector4 Scale;
+		};
+
+		std::string m_Name;
+		float m_SampleRate;
+		float m_Duration;
+		uint32_t m_FrameCount;
+		uint32_t m_JointCount;
+
+		//Per joint index into the frame block, or -1 for a constant track
+		std::vector<int32_t> m_RotationTracks;
+		std::vector<int32_t> m_TranslationTracks;
+		std::vector<int32_t> m_ScaleTracks;
+
+		//Values of constant tracks, also used as the track value before the first frame is decoded
+		LocalPose m_Constant;
+		std::vector<Range> m_TranslationRanges;
+		std::vector<Range> m_ScaleRanges;
+
+		uint32_t m_FrameStride = 0;
+		uint32_t m_TranslationOffset = 0;
+		uint32_t m_ScaleOffset = 0;
+		std::vector<uint16_t> m_FrameData;
+	};
+}
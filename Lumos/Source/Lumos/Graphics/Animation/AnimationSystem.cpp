@@ -0,0 +1,140 @@
+#include "Precompiled.h"
+#include "AnimationSystem.h"
+#include "Animator.h"
+#include "Skeleton.h"
+#include "AnimationClip.h"
+#include "Graphics/Model.h"
+#include "Core/JobSystem.h"
+#include "Utilities/TimeStep.h"
+#include "Utilities/Timer.h"
+
+#include <entt/entity/registry.hpp>
+#include <imgui/imgui.h>
+
+namespace Lumos
+{
+	AnimationSystem::AnimationSystem()
+	{
+		m_DebugName = "Animation";
+	}
+
+	void AnimationSystem::OnUpdate(const TimeStep& dt, Scene* scene)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		UpdateAnimators(scene, m_Paused ? 0.0f : dt.GetSeconds());
+		m_Updated = true;
+	}
+
+	const std::vector<Maths::Matrix4>& AnimationSystem::GetBonePalette(Scene* scene)
+	{
+		if(!m_Updated)
+			UpdateAnimators(scene, 0.0f);
+
+		m_Updated = false;
+		return m_Palette;
+	}
+
+	void AnimationSystem::UpdateAnimators(Scene* scene, float dt)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		if(!scene)
+			return;
+
+		Timer timer;
+		timer.GetTimedMS();
+
+		auto& registry = scene->GetRegistry();
+
+		//Every model with a skeleton gets an animator
+		{
+			std::vector<entt::entity> missing;
+			auto view = registry.view<Graphics::Model>(entt::exclude<Graphics::Animator>);
+			for(auto entity : view)
+			{
+				if(view.get<Graphics::Model>(entity).GetSkeleton())
+					missing.push_back(entity);
+			}
+
+			for(auto entity : missing)
+				registry.emplace<Graphics::Animator>(entity);
+		}
+
+		m_Jobs.clear();
+		uint32_t paletteSize = 0;
+
+		auto view = registry.view<Graphics::Animator, Graphics::Model>();
+		for(auto entity : view)
+		{
+			auto& model = view.get<Graphics::Model>(entity);
+			if(!model.GetSkeleton())
+				continue;
+
+			auto& animator = view.get<Graphics::Animator>(entity);
+			animator.SetPaletteOffset(paletteSize);
+			paletteSize += model.GetSkeleton()->GetJointCount();
+
+			m_Jobs.push_back({ &animator, &model });
+		}
+
+		m_Palette.resize(paletteSize);
+
+		if(!m_Jobs.empty())
+		{
+			System::JobSystem::Dispatch(uint32_t(m_Jobs.size()), 4, [&](JobDispatchArgs args)
+				{
+					const AnimatorJob& job = m_Jobs[args.jobIndex];
+					job.Animator->Update(dt, *job.Model->GetSkeleton(), job.Model->GetAnimations(), &m_Palette[job.Animator->GetPaletteOffset()]);
+				});
+
+			System::JobSystem::Wait();
+		}
+
+		m_UpdateTime = timer.GetTimedMS();
+	}
+
+	void AnimationSystem::OnImGui()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		ImGui::TextUnformatted("Animation");
+
+		ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(2, 2));
+		ImGui::Columns(2);
+		ImGui::Separator();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Animators");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Text("%5.2i", static_cast<int>(m_Jobs.size()));
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Palette Joints");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Text("%5.2i", static_cast<int>(m_Palette.size()));
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Update Time (ms)");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Text("%5.3f", m_UpdateTime);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Paused");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Checkbox("##Paused", &m_Paused);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::Columns(1);
+		ImGui::Separator();
+		ImGui::PopStyleVar();
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Scene/ISystem.h"
+#include "Maths/Maths.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		class Animator;
+		class Model;
+	}
+
+	//Evaluates every Animator in parallel and packs their skinning matrices into one palette, which the
+	//renderer uploads once per frame. Each animator's joints start at its palette offset.
+	class LUMOS_EXPORT AnimationSystem : public ISystem
+	{
+	public:
+		AnimationSystem();
+		virtual ~AnimationSystem() override = default;
+
+		void OnInit() override {};
+		void OnUpdate(const TimeStep& dt, Scene* scene) override;
+		void OnImGui() override;
+		void OnDebugDraw() override {};
+
+		//Palette for the current frame. Evaluates the scene at the current time if OnUpdate didn't run,
+		//e.g. while the editor isn't playing
+		const std::vector<Maths::Matrix4>& GetBonePalette(Scene* scene);
+
+		bool GetPaused() const { return m_Paused; }
+		void SetPaused(bool paused) { m_Paused = paused; }
+
+	private:
+		void UpdateAnimators(Scene* scene, float dt);
+
+		struct AnimatorJob
+		{
+			Graphics::Animator* Animator;
+			const Graphics::Model* Model;
+		};
+
+		std::vector<AnimatorJob> m_Jobs;
+		std::vector<Maths::Matrix4> m_Palette;
+		bool m_Updated = false;
+		bool m_Paused = false;
+		float m_UpdateTime = 0.0f;
+	};
+}
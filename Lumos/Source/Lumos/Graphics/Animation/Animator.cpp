@@ -0,0 +1,62 @@
+#include "Precompiled.h"
+#include "Animator.h"
+#include "Skeleton.h"
+#include "AnimationClip.h"
+
+namespace Lumos::Graphics
+{
+	void Animator::Play(int32_t clip, float blendDuration)
+	{
+		if(clip == m_Clip)
+			return;
+
+		if(blendDuration > 0.0f)
+		{
+			m_PreviousClip = m_Clip;
+			m_PreviousTime = m_Time;
+			m_BlendDuration = blendDuration;
+			m_BlendTime = 0.0f;
+		}
+		else
+			m_PreviousClip = -1;
+
+		m_Clip = clip;
+		m_Time = 0.0f;
+	}
+
+	void Animator::Update(float dt, const Skeleton& skeleton, const std::vector<Ref<AnimationClip>>& clips, Maths::Matrix4* palette)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		const uint32_t jointCount = skeleton.GetJointCount();
+
+		if(m_Pose.GetJointCount() != jointCount)
+		{
+			m_Pose = skeleton.GetBindPose();
+			m_BlendPose = skeleton.GetBindPose();
+			m_ModelSpace.resize(jointCount);
+		}
+
+		const int32_t clipCount = int32_t(clips.size());
+
+		if(m_Clip >= 0 && m_Clip < clipCount)
+		{
+			m_Time += dt * m_Speed;
+			clips[m_Clip]->Sample(m_Time, m_Loop, m_Pose);
+
+			if(m_PreviousClip >= 0 && m_PreviousClip < clipCount && m_BlendTime < m_BlendDuration)
+			{
+				m_PreviousTime += dt * m_Speed;
+				m_BlendTime += dt;
+
+				clips[m_PreviousClip]->Sample(m_PreviousTime, m_Loop, m_BlendPose);
+				PoseUtilities::Blend(m_BlendPose, m_Pose, Maths::Min(m_BlendTime / m_BlendDuration, 1.0f), m_Pose);
+			}
+			else
+				m_PreviousClip = -1;
+		}
+		else
+			m_Pose = skeleton.GetBindPose();
+
+		skeleton.ComputeSkinningMatrices(m_Pose, m_ModelSpace.data(), palette);
+	}
+}
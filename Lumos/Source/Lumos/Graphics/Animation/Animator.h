@@ -0,0 +1,66 @@
+#pragma once
+#include "Pose.h"
+#include <cereal/cereal.hpp>
+
+namespace Lumos::Graphics
+{
+	class Skeleton;
+	class AnimationClip;
+
+	//Plays the animation clips of the Model on the same entity. Added and evaluated by AnimationSystem
+	class LUMOS_EXPORT Animator
+	{
+	public:
+		Animator() = default;
+		~Animator() = default;
+
+		//Switches clip, crossfading from the current one over blendDuration seconds
+		void Play(int32_t clip, float blendDuration = 0.0f);
+
+		//Advances time, samples and blends the clips then writes one skinning matrix per joint to palette
+		void Update(float dt, const Skeleton& skeleton, const std::vector<Ref<AnimationClip>>& clips, Maths::Matrix4* palette);
+
+		int32_t GetClip() const { return m_Clip; }
+		float GetTime() const { return m_Time; }
+		void SetTime(float time) { m_Time = time; }
+		float GetSpeed() const { return m_Speed; }
+		void SetSpeed(float speed) { m_Speed = speed; }
+		bool GetLoop() const { return m_Loop; }
+		void SetLoop(bool loop) { m_Loop = loop; }
+		bool IsBlending() const { return m_PreviousClip >= 0; }
+
+		//First joint of this animator in the shared bone palette
+		uint32_t GetPaletteOffset() const { return m_PaletteOffset; }
+		void SetPaletteOffset(uint32_t offset) { m_PaletteOffset = offset; }
+
+		template<typename Archive>
+		void save(Archive& archive) const
+		{
+			archive(cereal::make_nvp("Clip", m_Clip), cereal::make_nvp("Speed", m_Speed), cereal::make_nvp("Loop", m_Loop));
+		}
+
+		template<typename Archive>
+		void load(Archive& archive)
+		{
+			archive(cereal::make_nvp("Clip", m_Clip), cereal::make_nvp("Speed", m_Speed), cereal::make_nvp("Loop", m_Loop));
+		}
+
+	private:
+		int32_t m_Clip = 0;
+		float m_Time = 0.0f;
+		float m_Speed = 1.0f;
+		bool m_Loop = true;
+
+		int32_t m_PreviousClip = -1;
+		float m_PreviousTime = 0.0f;
+		float m_BlendDuration = 0.0f;
+		float m_BlendTime = 0.0f;
+
+		uint32_t m_PaletteOffset = 0;
+
+		//Scratch space reused every update
+		LocalPose m_Pose;
+		LocalPose m_BlendPose;
+		std::vector<Maths::Matrix3x4> m_ModelSpace;
+	};
+}
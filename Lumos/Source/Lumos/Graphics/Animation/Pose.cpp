@@ -0,0 +1,48 @@
+#include "Precompiled.h"
+#include "Pose.h"
+
+namespace Lumos::Graphics::PoseUtilities
+{
+	Maths::Quaternion Nlerp(const Maths::Quaternion& a, const Maths::Quaternion& b, float t)
+	{
+#ifdef LUMOS_SSE
+		__m128 qa = _mm_loadu_ps(&a.w);
+		__m128 qb = _mm_loadu_ps(&b.w);
+
+		//Flip b into the same hemisphere as a
+		__m128 d = _mm_mul_ps(qa, qb);
+		d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+		d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(0, 1, 2, 3)));
+		const __m128 sign = _mm_and_ps(_mm_cmplt_ps(d, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+		qb = _mm_xor_ps(qb, sign);
+
+		__m128 q = _mm_add_ps(qa, _mm_mul_ps(_mm_sub_ps(qb, qa), _mm_set1_ps(t)));
+
+		__m128 n = _mm_mul_ps(q, q);
+		n = _mm_add_ps(n, _mm_shuffle_ps(n, n, _MM_SHUFFLE(2, 3, 0, 1)));
+		n = _mm_add_ps(n, _mm_shuffle_ps(n, n, _MM_SHUFFLE(0, 1, 2, 3)));
+		q = _mm_div_ps(q, _mm_sqrt_ps(n));
+
+		Maths::Quaternion result;
+		_mm_storeu_ps(&result.w, q);
+		return result;
+#else
+		float dot = a.DotProduct(b);
+		Maths::Quaternion target = dot < 0.0f ? -b : b;
+		return (a + (target - a) * t).Normalized();
+#endif
+	}
+
+	void Blend(const LocalPose& a, const LocalPose& b, float weight, LocalPose& out)
+	{
+		const uint32_t jointCount = Maths::Min(a.GetJointCount(), b.GetJointCount());
+		out.Resize(jointCount);
+
+		for(uint32_t i = 0; i < jointCount; i++)
+		{
+			out.Rotations[i] = Nlerp(a.Rotations[i], b.Rotations[i], weight);
+			out.Translations[i] = a.Translations[i].Lerp(b.Translations[i], weight);
+			out.Scales[i] = a.Scales[i].Lerp(b.Scales[i], weight);
+		}
+	}
+}
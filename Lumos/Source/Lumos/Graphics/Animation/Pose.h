@@ -0,0 +1,32 @@
+#pragma once
+#include "Maths/Maths.h"
+
+namespace Lumos::Graphics
+{
+	//Joint transforms relative to their parent. Translation and scale are kept in Vector4s so every
+	//channel is one 16 byte load, the w component is unused.
+	struct LUMOS_EXPORT LocalPose
+	{
+		std::vector<Maths::Quaternion> Rotations;
+		std::vector<Maths::Vector4> Translations;
+		std::vector<Maths::Vector4> Scales;
+
+		void Resize(uint32_t jointCount)
+		{
+			Rotations.resize(jointCount);
+			Translations.resize(jointCount);
+			Scales.resize(jointCount);
+		}
+
+		uint32_t GetJointCount() const { return uint32_t(Rotations.size()); }
+	};
+
+	namespace PoseUtilities
+	{
+		//Normalised lerp between two rotations along the shortest path
+		Maths::Quaternion Nlerp(const Maths::Quaternion& a, const Maths::Quaternion& b, float t);
+
+		//out = a + (b - a) * weight for every joint. out may alias a or b
+		void Blend(const LocalPose& a, const LocalPose& b, float weight, LocalPose& out);
+	}
+}
@@ -0,0 +1,49 @@
+#include "Precompiled.h"
+#include "Skeleton.h"
+
+namespace Lumos::Graphics
+{
+	uint32_t Skeleton::AddJoint(const std::string& name, int32_t parent, const Maths::Matrix3x4& inverseBindMatrix, const Maths::Vector3& translation, const Maths::Quaternion& rotation, const Maths::Vector3& scale)
+	{
+		LUMOS_ASSERT(parent < int32_t(m_Joints.size()), "Joint parent has to be added first");
+
+		Joint joint;
+		joint.Name = name;
+		joint.Parent = parent;
+		joint.InverseBindMatrix = inverseBindMatrix;
+		m_Joints.push_back(joint);
+
+		m_BindPose.Rotations.push_back(rotation);
+		m_BindPose.Translations.emplace_back(translation, 0.0f);
+		m_BindPose.Scales.emplace_back(scale, 0.0f);
+
+		return uint32_t(m_Joints.size() - 1);
+	}
+
+	int32_t Skeleton::FindJoint(const std::string& name) const
+	{
+		for(uint32_t i = 0; i < uint32_t(m_Joints.size()); i++)
+		{
+			if(m_Joints[i].Name == name)
+				return int32_t(i);
+		}
+
+		return -1;
+	}
+
+	void Skeleton::ComputeSkinningMatrices(const LocalPose& pose, Maths::Matrix3x4* modelSpace, Maths::Matrix4* palette) const
+	{
+		const uint32_t jointCount = Maths::Min(GetJointCount(), pose.GetJointCount());
+
+		for(uint32_t i = 0; i < jointCount; i++)
+		{
+			const Maths::Vector4& t = pose.Translations[i];
+			const Maths::Vector4& s = pose.Scales[i];
+			Maths::Matrix3x4 local(Maths::Vector3(t.x, t.y, t.z), pose.Rotations[i], Maths::Vector3(s.x, s.y, s.z));
+
+			const int32_t parent = m_Joints[i].Parent;
+			modelSpace[i] = parent >= 0 ? modelSpace[parent] * local : local;
+			palette[i] = (modelSpace[i] * m_Joints[i].InverseBindMatrix).ToMatrix4();
+		}
+	}
+}
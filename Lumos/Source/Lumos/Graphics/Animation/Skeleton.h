@@ -0,0 +1,38 @@
+#pragma once
+#include "Pose.h"
+#include "Maths/Matrix3x4.h"
+
+namespace Lumos::Graphics
+{
+	//Joint hierarchy of a skinned model. Joints are stored so a parent always comes before its children,
+	//which lets model space transforms be built in a single forward pass.
+	class LUMOS_EXPORT Skeleton
+	{
+	public:
+		struct Joint
+		{
+			std::string Name;
+			int32_t Parent = -1;
+			Maths::Matrix3x4 InverseBindMatrix;
+		};
+
+		Skeleton() = default;
+		~Skeleton() = default;
+
+		//The parent has to be added first. Returns the joint index
+		uint32_t AddJoint(const std::string& name, int32_t parent, const Maths::Matrix3x4& inverseBindMatrix, const Maths::Vector3& translation, const Maths::Quaternion& rotation, const Maths::Vector3& scale);
+
+		int32_t FindJoint(const std::string& name) const;
+
+		uint32_t GetJointCount() const { return uint32_t(m_Joints.size()); }
+		const std::vector<Joint>& GetJoints() const { return m_Joints; }
+		const LocalPose& GetBindPose() const { return m_BindPose; }
+
+		//Writes one skinning matrix per joint, modelSpace is scratch space for GetJointCount() matrices
+		void ComputeSkinningMatrices(const LocalPose& pose, Maths::Matrix3x4* modelSpace, Maths::Matrix4* palette) const;
+
+	private:
+		std::vector<Joint> m_Joints;
+		LocalPose m_BindPose;
+	};
+}
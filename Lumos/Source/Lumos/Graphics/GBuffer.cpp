@@ -10,6 +10,12 @@ namespace Lumos
 		GBuffer::GBuffer(uint32_t width, uint32_t height)
 			: m_Width(width), m_Height(height)
 		{
+#ifdef LUMOS_PLATFORM_IOS
+			//Unless all render targets were rgba32 there were visual glitches on ios
+			m_Layout = GBufferLayout::LEGACY;
+#else
+			m_Layout = GBufferLayout::THIN;
+#endif
 			Init();
 		}
 
@@ -55,31 +61,54 @@ namespace Lumos
 				m_DepthTexture = TextureDepth::Create(m_Width, m_Height);
 			}
 
+			m_Formats[SCREENTEX_DEPTH] = TextureFormat::DEPTH;
+			m_Formats[SCREENTEX_OFFSCREEN1] = TextureFormat::RGBA8;
+
 #ifdef LUMOS_PLATFORM_IOS
             //Unless all render targets were rgba32 there were visual glitches on ios
-			m_Formats[0] = TextureFormat::RGBA32;
-			m_Formats[1] = TextureFormat::RGBA32;
-			m_Formats[2] = TextureFormat::RGBA32;
-			m_Formats[3] = TextureFormat::RGBA32;
-            m_Formats[4] = TextureFormat::RGBA32;
+			m_Formats[SCREENTEX_COLOUR] = TextureFormat::RGBA32;
+			m_Formats[SCREENTEX_POSITION] = TextureFormat::RGBA32;
+			m_Formats[SCREENTEX_NORMALS] = TextureFormat::RGBA32;
+			m_Formats[SCREENTEX_PBR] = TextureFormat::RGBA32;
+            m_Formats[SCREENTEX_OFFSCREEN0] = TextureFormat::RGBA32;
 #else
-            m_Formats[0] = TextureFormat::RGBA8;
-            m_Formats[1] = TextureFormat::RGBA32;
-            m_Formats[2] = TextureFormat::RGBA16;
-            m_Formats[3] = TextureFormat::RGBA16;
-            m_Formats[4] = TextureFormat::RGBA8;
+			if(m_Layout == GBufferLayout::THIN)
+			{
+				//World position is reconstructed from the depth buffer, so the position target only carries emissive.
+				//Normals are octahedral encoded into two channels.
+				m_Formats[SCREENTEX_COLOUR] = TextureFormat::RGBA8;
+				m_Formats[SCREENTEX_EMISSIVE] = TextureFormat::RGBA16;
+				m_Formats[SCREENTEX_NORMALS] = TextureFormat::RG16;
+				m_Formats[SCREENTEX_PBR] = TextureFormat::RGBA8;
+			}
+			else
+			{
+				m_Formats[SCREENTEX_COLOUR] = TextureFormat::RGBA8;
+				m_Formats[SCREENTEX_POSITION] = TextureFormat::RGBA32;
+				m_Formats[SCREENTEX_NORMALS] = TextureFormat::RGBA16;
+				m_Formats[SCREENTEX_PBR] = TextureFormat::RGBA16;
+			}
+            m_Formats[SCREENTEX_OFFSCREEN0] = TextureFormat::RGBA8;
 #endif
-		
 
-			m_ScreenTex[SCREENTEX_COLOUR]->BuildTexture(m_Formats[0], m_Width, m_Height, false, false, false);
-			m_ScreenTex[SCREENTEX_POSITION]->BuildTexture(m_Formats[1], m_Width, m_Height, false, false, false);
-			m_ScreenTex[SCREENTEX_NORMALS]->BuildTexture(m_Formats[2], m_Width, m_Height, false, false, false);
-			m_ScreenTex[SCREENTEX_PBR]->BuildTexture(m_Formats[3], m_Width, m_Height, false, false, false);
-			m_ScreenTex[SCREENTEX_OFFSCREEN0]->BuildTexture(m_Formats[4], m_Width, m_Height, false, false, false);
+			m_ScreenTex[SCREENTEX_COLOUR]->BuildTexture(m_Formats[SCREENTEX_COLOUR], m_Width, m_Height, false, false, false);
+			m_ScreenTex[SCREENTEX_POSITION]->BuildTexture(m_Formats[SCREENTEX_POSITION], m_Width, m_Height, false, false, false);
+			m_ScreenTex[SCREENTEX_NORMALS]->BuildTexture(m_Formats[SCREENTEX_NORMALS], m_Width, m_Height, false, false, false);
+			m_ScreenTex[SCREENTEX_PBR]->BuildTexture(m_Formats[SCREENTEX_PBR], m_Width, m_Height, false, false, false);
+			m_ScreenTex[SCREENTEX_OFFSCREEN0]->BuildTexture(m_Formats[SCREENTEX_OFFSCREEN0], m_Width, m_Height, false, false, false);
 
 			m_DepthTexture->Resize(m_Width, m_Height);
 		}
 
+		void GBuffer::SetLayout(GBufferLayout layout)
+		{
+			if(m_Layout == layout)
+				return;
+
+			m_Layout = layout;
+			BuildTextures();
+		}
+
 		void GBuffer::Bind(int32_t mode)
 		{
 		}
@@ -16,7 +16,8 @@ namespace Lumos
 			SCREENTEX_DEPTH = 0,	//Depth Buffer
 			SCREENTEX_STENCIL = 0,	//Stencil Buffer (Same Tex as Depth)
 			SCREENTEX_COLOUR = 1,	//Main Render
-			SCREENTEX_POSITION = 2,	//Deferred Render - World Space Positions
+			SCREENTEX_POSITION = 2,	//Deferred Render - World Space Positions (Legacy layout only)
+			SCREENTEX_EMISSIVE = 2,	//Deferred Render - Emissive (Thin layout, position is rebuilt from depth)
 			SCREENTEX_NORMALS = 3,	//Deferred Render - World Space Normals
 			SCREENTEX_PBR = 4,	//Metallic/Roughness/Ao Stored Here
 			SCREENTEX_OFFSCREEN0 = 5,	//Extra Textures for multipass post processing
@@ -24,6 +25,12 @@ namespace Lumos
 			SCREENTEX_MAX
 		};
 
+		enum class GBufferLayout
+		{
+			THIN,	//Position from depth, octahedral RG16 normals, RGBA8 Metallic/Roughness/Ao
+			LEGACY	//RGBA32 positions, RGBA16 normals and pbr. Kept for debugging
+		};
+
 		class LUMOS_EXPORT GBuffer
 		{
 		public:
@@ -36,6 +43,9 @@ namespace Lumos
 			void Bind(int32_t mode = 0);
 			void UpdateTextureSize(uint32_t width, uint32_t height);
 			void SetReadBuffer(ScreenTextures type);
+			void SetLayout(GBufferLayout layout);
+
+			inline GBufferLayout GetLayout() const { return m_Layout; }
 
 			inline uint32_t GetWidth() const { return m_Width; }
 			inline uint32_t GetHeight() const { return m_Height; }
@@ -53,6 +63,7 @@ namespace Lumos
 			TextureDepth* m_DepthTexture{};
 			TextureFormat m_Formats[ScreenTextures::SCREENTEX_MAX];
 			uint32_t m_Width, m_Height;
+			GBufferLayout m_Layout;
 		};
 	}
 }
@@ -0,0 +1,412 @@
+#include "Precompiled.h"
+#include "GPUScene.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "Core/Application.h"
+
+#include "Graphics/API/Pipeline.h"
+#include "Graphics/API/RenderPass.h"
+#include "Graphics/API/Renderer.h"
+#include "Graphics/API/UniformBuffer.h"
+#include "Graphics/API/VertexBuffer.h"
+#include "Graphics/API/IndexBuffer.h"
+#include "Graphics/API/Texture.h"
+#include "Graphics/API/Shader.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		static const uint32_t CullGroupSize = 64;
+		static const uint32_t PyramidGroupSize = 8;
+		static const uint32_t MinInstanceCapacity = 256;
+
+		//std140 layout of CullUniforms in GPUCull.comp
+		struct CullUniforms
+		{
+			Maths::Matrix4 ProjView;
+			Maths::Matrix4 PreviousProjView;
+			uint32_t InstanceCount;
+			uint32_t OcclusionEnabled;
+			uint32_t PyramidWidth;
+			uint32_t PyramidHeight;
+			uint32_t PyramidLevels;
+			uint32_t DepthZeroOne;
+			uint32_t Padding[2];
+		};
+
+		//Push constants of DepthPyramid.comp
+		struct PyramidPushConstants
+		{
+			uint32_t SourceWidth;
+			uint32_t SourceHeight;
+			uint32_t Width;
+			uint32_t Height;
+			uint32_t SourceOffset;
+			uint32_t Offset;
+			uint32_t FromDepthTexture;
+			uint32_t Padding;
+		};
+
+		GPUScene::GPUScene()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			PipelineInfo cullPipelineInfo{};
+			cullPipelineInfo.shader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/GPUCull.shader");
+			m_CullPipeline = Pipeline::Get(cullPipelineInfo);
+
+			PipelineInfo pyramidPipelineInfo{};
+			pyramidPipelineInfo.shader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/DepthPyramid.shader");
+			m_DepthPyramidPipeline = Pipeline::Get(pyramidPipelineInfo);
+
+			m_CullUniformBuffer = UniformBuffer::Create();
+			m_CullUniformBuffer->Init(sizeof(CullUniforms), nullptr);
+
+			auto pushConstant = PushConstant();
+			pushConstant.size = sizeof(PyramidPushConstants);
+			pushConstant.data = new uint8_t[sizeof(PyramidPushConstants)];
+			pushConstant.shaderStage = ShaderType::COMPUTE;
+			m_PyramidPushConstants.push_back(pushConstant);
+
+			m_DescriptorSets.resize(2);
+		}
+
+		GPUScene::~GPUScene()
+		{
+			delete m_InstanceBuffer;
+			delete m_DrawCommandBuffer;
+			delete m_CullUniformBuffer;
+			delete m_DepthPyramidBuffer;
+
+			for(auto& pc : m_PyramidPushConstants)
+				delete[] pc.data;
+		}
+
+		void GPUScene::Clear()
+		{
+			m_GeometryRanges.clear();
+			m_PooledMeshes.clear();
+			m_VertexData.clear();
+			m_IndexData.clear();
+			m_MaterialBatchLookup.clear();
+			m_MaterialBatches.clear();
+			m_Instances.clear();
+			m_DrawBatches.clear();
+			m_GeometryDirty = true;
+			m_PreviousDepthValid = false;
+		}
+
+		void GPUScene::BeginFrame()
+		{
+			for(auto& batch : m_MaterialBatches)
+				batch.instances.clear();
+		}
+
+		bool GPUScene::AddInstance(const Ref<Mesh>& mesh, Material* material, const Maths::Matrix4& transform, uint32_t materialIndex)
+		{
+			const auto& indices = mesh->GetIndices();
+			const auto& vertices = mesh->GetVertices();
+			if(indices.empty() || vertices.empty())
+				return false;
+
+			auto range = m_GeometryRanges.find(mesh.get());
+			if(range == m_GeometryRanges.end())
+			{
+				GeometryRange newRange;
+				newRange.IndexCount = uint32_t(indices.size());
+				newRange.FirstIndex = uint32_t(m_IndexData.size());
+				newRange.VertexOffset = int32_t(m_VertexData.size() / sizeof(Vertex));
+
+				m_IndexData.insert(m_IndexData.end(), indices.begin(), indices.end());
+				const uint8_t* vertexData = reinterpret_cast<const uint8_t*>(vertices.data());
+				m_VertexData.insert(m_VertexData.end(), vertexData, vertexData + vertices.size() * sizeof(Vertex));
+
+				//Keeps the mesh alive so its address can't be reused by another mesh
+				m_PooledMeshes.push_back(mesh);
+				m_GeometryDirty = true;
+				range = m_GeometryRanges.emplace(mesh.get(), newRange).first;
+			}
+
+			auto batchIndex = m_MaterialBatchLookup.find(material);
+			if(batchIndex == m_MaterialBatchLookup.end())
+			{
+				batchIndex = m_MaterialBatchLookup.emplace(material, uint32_t(m_MaterialBatches.size())).first;
+				m_MaterialBatches.push_back({ material, {} });
+			}
+
+			const auto& bounds = *mesh->GetBoundingBox();
+
+			Instance instance;
+			instance.Transform = transform;
+			instance.BoundsMin = Maths::Vector4(bounds.min_, 1.0f);
+			instance.BoundsMax = Maths::Vector4(bounds.max_, 1.0f);
+			instance.IndexCount = range->second.IndexCount;
+			instance.FirstIndex = range->second.FirstIndex;
+			instance.VertexOffset = range->second.VertexOffset;
+			instance.MaterialIndex = materialIndex;
+
+			m_MaterialBatches[batchIndex->second].instances.push_back(instance);
+			return true;
+		}
+
+		void GPUScene::UploadGeometry()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_GeometryDirty = false;
+
+			if(m_IndexData.empty())
+				return;
+
+			m_VertexBuffer = Ref<VertexBuffer>(VertexBuffer::Create(BufferUsage::STATIC));
+			m_VertexBuffer->SetData(uint32_t(m_VertexData.size()), m_VertexData.data());
+			m_IndexBuffer = Ref<IndexBuffer>(IndexBuffer::Create(m_IndexData.data(), uint32_t(m_IndexData.size())));
+		}
+
+		void GPUScene::UploadInstances()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_Instances.clear();
+			m_DrawBatches.clear();
+
+			//Instances of a material are contiguous so each material is a single indirect draw
+			for(auto& batch : m_MaterialBatches)
+			{
+				if(batch.instances.empty())
+					continue;
+
+				m_DrawBatches.push_back({ batch.material, uint32_t(m_Instances.size()), uint32_t(batch.instances.size()) });
+				m_Instances.insert(m_Instances.end(), batch.instances.begin(), batch.instances.end());
+			}
+
+			if(m_Instances.size() > m_InstanceCapacity || !m_InstanceBuffer)
+			{
+				m_InstanceCapacity = Maths::Max(MinInstanceCapacity, m_InstanceCapacity);
+				while(m_InstanceCapacity < m_Instances.size())
+					m_InstanceCapacity *= 2;
+
+				delete m_InstanceBuffer;
+				delete m_DrawCommandBuffer;
+
+				m_InstanceBuffer = UniformBuffer::Create();
+				m_InstanceBuffer->Init(m_InstanceCapacity * sizeof(Instance), nullptr);
+
+				m_DrawCommandBuffer = UniformBuffer::Create();
+				m_DrawCommandBuffer->Init(m_InstanceCapacity * sizeof(DrawCommand), nullptr);
+
+				m_BuffersChanged = true;
+				m_DescriptorsDirty = true;
+			}
+
+			if(!m_Instances.empty())
+				m_InstanceBuffer->SetData(uint32_t(m_Instances.size() * sizeof(Instance)), m_Instances.data());
+		}
+
+		void GPUScene::CreatePyramid(uint32_t width, uint32_t height)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_DepthWidth = width;
+			m_DepthHeight = height;
+
+			//Level 0 is half the depth resolution, each level halves until 1x1
+			m_PyramidWidth = Maths::Max(1u, (width + 1) / 2);
+			m_PyramidHeight = Maths::Max(1u, (height + 1) / 2);
+			m_PyramidLevels = 0;
+			m_PyramidSize = 0;
+
+			uint32_t levelWidth = m_PyramidWidth;
+			uint32_t levelHeight = m_PyramidHeight;
+
+			while(true)
+			{
+				m_PyramidSize += levelWidth * levelHeight;
+				m_PyramidLevels++;
+
+				if(levelWidth == 1 && levelHeight == 1)
+					break;
+
+				levelWidth = Maths::Max(1u, (levelWidth + 1) / 2);
+				levelHeight = Maths::Max(1u, (levelHeight + 1) / 2);
+			}
+
+			delete m_DepthPyramidBuffer;
+			m_DepthPyramidBuffer = UniformBuffer::Create();
+			m_DepthPyramidBuffer->Init(m_PyramidSize * sizeof(float), nullptr);
+
+			m_PreviousDepthValid = false;
+			m_DescriptorsDirty = true;
+		}
+
+		void GPUScene::UpdateDescriptorSets(TextureDepth* depthTexture)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_DescriptorsDirty = false;
+
+			Graphics::BufferInfo pyramidBufferInfo = {};
+			pyramidBufferInfo.name = "DepthPyramidBuffer";
+			pyramidBufferInfo.buffer = m_DepthPyramidBuffer;
+			pyramidBufferInfo.offset = 0;
+			pyramidBufferInfo.size = m_PyramidSize * sizeof(float);
+			pyramidBufferInfo.type = Graphics::DescriptorType::STORAGE_BUFFER;
+			pyramidBufferInfo.binding = 1;
+			pyramidBufferInfo.shaderType = ShaderType::COMPUTE;
+
+			Graphics::ImageInfo depthImageInfo = {};
+			depthImageInfo.texture = depthTexture;
+			depthImageInfo.binding = 0;
+			depthImageInfo.type = TextureType::DEPTH;
+			depthImageInfo.name = "u_DepthTexture";
+
+			std::vector<Graphics::BufferInfo> pyramidBufferInfos = { pyramidBufferInfo };
+			std::vector<Graphics::ImageInfo> pyramidImageInfos = { depthImageInfo };
+			m_DepthPyramidPipeline->GetDescriptorSet()->Update(pyramidImageInfos, pyramidBufferInfos);
+
+			Graphics::BufferInfo cullUniformInfo = {};
+			cullUniformInfo.name = "CullUniforms";
+			cullUniformInfo.buffer = m_CullUniformBuffer;
+			cullUniformInfo.offset = 0;
+			cullUniformInfo.size = sizeof(CullUniforms);
+			cullUniformInfo.type = Graphics::DescriptorType::UNIFORM_BUFFER;
+			cullUniformInfo.binding = 0;
+			cullUniformInfo.shaderType = ShaderType::COMPUTE;
+
+			Graphics::BufferInfo instanceBufferInfo = cullUniformInfo;
+			instanceBufferInfo.name = "InstanceBuffer";
+			instanceBufferInfo.buffer = m_InstanceBuffer;
+			instanceBufferInfo.size = m_InstanceCapacity * sizeof(Instance);
+			instanceBufferInfo.type = Graphics::DescriptorType::STORAGE_BUFFER;
+			instanceBufferInfo.binding = 1;
+
+			Graphics::BufferInfo drawCommandBufferInfo = instanceBufferInfo;
+			drawCommandBufferInfo.name = "DrawCommandBuffer";
+			drawCommandBufferInfo.buffer = m_DrawCommandBuffer;
+			drawCommandBufferInfo.size = m_InstanceCapacity * sizeof(DrawCommand);
+			drawCommandBufferInfo.binding = 2;
+
+			Graphics::BufferInfo cullPyramidBufferInfo = pyramidBufferInfo;
+			cullPyramidBufferInfo.binding = 3;
+
+			std::vector<Graphics::BufferInfo> cullBufferInfos = { cullUniformInfo, instanceBufferInfo, drawCommandBufferInfo, cullPyramidBufferInfo };
+			m_CullPipeline->GetDescriptorSet()->Update(cullBufferInfos);
+		}
+
+		void GPUScene::Cull(CommandBuffer* commandBuffer, const Maths::Matrix4& projView, TextureDepth* depthTexture, uint32_t width, uint32_t height)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(m_GeometryDirty)
+				UploadGeometry();
+
+			UploadInstances();
+
+			if(width != m_DepthWidth || height != m_DepthHeight)
+				CreatePyramid(width, height);
+
+			if(m_DescriptorsDirty)
+				UpdateDescriptorSets(depthTexture);
+
+			if(m_Instances.empty())
+			{
+				m_PreviousProjView = projView;
+				return;
+			}
+
+			bool occlusion = m_OcclusionCulling && m_PreviousDepthValid;
+
+			CullUniforms uniforms;
+			uniforms.ProjView = projView;
+			uniforms.PreviousProjView = m_PreviousProjView;
+			uniforms.InstanceCount = uint32_t(m_Instances.size());
+			uniforms.OcclusionEnabled = occlusion ? 1 : 0;
+			uniforms.PyramidWidth = m_PyramidWidth;
+			uniforms.PyramidHeight = m_PyramidHeight;
+			uniforms.PyramidLevels = m_PyramidLevels;
+			uniforms.DepthZeroOne = Maths::Matrix4::IsDepthZeroOne() ? 1 : 0;
+			uniforms.Padding[0] = uniforms.Padding[1] = 0;
+			m_CullUniformBuffer->SetData(sizeof(CullUniforms), &uniforms);
+
+			std::vector<DescriptorSet*> descriptorSets(1);
+
+			if(occlusion)
+			{
+				LUMOS_PROFILE_SCOPE("Depth Pyramid");
+				m_DepthPyramidPipeline->Bind(commandBuffer);
+				descriptorSets[0] = m_DepthPyramidPipeline->GetDescriptorSet();
+
+				PyramidPushConstants constants;
+				constants.SourceWidth = m_DepthWidth;
+				constants.SourceHeight = m_DepthHeight;
+				constants.Width = m_PyramidWidth;
+				constants.Height = m_PyramidHeight;
+				constants.SourceOffset = 0;
+				constants.Offset = 0;
+				constants.FromDepthTexture = 1;
+				constants.Padding = 0;
+
+				for(uint32_t level = 0; level < m_PyramidLevels; level++)
+				{
+					memcpy(m_PyramidPushConstants[0].data, &constants, sizeof(PyramidPushConstants));
+					descriptorSets[0]->SetPushConstants(m_PyramidPushConstants);
+
+					Renderer::BindDescriptorSets(m_DepthPyramidPipeline.get(), commandBuffer, 0, descriptorSets);
+					Renderer::Dispatch(commandBuffer, (constants.Width + PyramidGroupSize - 1) / PyramidGroupSize, (constants.Height + PyramidGroupSize - 1) / PyramidGroupSize);
+
+					constants.SourceWidth = constants.Width;
+					constants.SourceHeight = constants.Height;
+					constants.SourceOffset = constants.Offset;
+					constants.Offset += constants.Width * constants.Height;
+					constants.Width = Maths::Max(1u, (constants.Width + 1) / 2);
+					constants.Height = Maths::Max(1u, (constants.Height + 1) / 2);
+					constants.FromDepthTexture = 0;
+				}
+			}
+
+			{
+				LUMOS_PROFILE_SCOPE("Cull Instances");
+				m_CullPipeline->Bind(commandBuffer);
+				descriptorSets[0] = m_CullPipeline->GetDescriptorSet();
+
+				Renderer::BindDescriptorSets(m_CullPipeline.get(), commandBuffer, 0, descriptorSets);
+				Renderer::Dispatch(commandBuffer, (uint32_t(m_Instances.size()) + CullGroupSize - 1) / CullGroupSize);
+			}
+
+			//The depth buffer rendered this frame is the occluder for the next one
+			m_PreviousProjView = projView;
+			m_PreviousDepthValid = true;
+		}
+
+		void GPUScene::Draw(CommandBuffer* commandBuffer, Pipeline* pipeline, DescriptorSet* sceneDescriptorSet, Material* defaultMaterial, DescriptorSet* materialTable)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(m_DrawBatches.empty() || !m_VertexBuffer || !m_IndexBuffer)
+				return;
+
+			pipeline->Bind(commandBuffer);
+			m_VertexBuffer->Bind(commandBuffer, pipeline);
+			m_IndexBuffer->Bind(commandBuffer);
+
+			m_DescriptorSets[0] = sceneDescriptorSet;
+
+			if(materialTable)
+			{
+				//Instances look their material up, so the commands of every material are one stream
+				m_DescriptorSets[1] = materialTable;
+
+				Renderer::BindDescriptorSets(pipeline, commandBuffer, 0, m_DescriptorSets);
+				Renderer::DrawIndexedIndirect(commandBuffer, DrawType::TRIANGLE, m_DrawCommandBuffer, 0, uint32_t(m_Instances.size()), sizeof(DrawCommand));
+			}
+			else
+			{
+				for(auto& batch : m_DrawBatches)
+				{
+					//Material sets were created with the regular geometry pipeline, set 1 layouts match
+					m_DescriptorSets[1] = batch.material && batch.material->GetDescriptorSet() ? batch.material->GetDescriptorSet() : defaultMaterial->GetDescriptorSet();
+
+					Renderer::BindDescriptorSets(pipeline, commandBuffer, 0, m_DescriptorSets);
+					Renderer::DrawIndexedIndirect(commandBuffer, DrawType::TRIANGLE, m_DrawCommandBuffer, batch.firstCommand * sizeof(DrawCommand), batch.commandCount, sizeof(DrawCommand));
+				}
+			}
+
+			m_VertexBuffer->Unbind();
+			m_IndexBuffer->Unbind();
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "Maths/Maths.h"
+#include "Graphics/API/DescriptorSet.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		class Mesh;
+		class Material;
+		class Pipeline;
+		class CommandBuffer;
+		class DescriptorSet;
+		class UniformBuffer;
+		class VertexBuffer;
+		class IndexBuffer;
+		class TextureDepth;
+
+		//Static meshes packed into shared vertex/index buffers and drawn with indirect draws.
+		//A compute pass culls every instance against the frustum and a depth pyramid built from last frame's depth,
+		//writing one draw command per instance so the cpu cost only grows with the number of materials.
+		class LUMOS_EXPORT GPUScene
+		{
+		public:
+			struct Instance
+			{
+				Maths::Matrix4 Transform;
+				Maths::Vector4 BoundsMin;
+				Maths::Vector4 BoundsMax;
+				uint32_t IndexCount;
+				uint32_t FirstIndex;
+				int32_t VertexOffset;
+				//Slot in the bindless material table
+				uint32_t MaterialIndex;
+			};
+
+			//Matches VkDrawIndexedIndirectCommand
+			struct DrawCommand
+			{
+				uint32_t IndexCount;
+				uint32_t InstanceCount;
+				uint32_t FirstIndex;
+				int32_t VertexOffset;
+				uint32_t FirstInstance;
+			};
+
+			GPUScene();
+			~GPUScene();
+
+			void Clear();
+			void BeginFrame();
+
+			//Returns false if the mesh has no cpu side data and has to be drawn individually
+			bool AddInstance(const Ref<Mesh>& mesh, Material* material, const Maths::Matrix4& transform, uint32_t materialIndex = 0);
+
+			//Uploads instances and records the depth pyramid and culling dispatches, call outside a renderpass
+			void Cull(CommandBuffer* commandBuffer, const Maths::Matrix4& projView, TextureDepth* depthTexture, uint32_t width, uint32_t height);
+
+			//Issues one indirect draw per material. Set 0 of the pipeline must bind GetInstanceBuffer() at binding 1.
+			//With a bindless material table as set 1 every instance is drawn by a single indirect draw
+			void Draw(CommandBuffer* commandBuffer, Pipeline* pipeline, DescriptorSet* sceneDescriptorSet, Material* defaultMaterial, DescriptorSet* materialTable = nullptr);
+
+			UniformBuffer* GetInstanceBuffer() const { return m_InstanceBuffer; }
+			uint32_t GetInstanceBufferSize() const { return m_InstanceCapacity * sizeof(Instance); }
+
+			//Set when GPU buffers were recreated and descriptor sets referencing them need updating
+			bool GetBuffersChanged() const { return m_BuffersChanged; }
+			void SetBuffersChanged(bool changed) { m_BuffersChanged = changed; }
+
+			bool& GetOcclusionCulling() { return m_OcclusionCulling; }
+			uint32_t GetInstanceCount() const { return uint32_t(m_Instances.size()); }
+			uint32_t GetBatchCount() const { return uint32_t(m_DrawBatches.size()); }
+			uint32_t GetMeshCount() const { return uint32_t(m_GeometryRanges.size()); }
+
+		private:
+			struct GeometryRange
+			{
+				uint32_t IndexCount;
+				uint32_t FirstIndex;
+				int32_t VertexOffset;
+			};
+
+			struct MaterialBatch
+			{
+				Material* material;
+				std::vector<Instance> instances;
+			};
+
+			struct DrawBatch
+			{
+				Material* material;
+				uint32_t firstCommand;
+				uint32_t commandCount;
+			};
+
+			void UploadGeometry();
+			void UploadInstances();
+			void CreatePyramid(uint32_t width, uint32_t height);
+			void UpdateDescriptorSets(TextureDepth* depthTexture);
+
+			//Geometry pool
+			std::unordered_map<Mesh*, GeometryRange> m_GeometryRanges;
+			std::vector<Ref<Mesh>> m_PooledMeshes;
+			std::vector<uint8_t> m_VertexData;
+			std::vector<uint32_t> m_IndexData;
+			Ref<VertexBuffer> m_VertexBuffer;
+			Ref<IndexBuffer> m_IndexBuffer;
+			bool m_GeometryDirty = false;
+
+			//Instances grouped by material, batches are kept between frames
+			std::unordered_map<Material*, uint32_t> m_MaterialBatchLookup;
+			std::vector<MaterialBatch> m_MaterialBatches;
+			std::vector<Instance> m_Instances;
+			std::vector<DrawBatch> m_DrawBatches;
+
+			UniformBuffer* m_InstanceBuffer = nullptr;
+			UniformBuffer* m_DrawCommandBuffer = nullptr;
+			UniformBuffer* m_CullUniformBuffer = nullptr;
+			UniformBuffer* m_DepthPyramidBuffer = nullptr;
+			uint32_t m_InstanceCapacity = 0;
+
+			Ref<Pipeline> m_CullPipeline;
+			Ref<Pipeline> m_DepthPyramidPipeline;
+			std::vector<PushConstant> m_PyramidPushConstants;
+			std::vector<DescriptorSet*> m_DescriptorSets;
+
+			uint32_t m_PyramidWidth = 0;
+			uint32_t m_PyramidHeight = 0;
+			uint32_t m_PyramidLevels = 0;
+			uint32_t m_PyramidSize = 0;
+			uint32_t m_DepthWidth = 0;
+			uint32_t m_DepthHeight = 0;
+
+			Maths::Matrix4 m_PreviousProjView;
+			bool m_PreviousDepthValid = false;
+			bool m_OcclusionCulling = true;
+			bool m_BuffersChanged = true;
+			bool m_DescriptorsDirty = true;
+		};
+	}
+}
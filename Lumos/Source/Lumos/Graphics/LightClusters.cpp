@@ -0,0 +1,202 @@
+#include "Precompiled.h"
+#include "LightClusters.h"
+#include "Light.h"
+#include "Core/JobSystem.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		LightClusters::LightClusters()
+		{
+			m_Clusters.resize(ClusterCount);
+			m_LightIndices.resize(MaxLightIndices);
+			m_SliceIndices.resize(ClusterCountZ);
+		}
+
+		uint32_t LightClusters::GetSlice(float viewDepth) const
+		{
+			float slice = logf(Maths::Max(viewDepth, Maths::M_EPSILON)) * m_DepthParams.x + m_DepthParams.y;
+			return static_cast<uint32_t>(Maths::Clamp(slice, 0.0f, float(ClusterCountZ - 1)));
+		}
+
+		void LightClusters::Build(const Light* lights, uint32_t lightCount, uint32_t firstLocalLight, const Maths::Matrix4& view, const Maths::Matrix4& projection, float nearPlane, float farPlane)
+		{
+			LUMOS_PROFILE_FUNCTION();
+
+			nearPlane = Maths::Max(nearPlane, Maths::M_EPSILON);
+			farPlane = Maths::Max(farPlane, nearPlane + Maths::M_EPSILON);
+
+			float logRatio = logf(farPlane / nearPlane);
+			m_DepthParams.x = float(ClusterCountZ) / logRatio;
+			m_DepthParams.y = -float(ClusterCountZ) * logf(nearPlane) / logRatio;
+			m_DepthParams.z = nearPlane;
+			m_DepthParams.w = farPlane;
+
+			m_LightBounds.resize(lightCount);
+
+			const uint32_t localLightCount = lightCount > firstLocalLight ? lightCount - firstLocalLight : 0;
+
+			//Cluster ranges covered by each light's bounding sphere
+			auto computeBounds = [&](uint32_t index)
+			{
+				const Light& light = lights[index];
+				LightBounds& bounds = m_LightBounds[index];
+				bounds.Visible = false;
+
+				Maths::Vector3 centre = view * light.Position.ToVector3();
+				float radius = light.Radius;
+				float depth = -centre.z;
+
+				if(depth + radius < nearPlane || depth - radius > farPlane)
+					return;
+
+				float minDepth = Maths::Max(depth - radius, nearPlane);
+				float maxDepth = Maths::Min(depth + radius, farPlane);
+
+				Maths::Vector2 ndcMin(1.0f, 1.0f);
+				Maths::Vector2 ndcMax(-1.0f, -1.0f);
+
+				for(uint32_t corner = 0; corner < 8; corner++)
+				{
+					Maths::Vector4 viewCorner(
+						centre.x + ((corner & 1) ? radius : -radius),
+						centre.y + ((corner & 2) ? radius : -radius),
+						(corner & 4) ? -maxDepth : -minDepth,
+						1.0f);
+
+					Maths::Vector4 clip = projection * viewCorner;
+					float invW = 1.0f / Maths::Max(clip.w, Maths::M_EPSILON);
+
+					ndcMin.x = Maths::Min(ndcMin.x, clip.x * invW);
+					ndcMin.y = Maths::Min(ndcMin.y, clip.y * invW);
+					ndcMax.x = Maths::Max(ndcMax.x, clip.x * invW);
+					ndcMax.y = Maths::Max(ndcMax.y, clip.y * invW);
+				}
+
+				if(ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+					return;
+
+				auto toTile = [](float ndc, uint32_t count)
+				{
+					float tile = (ndc * 0.5f + 0.5f) * float(count);
+					return static_cast<uint32_t>(Maths::Clamp(tile, 0.0f, float(count - 1)));
+				};
+
+				bounds.MinX = toTile(ndcMin.x, ClusterCountX);
+				bounds.MaxX = toTile(ndcMax.x, ClusterCountX);
+				bounds.MinY = toTile(ndcMin.y, ClusterCountY);
+				bounds.MaxY = toTile(ndcMax.y, ClusterCountY);
+				bounds.MinZ = GetSlice(minDepth);
+				bounds.MaxZ = GetSlice(maxDepth);
+				bounds.Visible = true;
+			};
+
+			const uint32_t boundsGroupSize = 64;
+			if(localLightCount > boundsGroupSize)
+			{
+				System::JobSystem::Dispatch(localLightCount, boundsGroupSize, [&](JobDispatchArgs args)
+				{
+					computeBounds(firstLocalLight + args.jobIndex);
+				});
+				System::JobSystem::Wait();
+			}
+			else
+			{
+				for(uint32_t i = firstLocalLight; i < lightCount; i++)
+					computeBounds(i);
+			}
+
+			//Each depth slice fills its own clusters and index list
+			const uint32_t clustersPerSlice = ClusterCountX * ClusterCountY;
+
+			auto buildSlice = [&](uint32_t slice)
+			{
+				Cluster* clusters = &m_Clusters[slice * clustersPerSlice];
+				std::vector<uint32_t>& indices = m_SliceIndices[slice];
+				indices.clear();
+
+				for(uint32_t i = 0; i < clustersPerSlice; i++)
+					clusters[i].Count = 0;
+
+				for(uint32_t i = firstLocalLight; i < lightCount; i++)
+				{
+					const LightBounds& bounds = m_LightBounds[i];
+					if(!bounds.Visible || slice < bounds.MinZ || slice > bounds.MaxZ)
+						continue;
+
+					for(uint32_t y = bounds.MinY; y <= bounds.MaxY; y++)
+						for(uint32_t x = bounds.MinX; x <= bounds.MaxX; x++)
+							clusters[y * ClusterCountX + x].Count++;
+				}
+
+				uint32_t offset = 0;
+				for(uint32_t i = 0; i < clustersPerSlice; i++)
+				{
+					clusters[i].Offset = offset;
+					offset += clusters[i].Count;
+					clusters[i].Count = 0;
+				}
+
+				indices.resize(offset);
+
+				for(uint32_t i = firstLocalLight; i < lightCount; i++)
+				{
+					const LightBounds& bounds = m_LightBounds[i];
+					if(!bounds.Visible || slice < bounds.MinZ || slice > bounds.MaxZ)
+						continue;
+
+					for(uint32_t y = bounds.MinY; y <= bounds.MaxY; y++)
+					{
+						for(uint32_t x = bounds.MinX; x <= bounds.MaxX; x++)
+						{
+							Cluster& cluster = clusters[y * ClusterCountX + x];
+							indices[cluster.Offset + cluster.Count++] = i;
+						}
+					}
+				}
+			};
+
+			if(localLightCount > 0)
+			{
+				System::JobSystem::Dispatch(ClusterCountZ, 1, [&](JobDispatchArgs args)
+				{
+					buildSlice(args.jobIndex);
+				});
+				System::JobSystem::Wait();
+			}
+			else
+			{
+				for(auto& cluster : m_Clusters)
+					cluster = {0, 0};
+
+				m_LightIndexCount = 0;
+				return;
+			}
+
+			//Concatenate the slice lists, clusters past the index budget are truncated
+			uint32_t base = 0;
+			for(uint32_t slice = 0; slice < ClusterCountZ; slice++)
+			{
+				const auto& indices = m_SliceIndices[slice];
+				uint32_t count = Maths::Min(static_cast<uint32_t>(indices.size()), MaxLightIndices - base);
+
+				if(count > 0)
+					memcpy(&m_LightIndices[base], indices.data(), count * sizeof(uint32_t));
+
+				Cluster* clusters = &m_Clusters[slice * clustersPerSlice];
+				for(uint32_t i = 0; i < clustersPerSlice; i++)
+				{
+					uint32_t start = Maths::Min(clusters[i].Offset, count);
+					uint32_t end = Maths::Min(clusters[i].Offset + clusters[i].Count, count);
+					clusters[i].Offset = base + start;
+					clusters[i].Count = end - start;
+				}
+
+				base += count;
+			}
+
+			m_LightIndexCount = base;
+		}
+	}
+}
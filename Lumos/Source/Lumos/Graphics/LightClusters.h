@@ -0,0 +1,59 @@
+#pragma once
+#include "Maths/Maths.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		struct Light;
+
+		//Assigns point and spot lights to a froxel grid (screen tiles x exponential depth slices).
+		//Each cluster stores an offset and count into a shared light index list, built on the cpu using the job system.
+		class LUMOS_EXPORT LightClusters
+		{
+		public:
+			static const uint32_t ClusterCountX = 16;
+			static const uint32_t ClusterCountY = 9;
+			static const uint32_t ClusterCountZ = 24;
+			static const uint32_t ClusterCount = ClusterCountX * ClusterCountY * ClusterCountZ;
+			static const uint32_t MaxLightIndices = ClusterCount * 64;
+
+			struct Cluster
+			{
+				uint32_t Offset;
+				uint32_t Count;
+			};
+
+			LightClusters();
+			~LightClusters() = default;
+
+			//lights [firstLocalLight, lightCount) are assigned, earlier lights are treated as directional
+			void Build(const Light* lights, uint32_t lightCount, uint32_t firstLocalLight, const Maths::Matrix4& view, const Maths::Matrix4& projection, float nearPlane, float farPlane);
+
+			const Cluster* GetClusters() const { return m_Clusters.data(); }
+			const uint32_t* GetLightIndices() const { return m_LightIndices.data(); }
+			uint32_t GetLightIndexCount() const { return m_LightIndexCount; }
+
+			//Slice = floor(log(viewDepth) * scale + bias)
+			const Maths::Vector4& GetDepthParams() const { return m_DepthParams; }
+
+		private:
+			struct LightBounds
+			{
+				uint32_t MinX, MaxX;
+				uint32_t MinY, MaxY;
+				uint32_t MinZ, MaxZ;
+				bool Visible;
+			};
+
+			uint32_t GetSlice(float viewDepth) const;
+
+			std::vector<Cluster> m_Clusters;
+			std::vector<uint32_t> m_LightIndices;
+			std::vector<LightBounds> m_LightBounds;
+			std::vector<std::vector<uint32_t>> m_SliceIndices;
+			uint32_t m_LightIndexCount = 0;
+			Maths::Vector4 m_DepthParams;
+		};
+	}
+}
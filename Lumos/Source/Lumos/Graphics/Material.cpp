@@ -149,8 +149,8 @@ namespace Lumos::Graphics
 
 	void Material::CreateDescriptorSet(Graphics::Pipeline* pipeline, int layoutID, bool pbr)
 	{
-		if(m_DescriptorSet)
-			delete m_DescriptorSet;
+		//Released once the new set is written, so unchanged bindings are matched to the set already made for them
+		Graphics::DescriptorSet* previousSet = m_DescriptorSet;
 
 		m_Pipeline = pipeline;
 
@@ -298,6 +298,8 @@ namespace Lumos::Graphics
 		}
 
 		m_DescriptorSet->Update(imageInfos, bufferInfos);
+
+		delete previousSet;
 	}
 
 	void Material::InitDefaultTexture()
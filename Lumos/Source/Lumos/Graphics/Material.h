@@ -137,6 +137,7 @@ namespace Lumos
 
 			static void InitDefaultTexture();
 			static void ReleaseDefaultTexture();
+			static Texture2D* GetDefaultTexture() { return s_DefaultTexture.get(); }
 
 			template<typename Archive>
 			void save(Archive& archive) const
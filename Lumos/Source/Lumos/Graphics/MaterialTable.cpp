@@ -0,0 +1,148 @@
+#include "Precompiled.h"
+#include "MaterialTable.h"
+#include "Material.h"
+
+#include "Graphics/API/Pipeline.h"
+#include "Graphics/API/DescriptorSet.h"
+#include "Graphics/API/UniformBuffer.h"
+#include "Graphics/API/Texture.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		static const uint32_t MinMaterialCapacity = 64;
+
+		MaterialTable::MaterialTable()
+		{
+			m_Materials.reserve(MinMaterialCapacity);
+			m_Textures.reserve(MAX_BINDLESS_TEXTURES);
+		}
+
+		MaterialTable::~MaterialTable()
+		{
+			delete m_DescriptorSet;
+			delete m_MaterialBuffer;
+		}
+
+		void MaterialTable::BeginFrame()
+		{
+			m_MaterialLookup.clear();
+			m_TextureLookup.clear();
+			m_Materials.clear();
+			m_Textures.clear();
+
+			//Slot 0 is sampled by every material without a map
+			AddTexture(Material::GetDefaultTexture());
+		}
+
+		uint32_t MaterialTable::AddMaterial(Material* material)
+		{
+			auto it = m_MaterialLookup.find(material);
+			if(it != m_MaterialLookup.end())
+				return it->second;
+
+			const auto& textures = material->GetTextures();
+			const MaterialProperties* properties = material->GetProperties();
+
+			//Maps a material doesn't have fall back to its colours, as in Material::CreateDescriptorSet
+			GPUMaterial gpuMaterial = {};
+			gpuMaterial.AlbedoColour = properties->albedoColour;
+			gpuMaterial.RoughnessColour = properties->roughnessColour;
+			gpuMaterial.MetallicColour = properties->metallicColour;
+			gpuMaterial.EmissiveColour = properties->emissiveColour;
+			gpuMaterial.UsingAlbedoMap = textures.albedo ? properties->usingAlbedoMap : 0.0f;
+			gpuMaterial.UsingMetallicMap = textures.metallic ? properties->usingMetallicMap : 0.0f;
+			gpuMaterial.UsingRoughnessMap = textures.roughness ? properties->usingRoughnessMap : 0.0f;
+			gpuMaterial.UsingNormalMap = textures.normal ? properties->usingNormalMap : 0.0f;
+			gpuMaterial.UsingAOMap = textures.ao ? properties->usingAOMap : 0.0f;
+			gpuMaterial.UsingEmissiveMap = textures.emissive ? properties->usingEmissiveMap : 0.0f;
+			gpuMaterial.Workflow = properties->workflow;
+			gpuMaterial.TextureIndices[0] = AddTexture(textures.albedo.get());
+			gpuMaterial.TextureIndices[1] = AddTexture(textures.metallic.get());
+			gpuMaterial.TextureIndices[2] = AddTexture(textures.roughness.get());
+			gpuMaterial.TextureIndices[3] = AddTexture(textures.normal.get());
+			gpuMaterial.TextureIndices[4] = AddTexture(textures.ao.get());
+			gpuMaterial.TextureIndices[5] = AddTexture(textures.emissive.get());
+
+			const uint32_t index = uint32_t(m_Materials.size());
+			m_Materials.push_back(gpuMaterial);
+			m_MaterialLookup.emplace(material, index);
+			return index;
+		}
+
+		uint32_t MaterialTable::AddTexture(Texture2D* texture)
+		{
+			if(!texture)
+				return 0;
+
+			auto it = m_TextureLookup.find(texture);
+			if(it != m_TextureLookup.end())
+				return it->second;
+
+			//Past the end of the array the map is replaced by the default texture
+			if(m_Textures.size() >= MAX_BINDLESS_TEXTURES)
+				return 0;
+
+			const uint32_t index = uint32_t(m_Textures.size());
+			m_Textures.push_back(texture);
+			m_TextureLookup.emplace(texture, index);
+			return index;
+		}
+
+		void MaterialTable::Upload(Pipeline* pipeline)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(m_Materials.empty())
+				return;
+
+			if(m_Materials.size() > m_MaterialCapacity || !m_MaterialBuffer)
+			{
+				m_MaterialCapacity = Maths::Max(MinMaterialCapacity, m_MaterialCapacity);
+				while(m_MaterialCapacity < m_Materials.size())
+					m_MaterialCapacity *= 2;
+
+				delete m_MaterialBuffer;
+				m_MaterialBuffer = UniformBuffer::Create();
+				m_MaterialBuffer->Init(m_MaterialCapacity * sizeof(GPUMaterial), nullptr);
+			}
+
+			m_MaterialBuffer->SetData(uint32_t(m_Materials.size() * sizeof(GPUMaterial)), m_Materials.data());
+
+			if(pipeline != m_Pipeline)
+			{
+				delete m_DescriptorSet;
+
+				DescriptorInfo info{};
+				info.pipeline = pipeline;
+				info.layoutIndex = 1;
+				info.shader = pipeline->GetShader();
+				m_DescriptorSet = DescriptorSet::Create(info);
+				m_Pipeline = pipeline;
+			}
+
+			//Entries past the texture count are left unwritten, the array is partially bound
+			ImageInfo imageInfo = {};
+			imageInfo.textures = m_Textures.data();
+			imageInfo.texture = m_Textures[0];
+			imageInfo.count = int(m_Textures.size());
+			imageInfo.binding = 0;
+			imageInfo.name = "u_Textures";
+			imageInfo.type = TextureType::COLOUR;
+
+			BufferInfo bufferInfo = {};
+			bufferInfo.buffer = m_MaterialBuffer;
+			bufferInfo.offset = 0;
+			bufferInfo.size = m_MaterialCapacity * sizeof(GPUMaterial);
+			bufferInfo.type = DescriptorType::STORAGE_BUFFER;
+			bufferInfo.binding = 1;
+			bufferInfo.shaderType = ShaderType::FRAGMENT;
+			bufferInfo.name = "MaterialBuffer";
+
+			//Unchanged textures and buffer write nothing, the set cache matches them to what is already bound
+			std::vector<ImageInfo> imageInfos = { imageInfo };
+			std::vector<BufferInfo> bufferInfos = { bufferInfo };
+			m_DescriptorSet->Update(imageInfos, bufferInfos);
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Maths/Maths.h"
+
+#define MAX_BINDLESS_TEXTURES 1024
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		class Material;
+		class Pipeline;
+		class DescriptorSet;
+		class UniformBuffer;
+		class Texture;
+		class Texture2D;
+
+		//Every material drawn in a frame packed into one storage buffer, with all of their textures in one array.
+		//Bindless pipelines bind it once as set 1 and pick the material with an index per draw or per instance,
+		//so draws of different materials no longer need their own descriptor sets. Requires SupportsBindless
+		class LUMOS_EXPORT MaterialTable
+		{
+		public:
+			//std430 layout of Material in DeferredColourBindless.frag
+			struct GPUMaterial
+			{
+				Maths::Vector4 AlbedoColour;
+				Maths::Vector4 RoughnessColour;
+				Maths::Vector4 MetallicColour;
+				Maths::Vector4 EmissiveColour;
+				float UsingAlbedoMap;
+				float UsingMetallicMap;
+				float UsingRoughnessMap;
+				float UsingNormalMap;
+				float UsingAOMap;
+				float UsingEmissiveMap;
+				float Workflow;
+				float Padding;
+				//Albedo, metallic, roughness, normal, ao, emissive
+				uint32_t TextureIndices[8];
+			};
+
+			MaterialTable();
+			~MaterialTable();
+
+			void BeginFrame();
+
+			//Returns the material's index for this frame
+			uint32_t AddMaterial(Material* material);
+
+			//Writes the materials added this frame. The descriptor set is made for set 1 of the pipeline
+			void Upload(Pipeline* pipeline);
+
+			DescriptorSet* GetDescriptorSet() const { return m_DescriptorSet; }
+			uint32_t GetMaterialCount() const { return uint32_t(m_Materials.size()); }
+			uint32_t GetTextureCount() const { return uint32_t(m_Textures.size()); }
+
+		private:
+			uint32_t AddTexture(Texture2D* texture);
+
+			std::unordered_map<Material*, uint32_t> m_MaterialLookup;
+			std::unordered_map<Texture*, uint32_t> m_TextureLookup;
+			std::vector<GPUMaterial> m_Materials;
+			std::vector<Texture*> m_Textures;
+
+			UniformBuffer* m_MaterialBuffer = nullptr;
+			uint32_t m_MaterialCapacity = 0;
+			DescriptorSet* m_DescriptorSet = nullptr;
+			Pipeline* m_Pipeline = nullptr;
+		};
+	}
+}
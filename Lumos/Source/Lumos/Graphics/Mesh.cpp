@@ -13,9 +13,11 @@ namespace Lumos
 		}
 
 		Mesh::Mesh(const Mesh& mesh)
-            : m_VertexBuffer(mesh.m_VertexBuffer), m_IndexBuffer(mesh.m_IndexBuffer), m_BoundingBox(mesh.m_BoundingBox), m_Name(mesh.m_Name), m_Material(mesh.m_Material)
-			, m_Indices(mesh.m_Indices), m_Vertices(mesh.m_Vertices)
+            : m_VertexBuffer(mesh.m_VertexBuffer), m_IndexBuffer(mesh.m_IndexBuffer), m_LODIndexBuffers(mesh.m_LODIndexBuffers), m_BoundingBox(mesh.m_BoundingBox), m_Name(mesh.m_Name), m_Material(mesh.m_Material)
+			, m_Indices(mesh.m_Indices), m_Vertices(mesh.m_Vertices), m_Skinned(mesh.m_Skinned)
 		{
+			for(uint32_t i = 0; i < MaxLODCount; i++)
+				m_LODScreenSizes[i] = mesh.m_LODScreenSizes[i];
 		}
 		
 		Mesh::Mesh(Ref<VertexBuffer>& vertexBuffer, Ref<IndexBuffer>& indexBuffer, const Ref<Maths::BoundingBox>& boundingBox)
@@ -23,34 +25,68 @@ namespace Lumos
 		{
 		}
 
+		//Fraction of the base level's indices targeted by each LOD
+		static const float LODIndexRatios[Mesh::MaxLODCount] = { 1.0f, 0.5f, 0.25f, 0.1f };
+
 		Mesh::Mesh(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float optimiseThreshold)
         {
 			m_Indices = indices;
 			m_Vertices = vertices;
-            
-            //int lod = 2;
-            //float threshold = powf(0.7f, float(lod));
 
             size_t indexCount = indices.size();
-            size_t target_index_count = size_t( indices.size() * optimiseThreshold );
+            size_t originalVertexCount = vertices.size();
+
+            //Weld identical vertices so the simplifier can collapse edges across them
+            std::vector<uint32_t> remap(m_Vertices.size());
+            size_t vertexCount = meshopt_generateVertexRemap(remap.data(), m_Indices.data(), indexCount, m_Vertices.data(), m_Vertices.size(), sizeof(Graphics::Vertex));
+            meshopt_remapIndexBuffer(m_Indices.data(), m_Indices.data(), indexCount, remap.data());
+            meshopt_remapVertexBuffer(m_Vertices.data(), m_Vertices.data(), m_Vertices.size(), sizeof(Graphics::Vertex), remap.data());
+            m_Vertices.resize(vertexCount);
+
+            if(optimiseThreshold < 1.0f)
+            {
+                size_t target_index_count = size_t( indexCount * optimiseThreshold );
+                float target_error = 1e-3f;
+                m_Indices.resize(meshopt_simplify(m_Indices.data(), m_Indices.data(), indexCount, (const float*)(&m_Vertices[0]), vertexCount, sizeof(Graphics::Vertex), target_index_count, target_error, nullptr));
+            }
+
+            meshopt_optimizeVertexCache(m_Indices.data(), m_Indices.data(), m_Indices.size(), vertexCount);
+
+            std::vector<std::vector<uint32_t>> lodIndices;
+
+            for(uint32_t lod = 1; lod < MaxLODCount; lod++)
+            {
+                size_t target_index_count = size_t( m_Indices.size() * LODIndexRatios[lod] ) / 3 * 3;
+                float target_error = 1e-2f;
+
+                std::vector<uint32_t> simplified(m_Indices.size());
+                size_t lodIndexCount = meshopt_simplify(simplified.data(), m_Indices.data(), m_Indices.size(), (const float*)(&m_Vertices[0]), vertexCount, sizeof(Graphics::Vertex), target_index_count, target_error, nullptr);
+
+                //Stop once the simplifier can't remove a meaningful amount of detail
+                size_t previousIndexCount = lodIndices.empty() ? m_Indices.size() : lodIndices.back().size();
+                if(lodIndexCount == 0 || lodIndexCount > previousIndexCount * 0.8f)
+                    break;
+
+                simplified.resize(lodIndexCount);
+                meshopt_optimizeVertexCache(simplified.data(), simplified.data(), lodIndexCount, vertexCount);
+                lodIndices.push_back(std::move(simplified));
+            }
+
+            //Vertex fetch order follows the base level, LODs only reference a subset of its vertices
+            std::vector<uint32_t> fetchRemap(vertexCount);
+            size_t newVertexCount = meshopt_optimizeVertexFetchRemap(fetchRemap.data(), m_Indices.data(), m_Indices.size(), vertexCount);
+            meshopt_remapIndexBuffer(m_Indices.data(), m_Indices.data(), m_Indices.size(), fetchRemap.data());
+            meshopt_remapVertexBuffer(m_Vertices.data(), m_Vertices.data(), vertexCount, sizeof(Graphics::Vertex), fetchRemap.data());
+            m_Vertices.resize(newVertexCount);
+
+            for(auto& lod : lodIndices)
+            {
+                meshopt_remapIndexBuffer(lod.data(), lod.data(), lod.size(), fetchRemap.data());
+                m_LODIndexBuffers.emplace_back(Graphics::IndexBuffer::Create(lod.data(), (uint32_t)lod.size()));
+            }
+
+            LUMOS_LOG_INFO("Mesh Optimizer - Before : {0} indices {1} vertices , After : {2} indices , {3} vertices, {4} LODs", indexCount, originalVertexCount, m_Indices.size(), newVertexCount, GetLODCount());
 
-            float target_error = 1e-3f;
-            float* resultError = nullptr;
-            
-            auto newIndexCount = meshopt_simplify(m_Indices.data(), m_Indices.data(), m_Indices.size(), (const float*)(&m_Vertices[0]), m_Vertices.size(), sizeof(Graphics::Vertex), target_index_count, target_error, resultError);
-            
-            auto newVertexCount = meshopt_optimizeVertexFetch( // return vertices (not vertex attribute values)
-                                                           (m_Vertices.data()),
-                                                               (unsigned int*)(m_Indices.data()),
-                                                           newIndexCount, // total new indices (not faces)
-                                                           (m_Vertices.data()),
-                                                           (size_t)m_Vertices.size(), // total vertices (not vertex attribute values)
-                                                           sizeof(Graphics::Vertex) // vertex stride
-                                                               );
-            
-            LUMOS_LOG_INFO("Mesh Optimizer - Before : {0} indices {1} vertices , After : {2} indices , {3} vertices", indexCount, m_Vertices.size(), newIndexCount, newVertexCount);
-            
-            
             m_BoundingBox = CreateRef<Maths::BoundingBox>();
             
             for(auto& vertex : m_Vertices)
@@ -58,12 +94,66 @@ namespace Lumos
                 m_BoundingBox->Merge(vertex.Position);
             }
 			
-			m_IndexBuffer = Ref<Graphics::IndexBuffer>(Graphics::IndexBuffer::Create(m_Indices.data(), (uint32_t)newIndexCount));
+			m_IndexBuffer = Ref<Graphics::IndexBuffer>(Graphics::IndexBuffer::Create(m_Indices.data(), (uint32_t)m_Indices.size()));
 			
 			m_VertexBuffer = Ref<VertexBuffer>(VertexBuffer::Create(BufferUsage::STATIC));
             m_VertexBuffer->SetData((uint32_t)(sizeof(Graphics::Vertex) * newVertexCount), m_Vertices.data());
 		}
 
+		Mesh::Mesh(const std::vector<uint32_t>& indices, const std::vector<AnimVertex>& vertices)
+		{
+			m_Skinned = true;
+			m_Indices = indices;
+
+			std::vector<AnimVertex> animVertices = vertices;
+			meshopt_optimizeVertexCache(m_Indices.data(), m_Indices.data(), m_Indices.size(), animVertices.size());
+
+			std::vector<uint32_t> fetchRemap(animVertices.size());
+			size_t vertexCount = meshopt_optimizeVertexFetchRemap(fetchRemap.data(), m_Indices.data(), m_Indices.size(), animVertices.size());
+			meshopt_remapIndexBuffer(m_Indices.data(), m_Indices.data(), m_Indices.size(), fetchRemap.data());
+			meshopt_remapVertexBuffer(animVertices.data(), animVertices.data(), animVertices.size(), sizeof(AnimVertex), fetchRemap.data());
+			animVertices.resize(vertexCount);
+
+			//Bounds come from the bind pose
+			m_BoundingBox = CreateRef<Maths::BoundingBox>();
+			m_Vertices.reserve(vertexCount);
+			for(auto& vertex : animVertices)
+			{
+				m_BoundingBox->Merge(vertex.Position);
+				m_Vertices.push_back(vertex);
+			}
+
+			m_IndexBuffer = Ref<Graphics::IndexBuffer>(Graphics::IndexBuffer::Create(m_Indices.data(), (uint32_t)m_Indices.size()));
+
+			m_VertexBuffer = Ref<VertexBuffer>(VertexBuffer::Create(BufferUsage::STATIC));
+			m_VertexBuffer->SetData((uint32_t)(sizeof(AnimVertex) * vertexCount), animVertices.data());
+		}
+
+		uint32_t Mesh::SelectLOD(float screenSize, uint32_t bias) const
+		{
+			uint32_t lodCount = GetLODCount();
+			uint32_t lod = 0;
+
+			while(lod + 1 < lodCount && screenSize < m_LODScreenSizes[lod + 1])
+				lod++;
+
+			return Maths::Min(lod + bias, lodCount - 1);
+		}
+
+		float Mesh::GetProjectedScreenSize(const Maths::BoundingBox& worldBounds, const Maths::Vector3& cameraPosition, const Maths::Matrix4& projection)
+		{
+			//Bounding sphere diameter as a fraction of the screen height
+			float radius = worldBounds.Size().Length() * 0.5f;
+			float scale = Maths::Abs(projection.m11_);
+
+			//Orthographic projections don't shrink with distance
+			if(projection.m33_ == 1.0f)
+				return radius * scale;
+
+			float distance = Maths::Max((worldBounds.Center() - cameraPosition).Length() - radius, Maths::M_EPSILON);
+			return Maths::Min(radius * scale / distance, 1.0f);
+		}
+
 		Mesh::~Mesh()
 		{
 		}
@@ -45,27 +45,57 @@ namespace Lumos
 			}
 		};
 
+		//Vertex layout used by DeferredColourAnim, up to four joints per vertex
+		struct LUMOS_EXPORT AnimVertex : public Vertex
+		{
+			AnimVertex()
+				: BoneIndices(0, 0, 0, 0)
+				, BoneWeights(1.0f, 0.0f, 0.0f, 0.0f)
+			{
+			}
+
+			Maths::IntVector4 BoneIndices;
+			Maths::Vector4 BoneWeights;
+		};
+
 		class LUMOS_EXPORT Mesh
 		{
 		public:
+			static const uint32_t MaxLODCount = 4;
 
 			Mesh();
 			Mesh(const Mesh& mesh);
-			Mesh(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float optimiseThreshold = 0.9f);
+			//Generates a LOD chain, optimiseThreshold < 1 also simplifies the base level
+			Mesh(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float optimiseThreshold = 1.0f);
+			//Skinned mesh, only optimised for the vertex cache since simplifying would break joint weights
+			Mesh(const std::vector<uint32_t>& indices, const std::vector<AnimVertex>& vertices);
 			Mesh(Ref<VertexBuffer>& vertexBuffer, Ref<IndexBuffer>& indexBuffer, const Ref<Maths::BoundingBox>& boundingBox);
 			
 			virtual ~Mesh();
 
 			const Ref<VertexBuffer>& GetVertexBuffer() const { return m_VertexBuffer; }
 			const Ref<IndexBuffer>& GetIndexBuffer() const { return m_IndexBuffer; }
+			const Ref<IndexBuffer>& GetIndexBuffer(uint32_t lod) const { return lod == 0 || m_LODIndexBuffers.empty() ? m_IndexBuffer : m_LODIndexBuffers[Maths::Min(lod, uint32_t(m_LODIndexBuffers.size())) - 1]; }
+			uint32_t GetLODCount() const { return 1 + uint32_t(m_LODIndexBuffers.size()); }
 			const Ref<Material>& GetMaterial() const { return m_Material; }
 			const Ref<Maths::BoundingBox>& GetBoundingBox() const { return m_BoundingBox; }
+			//Only kept for meshes created from vertex/index lists
+			const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
+			const std::vector<Vertex>& GetVertices() const { return m_Vertices; }
 
 			void SetMaterial(const Ref<Material>& material) { m_Material = material; }
+			bool IsSkinned() const { return m_Skinned; }
 
 			bool& GetActive() { return m_Active; }
 			void SetName(const std::string& name) { m_Name = name; }
 
+			//LOD i is used once the projected size drops below its screen size (fraction of screen height)
+			void SetLODScreenSize(uint32_t lod, float screenSize) { if(lod < MaxLODCount) m_LODScreenSizes[lod] = screenSize; }
+			float GetLODScreenSize(uint32_t lod) const { return m_LODScreenSizes[Maths::Min(lod, MaxLODCount - 1)]; }
+
+			uint32_t SelectLOD(float screenSize, uint32_t bias = 0) const;
+			static float GetProjectedScreenSize(const Maths::BoundingBox& worldBounds, const Maths::Vector3& cameraPosition, const Maths::Matrix4& projection);
+
 		protected:
 
 			static Maths::Vector3 GenerateTangent(const Maths::Vector3 &a, const Maths::Vector3 &b, const Maths::Vector3 &c, const Maths::Vector2 &ta, const Maths::Vector2 &tb, const Maths::Vector2 &tc);
@@ -74,12 +104,15 @@ namespace Lumos
 
 			Ref<VertexBuffer> m_VertexBuffer;
 			Ref<IndexBuffer> m_IndexBuffer;
+			std::vector<Ref<IndexBuffer>> m_LODIndexBuffers;
+			float m_LODScreenSizes[MaxLODCount] = { 1.0f, 0.5f, 0.25f, 0.1f };
 			Ref<Material> m_Material;
 			Ref<Maths::BoundingBox> m_BoundingBox;
 
 			std::string m_Name;
 			
 			bool m_Active = true;
+			bool m_Skinned = false;
             std::vector<uint32_t> m_Indices;
 			std::vector<Vertex> m_Vertices;
 		};
@@ -3,6 +3,8 @@
 #include "MeshFactory.h"
 #include "Mesh.h"
 #include "Material.h"
+#include "Animation/Skeleton.h"
+#include "Animation/AnimationClip.h"
 #include "Core/VFS.h"
 #include <cereal/cereal.hpp>
 
@@ -24,6 +26,11 @@ namespace Lumos
             const std::vector<Ref<Mesh>>& GetMeshes() const { return m_Meshes; }
             void AddMesh(Ref<Mesh> mesh) { m_Meshes.push_back(mesh); }
 
+            const Ref<Skeleton>& GetSkeleton() const { return m_Skeleton; }
+            void SetSkeleton(const Ref<Skeleton>& skeleton) { m_Skeleton = skeleton; }
+            const std::vector<Ref<AnimationClip>>& GetAnimations() const { return m_Animations; }
+            void AddAnimation(const Ref<AnimationClip>& animation) { m_Animations.push_back(animation); }
+
             template<typename Archive>
             void save(Archive& archive) const
             {
@@ -46,6 +53,8 @@ namespace Lumos
                 archive(cereal::make_nvp("PrimitiveType", m_PrimitiveType), cereal::make_nvp("FilePath", m_FilePath), cereal::make_nvp("Material", material));
                 
                 m_Meshes.clear();
+                m_Skeleton = nullptr;
+                m_Animations.clear();
                 
                 if(m_PrimitiveType != PrimitiveType::File)
                 {	
@@ -67,6 +76,8 @@ namespace Lumos
             PrimitiveType m_PrimitiveType;
             std::vector<Ref<Mesh>> m_Meshes;
             std::string m_FilePath;
+            Ref<Skeleton> m_Skeleton;
+            std::vector<Ref<AnimationClip>> m_Animations;
 
             void LoadOBJ(const std::string& path);
 		    void LoadGLTF(const std::string& path);
@@ -133,6 +133,182 @@ namespace Lumos::Graphics
 		return Maths::Quaternion(float(quat.x), float(quat.y), float(quat.z), float(quat.w));
 	}
 	
+	//ofbx matrices are column major
+	Maths::Matrix4 ToLumosMatrix(const ofbx::Matrix& matrix)
+	{
+		float data[16];
+		for(int i = 0; i < 16; i++)
+			data[i] = float(matrix.m[i]);
+		
+		return Maths::Matrix4(data).Transpose();
+	}
+	
+	struct FBXSkeleton
+	{
+		Ref<Skeleton> Joints;
+		std::vector<const ofbx::Object*> JointObjects;
+		std::unordered_map<const ofbx::Object*, int32_t> ObjectToJoint;
+	};
+	
+	//Every cluster link of every skin becomes a joint, along with the nodes between it and the scene root
+	static FBXSkeleton LoadSkeleton(const ofbx::IScene* scene)
+	{
+		FBXSkeleton result;
+		std::vector<const ofbx::Object*> objects;
+		std::unordered_map<const ofbx::Object*, Maths::Matrix3x4> inverseBindMatrices;
+		
+		for(int i = 0; i < scene->getMeshCount(); i++)
+		{
+			const ofbx::Mesh* mesh = scene->getMesh(i);
+			const ofbx::Skin* skin = mesh->getGeometry() ? mesh->getGeometry()->getSkin() : nullptr;
+			if(!skin)
+				continue;
+			
+			for(int c = 0; c < skin->getClusterCount(); c++)
+			{
+				const ofbx::Cluster* cluster = skin->getCluster(c);
+				const ofbx::Object* link = cluster->getLink();
+				if(!link || inverseBindMatrices.find(link) != inverseBindMatrices.end())
+					continue;
+				
+				//Bone space from the mesh's bind transform
+				Maths::Matrix4 inverseBind = ToLumosMatrix(cluster->getTransformLinkMatrix()).Inverse() * ToLumosMatrix(cluster->getTransformMatrix());
+				inverseBindMatrices[link] = Maths::Matrix3x4(inverseBind);
+				objects.push_back(link);
+			}
+		}
+		
+		if(objects.empty())
+			return result;
+		
+		for(size_t i = 0, count = objects.size(); i < count; i++)
+		{
+			for(const ofbx::Object* parent = objects[i]->getParent(); parent && parent->getType() != ofbx::Object::Type::ROOT; parent = parent->getParent())
+			{
+				if(inverseBindMatrices.find(parent) != inverseBindMatrices.end())
+					break;
+				
+				inverseBindMatrices[parent] = Maths::Matrix3x4::IDENTITY;
+				objects.push_back(parent);
+			}
+		}
+		
+		auto depth = [](const ofbx::Object* object)
+		{
+			int32_t d = 0;
+			for(const ofbx::Object* parent = object->getParent(); parent; parent = parent->getParent())
+				d++;
+			return d;
+		};
+		
+		std::stable_sort(objects.begin(), objects.end(), [&depth](const ofbx::Object* a, const ofbx::Object* b) { return depth(a) < depth(b); });
+		
+		result.Joints = CreateRef<Skeleton>();
+		for(const ofbx::Object* object : objects)
+		{
+			Maths::Vector3 translation, scale;
+			Maths::Quaternion rotation;
+			ToLumosMatrix(object->getLocalTransform()).Decompose(translation, rotation, scale);
+			
+			auto parent = result.ObjectToJoint.find(object->getParent());
+			int32_t parentIndex = parent != result.ObjectToJoint.end() ? parent->second : -1;
+			
+			result.ObjectToJoint[object] = int32_t(result.Joints->AddJoint(object->name, parentIndex, inverseBindMatrices[object], translation, rotation, scale));
+			result.JointObjects.push_back(object);
+		}
+		
+		return result;
+	}
+	
+	//Evaluates each animation stack at a fixed rate using the nodes' full local transform (pivots, pre and post rotation)
+	static void LoadAnimations(Model* model, const ofbx::IScene* scene, const FBXSkeleton& skeleton)
+	{
+		const float sampleRate = AnimationClip::DefaultSampleRate;
+		const uint32_t jointCount = uint32_t(skeleton.JointObjects.size());
+		
+		for(int i = 0; i < scene->getAnimationStackCount(); i++)
+		{
+			const ofbx::AnimationStack* stack = scene->getAnimationStack(i);
+			const ofbx::AnimationLayer* layer = stack->getLayer(0);
+			if(!layer)
+				continue;
+			
+			double start = 0.0, end = 0.0;
+			const ofbx::TakeInfo* takeInfo = scene->getTakeInfo(stack->name);
+			if(takeInfo)
+			{
+				start = takeInfo->local_time_from;
+				end = takeInfo->local_time_to;
+			}
+			else
+			{
+				for(const ofbx::Object* object : skeleton.JointObjects)
+				{
+					for(const char* property : { "Lcl Translation", "Lcl Rotation", "Lcl Scaling" })
+					{
+						const ofbx::AnimationCurveNode* node = layer->getCurveNode(*object, property);
+						for(int c = 0; node && c < 3; c++)
+						{
+							const ofbx::AnimationCurve* curve = node->getCurve(c);
+							if(curve && curve->getKeyCount() > 0)
+								end = Maths::Max(end, ofbx::fbxTimeToSeconds(curve->getKeyTime()[curve->getKeyCount() - 1]));
+						}
+					}
+				}
+			}
+			
+			const uint32_t frameCount = uint32_t(Maths::CeilToInt(float(end - start) * sampleRate)) + 1;
+			
+			std::vector<AnimationClip::JointTrack> tracks(jointCount);
+			for(uint32_t joint = 0; joint < jointCount; joint++)
+			{
+				const ofbx::Object* object = skeleton.JointObjects[joint];
+				const ofbx::AnimationCurveNode* translationNode = layer->getCurveNode(*object, "Lcl Translation");
+				const ofbx::AnimationCurveNode* rotationNode = layer->getCurveNode(*object, "Lcl Rotation");
+				const ofbx::AnimationCurveNode* scaleNode = layer->getCurveNode(*object, "Lcl Scaling");
+				
+				AnimationClip::JointTrack& track = tracks[joint];
+				track.Translations.resize(frameCount);
+				track.Rotations.resize(frameCount);
+				track.Scales.resize(frameCount);
+				
+				for(uint32_t frame = 0; frame < frameCount; frame++)
+				{
+					const double time = start + frame / double(sampleRate);
+					ofbx::Vec3 t = translationNode ? translationNode->getNodeLocalTransform(time) : object->getLocalTranslation();
+					ofbx::Vec3 r = rotationNode ? rotationNode->getNodeLocalTransform(time) : object->getLocalRotation();
+					ofbx::Vec3 s = scaleNode ? scaleNode->getNodeLocalTransform(time) : object->getLocalScaling();
+					
+					ToLumosMatrix(object->evalLocal(t, r, s)).Decompose(track.Translations[frame], track.Rotations[frame], track.Scales[frame]);
+				}
+			}
+			
+			auto clip = CreateRef<AnimationClip>(stack->name, sampleRate, frameCount, tracks);
+			LUMOS_LOG_INFO("Loaded animation {0} - {1} frames, {2} bytes", stack->name, frameCount, clip->GetMemorySize());
+			model->AddAnimation(clip);
+		}
+	}
+	
+	//Keeps the four largest influences per vertex and normalises them
+	static void AddBoneInfluence(Graphics::AnimVertex& vertex, int32_t joint, float weight)
+	{
+		float* weights = &vertex.BoneWeights.x;
+		int* indices = &vertex.BoneIndices.x;
+		
+		int smallest = 0;
+		for(int i = 1; i < 4; i++)
+		{
+			if(weights[i] < weights[smallest])
+				smallest = i;
+		}
+		
+		if(weight > weights[smallest])
+		{
+			weights[smallest] = weight;
+			indices[smallest] = joint;
+		}
+	}
+	
 	void Model::LoadFBX(const std::string& path)
 	{
 		std::string err;
@@ -176,6 +352,8 @@ namespace Lumos::Graphics
 			break;
 		}
 		
+		FBXSkeleton skeleton = LoadSkeleton(scene);
+		
 		int c = scene->getMeshCount();
 		for(int i = 0; i < c; ++i)
 		{
@@ -191,8 +369,6 @@ namespace Lumos::Graphics
 			Graphics::Vertex* tempvertices = new Graphics::Vertex[vertex_count];
 			uint32_t* indicesArray = new uint32_t[numIndices];
 			
-			Ref<Maths::BoundingBox> boundingBox = CreateRef<Maths::BoundingBox>();
-			
 			auto indices = geom->getFaceIndices();
 			
 			ofbx::Vec3* generatedTangents = nullptr;
@@ -210,7 +386,6 @@ namespace Lumos::Graphics
 				auto& vertex = tempvertices[i];
 				vertex.Position = Maths::Vector3(float(cp.x), float(cp.y), float(cp.z));
 				FixOrientation(vertex.Position);
-				boundingBox->Merge(vertex.Position);
 				
 				if(normals)
 					vertex.Normal = Maths::Vector3(float(normals[i].x), float(normals[i].y), float(normals[i].z));
@@ -232,12 +407,6 @@ namespace Lumos::Graphics
 				indicesArray[i] = index;
 			}
 			
-			Ref<Graphics::VertexBuffer> vb = Ref<Graphics::VertexBuffer>(Graphics::VertexBuffer::Create());
-			vb->SetData(sizeof(Graphics::Vertex) * vertex_count, tempvertices);
-    
-			Ref<Graphics::IndexBuffer> ib;
-			ib.reset(Graphics::IndexBuffer::Create(indicesArray, numIndices));
-			
 			Ref<Material> pbrMaterial = CreateRef<Material>();
 			
 			const ofbx::Material* material = fbx_mesh->getMaterialCount() > 0 ? fbx_mesh->getMaterial(0) : nullptr;
@@ -363,7 +532,47 @@ namespace Lumos::Graphics
 				pbrMaterial->SetMaterialProperites(properties);
 			}
 			
-			auto mesh = CreateRef<Graphics::Mesh>(vb, ib, boundingBox);
+			Ref<Graphics::Mesh> mesh;
+			const ofbx::Skin* skin = geom->getSkin();
+			
+			if(skin && skeleton.Joints)
+			{
+				std::vector<Graphics::AnimVertex> animVertices(vertex_count);
+				for(int v = 0; v < vertex_count; v++)
+				{
+					static_cast<Graphics::Vertex&>(animVertices[v]) = tempvertices[v];
+					animVertices[v].BoneWeights = Maths::Vector4(0.0f);
+				}
+				
+				for(int cl = 0; cl < skin->getClusterCount(); cl++)
+				{
+					const ofbx::Cluster* cluster = skin->getCluster(cl);
+					auto joint = skeleton.ObjectToJoint.find(cluster->getLink());
+					if(joint == skeleton.ObjectToJoint.end())
+						continue;
+					
+					const int* clusterIndices = cluster->getIndices();
+					const double* clusterWeights = cluster->getWeights();
+					for(int w = 0; w < cluster->getIndicesCount(); w++)
+					{
+						if(clusterIndices[w] < vertex_count)
+							AddBoneInfluence(animVertices[clusterIndices[w]], joint->second, float(clusterWeights[w]));
+					}
+				}
+				
+				for(auto& vertex : animVertices)
+				{
+					float total = vertex.BoneWeights.x + vertex.BoneWeights.y + vertex.BoneWeights.z + vertex.BoneWeights.w;
+					vertex.BoneWeights = total > 0.0f ? vertex.BoneWeights / total : Maths::Vector4(1.0f, 0.0f, 0.0f, 0.0f);
+				}
+				
+				mesh = CreateRef<Graphics::Mesh>(std::vector<uint32_t>(indicesArray, indicesArray + numIndices), animVertices);
+			}
+			else
+			{
+				//Mesh welds, optimises and generates the LOD chain
+				mesh = CreateRef<Graphics::Mesh>(std::vector<uint32_t>(indicesArray, indicesArray + numIndices), std::vector<Graphics::Vertex>(tempvertices, tempvertices + vertex_count));
+			}
 			if(c == 1)
 			{
 				mesh->SetName(fbx_mesh->name);
@@ -418,6 +627,12 @@ namespace Lumos::Graphics
 			delete[] tempvertices;
 			delete[] indicesArray;
 		}
+		
+		if(skeleton.Joints)
+		{
+			m_Skeleton = skeleton.Joints;
+			LoadAnimations(this, scene, skeleton);
+		}
 	}
 	
 }
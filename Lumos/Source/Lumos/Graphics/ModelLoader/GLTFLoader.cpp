@@ -234,10 +234,283 @@ namespace Lumos::Graphics
 		return loadedMaterials;
 	}
 
-	std::vector<Graphics::Mesh*> LoadMesh(tinygltf::Model& model, tinygltf::Mesh& mesh, std::vector<Ref<Material>>& materials, Maths::Transform& parentTransform)
+	//Reads any accessor as floats, honouring the buffer view stride and normalised integer types
+	static std::vector<float> ReadAccessor(const tinygltf::Model& model, int accessorIndex, int& componentCount)
+	{
+		std::vector<float> result;
+		componentCount = 0;
+		if(accessorIndex < 0)
+			return result;
+
+		const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+		if(accessor.bufferView < 0)
+			return result;
+
+		const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
+		const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
+
+		componentCount = GLTF_COMPONENT_LENGTH_LOOKUP.at(accessor.type);
+		const size_t componentSize = ComponentSize.at(accessor.componentType);
+		const size_t stride = bufferView.byteStride > 0 ? bufferView.byteStride : componentSize * componentCount;
+		const uint8_t* base = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset;
+
+		result.resize(accessor.count * componentCount);
+
+		for(size_t i = 0; i < accessor.count; i++)
+		{
+			const uint8_t* element = base + i * stride;
+			for(int c = 0; c < componentCount; c++)
+			{
+				const uint8_t* src = element + c * componentSize;
+				float value = 0.0f;
+
+				switch(accessor.componentType)
+				{
+				case TINYGLTF_COMPONENT_TYPE_FLOAT:
+					memcpy(&value, src, sizeof(float));
+					break;
+				case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+					value = accessor.normalized ? *src / 255.0f : float(*src);
+					break;
+				case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+				{
+					uint16_t v;
+					memcpy(&v, src, sizeof(uint16_t));
+					value = accessor.normalized ? v / 65535.0f : float(v);
+					break;
+				}
+				case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+				{
+					uint32_t v;
+					memcpy(&v, src, sizeof(uint32_t));
+					value = float(v);
+					break;
+				}
+				case TINYGLTF_COMPONENT_TYPE_BYTE:
+					value = accessor.normalized ? Maths::Max(int8_t(*src) / 127.0f, -1.0f) : float(int8_t(*src));
+					break;
+				case TINYGLTF_COMPONENT_TYPE_SHORT:
+				{
+					int16_t v;
+					memcpy(&v, src, sizeof(int16_t));
+					value = accessor.normalized ? Maths::Max(v / 32767.0f, -1.0f) : float(v);
+					break;
+				}
+				default:
+					break;
+				}
+
+				result[i * componentCount + c] = value;
+			}
+		}
+
+		return result;
+	}
+
+	static void GetNodeLocalTransform(const tinygltf::Node& node, Maths::Vector3& translation, Maths::Quaternion& rotation, Maths::Vector3& scale)
+	{
+		translation = Maths::Vector3(0.0f);
+		rotation = Maths::Quaternion::IDENTITY;
+		scale = Maths::Vector3(1.0f);
+
+		if(node.matrix.size() == 16)
+		{
+			float matrix[16];
+			for(int i = 0; i < 16; i++)
+				matrix[i] = static_cast<float>(node.matrix[i]);
+
+			Maths::Matrix4(matrix).Transpose().Decompose(translation, rotation, scale);
+			return;
+		}
+
+		if(node.translation.size() == 3)
+			translation = Maths::Vector3(static_cast<float>(node.translation[0]), static_cast<float>(node.translation[1]), static_cast<float>(node.translation[2]));
+		if(node.rotation.size() == 4)
+			rotation = Maths::Quaternion(static_cast<float>(node.rotation[3]), static_cast<float>(node.rotation[0]), static_cast<float>(node.rotation[1]), static_cast<float>(node.rotation[2]));
+		if(node.scale.size() == 3)
+			scale = Maths::Vector3(static_cast<float>(node.scale[0]), static_cast<float>(node.scale[1]), static_cast<float>(node.scale[2]));
+	}
+
+	struct GLTFSkeleton
+	{
+		Ref<Skeleton> Joints;
+		std::vector<int32_t> NodeToJoint;
+		//Skin joint index to skeleton joint index, per skin
+		std::vector<std::vector<int32_t>> SkinJoints;
+	};
+
+	//Merges every skin into one skeleton. Non joint ancestors of joints are added too so their transforms
+	//are part of the hierarchy, joints are ordered by depth so parents come first.
+	static GLTFSkeleton LoadSkeleton(const tinygltf::Model& model)
+	{
+		GLTFSkeleton result;
+		if(model.skins.empty())
+			return result;
+
+		std::vector<int32_t> nodeParents(model.nodes.size(), -1);
+		for(size_t i = 0; i < model.nodes.size(); i++)
+		{
+			for(int child : model.nodes[i].children)
+				nodeParents[child] = int32_t(i);
+		}
+
+		std::vector<int32_t> jointNodes;
+		std::unordered_map<int32_t, Maths::Matrix3x4> inverseBindMatrices;
+
+		for(auto& skin : model.skins)
+		{
+			int componentCount;
+			std::vector<float> matrices = ReadAccessor(model, skin.inverseBindMatrices, componentCount);
+
+			for(size_t j = 0; j < skin.joints.size(); j++)
+			{
+				int32_t node = skin.joints[j];
+				if(inverseBindMatrices.find(node) != inverseBindMatrices.end())
+					continue;
+
+				Maths::Matrix3x4 inverseBind = Maths::Matrix3x4::IDENTITY;
+				if(componentCount == 16 && matrices.size() >= (j + 1) * 16)
+					inverseBind = Maths::Matrix3x4(Maths::Matrix4(&matrices[j * 16]).Transpose());
+
+				inverseBindMatrices[node] = inverseBind;
+				jointNodes.push_back(node);
+			}
+		}
+
+		for(size_t i = 0, count = jointNodes.size(); i < count; i++)
+		{
+			for(int32_t parent = nodeParents[jointNodes[i]]; parent >= 0; parent = nodeParents[parent])
+			{
+				if(inverseBindMatrices.find(parent) != inverseBindMatrices.end())
+					break;
+
+				inverseBindMatrices[parent] = Maths::Matrix3x4::IDENTITY;
+				jointNodes.push_back(parent);
+			}
+		}
+
+		auto depth = [&nodeParents](int32_t node)
+		{
+			int32_t d = 0;
+			for(int32_t parent = nodeParents[node]; parent >= 0; parent = nodeParents[parent])
+				d++;
+			return d;
+		};
+
+		std::stable_sort(jointNodes.begin(), jointNodes.end(), [&depth](int32_t a, int32_t b) { return depth(a) < depth(b); });
+
+		result.Joints = CreateRef<Skeleton>();
+		result.NodeToJoint.assign(model.nodes.size(), -1);
+
+		for(int32_t node : jointNodes)
+		{
+			Maths::Vector3 translation, scale;
+			Maths::Quaternion rotation;
+			GetNodeLocalTransform(model.nodes[node], translation, rotation, scale);
+
+			int32_t parent = nodeParents[node];
+			result.NodeToJoint[node] = int32_t(result.Joints->AddJoint(model.nodes[node].name, parent >= 0 ? result.NodeToJoint[parent] : -1, inverseBindMatrices[node], translation, rotation, scale));
+		}
+
+		for(auto& skin : model.skins)
+		{
+			std::vector<int32_t> remap(skin.joints.size());
+			for(size_t j = 0; j < skin.joints.size(); j++)
+				remap[j] = result.NodeToJoint[skin.joints[j]];
+			result.SkinJoints.push_back(std::move(remap));
+		}
+
+		return result;
+	}
+
+	//Resamples every channel at a fixed rate so clips can be quantized per frame
+	static void LoadAnimations(Model* mainModel, const tinygltf::Model& model, const GLTFSkeleton& skeleton)
+	{
+		if(!skeleton.Joints)
+			return;
+
+		const LocalPose& bindPose = skeleton.Joints->GetBindPose();
+		const uint32_t jointCount = skeleton.Joints->GetJointCount();
+		const float sampleRate = AnimationClip::DefaultSampleRate;
+
+		for(auto& animation : model.animations)
+		{
+			float duration = 0.0f;
+			for(auto& sampler : animation.samplers)
+			{
+				const tinygltf::Accessor& input = model.accessors[sampler.input];
+				if(!input.maxValues.empty())
+					duration = Maths::Max(duration, static_cast<float>(input.maxValues[0]));
+			}
+
+			const uint32_t frameCount = uint32_t(Maths::CeilToInt(duration * sampleRate)) + 1;
+
+			std::vector<AnimationClip::JointTrack> tracks(jointCount);
+			for(uint32_t joint = 0; joint < jointCount; joint++)
+			{
+				const Maths::Vector4& t = bindPose.Translations[joint];
+				const Maths::Vector4& s = bindPose.Scales[joint];
+				tracks[joint].Translations.assign(frameCount, Maths::Vector3(t.x, t.y, t.z));
+				tracks[joint].Rotations.assign(frameCount, bindPose.Rotations[joint]);
+				tracks[joint].Scales.assign(frameCount, Maths::Vector3(s.x, s.y, s.z));
+			}
+
+			for(auto& channel : animation.channels)
+			{
+				if(channel.target_node < 0 || skeleton.NodeToJoint[channel.target_node] < 0)
+					continue;
+
+				AnimationClip::JointTrack& track = tracks[skeleton.NodeToJoint[channel.target_node]];
+				const tinygltf::AnimationSampler& sampler = animation.samplers[channel.sampler];
+
+				int timeComponents, valueComponents;
+				std::vector<float> times = ReadAccessor(model, sampler.input, timeComponents);
+				std::vector<float> values = ReadAccessor(model, sampler.output, valueComponents);
+				if(times.empty() || values.empty())
+					continue;
+
+				//Cubic spline keys are stored as in tangent, value, out tangent. Tangents are ignored
+				const bool cubic = sampler.interpolation == "CUBICSPLINE";
+				const bool step = sampler.interpolation == "STEP";
+				auto key = [&](size_t index) { return &values[(cubic ? index * 3 + 1 : index) * valueComponents]; };
+
+				size_t k = 0;
+				for(uint32_t frame = 0; frame < frameCount; frame++)
+				{
+					const float time = frame / sampleRate;
+					while(k + 1 < times.size() && times[k + 1] <= time)
+						k++;
+
+					size_t next = Maths::Min(k + 1, times.size() - 1);
+					float alpha = 0.0f;
+					if(!step && next != k && time > times[k])
+						alpha = Maths::Clamp((time - times[k]) / (times[next] - times[k]), 0.0f, 1.0f);
+
+					const float* a = key(k);
+					const float* b = key(next);
+
+					if(channel.target_path == "translation")
+						track.Translations[frame] = Maths::Vector3(a[0], a[1], a[2]).Lerp(Maths::Vector3(b[0], b[1], b[2]), alpha);
+					else if(channel.target_path == "scale")
+						track.Scales[frame] = Maths::Vector3(a[0], a[1], a[2]).Lerp(Maths::Vector3(b[0], b[1], b[2]), alpha);
+					else if(channel.target_path == "rotation")
+						track.Rotations[frame] = Maths::Quaternion(a[3], a[0], a[1], a[2]).Slerp(Maths::Quaternion(b[3], b[0], b[1], b[2]), alpha);
+				}
+			}
+
+			auto clip = CreateRef<AnimationClip>(animation.name, sampleRate, frameCount, tracks);
+			LUMOS_LOG_INFO("Loaded animation {0} - {1} frames, {2} bytes", animation.name, frameCount, clip->GetMemorySize());
+			mainModel->AddAnimation(clip);
+		}
+	}
+
+	std::vector<Graphics::Mesh*> LoadMesh(tinygltf::Model& model, tinygltf::Mesh& mesh, std::vector<Ref<Material>>& materials, Maths::Transform& parentTransform, const std::vector<int32_t>* skinJoints)
 	{
 		std::vector<Graphics::Mesh*> meshes;
 
+		//Skinned meshes are positioned by their joints, the node transform is ignored
+		const Maths::Matrix4 meshTransform = skinJoints ? Maths::Matrix4() : parentTransform.GetWorldMatrix();
+
 		for(auto& primitive : mesh.primitives)
 		{
 			const tinygltf::Accessor& indicesAccessor = model.accessors[primitive.indices];
@@ -272,7 +545,7 @@ namespace Lumos::Graphics
 					Maths::Vector3Simple* positions = reinterpret_cast<Maths::Vector3Simple*>(data.data());
 					for(auto p = 0; p < positionCount; ++p)
 					{
-                        vertices[p].Position = parentTransform.GetWorldMatrix() * Maths::ToVector(positions[p]);
+                        vertices[p].Position = meshTransform * Maths::ToVector(positions[p]);
 					}
 				}
 
@@ -284,7 +557,7 @@ namespace Lumos::Graphics
 					Maths::Vector3Simple* normals = reinterpret_cast<Maths::Vector3Simple*>(data.data());
 					for(auto p = 0; p < normalCount; ++p)
 					{
-                        vertices[p].Normal = parentTransform.GetWorldMatrix() * Maths::ToVector(normals[p]);
+                        vertices[p].Normal = meshTransform * Maths::ToVector(normals[p]);
 					}
 				}
 
@@ -320,7 +593,7 @@ namespace Lumos::Graphics
 					Maths::Vector3Simple* uvs = reinterpret_cast<Maths::Vector3Simple*>(data.data());
 					for(auto p = 0; p < uvCount; ++p)
 					{
-                        vertices[p].Tangent = parentTransform.GetWorldMatrix() * ToVector(uvs[p]);
+                        vertices[p].Tangent = meshTransform * ToVector(uvs[p]);
 					}
 				}
 			}
@@ -361,14 +634,50 @@ namespace Lumos::Graphics
 				}
 			}
         
-			auto lMesh = new Graphics::Mesh(indices, vertices);
-			meshes.emplace_back(lMesh);
+			auto joints = primitive.attributes.find("JOINTS_0");
+			auto weights = primitive.attributes.find("WEIGHTS_0");
+
+			if(skinJoints && joints != primitive.attributes.end() && weights != primitive.attributes.end())
+			{
+				int jointComponents, weightComponents;
+				std::vector<float> jointData = ReadAccessor(model, joints->second, jointComponents);
+				std::vector<float> weightData = ReadAccessor(model, weights->second, weightComponents);
+
+				std::vector<Graphics::AnimVertex> animVertices(vertices.size());
+				for(size_t v = 0; v < vertices.size(); v++)
+				{
+					static_cast<Graphics::Vertex&>(animVertices[v]) = vertices[v];
+
+					if(jointComponents != 4 || weightComponents != 4 || (v + 1) * 4 > jointData.size() || (v + 1) * 4 > weightData.size())
+						continue;
+
+					int boneIndices[4];
+					for(int c = 0; c < 4; c++)
+					{
+						size_t skinJoint = size_t(jointData[v * 4 + c]);
+						boneIndices[c] = skinJoint < skinJoints->size() ? Maths::Max((*skinJoints)[skinJoint], 0) : 0;
+					}
+
+					Maths::Vector4 boneWeights(weightData[v * 4], weightData[v * 4 + 1], weightData[v * 4 + 2], weightData[v * 4 + 3]);
+					float total = boneWeights.x + boneWeights.y + boneWeights.z + boneWeights.w;
+
+					animVertices[v].BoneIndices = Maths::IntVector4(boneIndices[0], boneIndices[1], boneIndices[2], boneIndices[3]);
+					animVertices[v].BoneWeights = total > 0.0f ? boneWeights / total : Maths::Vector4(1.0f, 0.0f, 0.0f, 0.0f);
+				}
+
+				meshes.emplace_back(new Graphics::Mesh(indices, animVertices));
+			}
+			else
+			{
+				auto lMesh = new Graphics::Mesh(indices, vertices);
+				meshes.emplace_back(lMesh);
+			}
 		}
 
 		return meshes;
 	}
 
-	void LoadNode(Model* mainModel, int nodeIndex, const Maths::Matrix4& parentTransform, tinygltf::Model& model, std::vector<Ref<Material>>& materials, std::vector<std::vector<Graphics::Mesh*>>& meshes)
+	void LoadNode(Model* mainModel, int nodeIndex, const Maths::Matrix4& parentTransform, tinygltf::Model& model, std::vector<Ref<Material>>& materials, std::vector<std::vector<Graphics::Mesh*>>& meshes, const GLTFSkeleton& skeleton)
 	{
 		if(nodeIndex < 0)
 		{
@@ -408,7 +717,8 @@ namespace Lumos::Graphics
 		{
 			int subIndex = 0;
 
-			auto meshes = LoadMesh(model, model.meshes[node.mesh], materials, transform);
+			const std::vector<int32_t>* skinJoints = node.skin >= 0 && node.skin < int(skeleton.SkinJoints.size()) ? &skeleton.SkinJoints[node.skin] : nullptr;
+			auto meshes = LoadMesh(model, model.meshes[node.mesh], materials, transform, skinJoints);
 
 			for(auto& mesh : meshes)
 			{
@@ -422,10 +732,6 @@ namespace Lumos::Graphics
 
 				mainModel->AddMesh(lMesh);
 
-				/*if (node.skin >= 0)
-                {
-                }*/
-
 				subIndex++;
 			}
 		}
@@ -434,7 +740,7 @@ namespace Lumos::Graphics
 		{
 			for(int child : node.children)
 			{
-				LoadNode(mainModel, child, transform.GetLocalMatrix(), model, materials, meshes);
+				LoadNode(mainModel, child, transform.GetLocalMatrix(), model, materials, meshes, skeleton);
 			}
 		}
 	}
@@ -481,11 +787,19 @@ namespace Lumos::Graphics
 
 		std::string name = path.substr(path.find_last_of('/') + 1);
 
+		GLTFSkeleton skeleton = LoadSkeleton(model);
+
 		auto meshes = std::vector<std::vector<Graphics::Mesh*>>();
 		const tinygltf::Scene& gltfScene = model.scenes[Lumos::Maths::Max(0, model.defaultScene)];
 		for(size_t i = 0; i < gltfScene.nodes.size(); i++)
 		{
-			LoadNode(this, gltfScene.nodes[i], Maths::Matrix4(), model, LoadedMaterials, meshes);
+			LoadNode(this, gltfScene.nodes[i], Maths::Matrix4(), model, LoadedMaterials, meshes, skeleton);
+		}
+
+		if(skeleton.Joints)
+		{
+			m_Skeleton = skeleton.Joints;
+			LoadAnimations(this, model, skeleton);
 		}
 	}
 }
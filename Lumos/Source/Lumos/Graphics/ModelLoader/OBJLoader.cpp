@@ -68,8 +68,6 @@ namespace Lumos
 
 			std::unordered_map<Graphics::Vertex, uint32_t> uniqueVertices;
 
-			Ref<Maths::BoundingBox> boundingBox = CreateRef<Maths::BoundingBox>();
-
 			for(uint32_t i = 0; i < shape.mesh.indices.size(); i++)
 			{
 				auto& index = shape.mesh.indices[i];
@@ -91,8 +89,6 @@ namespace Lumos
 					attrib.vertices[3 * index.vertex_index + 1],
 					attrib.vertices[3 * index.vertex_index + 2]));
 
-				boundingBox->Merge(vertex.Position);
-
 				if(!attrib.normals.empty())
 				{
 					vertex.Normal = (Maths::Vector3(
@@ -175,13 +171,8 @@ namespace Lumos
 
 			pbrMaterial->SetTextures(textures);
 
-			Ref<VertexBuffer> vb = Ref<VertexBuffer>(VertexBuffer::Create(BufferUsage::STATIC));
-			vb->SetData(sizeof(Graphics::Vertex) * numVertices, vertices);
-
-			Ref<Graphics::IndexBuffer> ib;
-			ib.reset(Graphics::IndexBuffer::Create(indices, numIndices));
-
-			auto mesh = CreateRef<Graphics::Mesh>(vb, ib, boundingBox);
+			//Mesh welds, optimises and generates the LOD chain
+			auto mesh = CreateRef<Graphics::Mesh>(std::vector<uint32_t>(indices, indices + numIndices), std::vector<Graphics::Vertex>(vertices, vertices + numVertices));
 			mesh->SetMaterial(pbrMaterial);
 			m_Meshes.push_back(mesh);
 			
@@ -0,0 +1,198 @@
+#include "Precompiled.h"
+#include "ParticleBuffer.h"
+
+namespace Lumos::Graphics
+{
+	void ParticleBuffer::Resize(uint32_t capacity)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		capacity = (capacity + 3) & ~3u;
+		if(capacity == m_Capacity)
+			return;
+
+		std::vector<float> data(size_t(capacity) * ParticleStreamCount, 0.0f);
+		const uint32_t count = Maths::Min(m_Count, capacity);
+
+		for(uint32_t stream = 0; stream < ParticleStreamCount; stream++)
+			memcpy(data.data() + size_t(stream) * capacity, Get(ParticleStream(stream)), count * sizeof(float));
+
+		m_Data.swap(data);
+		m_Capacity = capacity;
+		m_Count = count;
+	}
+
+	uint32_t ParticleBuffer::Add(uint32_t count)
+	{
+		LUMOS_ASSERT(count <= GetFreeCount(), "Particle buffer is full");
+		const uint32_t first = m_Count;
+		m_Count += count;
+		return first;
+	}
+
+	void ParticleBuffer::Remove(uint32_t index)
+	{
+		m_Count--;
+		for(uint32_t stream = 0; stream < ParticleStreamCount; stream++)
+		{
+			float* values = Get(ParticleStream(stream));
+			values[index] = values[m_Count];
+		}
+	}
+
+	namespace ParticleKernels
+	{
+		void Integrate(ParticleBuffer& buffer, uint32_t start, uint32_t end, const Maths::Vector3& gravity, float dt)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			float* px = buffer.Get(ParticlePositionX);
+			float* py = buffer.Get(ParticlePositionY);
+			float* pz = buffer.Get(ParticlePositionZ);
+			float* vx = buffer.Get(ParticleVelocityX);
+			float* vy = buffer.Get(ParticleVelocityY);
+			float* vz = buffer.Get(ParticleVelocityZ);
+			float* age = buffer.Get(ParticleAge);
+			const float* invLifeTime = buffer.Get(ParticleInvLifeTime);
+
+			//Capacity is padded so the last group never reads past the streams
+			end = Maths::Min((end + 3) & ~3u, buffer.GetCapacity());
+
+#ifdef LUMOS_SSE
+			const __m128 delta = _mm_set1_ps(dt);
+			const __m128 gx = _mm_set1_ps(gravity.x * dt);
+			const __m128 gy = _mm_set1_ps(gravity.y * dt);
+			const __m128 gz = _mm_set1_ps(gravity.z * dt);
+
+			for(uint32_t i = start; i < end; i += 4)
+			{
+				const __m128 velX = _mm_add_ps(_mm_loadu_ps(vx + i), gx);
+				const __m128 velY = _mm_add_ps(_mm_loadu_ps(vy + i), gy);
+				const __m128 velZ = _mm_add_ps(_mm_loadu_ps(vz + i), gz);
+				_mm_storeu_ps(vx + i, velX);
+				_mm_storeu_ps(vy + i, velY);
+				_mm_storeu_ps(vz + i, velZ);
+
+				_mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velX, delta)));
+				_mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velY, delta)));
+				_mm_storeu_ps(pz + i, _mm_add_ps(_mm_loadu_ps(pz + i), _mm_mul_ps(velZ, delta)));
+				_mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), _mm_mul_ps(_mm_loadu_ps(invLifeTime + i), delta)));
+			}
+#else
+			const Maths::Vector3 impulse = gravity * dt;
+			for(uint32_t i = start; i < end; i++)
+			{
+				vx[i] += impulse.x;
+				vy[i] += impulse.y;
+				vz[i] += impulse.z;
+				px[i] += vx[i] * dt;
+				py[i] += vy[i] * dt;
+				pz[i] += vz[i] * dt;
+				age[i] += invLifeTime[i] * dt;
+			}
+#endif
+		}
+
+		void RemoveDead(ParticleBuffer& buffer)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			const float* age = buffer.Get(ParticleAge);
+
+			uint32_t i = 0;
+			while(i < buffer.GetCount())
+			{
+#ifdef LUMOS_SSE
+				//Most groups have no dead particles, skip them four at a time
+				if((i & 3) == 0 && i + 4 <= buffer.GetCount() && _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(age + i), _mm_set1_ps(1.0f))) == 0)
+				{
+					i += 4;
+					continue;
+				}
+#endif
+				//The swapped in particle is checked on the next iteration
+				if(age[i] >= 1.0f)
+					buffer.Remove(i);
+				else
+					i++;
+			}
+		}
+
+		Maths::BoundingBox ComputeBounds(const ParticleBuffer& buffer, uint32_t start, uint32_t end)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			const float* px = buffer.Get(ParticlePositionX);
+			const float* py = buffer.Get(ParticlePositionY);
+			const float* pz = buffer.Get(ParticlePositionZ);
+
+			Maths::BoundingBox bounds;
+			uint32_t i = start;
+
+#ifdef LUMOS_SSE
+			if(end - start >= 4)
+			{
+				__m128 minX = _mm_loadu_ps(px + i), maxX = minX;
+				__m128 minY = _mm_loadu_ps(py + i), maxY = minY;
+				__m128 minZ = _mm_loadu_ps(pz + i), maxZ = minZ;
+
+				for(i += 4; i + 4 <= end; i += 4)
+				{
+					const __m128 x = _mm_loadu_ps(px + i);
+					const __m128 y = _mm_loadu_ps(py + i);
+					const __m128 z = _mm_loadu_ps(pz + i);
+					minX = _mm_min_ps(minX, x);
+					maxX = _mm_max_ps(maxX, x);
+					minY = _mm_min_ps(minY, y);
+					maxY = _mm_max_ps(maxY, y);
+					minZ = _mm_min_ps(minZ, z);
+					maxZ = _mm_max_ps(maxZ, z);
+				}
+
+				alignas(16) float lanes[6][4];
+				_mm_store_ps(lanes[0], minX);
+				_mm_store_ps(lanes[1], minY);
+				_mm_store_ps(lanes[2], minZ);
+				_mm_store_ps(lanes[3], maxX);
+				_mm_store_ps(lanes[4], maxY);
+				_mm_store_ps(lanes[5], maxZ);
+
+				for(uint32_t lane = 0; lane < 4; lane++)
+				{
+					bounds.Merge(Maths::Vector3(lanes[0][lane], lanes[1][lane], lanes[2][lane]));
+					bounds.Merge(Maths::Vector3(lanes[3][lane], lanes[4][lane], lanes[5][lane]));
+				}
+			}
+#endif
+			for(; i < end; i++)
+				bounds.Merge(Maths::Vector3(px[i], py[i], pz[i]));
+
+			return bounds;
+		}
+
+		void WriteInstances(const ParticleBuffer& buffer, uint32_t start, uint32_t end, ParticleInstance* out)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			const float* px = buffer.Get(ParticlePositionX);
+			const float* py = buffer.Get(ParticlePositionY);
+			const float* pz = buffer.Get(ParticlePositionZ);
+			const float* age = buffer.Get(ParticleAge);
+
+			uint32_t i = start;
+#ifdef LUMOS_SSE
+			for(; i + 4 <= end; i += 4)
+			{
+				__m128 x = _mm_loadu_ps(px + i);
+				__m128 y = _mm_loadu_ps(py + i);
+				__m128 z = _mm_loadu_ps(pz + i);
+				__m128 a = _mm_loadu_ps(age + i);
+				_MM_TRANSPOSE4_PS(x, y, z, a);
+
+				float* dst = &out[i - start].x;
+				_mm_storeu_ps(dst, x);
+				_mm_storeu_ps(dst + 4, y);
+				_mm_storeu_ps(dst + 8, z);
+				_mm_storeu_ps(dst + 12, a);
+			}
+#endif
+			for(; i < end; i++)
+				out[i - start] = { px[i], py[i], pz[i], age[i] };
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "Maths/Maths.h"
+
+namespace Lumos::Graphics
+{
+	enum ParticleStream : uint32_t
+	{
+		ParticlePositionX,
+		ParticlePositionY,
+		ParticlePositionZ,
+		ParticleVelocityX,
+		ParticleVelocityY,
+		ParticleVelocityZ,
+		ParticleAge,		 //Normalised, the particle dies when it reaches 1
+		ParticleInvLifeTime, //Age added per second
+		ParticleStreamCount
+	};
+
+	//What the billboard pass reads per instance, colour and size are derived from age on the gpu
+	struct ParticleInstance
+	{
+		float x, y, z;
+		float age;
+	};
+
+	//Pooled particle storage, one float stream per attribute so the update runs four particles at a time.
+	//Capacity is a multiple of four, lanes past Count are simulated but never read
+	class LUMOS_EXPORT ParticleBuffer
+	{
+	public:
+		ParticleBuffer() = default;
+		~ParticleBuffer() = default;
+
+		//Keeps the first min(Count, capacity) particles
+		void Resize(uint32_t capacity);
+		void Clear() { m_Count = 0; }
+
+		float* Get(ParticleStream stream) { return m_Data.data() + size_t(stream) * m_Capacity; }
+		const float* Get(ParticleStream stream) const { return m_Data.data() + size_t(stream) * m_Capacity; }
+
+		//Returns the index of the first new particle, count must fit in the free space
+		uint32_t Add(uint32_t count);
+
+		//Moves the last particle into index
+		void Remove(uint32_t index);
+
+		uint32_t GetCount() const { return m_Count; }
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetFreeCount() const { return m_Capacity - m_Count; }
+
+	private:
+		std::vector<float> m_Data;
+		uint32_t m_Count = 0;
+		uint32_t m_Capacity = 0;
+	};
+
+	//SIMD kernels run by ParticleSystem and the particle renderers. Ranges start on a multiple of four
+	namespace ParticleKernels
+	{
+		//velocity += gravity * dt, position += velocity * dt, age += invLifeTime * dt
+		LUMOS_EXPORT void Integrate(ParticleBuffer& buffer, uint32_t start, uint32_t end, const Maths::Vector3& gravity, float dt);
+
+		//Swaps dead particles with the last live one, order isn't kept
+		LUMOS_EXPORT void RemoveDead(ParticleBuffer& buffer);
+
+		//Bounds of the particle centres in the range
+		LUMOS_EXPORT Maths::BoundingBox ComputeBounds(const ParticleBuffer& buffer, uint32_t start, uint32_t end);
+
+		//Transposes the streams into one ParticleInstance per particle
+		LUMOS_EXPORT void WriteInstances(const ParticleBuffer& buffer, uint32_t start, uint32_t end, ParticleInstance* out);
+	}
+}
@@ -0,0 +1,90 @@
+#include "Precompiled.h"
+#include "ParticleEmitter.h"
+
+namespace Lumos::Graphics
+{
+	static std::atomic<uint32_t> s_EmitterSeed = 1;
+
+	ParticleEmitter::ParticleEmitter()
+		: m_Seed(s_EmitterSeed.fetch_add(0x9E3779B9u))
+	{
+		m_Buffer.Resize(m_MaxParticles);
+	}
+
+	float ParticleEmitter::Random(float min, float max)
+	{
+		m_Seed = m_Seed * 1664525u + 1013904223u;
+		return min + (max - min) * float(m_Seed >> 8) / float(1u << 24);
+	}
+
+	uint32_t ParticleEmitter::Emit(float dt, const Maths::Vector3& position)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		uint32_t count = m_PendingBurst;
+		m_PendingBurst = 0;
+
+		if(m_Emitting)
+		{
+			m_EmitAccumulator += m_EmissionRate * dt;
+			const uint32_t emitted = uint32_t(m_EmitAccumulator);
+			m_EmitAccumulator -= float(emitted);
+			count += emitted;
+		}
+
+		//Particles that don't fit are dropped rather than queued
+		count = Maths::Min(count, m_Buffer.GetFreeCount());
+		if(count == 0)
+			return 0;
+
+		const uint32_t first = m_Buffer.Add(count);
+		float* px = m_Buffer.Get(ParticlePositionX);
+		float* py = m_Buffer.Get(ParticlePositionY);
+		float* pz = m_Buffer.Get(ParticlePositionZ);
+		float* vx = m_Buffer.Get(ParticleVelocityX);
+		float* vy = m_Buffer.Get(ParticleVelocityY);
+		float* vz = m_Buffer.Get(ParticleVelocityZ);
+		float* age = m_Buffer.Get(ParticleAge);
+		float* invLifeTime = m_Buffer.Get(ParticleInvLifeTime);
+
+		for(uint32_t i = first; i < first + count; i++)
+		{
+			px[i] = position.x + Random(-m_SpawnExtent.x, m_SpawnExtent.x);
+			py[i] = position.y + Random(-m_SpawnExtent.y, m_SpawnExtent.y);
+			pz[i] = position.z + Random(-m_SpawnExtent.z, m_SpawnExtent.z);
+			vx[i] = m_Velocity.x + Random(-m_VelocitySpread.x, m_VelocitySpread.x);
+			vy[i] = m_Velocity.y + Random(-m_VelocitySpread.y, m_VelocitySpread.y);
+			vz[i] = m_Velocity.z + Random(-m_VelocitySpread.z, m_VelocitySpread.z);
+			age[i] = 0.0f;
+			invLifeTime[i] = 1.0f / Maths::Max(Random(m_MinLifeTime, m_MaxLifeTime), 0.001f);
+		}
+
+		return count;
+	}
+
+	void ParticleEmitter::Clear()
+	{
+		m_Buffer.Clear();
+		m_Bounds.Clear();
+		m_EmitAccumulator = 0.0f;
+		m_PendingBurst = 0;
+	}
+
+	void ParticleEmitter::SetMaxParticles(uint32_t maxParticles)
+	{
+		m_MaxParticles = Maths::Max(maxParticles, 1u);
+		m_Buffer.Resize(m_MaxParticles);
+	}
+
+	void ParticleEmitter::SetLifeTime(float minLifeTime, float maxLifeTime)
+	{
+		m_MinLifeTime = Maths::Max(minLifeTime, 0.001f);
+		m_MaxLifeTime = Maths::Max(maxLifeTime, m_MinLifeTime);
+	}
+
+	void ParticleEmitter::SetTextureFromFile(const std::string& filePath)
+	{
+		auto texture = Ref<Texture2D>(Texture2D::CreateFromFile(filePath, filePath));
+		if(texture)
+			m_Texture = texture;
+	}
+}
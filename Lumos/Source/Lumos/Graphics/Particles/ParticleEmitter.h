@@ -0,0 +1,152 @@
+#pragma once
+#include "ParticleBuffer.h"
+#include "Graphics/API/Texture.h"
+#include "Core/VFS.h"
+
+#include <cereal/cereal.hpp>
+
+namespace Lumos::Graphics
+{
+	//Spawns particles into a pooled ParticleBuffer at the entity's position. Particles live in world space,
+	//they are simulated by ParticleSystem and drawn as camera facing billboards or as Renderer2D quads
+	class LUMOS_EXPORT ParticleEmitter
+	{
+	public:
+		enum class RenderMode : uint8_t
+		{
+			Billboard,
+			Sprite
+		};
+
+		ParticleEmitter();
+		~ParticleEmitter() = default;
+
+		//Spawns this frame's particles around position, returns the number spawned
+		uint32_t Emit(float dt, const Maths::Vector3& position);
+
+		//Spawns count extra particles on the next update
+		void Burst(uint32_t count) { m_PendingBurst += count; }
+		void Clear();
+
+		ParticleBuffer& GetBuffer() { return m_Buffer; }
+		const ParticleBuffer& GetBuffer() const { return m_Buffer; }
+		uint32_t GetParticleCount() const { return m_Buffer.GetCount(); }
+
+		//World space bounds of the live particles including their size, updated by ParticleSystem
+		const Maths::BoundingBox& GetBounds() const { return m_Bounds; }
+		void SetBounds(const Maths::BoundingBox& bounds) { m_Bounds = bounds; }
+
+		uint32_t GetMaxParticles() const { return m_MaxParticles; }
+		void SetMaxParticles(uint32_t maxParticles);
+		float GetEmissionRate() const { return m_EmissionRate; }
+		void SetEmissionRate(float rate) { m_EmissionRate = rate; }
+		float GetMinLifeTime() const { return m_MinLifeTime; }
+		float GetMaxLifeTime() const { return m_MaxLifeTime; }
+		void SetLifeTime(float minLifeTime, float maxLifeTime);
+		const Maths::Vector3& GetSpawnExtent() const { return m_SpawnExtent; }
+		void SetSpawnExtent(const Maths::Vector3& extent) { m_SpawnExtent = extent; }
+		const Maths::Vector3& GetVelocity() const { return m_Velocity; }
+		void SetVelocity(const Maths::Vector3& velocity) { m_Velocity = velocity; }
+		const Maths::Vector3& GetVelocitySpread() const { return m_VelocitySpread; }
+		void SetVelocitySpread(const Maths::Vector3& spread) { m_VelocitySpread = spread; }
+		const Maths::Vector3& GetGravity() const { return m_Gravity; }
+		void SetGravity(const Maths::Vector3& gravity) { m_Gravity = gravity; }
+		const Maths::Vector4& GetStartColour() const { return m_StartColour; }
+		void SetStartColour(const Maths::Vector4& colour) { m_StartColour = colour; }
+		const Maths::Vector4& GetEndColour() const { return m_EndColour; }
+		void SetEndColour(const Maths::Vector4& colour) { m_EndColour = colour; }
+		float GetStartSize() const { return m_StartSize; }
+		void SetStartSize(float size) { m_StartSize = size; }
+		float GetEndSize() const { return m_EndSize; }
+		void SetEndSize(float size) { m_EndSize = size; }
+		RenderMode GetRenderMode() const { return m_RenderMode; }
+		void SetRenderMode(RenderMode mode) { m_RenderMode = mode; }
+		bool GetEmitting() const { return m_Emitting; }
+		void SetEmitting(bool emitting) { m_Emitting = emitting; }
+
+		Texture2D* GetTexture() const { return m_Texture.get(); }
+		const Ref<Texture2D>& GetTextureRef() const { return m_Texture; }
+		void SetTexture(const Ref<Texture2D>& texture) { m_Texture = texture; }
+		void SetTextureFromFile(const std::string& filePath);
+
+		template<typename Archive>
+		void save(Archive& archive) const
+		{
+			std::string texturePath = "";
+			if(m_Texture)
+				VFS::Get()->AbsoulePathToVFS(m_Texture->GetFilepath(), texturePath);
+
+			archive(cereal::make_nvp("TexturePath", texturePath),
+				cereal::make_nvp("MaxParticles", m_MaxParticles),
+				cereal::make_nvp("EmissionRate", m_EmissionRate),
+				cereal::make_nvp("MinLifeTime", m_MinLifeTime),
+				cereal::make_nvp("MaxLifeTime", m_MaxLifeTime),
+				cereal::make_nvp("SpawnExtent", m_SpawnExtent),
+				cereal::make_nvp("Velocity", m_Velocity),
+				cereal::make_nvp("VelocitySpread", m_VelocitySpread),
+				cereal::make_nvp("Gravity", m_Gravity),
+				cereal::make_nvp("StartColour", m_StartColour),
+				cereal::make_nvp("EndColour", m_EndColour),
+				cereal::make_nvp("StartSize", m_StartSize),
+				cereal::make_nvp("EndSize", m_EndSize),
+				cereal::make_nvp("RenderMode", int(m_RenderMode)),
+				cereal::make_nvp("Emitting", m_Emitting));
+		}
+
+		template<typename Archive>
+		void load(Archive& archive)
+		{
+			std::string texturePath;
+			uint32_t maxParticles;
+			int renderMode;
+
+			archive(cereal::make_nvp("TexturePath", texturePath),
+				cereal::make_nvp("MaxParticles", maxParticles),
+				cereal::make_nvp("EmissionRate", m_EmissionRate),
+				cereal::make_nvp("MinLifeTime", m_MinLifeTime),
+				cereal::make_nvp("MaxLifeTime", m_MaxLifeTime),
+				cereal::make_nvp("SpawnExtent", m_SpawnExtent),
+				cereal::make_nvp("Velocity", m_Velocity),
+				cereal::make_nvp("VelocitySpread", m_VelocitySpread),
+				cereal::make_nvp("Gravity", m_Gravity),
+				cereal::make_nvp("StartColour", m_StartColour),
+				cereal::make_nvp("EndColour", m_EndColour),
+				cereal::make_nvp("StartSize", m_StartSize),
+				cereal::make_nvp("EndSize", m_EndSize),
+				cereal::make_nvp("RenderMode", renderMode),
+				cereal::make_nvp("Emitting", m_Emitting));
+
+			m_RenderMode = RenderMode(renderMode);
+			SetMaxParticles(maxParticles);
+
+			if(!texturePath.empty())
+				m_Texture = Ref<Texture2D>(Texture2D::CreateFromFile("particle", texturePath));
+		}
+
+	private:
+		float Random(float min, float max);
+
+		ParticleBuffer m_Buffer;
+		Maths::BoundingBox m_Bounds;
+
+		uint32_t m_MaxParticles = 1000;
+		float m_EmissionRate = 50.0f;
+		float m_MinLifeTime = 1.0f;
+		float m_MaxLifeTime = 2.0f;
+		Maths::Vector3 m_SpawnExtent = Maths::Vector3(0.0f);
+		Maths::Vector3 m_Velocity = Maths::Vector3(0.0f, 2.0f, 0.0f);
+		Maths::Vector3 m_VelocitySpread = Maths::Vector3(0.5f, 0.5f, 0.5f);
+		Maths::Vector3 m_Gravity = Maths::Vector3(0.0f, -1.0f, 0.0f);
+		Maths::Vector4 m_StartColour = Maths::Vector4(1.0f);
+		Maths::Vector4 m_EndColour = Maths::Vector4(1.0f, 1.0f, 1.0f, 0.0f);
+		float m_StartSize = 0.2f;
+		float m_EndSize = 0.05f;
+		RenderMode m_RenderMode = RenderMode::Billboard;
+		bool m_Emitting = true;
+		Ref<Texture2D> m_Texture;
+
+		float m_EmitAccumulator = 0.0f;
+		uint32_t m_PendingBurst = 0;
+		uint32_t m_Seed;
+	};
+}
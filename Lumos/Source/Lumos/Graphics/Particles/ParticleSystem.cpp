@@ -0,0 +1,251 @@
+#include "Precompiled.h"
+#include "ParticleSystem.h"
+#include "ParticleEmitter.h"
+#include "Core/JobSystem.h"
+#include "Maths/Transform.h"
+#include "Graphics/Renderers/DebugRenderer.h"
+#include "Utilities/TimeStep.h"
+#include "Utilities/Timer.h"
+
+#include <entt/entity/registry.hpp>
+#include <imgui/imgui.h>
+
+namespace Lumos
+{
+	//Particles per integration and instance packing job, a multiple of four
+	static const uint32_t ParticleChunkSize = 16384;
+
+	ParticleSystem::ParticleSystem()
+	{
+		m_DebugName = "Particles";
+	}
+
+	void ParticleSystem::OnUpdate(const TimeStep& dt, Scene* scene)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		if(m_Paused || !scene)
+			return;
+
+		Timer timer;
+		timer.GetTimedMS();
+
+		auto& registry = scene->GetRegistry();
+
+		m_Jobs.clear();
+		auto view = registry.view<Graphics::ParticleEmitter, Maths::Transform>();
+		for(auto entity : view)
+		{
+			const auto& [emitter, transform] = view.get<Graphics::ParticleEmitter, Maths::Transform>(entity);
+			m_Jobs.push_back({ &emitter, transform.GetWorldPosition() });
+		}
+
+		Simulate(m_Jobs, m_Chunks, dt.GetSeconds());
+
+		m_ParticleCount = 0;
+		m_DebugBounds.clear();
+		for(auto& job : m_Jobs)
+		{
+			m_ParticleCount += job.Emitter->GetParticleCount();
+			if(m_DrawBounds && job.Emitter->GetParticleCount() > 0)
+				m_DebugBounds.push_back(job.Emitter->GetBounds());
+		}
+
+		m_UpdateTime = timer.GetTimedMS();
+	}
+
+	void ParticleSystem::Simulate(std::vector<EmitterJob>& jobs, std::vector<Chunk>& chunks, float dt)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		const uint32_t jobCount = uint32_t(jobs.size());
+
+		System::JobSystem::Dispatch(jobCount, 4, [&](JobDispatchArgs args)
+			{
+				EmitterJob& job = jobs[args.jobIndex];
+				job.Emitter->Emit(dt, job.Position);
+			});
+		System::JobSystem::Wait();
+
+		chunks.clear();
+		for(uint32_t i = 0; i < jobCount; i++)
+		{
+			const uint32_t count = jobs[i].Emitter->GetParticleCount();
+			for(uint32_t start = 0; start < count; start += ParticleChunkSize)
+				chunks.push_back({ i, start, Maths::Min(start + ParticleChunkSize, count), Maths::BoundingBox() });
+		}
+
+		//Bounds are taken before dead particles are removed, they can only be slightly larger than needed
+		System::JobSystem::Dispatch(uint32_t(chunks.size()), 1, [&](JobDispatchArgs args)
+			{
+				Chunk& chunk = chunks[args.jobIndex];
+				Graphics::ParticleEmitter* emitter = jobs[chunk.Job].Emitter;
+				Graphics::ParticleKernels::Integrate(emitter->GetBuffer(), chunk.Start, chunk.End, emitter->GetGravity(), dt);
+				chunk.Bounds = Graphics::ParticleKernels::ComputeBounds(emitter->GetBuffer(), chunk.Start, chunk.End);
+			});
+
+		System::JobSystem::Wait();
+		System::JobSystem::Dispatch(jobCount, 4, [&](JobDispatchArgs args)
+			{
+				Graphics::ParticleKernels::RemoveDead(jobs[args.jobIndex].Emitter->GetBuffer());
+			});
+		System::JobSystem::Wait();
+
+		for(auto& job : jobs)
+			job.Emitter->SetBounds(Maths::BoundingBox());
+
+		for(auto& chunk : chunks)
+		{
+			Graphics::ParticleEmitter* emitter = jobs[chunk.Job].Emitter;
+			Maths::BoundingBox bounds = emitter->GetBounds();
+			bounds.Merge(chunk.Bounds);
+			emitter->SetBounds(bounds);
+		}
+
+		//Grow by the largest particle so billboards at the edges aren't culled
+		for(auto& job : jobs)
+		{
+			if(job.Emitter->GetParticleCount() == 0)
+				continue;
+
+			const float extent = Maths::Max(job.Emitter->GetStartSize(), job.Emitter->GetEndSize()) * 0.5f;
+			const Maths::BoundingBox& bounds = job.Emitter->GetBounds();
+			job.Emitter->SetBounds(Maths::BoundingBox(bounds.min_ - Maths::Vector3(extent), bounds.max_ + Maths::Vector3(extent)));
+		}
+	}
+
+	void ParticleSystem::WriteInstances(const Graphics::ParticleEmitter* const* emitters, uint32_t emitterCount, Graphics::ParticleInstance* out)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		struct WriteChunk
+		{
+			const Graphics::ParticleEmitter* Emitter;
+			uint32_t Start;
+			uint32_t End;
+			uint32_t Offset;
+		};
+
+		std::vector<WriteChunk> chunks;
+		uint32_t offset = 0;
+		for(uint32_t i = 0; i < emitterCount; i++)
+		{
+			const uint32_t count = emitters[i]->GetParticleCount();
+			for(uint32_t start = 0; start < count; start += ParticleChunkSize)
+			{
+				const uint32_t end = Maths::Min(start + ParticleChunkSize, count);
+				chunks.push_back({ emitters[i], start, end, offset });
+				offset += end - start;
+			}
+		}
+
+		if(chunks.size() > 1)
+		{
+			System::JobSystem::Dispatch(uint32_t(chunks.size()), 1, [&](JobDispatchArgs args)
+				{
+					const WriteChunk& chunk = chunks[args.jobIndex];
+					Graphics::ParticleKernels::WriteInstances(chunk.Emitter->GetBuffer(), chunk.Start, chunk.End, out + chunk.Offset);
+				});
+			System::JobSystem::Wait();
+		}
+		else if(!chunks.empty())
+			Graphics::ParticleKernels::WriteInstances(chunks[0].Emitter->GetBuffer(), chunks[0].Start, chunks[0].End, out);
+	}
+
+	void ParticleSystem::RunBenchmark(uint32_t particleCount)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		const uint32_t frames = 60;
+		const float dt = 1.0f / 60.0f;
+
+		//Lifetimes are long enough that the pool stays close to full, the emission rate replaces what dies
+		Graphics::ParticleEmitter emitter;
+		emitter.SetMaxParticles(particleCount);
+		emitter.SetLifeTime(2.0f, 4.0f);
+		emitter.SetSpawnExtent(Maths::Vector3(10.0f));
+		emitter.SetEmissionRate(float(particleCount) / 3.0f);
+		emitter.Burst(particleCount);
+
+		std::vector<EmitterJob> jobs = { { &emitter, Maths::Vector3(0.0f) } };
+		std::vector<Chunk> chunks;
+		Simulate(jobs, chunks, dt);
+
+		Timer timer;
+		timer.GetTimedMS();
+		uint64_t simulated = 0;
+		for(uint32_t frame = 0; frame < frames; frame++)
+		{
+			simulated += emitter.GetParticleCount();
+			Simulate(jobs, chunks, dt);
+		}
+		const float updateTime = timer.GetTimedMS() / frames;
+
+		std::vector<Graphics::ParticleInstance> instances(emitter.GetParticleCount());
+		const Graphics::ParticleEmitter* emitters[] = { &emitter };
+		timer.GetTimedMS();
+		for(uint32_t frame = 0; frame < frames; frame++)
+			WriteInstances(emitters, 1, instances.data());
+		const float packTime = timer.GetTimedMS() / frames;
+
+		LUMOS_LOG_INFO("Particle benchmark, {0} particles, {1} frames", particleCount, frames);
+		LUMOS_LOG_INFO("Update {0:.3f}ms, Instance packing {1:.3f}ms, {2:.1f}M particles/s", updateTime, packTime, float(simulated) / (updateTime * frames * 1000.0f));
+	}
+
+	void ParticleSystem::OnDebugDraw()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		for(auto& bounds : m_DebugBounds)
+			DebugRenderer::DebugDraw(bounds, Maths::Vector4(1.0f, 0.5f, 0.0f, 1.0f), true);
+	}
+
+	void ParticleSystem::OnImGui()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		ImGui::TextUnformatted("Particles");
+
+		ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(2, 2));
+		ImGui::Columns(2);
+		ImGui::Separator();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Emitters");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Text("%5.2i", static_cast<int>(m_Jobs.size()));
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Particles");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Text("%5.2i", static_cast<int>(m_ParticleCount));
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Update Time (ms)");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Text("%5.3f", m_UpdateTime);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Paused");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Checkbox("##Paused", &m_Paused);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Draw Bounds");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Checkbox("##DrawBounds", &m_DrawBounds);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
+		ImGui::Columns(1);
+		ImGui::Separator();
+		ImGui::PopStyleVar();
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Scene/ISystem.h"
+#include "Maths/Maths.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		class ParticleEmitter;
+		struct ParticleInstance;
+	}
+
+	//Simulates every ParticleEmitter. Spawning is done per emitter, integration is split into fixed size
+	//chunks so a single large emitter still spreads across the job system
+	class LUMOS_EXPORT ParticleSystem : public ISystem
+	{
+	public:
+		ParticleSystem();
+		virtual ~ParticleSystem() override = default;
+
+		void OnInit() override {};
+		void OnUpdate(const TimeStep& dt, Scene* scene) override;
+		void OnImGui() override;
+		void OnDebugDraw() override;
+
+		bool GetPaused() const { return m_Paused; }
+		void SetPaused(bool paused) { m_Paused = paused; }
+
+		//Transposes the emitters' particles into out back to back, in parallel for large counts
+		static void WriteInstances(const Graphics::ParticleEmitter* const* emitters, uint32_t emitterCount, Graphics::ParticleInstance* out);
+
+		//Simulates a standalone emitter with particleCount live particles and logs the update and instance packing times
+		static void RunBenchmark(uint32_t particleCount = 1000000);
+
+		struct EmitterJob
+		{
+			Graphics::ParticleEmitter* Emitter;
+			Maths::Vector3 Position;
+		};
+
+		struct Chunk
+		{
+			uint32_t Job;
+			uint32_t Start;
+			uint32_t End;
+			Maths::BoundingBox Bounds;
+		};
+
+		static void Simulate(std::vector<EmitterJob>& jobs, std::vector<Chunk>& chunks, float dt);
+
+	private:
+		std::vector<EmitterJob> m_Jobs;
+		std::vector<Chunk> m_Chunks;
+		std::vector<Maths::BoundingBox> m_DebugBounds;
+
+		uint32_t m_ParticleCount = 0;
+		float m_UpdateTime = 0.0f;
+		bool m_Paused = false;
+		bool m_DrawBounds = false;
+	};
+}
@@ -29,6 +29,7 @@ namespace Lumos
 			virtual ~Renderable2D();
 
 			Texture2D* GetTexture() const { return m_Texture.get(); }
+			const Ref<Texture2D>& GetTextureRef() const { return m_Texture; }
 			Maths::Vector2 GetPosition() const { return m_Position; }
 			Maths::Vector2 GetScale() const { return m_Scale; }
 			const Maths::Vector4& GetColour() const { return m_Colour; }
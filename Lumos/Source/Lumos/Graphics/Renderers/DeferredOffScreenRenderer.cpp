@@ -13,6 +13,12 @@
 #include "Graphics/Model.h"
 #include "Graphics/Material.h"
 #include "Graphics/GBuffer.h"
+#include "Graphics/GPUScene.h"
+#include "Graphics/MaterialTable.h"
+#include "ParallelCommandRecorder.h"
+#include "Graphics/Animation/Animator.h"
+#include "Graphics/Animation/AnimationSystem.h"
+#include "Graphics/Terrain/ChunkedTerrain.h"
 
 #include "Graphics/API/Shader.h"
 #include "Graphics/API/Framebuffer.h"
@@ -29,7 +35,7 @@
 
 #define MAX_LIGHTS 32
 #define MAX_SHADOWMAPS 16
-#define MAX_BONES 100
+#define MIN_BONE_CAPACITY 256
 
 namespace Lumos
 {
@@ -58,16 +64,15 @@ namespace Lumos
 		DeferredOffScreenRenderer::~DeferredOffScreenRenderer()
 		{
 			delete m_UniformBuffer;
-            delete m_AnimUniformBuffer;
+            delete m_BoneBuffer;
 			delete m_DeferredCommandBuffers;
 			delete m_DefaultMaterial;
 
 			delete[] m_VSSystemUniformBuffer;
             
-            for(auto& pc: m_PushConstants)
-                delete[] pc.data;
-            
             m_PushConstants.clear();
+            m_AnimPushConstants.clear();
+			m_BindlessPushConstants.clear();
 			m_Framebuffers.clear();
 			m_CommandBuffers.clear();
 		}
@@ -75,7 +80,7 @@ namespace Lumos
 		void DeferredOffScreenRenderer::Init()
 		{
 			LUMOS_PROFILE_FUNCTION();
-			m_Shader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/DeferredColour.shader");
+			LoadShaders();
             m_AnimatedShader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/DeferredColourAnim.shader");
 
 			m_DefaultMaterial = new Material();
@@ -93,7 +98,7 @@ namespace Lumos
 			const size_t minUboAlignment = size_t(Graphics::Renderer::GetCapabilities().UniformBufferOffsetAlignment);
 
 			m_UniformBuffer = nullptr;
-            m_AnimUniformBuffer = nullptr;
+            m_BoneBuffer = nullptr;
 
 			m_CommandQueue.reserve(1000);
 
@@ -104,37 +109,35 @@ namespace Lumos
 			m_VSSystemUniformBuffer = new uint8_t[m_VSSystemUniformBufferSize];
 			memset(m_VSSystemUniformBuffer, 0, m_VSSystemUniformBufferSize);
 			m_VSSystemUniformBufferOffsets.resize(VSSystemUniformIndex_Size);
-            
-            //Animated Vertex shader uniform
-            m_VSSystemUniformBufferAnimSize = sizeof(Maths::Matrix4) * MAX_BONES;
-            m_VSSystemUniformBufferAnim = new uint8_t[m_VSSystemUniformBufferAnimSize];
-            memset(m_VSSystemUniformBufferAnim, 0, m_VSSystemUniformBufferAnimSize);
 
 			// Per Scene System Uniforms
 			m_VSSystemUniformBufferOffsets[VSSystemUniformIndex_ProjectionViewMatrix] = 0;
 
-			AttachmentInfo textureTypesOffScreen[5] =
-				{
-					{TextureType::COLOUR, Application::Get().GetRenderGraph()->GetGBuffer()->GetTextureFormat(SCREENTEX_COLOUR)},
-					{TextureType::COLOUR, Application::Get().GetRenderGraph()->GetGBuffer()->GetTextureFormat(SCREENTEX_POSITION)},
-					{TextureType::COLOUR, Application::Get().GetRenderGraph()->GetGBuffer()->GetTextureFormat(SCREENTEX_NORMALS)},
-					{TextureType::COLOUR, Application::Get().GetRenderGraph()->GetGBuffer()->GetTextureFormat(SCREENTEX_PBR)},
-					{TextureType::DEPTH, TextureFormat::DEPTH}};
-
-			Graphics::RenderPassInfo renderpassCIOffScreen{};
-			renderpassCIOffScreen.attachmentCount = 5;
-			renderpassCIOffScreen.textureType = textureTypesOffScreen;
+			CreateRenderPass();
 
-            m_RenderPass = Graphics::RenderPass::Get(renderpassCIOffScreen);
-
-            
+			//Push constant data points at each recording chunk's own copy, see RecordCommands
             auto pushConstant = Graphics::PushConstant();
             pushConstant.size = sizeof(Lumos::Maths::Matrix4);
-            pushConstant.data = new uint8_t[sizeof(Lumos::Maths::Matrix4)];
+            pushConstant.data = nullptr;
             pushConstant.shaderStage = ShaderType::VERTEX;
             
             m_PushConstants.push_back(pushConstant);
 
+            //Transform followed by the bone offset
+            auto animPushConstant = Graphics::PushConstant();
+            animPushConstant.size = sizeof(Lumos::Maths::Matrix4) + sizeof(uint32_t);
+            animPushConstant.data = nullptr;
+            animPushConstant.shaderStage = ShaderType::VERTEX;
+
+            m_AnimPushConstants.push_back(animPushConstant);
+
+			auto bindlessPushConstant = Graphics::PushConstant();
+			bindlessPushConstant.size = sizeof(Lumos::Maths::Matrix4) + sizeof(uint32_t);
+			bindlessPushConstant.data = nullptr;
+			bindlessPushConstant.shaderStage = ShaderType::VERTEX;
+
+			m_BindlessPushConstants.push_back(bindlessPushConstant);
+
 			m_CommandBuffers.resize(Renderer::GetSwapchain()->GetSwapchainBufferCount());
 
 			for(auto& commandBuffer : m_CommandBuffers)
@@ -146,6 +149,8 @@ namespace Lumos
 			m_DeferredCommandBuffers = Graphics::CommandBuffer::Create();
 			m_DeferredCommandBuffers->Init(true);
 
+			m_Recorder = CreateUniqueRef<ParallelCommandRecorder>();
+
 			CreatePipeline();
 			CreateBuffer();
 			CreateFramebuffer();
@@ -153,13 +158,239 @@ namespace Lumos
 			m_DefaultMaterial->CreateDescriptorSet(m_Pipeline.get(), 1);
 
 			m_ClearColour = Maths::Vector4(0.1f, 0.1f, 0.1f, 1.0f);
-            m_CurrentDescriptorSets.resize(2);
+		}
+
+		void DeferredOffScreenRenderer::LoadShaders()
+		{
+			if(Application::Get().GetRenderGraph()->GetGBuffer()->GetLayout() == GBufferLayout::THIN)
+				m_Shader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/DeferredColour.shader");
+			else
+				m_Shader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/DeferredColourLegacy.shader");
+		}
+
+		void DeferredOffScreenRenderer::CreateRenderPass()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			AttachmentInfo textureTypesOffScreen[5] =
+				{
+					{TextureType::COLOUR, Application::Get().GetRenderGraph()->GetGBuffer()->GetTextureFormat(SCREENTEX_COLOUR)},
+					{TextureType::COLOUR, Application::Get().GetRenderGraph()->GetGBuffer()->GetTextureFormat(SCREENTEX_POSITION)},
+					{TextureType::COLOUR, Application::Get().GetRenderGraph()->GetGBuffer()->GetTextureFormat(SCREENTEX_NORMALS)},
+					{TextureType::COLOUR, Application::Get().GetRenderGraph()->GetGBuffer()->GetTextureFormat(SCREENTEX_PBR)},
+					{TextureType::DEPTH, TextureFormat::DEPTH}};
+
+			Graphics::RenderPassInfo renderpassCIOffScreen{};
+			renderpassCIOffScreen.attachmentCount = 5;
+			renderpassCIOffScreen.textureType = textureTypesOffScreen;
+
+            m_RenderPass = Graphics::RenderPass::Get(renderpassCIOffScreen);
+		}
+
+		void DeferredOffScreenRenderer::OnGBufferLayoutChanged()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_Framebuffers.clear();
+
+			LoadShaders();
+			CreateRenderPass();
+			CreatePipeline();
+			CreateBuffer();
+			CreateFramebuffer();
+
+			//Materials recreate their descriptor sets in BeginScene once they see the new pipeline
+			m_DefaultMaterial->CreateDescriptorSet(m_Pipeline.get(), 1);
+
+			//The bindless shaders only write the thin layout
+			if(m_Bindless && Application::Get().GetRenderGraph()->GetGBuffer()->GetLayout() != GBufferLayout::THIN)
+			{
+				LUMOS_LOG_WARN("Bindless materials are only supported with the thin GBuffer layout");
+				SetBindless(false);
+			}
+			else if(m_Bindless)
+				CreateBindlessPipeline();
+
+			if(m_GPUDriven)
+				CreateIndirectPipeline();
+		}
+
+		void DeferredOffScreenRenderer::SetBindless(bool enabled)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(enabled && !Renderer::GetCapabilities().SupportsBindless)
+			{
+				LUMOS_LOG_WARN("Bindless materials are not supported by this render api");
+				enabled = false;
+			}
+
+			if(enabled && Application::Get().GetRenderGraph()->GetGBuffer()->GetLayout() != GBufferLayout::THIN)
+			{
+				LUMOS_LOG_WARN("Bindless materials are only supported with the thin GBuffer layout");
+				enabled = false;
+			}
+
+			if(m_Bindless == enabled)
+				return;
+
+			m_Bindless = enabled;
+
+			if(m_Bindless)
+			{
+				m_MaterialTable = CreateUniqueRef<MaterialTable>();
+				CreateBindlessPipeline();
+			}
+			else
+			{
+				m_MaterialTable.reset();
+				m_BindlessPipeline.reset();
+			}
+
+			if(m_GPUDriven)
+				CreateIndirectPipeline();
+		}
+
+		void DeferredOffScreenRenderer::CreateBindlessPipeline()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_BindlessShader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/DeferredColourBindless.shader");
+
+            Graphics::BufferLayout vertexBufferLayout;
+            vertexBufferLayout.Push<Maths::Vector3>("position");
+            vertexBufferLayout.Push<Maths::Vector4>("colour");
+            vertexBufferLayout.Push<Maths::Vector2>("uv");
+            vertexBufferLayout.Push<Maths::Vector3>("normal");
+            vertexBufferLayout.Push<Maths::Vector3>("tangent");
+
+			Graphics::PipelineInfo pipelineCreateInfo{};
+			pipelineCreateInfo.shader = m_BindlessShader;
+			pipelineCreateInfo.renderpass = m_RenderPass;
+            pipelineCreateInfo.vertexBufferLayout = vertexBufferLayout;
+            pipelineCreateInfo.polygonMode = Graphics::PolygonMode::FILL;
+			pipelineCreateInfo.cullMode = Graphics::CullMode::BACK;
+			pipelineCreateInfo.transparencyEnabled = false;
+			pipelineCreateInfo.depthBiasEnabled = false;
+
+			m_BindlessPipeline = Graphics::Pipeline::Get(pipelineCreateInfo);
+
+			Graphics::BufferInfo bufferInfo = {};
+			bufferInfo.buffer = m_UniformBuffer;
+			bufferInfo.offset = 0;
+			bufferInfo.size = m_VSSystemUniformBufferSize;
+			bufferInfo.type = Graphics::DescriptorType::UNIFORM_BUFFER;
+			bufferInfo.binding = 0;
+			bufferInfo.shaderType = ShaderType::VERTEX;
+			bufferInfo.name = "UniformBufferObject";
+
+			std::vector<Graphics::BufferInfo> bufferInfos = { bufferInfo };
+			m_BindlessPipeline->GetDescriptorSet()->Update(bufferInfos);
+		}
+
+		void DeferredOffScreenRenderer::SetGPUDriven(bool enabled)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(enabled && !Renderer::GetCapabilities().SupportsIndirectDraw)
+			{
+				LUMOS_LOG_WARN("GPU driven rendering is not supported by this render api");
+				enabled = false;
+			}
+
+			if(m_GPUDriven == enabled)
+				return;
+
+			m_GPUDriven = enabled;
+
+			if(m_GPUDriven)
+			{
+				m_GPUScene = CreateUniqueRef<GPUScene>();
+				CreateIndirectPipeline();
+			}
+			else
+			{
+				m_GPUScene.reset();
+				m_IndirectPipeline.reset();
+				m_CurrentScene = nullptr;
+			}
+		}
+
+		void DeferredOffScreenRenderer::CreateIndirectPipeline()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(m_Bindless)
+				m_IndirectShader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/DeferredColourIndirectBindless.shader");
+			else if(Application::Get().GetRenderGraph()->GetGBuffer()->GetLayout() == GBufferLayout::THIN)
+				m_IndirectShader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/DeferredColourIndirect.shader");
+			else
+				m_IndirectShader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/DeferredColourIndirectLegacy.shader");
+
+            Graphics::BufferLayout vertexBufferLayout;
+            vertexBufferLayout.Push<Maths::Vector3>("position");
+            vertexBufferLayout.Push<Maths::Vector4>("colour");
+            vertexBufferLayout.Push<Maths::Vector2>("uv");
+            vertexBufferLayout.Push<Maths::Vector3>("normal");
+            vertexBufferLayout.Push<Maths::Vector3>("tangent");
+
+			Graphics::PipelineInfo pipelineCreateInfo{};
+			pipelineCreateInfo.shader = m_IndirectShader;
+			pipelineCreateInfo.renderpass = m_RenderPass;
+            pipelineCreateInfo.vertexBufferLayout = vertexBufferLayout;
+            pipelineCreateInfo.polygonMode = Graphics::PolygonMode::FILL;
+			pipelineCreateInfo.cullMode = Graphics::CullMode::BACK;
+			pipelineCreateInfo.transparencyEnabled = false;
+			pipelineCreateInfo.depthBiasEnabled = false;
+
+			m_IndirectPipeline = Graphics::Pipeline::Get(pipelineCreateInfo);
+			m_GPUScene->SetBuffersChanged(true);
+		}
+
+		void DeferredOffScreenRenderer::UpdateIndirectDescriptorSet()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_GPUScene->SetBuffersChanged(false);
+
+			Graphics::BufferInfo bufferInfo = {};
+			bufferInfo.buffer = m_UniformBuffer;
+			bufferInfo.offset = 0;
+			bufferInfo.size = m_VSSystemUniformBufferSize;
+			bufferInfo.type = Graphics::DescriptorType::UNIFORM_BUFFER;
+			bufferInfo.binding = 0;
+			bufferInfo.shaderType = ShaderType::VERTEX;
+			bufferInfo.name = "UniformBufferObject";
+
+			Graphics::BufferInfo instanceBufferInfo = {};
+			instanceBufferInfo.buffer = m_GPUScene->GetInstanceBuffer();
+			instanceBufferInfo.offset = 0;
+			instanceBufferInfo.size = m_GPUScene->GetInstanceBufferSize();
+			instanceBufferInfo.type = Graphics::DescriptorType::STORAGE_BUFFER;
+			instanceBufferInfo.binding = 1;
+			instanceBufferInfo.shaderType = ShaderType::VERTEX;
+			instanceBufferInfo.name = "InstanceBuffer";
+
+			std::vector<Graphics::BufferInfo> bufferInfos = { bufferInfo, instanceBufferInfo };
+			m_IndirectPipeline->GetDescriptorSet()->Update(bufferInfos);
 		}
 
 		void DeferredOffScreenRenderer::RenderScene()
 		{
 			LUMOS_PROFILE_FUNCTION();
 
+			m_RecordingStarted = false;
+			m_RecordParallel = m_ParallelRecording && ParallelCommandRecorder::IsSupported();
+
+			if(m_GPUDriven && m_Camera)
+			{
+				//Culling dispatches have to be recorded before the renderpass begins
+				m_DeferredCommandBuffers->BeginRecording();
+				m_RecordingStarted = true;
+
+				auto gbuffer = Application::Get().GetRenderGraph()->GetGBuffer();
+				m_GPUScene->Cull(m_DeferredCommandBuffers, m_ProjView, gbuffer->GetDepthTexture(), gbuffer->GetWidth(), gbuffer->GetHeight());
+
+				if(m_GPUScene->GetBuffersChanged() && m_GPUScene->GetInstanceBuffer())
+					UpdateIndirectDescriptorSet();
+			}
+
+			if(m_Bindless)
+				m_MaterialTable->Upload(m_BindlessPipeline.get());
+
 			Begin();
 			SetSystemUniforms(m_Shader.get());
 			Present();
@@ -175,7 +406,7 @@ namespace Lumos
 		void DeferredOffScreenRenderer::Begin()
 		{
 			LUMOS_PROFILE_FUNCTION();
-			m_RenderPass->BeginRenderpass(m_DeferredCommandBuffers, Maths::Vector4(0.0f), m_Framebuffers.front().get(), Graphics::INLINE, m_ScreenBufferWidth, m_ScreenBufferHeight);
+			m_RenderPass->BeginRenderpass(m_DeferredCommandBuffers, Maths::Vector4(0.0f), m_Framebuffers.front().get(), m_RecordParallel ? Graphics::SECONDARY : Graphics::INLINE, m_ScreenBufferWidth, m_ScreenBufferHeight, !m_RecordingStarted);
 		}
 
 		void DeferredOffScreenRenderer::BeginScene(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform)
@@ -198,14 +429,66 @@ namespace Lumos
                 LUMOS_ASSERT(m_Camera, "No Camera Set for Renderer");
                 auto projView = m_Camera->GetProjectionMatrix() * view;
                 memcpy(m_VSSystemUniformBuffer + m_VSSystemUniformBufferOffsets[VSSystemUniformIndex_ProjectionViewMatrix], &projView, sizeof(Maths::Matrix4));
+                m_ProjView = projView;
 
                 m_Frustum = m_Camera->GetFrustum(view);
+                m_CameraPosition = m_CameraTransform->GetWorldPosition();
             }
 			
+            if(m_GPUDriven)
+            {
+                //Pooled geometry belongs to the previous scene
+                if(scene != m_CurrentScene)
+                {
+                    m_GPUScene->Clear();
+                    m_CurrentScene = scene;
+                }
+
+                m_GPUScene->BeginFrame();
+            }
+
+			if(m_Bindless)
+				m_MaterialTable->BeginFrame();
+
+            {
+                LUMOS_PROFILE_SCOPE("Bone Palette");
+                auto animationSystem = Application::Get().GetSystem<AnimationSystem>();
+                m_BonePalette = animationSystem ? &animationSystem->GetBonePalette(scene) : nullptr;
+
+                const uint32_t boneCount = m_BonePalette ? uint32_t(m_BonePalette->size()) : 0;
+                if(boneCount > m_BoneBufferCapacity)
+                {
+                    m_BoneBufferCapacity = Maths::Max(m_BoneBufferCapacity, uint32_t(MIN_BONE_CAPACITY));
+                    while(m_BoneBufferCapacity < boneCount)
+                        m_BoneBufferCapacity *= 2;
+
+                    delete m_BoneBuffer;
+                    m_BoneBuffer = Graphics::UniformBuffer::Create();
+                    m_BoneBuffer->Init(m_BoneBufferCapacity * sizeof(Maths::Matrix4), nullptr);
+                    UpdateAnimatedDescriptorSet();
+                }
+            }
+
             {
                 auto& registry = scene->GetRegistry();
                 auto group = registry.group<Model>(entt::get<Maths::Transform>);
-                
+
+                auto prepareMaterial = [this](Material* material)
+                {
+                    if(material && (material->GetDescriptorSet() == nullptr || material->GetPipeline() != m_Pipeline.get() || material->GetTexturesUpdated()))
+                    {
+                        LUMOS_PROFILE_SCOPE("Create DescriptorSet");
+
+                        material->CreateDescriptorSet(m_Pipeline.get(), 1);
+                        material->SetTexturesUpdated(false);
+                    }
+                };
+
+                m_CullMeshes.clear();
+                m_CullEntities.clear();
+                m_CullTransforms.clear();
+                m_CullBounds.clear();
+
                 for(auto entity : group)
                 {
                     const auto& [model, trans] = group.get<Model, Maths::Transform>(entity);
@@ -213,38 +496,88 @@ namespace Lumos
                     
                     for(auto& mesh : meshes)
                     {
+                        if(!mesh->GetActive())
+                            continue;
 
-                        if(mesh->GetActive())
-                        {
+                        auto& worldTransform = trans.GetWorldMatrix();
+                        auto material = mesh->GetMaterial();
 
-                            auto& worldTransform = trans.GetWorldMatrix();
-                            Maths::Intersection inside;
+                        //Gpu driven instances are culled in GPUScene::Cull. Skinned meshes need their bone palette so stay on the cpu path
+                        if(m_GPUDriven && !mesh->IsSkinned())
+                        {
+                            const uint32_t materialIndex = m_Bindless ? m_MaterialTable->AddMaterial(material ? material.get() : m_DefaultMaterial) : 0;
+                            if(m_GPUScene->AddInstance(mesh, material.get(), worldTransform, materialIndex))
                             {
-                                LUMOS_PROFILE_SCOPE("Frustum Check");
-
-                                inside = m_Frustum.IsInsideFast(mesh->GetBoundingBox()->Transformed(worldTransform));
-                            }
-                            
-                            if(inside == Maths::Intersection::OUTSIDE)
+                                if(!m_Bindless)
+                                    prepareMaterial(material.get());
                                 continue;
-                            
-                            auto material = mesh->GetMaterial();
-                            if(material)
-                            {
-                                if(material->GetDescriptorSet() == nullptr || material->GetPipeline() != m_Pipeline.get() || material->GetTexturesUpdated())
-                                {
-                                    LUMOS_PROFILE_SCOPE("Create DescriptorSet");
-
-                                    material->CreateDescriptorSet(m_Pipeline.get(), 1);
-                                    material->SetTexturesUpdated(false);
-                                }
                             }
-                            
-                            auto textureMatrixTransform = registry.try_get<TextureMatrixComponent>(entity);
-                            SubmitMesh(mesh.get(), material.get(), worldTransform, textureMatrixTransform ? textureMatrixTransform->GetMatrix() : Maths::Matrix4());
                         }
+
+                        m_CullMeshes.push_back(mesh.get());
+                        m_CullEntities.push_back(entity);
+                        m_CullTransforms.push_back(worldTransform);
+                        m_CullBounds.push_back(*mesh->GetBoundingBox());
                     }
                 }
+
+                //Streamed terrain chunks stay on the cpu path, they come and go too often for the gpu scene pools
+                auto terrainView = registry.view<ChunkedTerrain, Maths::Transform>();
+                for(auto entity : terrainView)
+                {
+                    const auto& [terrain, trans] = terrainView.get<ChunkedTerrain, Maths::Transform>(entity);
+                    for(auto mesh : terrain.GetVisibleChunks())
+                    {
+                        m_CullMeshes.push_back(mesh);
+                        m_CullEntities.push_back(entity);
+                        m_CullTransforms.push_back(trans.GetWorldMatrix());
+                        m_CullBounds.push_back(*mesh->GetBoundingBox());
+                    }
+                }
+
+                const uint32_t meshCount = uint32_t(m_CullMeshes.size());
+                m_CullVisible.resize(meshCount);
+
+                {
+                    LUMOS_PROFILE_SCOPE("Frustum Check");
+                    Maths::Batch::TransformBoundingBoxes(m_CullTransforms.data(), m_CullBounds.data(), meshCount, m_CullWorldBounds);
+                    Maths::Batch::IsInsideFast(m_Frustum, m_CullWorldBounds, m_CullVisible.data());
+                }
+
+                for(uint32_t i = 0; i < meshCount; i++)
+                {
+                    if(!m_CullVisible[i])
+                        continue;
+
+                    Mesh* mesh = m_CullMeshes[i];
+                    RenderCommand command;
+
+                    if(mesh->IsSkinned())
+                    {
+                        //Culled against the bind pose bounds
+                        auto animator = registry.try_get<Animator>(m_CullEntities[i]);
+                        if(!animator || !m_BonePalette || animator->GetPaletteOffset() >= m_BonePalette->size())
+                            continue;
+
+                        command.animated = true;
+                        command.boneOffset = animator->GetPaletteOffset();
+                    }
+
+                    auto material = mesh->GetMaterial();
+                    if(m_Bindless && !command.animated)
+                        command.materialIndex = m_MaterialTable->AddMaterial(material ? material.get() : m_DefaultMaterial);
+                    else
+                        prepareMaterial(material.get());
+
+                    auto textureMatrixTransform = registry.try_get<TextureMatrixComponent>(m_CullEntities[i]);
+
+                    command.mesh = mesh;
+                    command.material = material.get();
+                    command.transform = m_CullTransforms[i];
+                    command.textureMatrix = textureMatrixTransform ? textureMatrixTransform->GetMatrix() : Maths::Matrix4();
+                    command.lod = mesh->SelectLOD(Mesh::GetProjectedScreenSize(m_CullWorldBounds.Get(i), m_CameraPosition, m_Camera->GetProjectionMatrix()));
+                    Submit(command);
+                }
             }
 		}
 
@@ -262,6 +595,11 @@ namespace Lumos
 			command.material = material;
 			command.transform = transform;
 			command.textureMatrix = textureMatrix;
+
+			//Added before RenderScene uploads the table
+			if(m_Bindless)
+				command.materialIndex = m_MaterialTable->AddMaterial(material ? material : m_DefaultMaterial);
+
 			Submit(command);
 		}
 
@@ -280,38 +618,123 @@ namespace Lumos
 		{
 			LUMOS_PROFILE_FUNCTION();
 			m_UniformBuffer->SetData(m_VSSystemUniformBufferSize, *&m_VSSystemUniformBuffer);
-            //Move as per mesh
-            m_AnimUniformBuffer->SetData(m_VSSystemUniformBufferAnimSize, *&m_VSSystemUniformBufferAnim);
+
+            if(m_BonePalette && !m_BonePalette->empty())
+                m_BoneBuffer->SetData(uint32_t(m_BonePalette->size() * sizeof(Maths::Matrix4)), m_BonePalette->data());
 		}
 
 		void DeferredOffScreenRenderer::Present()
 		{
 			LUMOS_PROFILE_FUNCTION();
-			m_Pipeline->Bind(m_DeferredCommandBuffers);
 
-			for(uint32_t i = 0; i < static_cast<uint32_t>(m_CommandQueue.size()); i++)
+			//Skinned meshes are drawn after the static ones so the pipeline only switches once
+			const uint32_t commandCount = uint32_t(m_CommandQueue.size());
+			const uint32_t staticCount = uint32_t(std::stable_partition(m_CommandQueue.begin(), m_CommandQueue.end(), [](const RenderCommand& command) { return !command.animated; }) - m_CommandQueue.begin());
+			const bool drawAnimated = m_BonePalette && !m_BonePalette->empty();
+			const bool drawGPUScene = m_GPUDriven && m_RecordingStarted;
+
+			if(!m_RecordParallel)
+			{
+				RecordCommands(m_DeferredCommandBuffers, 0, staticCount, false);
+
+				if(drawAnimated)
+					RecordCommands(m_DeferredCommandBuffers, staticCount, commandCount, true);
+
+				if(drawGPUScene)
+					RecordGPUScene(m_DeferredCommandBuffers);
+
+				return;
+			}
+
+			m_Recorder->Clear();
+			const uint32_t pass = m_Recorder->AddPass(m_RenderPass.get(), m_Framebuffers.front().get(), m_ScreenBufferWidth, m_ScreenBufferHeight);
+
+			m_Recorder->Add(pass, staticCount, 64, [this](CommandBuffer* commandBuffer, uint32_t begin, uint32_t end)
+			{
+				RecordCommands(commandBuffer, begin, end, false);
+			});
+
+			if(drawAnimated)
+			{
+				m_Recorder->Add(pass, commandCount - staticCount, 64, [this, staticCount](CommandBuffer* commandBuffer, uint32_t begin, uint32_t end)
+				{
+					RecordCommands(commandBuffer, staticCount + begin, staticCount + end, true);
+				});
+			}
+
+			if(drawGPUScene)
+			{
+				m_Recorder->Add(pass, 1, 1, [this](CommandBuffer* commandBuffer, uint32_t begin, uint32_t end)
+				{
+					RecordGPUScene(commandBuffer);
+				});
+			}
+
+			m_Recorder->Record();
+			m_Recorder->Execute(pass, m_DeferredCommandBuffers);
+		}
+
+		void DeferredOffScreenRenderer::RecordCommands(CommandBuffer* commandBuffer, uint32_t begin, uint32_t end, bool animated)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			//The table is only uploaded once a material has been added
+			const bool bindless = !animated && m_Bindless && m_MaterialTable->GetDescriptorSet();
+
+			Pipeline* pipeline = m_Pipeline.get();
+			std::vector<Graphics::PushConstant>* pushConstantLayout = &m_PushConstants;
+			if(animated)
+			{
+				pipeline = m_AnimatedPipeline.get();
+				pushConstantLayout = &m_AnimPushConstants;
+			}
+			else if(bindless)
 			{
-				Engine::Get().Statistics().NumRenderedObjects++;
-				
-				auto command = m_CommandQueue[i];
+				pipeline = m_BindlessPipeline.get();
+				pushConstantLayout = &m_BindlessPushConstants;
+			}
+
+			//Per call so chunks can record on different workers
+			std::vector<DescriptorSet*> descriptorSets = { pipeline->GetDescriptorSet(), bindless ? m_MaterialTable->GetDescriptorSet() : nullptr };
+			uint8_t pushConstantData[sizeof(Maths::Matrix4) + sizeof(uint32_t)] = {};
+			std::vector<Graphics::PushConstant> pushConstants = *pushConstantLayout;
+			pushConstants[0].data = pushConstantData;
+
+			pipeline->Bind(commandBuffer);
+
+			for(uint32_t i = begin; i < end; i++)
+			{
+				auto& command = m_CommandQueue[i];
 				Mesh* mesh = command.mesh;
-                
-                m_CurrentDescriptorSets[0] = m_Pipeline->GetDescriptorSet();
-                m_CurrentDescriptorSets[1] = command.material ? command.material->GetDescriptorSet() : m_DefaultMaterial->GetDescriptorSet();
-                
-                auto trans = command.transform;
-                memcpy(m_PushConstants[0].data, &trans, sizeof(Maths::Matrix4));
-                m_CurrentDescriptorSets[0]->SetPushConstants(m_PushConstants);
 
-				mesh->GetVertexBuffer()->Bind(m_DeferredCommandBuffers, m_Pipeline.get());
-				mesh->GetIndexBuffer()->Bind(m_DeferredCommandBuffers);
+				if(!bindless)
+					descriptorSets[1] = command.material ? command.material->GetDescriptorSet() : m_DefaultMaterial->GetDescriptorSet();
+
+				memcpy(pushConstantData, &command.transform, sizeof(Maths::Matrix4));
+				if(animated)
+					memcpy(pushConstantData + sizeof(Maths::Matrix4), &command.boneOffset, sizeof(uint32_t));
+				else if(bindless)
+					memcpy(pushConstantData + sizeof(Maths::Matrix4), &command.materialIndex, sizeof(uint32_t));
 
-				Renderer::BindDescriptorSets(m_Pipeline.get(), m_DeferredCommandBuffers, 0, m_CurrentDescriptorSets);
-				Renderer::DrawIndexed(m_DeferredCommandBuffers, DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount());
+				auto& indexBuffer = mesh->GetIndexBuffer(command.lod);
+
+				mesh->GetVertexBuffer()->Bind(commandBuffer, pipeline);
+				indexBuffer->Bind(commandBuffer);
+
+				Renderer::BindDescriptorSets(pipeline, commandBuffer, 0, descriptorSets);
+				Renderer::PushConstants(pipeline, commandBuffer, pushConstants);
+				Renderer::DrawIndexed(commandBuffer, DrawType::TRIANGLE, indexBuffer->GetCount());
 
 				mesh->GetVertexBuffer()->Unbind();
-				mesh->GetIndexBuffer()->Unbind();
+				indexBuffer->Unbind();
 			}
+
+			Engine::Get().Statistics().NumRenderedObjects += end - begin;
+		}
+
+		void DeferredOffScreenRenderer::RecordGPUScene(CommandBuffer* commandBuffer)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_GPUScene->Draw(commandBuffer, m_IndirectPipeline.get(), m_IndirectPipeline->GetDescriptorSet(), m_DefaultMaterial, m_Bindless ? m_MaterialTable->GetDescriptorSet() : nullptr);
 		}
 
 		void DeferredOffScreenRenderer::CreatePipeline()
@@ -367,12 +790,11 @@ namespace Lumos
 				m_UniformBuffer->Init(bufferSize, nullptr);
 			}
             
-            if(m_AnimUniformBuffer == nullptr)
+            if(m_BoneBuffer == nullptr)
             {
-                m_AnimUniformBuffer = Graphics::UniformBuffer::Create();
-
-                uint32_t bufferSize = m_VSSystemUniformBufferAnimSize;
-                m_AnimUniformBuffer->Init(bufferSize, nullptr);
+                m_BoneBufferCapacity = MIN_BONE_CAPACITY;
+                m_BoneBuffer = Graphics::UniformBuffer::Create();
+                m_BoneBuffer->Init(m_BoneBufferCapacity * sizeof(Maths::Matrix4), nullptr);
             }
 
 			std::vector<Graphics::BufferInfo> bufferInfos;
@@ -388,19 +810,33 @@ namespace Lumos
 			bufferInfos.push_back(bufferInfo);
 
 			m_Pipeline->GetDescriptorSet()->Update(bufferInfos);
-            
-            Graphics::BufferInfo bufferInfoAnim = {};
-            bufferInfoAnim.buffer = m_AnimUniformBuffer;
-            bufferInfoAnim.offset = 0;
-            bufferInfoAnim.size = m_VSSystemUniformBufferAnimSize;
-            bufferInfoAnim.type = Graphics::DescriptorType::UNIFORM_BUFFER;
-            bufferInfoAnim.binding = 1;
-            bufferInfoAnim.shaderType = ShaderType::VERTEX;
-            bufferInfoAnim.name = "UniformBufferObjectAnim";
-            bufferInfos.push_back(bufferInfoAnim);
-            
-            m_AnimatedPipeline->GetDescriptorSet()->Update(bufferInfos);
 
+            UpdateAnimatedDescriptorSet();
+		}
+
+		void DeferredOffScreenRenderer::UpdateAnimatedDescriptorSet()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			Graphics::BufferInfo bufferInfo = {};
+			bufferInfo.buffer = m_UniformBuffer;
+			bufferInfo.offset = 0;
+			bufferInfo.size = m_VSSystemUniformBufferSize;
+			bufferInfo.type = Graphics::DescriptorType::UNIFORM_BUFFER;
+			bufferInfo.binding = 0;
+			bufferInfo.shaderType = ShaderType::VERTEX;
+			bufferInfo.name = "UniformBufferObject";
+
+            Graphics::BufferInfo boneBufferInfo = {};
+            boneBufferInfo.buffer = m_BoneBuffer;
+            boneBufferInfo.offset = 0;
+            boneBufferInfo.size = m_BoneBufferCapacity * sizeof(Maths::Matrix4);
+            boneBufferInfo.type = Graphics::DescriptorType::STORAGE_BUFFER;
+            boneBufferInfo.binding = 1;
+            boneBufferInfo.shaderType = ShaderType::VERTEX;
+            boneBufferInfo.name = "BoneTransforms";
+
+            std::vector<Graphics::BufferInfo> bufferInfos = { bufferInfo, boneBufferInfo };
+            m_AnimatedPipeline->GetDescriptorSet()->Update(bufferInfos);
 		}
 
 		void DeferredOffScreenRenderer::CreateFramebuffer()
@@ -445,6 +881,40 @@ namespace Lumos
 		void DeferredOffScreenRenderer::OnImGui()
 		{
 			ImGui::TextUnformatted("Deferred Offscreen Renderer");
+
+			if(Renderer::GetCapabilities().SupportsIndirectDraw)
+			{
+				bool gpuDriven = m_GPUDriven;
+				if(ImGui::Checkbox("GPU Driven Rendering", &gpuDriven))
+					SetGPUDriven(gpuDriven);
+
+				if(m_GPUDriven)
+				{
+					ImGui::Checkbox("Occlusion Culling", &m_GPUScene->GetOcclusionCulling());
+					ImGui::Text("Instances : %u", m_GPUScene->GetInstanceCount());
+					ImGui::Text("Pooled Meshes : %u", m_GPUScene->GetMeshCount());
+					ImGui::Text("Indirect Draws : %u", m_GPUScene->GetBatchCount());
+				}
+			}
+
+			if(Renderer::GetCapabilities().SupportsBindless)
+			{
+				bool bindless = m_Bindless;
+				if(ImGui::Checkbox("Bindless Materials", &bindless))
+					SetBindless(bindless);
+
+				if(m_Bindless)
+				{
+					ImGui::Text("Materials : %u", m_MaterialTable->GetMaterialCount());
+					ImGui::Text("Textures : %u / %u", m_MaterialTable->GetTextureCount(), uint32_t(MAX_BINDLESS_TEXTURES));
+				}
+			}
+
+			if(ParallelCommandRecorder::IsSupported())
+			{
+				ImGui::Checkbox("Parallel Recording", &m_ParallelRecording);
+				ImGui::Text("Recorded Chunks : %u", m_RecordParallel ? m_Recorder->GetChunkCount() : 0u);
+			}
 		}
 	}
 }
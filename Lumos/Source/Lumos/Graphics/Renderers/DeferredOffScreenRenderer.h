@@ -1,6 +1,8 @@
 #pragma once
 #include "IRenderer.h"
 #include "Maths/Frustum.h"
+#include "Maths/BatchMaths.h"
+#include <entt/entity/fwd.hpp>
 
 namespace Lumos
 {
@@ -19,6 +21,9 @@ namespace Lumos
 		class ShadowRenderer;
 		class Framebuffer;
 		class Material;
+		class GPUScene;
+		class MaterialTable;
+		class ParallelCommandRecorder;
 
 		class LUMOS_EXPORT DeferredOffScreenRenderer : public IRenderer
 		{
@@ -42,6 +47,19 @@ namespace Lumos
 			void CreatePipeline();
 			void CreateBuffer();
 			void CreateFramebuffer();
+			void CreateRenderPass();
+
+			//Rebuilds the renderpass, pipelines and framebuffer to match the current GBuffer layout
+			void OnGBufferLayoutChanged();
+
+			//Static meshes are culled on the gpu and drawn with indirect draws. Requires SupportsIndirectDraw
+			void SetGPUDriven(bool enabled);
+			bool GetGPUDriven() const { return m_GPUDriven; }
+
+			//Static meshes read their material from one table indexed per draw, instead of binding a set per material.
+			//Requires SupportsBindless and the thin GBuffer layout
+			void SetBindless(bool enabled);
+			bool GetBindless() const { return m_Bindless; }
 
 			int GetCommandBufferCount() const
 			{
@@ -57,6 +75,13 @@ namespace Lumos
 
 		private:
 			void SetSystemUniforms(Shader* shader);
+			void LoadShaders();
+			void CreateIndirectPipeline();
+			void UpdateIndirectDescriptorSet();
+			void UpdateAnimatedDescriptorSet();
+			void CreateBindlessPipeline();
+			void RecordCommands(CommandBuffer* commandBuffer, uint32_t begin, uint32_t end, bool animated);
+			void RecordGPUScene(CommandBuffer* commandBuffer);
 
 			Material* m_DefaultMaterial;
 
@@ -64,9 +89,11 @@ namespace Lumos
             
             Ref<Shader> m_AnimatedShader = nullptr;
             Ref<Lumos::Graphics::Pipeline> m_AnimatedPipeline;
-            UniformBuffer* m_AnimUniformBuffer;
-            uint8_t* m_VSSystemUniformBufferAnim = nullptr;
-            uint32_t m_VSSystemUniformBufferAnimSize = 0;
+            //Skinning matrices of every animated model, uploaded once per frame. Grows by doubling
+            UniformBuffer* m_BoneBuffer = nullptr;
+            uint32_t m_BoneBufferCapacity = 0;
+            const std::vector<Maths::Matrix4>* m_BonePalette = nullptr;
+            std::vector<Graphics::PushConstant> m_AnimPushConstants;
 
 			CommandBuffer* m_DeferredCommandBuffers;
 
@@ -78,6 +105,35 @@ namespace Lumos
 			UniformBufferModel m_UBODataDynamic;
 			int m_CommandBufferIndex = 0;
             std::vector<Graphics::PushConstant> m_PushConstants;
+			Maths::Vector3 m_CameraPosition;
+
+			UniqueRef<GPUScene> m_GPUScene;
+			Ref<Shader> m_IndirectShader;
+			Ref<Lumos::Graphics::Pipeline> m_IndirectPipeline;
+			Scene* m_CurrentScene = nullptr;
+			Maths::Matrix4 m_ProjView;
+			bool m_GPUDriven = false;
+
+			UniqueRef<MaterialTable> m_MaterialTable;
+			Ref<Shader> m_BindlessShader;
+			Ref<Lumos::Graphics::Pipeline> m_BindlessPipeline;
+			//Transform followed by the material index
+			std::vector<Graphics::PushConstant> m_BindlessPushConstants;
+			bool m_Bindless = false;
+
+			//Static, skinned and gpu scene draws are recorded in chunks on workers into secondary command buffers
+			UniqueRef<ParallelCommandRecorder> m_Recorder;
+			bool m_ParallelRecording = true;
+			bool m_RecordParallel = false;
+			bool m_RecordingStarted = false;
+
+			//Meshes gathered in BeginScene and frustum culled as one batch
+			std::vector<Mesh*> m_CullMeshes;
+			std::vector<entt::entity> m_CullEntities;
+			std::vector<Maths::Matrix4> m_CullTransforms;
+			std::vector<Maths::BoundingBox> m_CullBounds;
+			Maths::BoundingBoxStream m_CullWorldBounds;
+			std::vector<uint8_t> m_CullVisible;
 		};
 	}
 }
@@ -15,6 +15,7 @@
 #include "Graphics/Material.h"
 #include "Graphics/GBuffer.h"
 #include "Graphics/Light.h"
+#include "Graphics/LightClusters.h"
 
 #include "Graphics/API/Shader.h"
 #include "Graphics/API/Framebuffer.h"
@@ -32,7 +33,7 @@
 
 #include <imgui/imgui.h>
 
-#define MAX_LIGHTS 32
+#define MAX_LIGHTS 4096
 #define MAX_SHADOWMAPS 4
 
 namespace Lumos
@@ -41,13 +42,15 @@ namespace Lumos
 	{
 		enum PSSystemUniformIndices : int32_t
 		{
-			PSSystemUniformIndex_Lights = 0,
+			PSSystemUniformIndex_ClusterSize = 0,
+			PSSystemUniformIndex_ClusterDepthParams,
 			PSSystemUniformIndex_CameraPosition,
 			PSSystemUniformIndex_ViewMatrix,
 			PSSystemUniformIndex_LightView,
             PSSystemUniformIndex_ShadowTransforms,
 			PSSystemUniformIndex_ShadowSplitDepths,
 			PSSystemUniformIndex_BiasMatrix,
+			PSSystemUniformIndex_InvViewProjection,
 			PSSystemUniformIndex_LightCount,
 			PSSystemUniformIndex_ShadowCount,
 			PSSystemUniformIndex_RenderMode,
@@ -56,6 +59,7 @@ namespace Lumos
             PSSystemUniformIndex_maxShadowDistance,
             PSSystemUniformIndex_shadowFade,
             PSSystemUniformIndex_cascadeTransitionFade,
+			PSSystemUniformIndex_GBufferLayout,
 			PSSystemUniformIndex_Size
 		};
 
@@ -69,6 +73,9 @@ namespace Lumos
 		{
 			delete m_UniformBuffer;
 			delete m_LightUniformBuffer;
+			delete m_LightStorageBuffer;
+			delete m_LightClusterBuffer;
+			delete m_LightIndexBuffer;
 			delete m_ScreenQuad;
 			delete m_OffScreenRenderer;
 
@@ -106,6 +113,10 @@ namespace Lumos
 				break;
 			}
 
+			//Sampled depth is always [0, 1], remap it when clip space depth is [-1, 1]
+			if(!Maths::Matrix4::IsDepthZeroOne())
+				m_DepthRemapMatrix = Maths::Matrix4(1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 2.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+
 			TextureParameters param;
 			param.minFilter = TextureFilter::LINEAR;
 			param.magFilter = TextureFilter::LINEAR;
@@ -115,23 +126,31 @@ namespace Lumos
 			m_PreintegratedFG = UniqueRef<Texture2D>(Texture2D::CreateFromSource(BRDFTextureWidth, BRDFTextureHeight, (void*)BRDFTexture, param));
 
 			m_LightUniformBuffer = nullptr;
+			m_LightStorageBuffer = nullptr;
+			m_LightClusterBuffer = nullptr;
+			m_LightIndexBuffer = nullptr;
 			m_UniformBuffer = nullptr;
 
+			m_LightClusters = CreateUniqueRef<LightClusters>();
+			m_Lights.reserve(MAX_LIGHTS);
+
 			m_ScreenQuad = Graphics::CreateQuad();
             
 			// Pixel/fragment shader System uniforms
-			m_PSSystemUniformBufferSize = sizeof(Light) * MAX_LIGHTS + sizeof(Maths::Matrix4) * MAX_SHADOWMAPS + sizeof(Maths::Matrix4) * 3 + sizeof(Maths::Vector4) + sizeof(Maths::Vector4) * MAX_SHADOWMAPS + sizeof(float) * 4 + sizeof(int) * 4 + sizeof(float);
+			m_PSSystemUniformBufferSize = sizeof(Maths::Vector4) * 2 + sizeof(Maths::Matrix4) * MAX_SHADOWMAPS + sizeof(Maths::Matrix4) * 4 + sizeof(Maths::Vector4) + sizeof(Maths::Vector4) * MAX_SHADOWMAPS + sizeof(float) * 4 + sizeof(int) * 4 + sizeof(float) + sizeof(int);
 			m_PSSystemUniformBuffer = new uint8_t[m_PSSystemUniformBufferSize];
 			memset(m_PSSystemUniformBuffer, 0, m_PSSystemUniformBufferSize);
 			m_PSSystemUniformBufferOffsets.resize(PSSystemUniformIndex_Size);
 
 			// Per Scene System Uniforms
-			m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_Lights] = 0;
-            m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ShadowTransforms] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_Lights] + sizeof(Light) * MAX_LIGHTS;
+			m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ClusterSize] = 0;
+			m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ClusterDepthParams] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ClusterSize] + sizeof(Maths::Vector4);
+            m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ShadowTransforms] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ClusterDepthParams] + sizeof(Maths::Vector4);
             m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ViewMatrix] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ShadowTransforms] + sizeof(Maths::Matrix4) * MAX_SHADOWMAPS;
 			m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_LightView] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ViewMatrix] + sizeof(Maths::Matrix4);
             m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_BiasMatrix] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_LightView] + sizeof(Maths::Matrix4);
-            m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_CameraPosition] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_BiasMatrix] + sizeof(Maths::Matrix4);
+            m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_InvViewProjection] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_BiasMatrix] + sizeof(Maths::Matrix4);
+            m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_CameraPosition] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_InvViewProjection] + sizeof(Maths::Matrix4);
             m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ShadowSplitDepths] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_CameraPosition] + sizeof(Maths::Vector4);
 
             m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_lightSize] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ShadowSplitDepths] + sizeof(Maths::Vector4) * MAX_SHADOWMAPS;
@@ -143,6 +162,8 @@ namespace Lumos
 			m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ShadowCount] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_LightCount] + sizeof(int);
 			m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_RenderMode] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ShadowCount] + sizeof(int);
 			m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_cubemapMipLevels] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_RenderMode] + sizeof(int);
+			//Initial shadow bias is stored after cubemapMipLevels
+			m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_GBufferLayout] = m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_cubemapMipLevels] + sizeof(int) + sizeof(float);
 
 			AttachmentInfo textureTypes[2] =
             {
@@ -302,12 +323,14 @@ namespace Lumos
 
 			auto group = registry.group<Graphics::Light>(entt::get<Maths::Transform>);
 
-			uint32_t numLights = 0;
-
 			auto viewMatrix = m_CameraTransform->GetWorldMatrix().Inverse();
 
 			auto& frustum = m_Camera->GetFrustum(viewMatrix);
 
+			//Directional lights are stored first and applied to every pixel, the rest go through the clusters
+			m_Lights.clear();
+			uint32_t numDirectionalLights = 0;
+
 			for(auto entity : group)
 			{
 				const auto& [light, trans] = group.get<Graphics::Light, Maths::Transform>(entity);
@@ -321,18 +344,39 @@ namespace Lumos
 						continue;
 				}
 
+				if(m_Lights.size() >= MAX_LIGHTS)
+					break;
+
 				Maths::Vector3 forward = Maths::Vector3::FORWARD;
 				forward = trans.GetWorldOrientation() * forward;
 
 				light.Direction = forward.Normalized();
 
-				memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_Lights] + sizeof(Graphics::Light) * numLights, &light, sizeof(Graphics::Light));
-				numLights++;
+				if(light.Type == float(LightType::DirectionalLight))
+				{
+					m_Lights.insert(m_Lights.begin() + numDirectionalLights, light);
+					numDirectionalLights++;
+				}
+				else
+					m_Lights.push_back(light);
 			}
 
+			uint32_t numLights = static_cast<uint32_t>(m_Lights.size());
+
+			m_LightClusters->Build(m_Lights.data(), numLights, numDirectionalLights, viewMatrix, m_Camera->GetProjectionMatrix(), m_Camera->GetNear(), m_Camera->GetFar());
+
+			int clusterSize[4] = { int(LightClusters::ClusterCountX), int(LightClusters::ClusterCountY), int(LightClusters::ClusterCountZ), int(numDirectionalLights) };
+			memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ClusterSize], clusterSize, sizeof(int) * 4);
+			memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ClusterDepthParams], &m_LightClusters->GetDepthParams(), sizeof(Maths::Vector4));
+			memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ViewMatrix], &viewMatrix, sizeof(Maths::Matrix4));
+
 			Maths::Vector4 cameraPos = Maths::Vector4(m_CameraTransform->GetWorldPosition());
 			memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_CameraPosition], &cameraPos, sizeof(Maths::Vector4));
 
+			//Used to rebuild world positions from the depth buffer
+			Maths::Matrix4 invViewProj = (m_Camera->GetProjectionMatrix() * viewMatrix).Inverse() * m_DepthRemapMatrix;
+			memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_InvViewProjection], &invViewProj, sizeof(Maths::Matrix4));
+
 			auto shadowRenderer = Application::Get().GetRenderGraph()->GetShadowRenderer();
 			if(shadowRenderer)
 			{
@@ -340,7 +384,6 @@ namespace Lumos
                 Lumos::Maths::Vector4* uSplitDepth = shadowRenderer->GetSplitDepths();
                 const Maths::Matrix4& lightView = shadowRenderer->GetLightView();
 
-				memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ViewMatrix], &viewMatrix, sizeof(Maths::Matrix4));
                 memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_LightView], &lightView, sizeof(Maths::Matrix4));
 
 				memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ShadowTransforms], shadowTransforms, sizeof(Maths::Matrix4) * MAX_SHADOWMAPS);
@@ -369,6 +412,9 @@ namespace Lumos
 			memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ShadowCount], &numShadows, sizeof(int));
 			memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_RenderMode], &m_RenderMode, sizeof(int));
 			memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_cubemapMipLevels], &cubemapMipLevels, sizeof(int));
+
+			int gbufferLayout = int(Application::Get().GetRenderGraph()->GetGBuffer()->GetLayout());
+			memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_GBufferLayout], &gbufferLayout, sizeof(int));
 		}
 
 		void DeferredRenderer::EndScene()
@@ -388,6 +434,15 @@ namespace Lumos
 		{
 			LUMOS_PROFILE_FUNCTION();
 			m_LightUniformBuffer->SetData(m_PSSystemUniformBufferSize, *&m_PSSystemUniformBuffer);
+
+			//Only upload the used part of the light and index lists
+			if(!m_Lights.empty())
+				m_LightStorageBuffer->SetData(uint32_t(sizeof(Light) * m_Lights.size()), m_Lights.data());
+
+			m_LightClusterBuffer->SetData(sizeof(LightClusters::Cluster) * LightClusters::ClusterCount, m_LightClusters->GetClusters());
+
+			if(m_LightClusters->GetLightIndexCount() > 0)
+				m_LightIndexBuffer->SetData(sizeof(uint32_t) * m_LightClusters->GetLightIndexCount(), m_LightClusters->GetLightIndices());
 		}
 
 		void DeferredRenderer::Present()
@@ -488,6 +543,22 @@ namespace Lumos
 			ImGui::PopItemWidth();
 			ImGui::NextColumn();
 
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Number Of Lights");
+			ImGui::NextColumn();
+			ImGui::PushItemWidth(-1);
+			ImGui::Text("%5.2lu", m_Lights.size());
+			ImGui::PopItemWidth();
+			ImGui::NextColumn();
+
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Cluster Light Indices");
+			ImGui::NextColumn();
+			ImGui::PushItemWidth(-1);
+			ImGui::Text("%5.2u", m_LightClusters->GetLightIndexCount());
+			ImGui::PopItemWidth();
+			ImGui::NextColumn();
+
 			ImGui::AlignTextToFramePadding();
 			ImGui::TextUnformatted("Render Mode");
 			ImGui::NextColumn();
@@ -508,6 +579,22 @@ namespace Lumos
 			ImGui::PopItemWidth();
 			ImGui::NextColumn();
 
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Thin GBuffer");
+			ImGui::NextColumn();
+			ImGui::PushItemWidth(-1);
+			auto gbuffer = Application::Get().GetRenderGraph()->GetGBuffer();
+			bool thinGBuffer = gbuffer->GetLayout() == GBufferLayout::THIN;
+			if(ImGui::Checkbox("##ThinGBuffer", &thinGBuffer))
+			{
+				Graphics::GraphicsContext::GetContext()->WaitIdle();
+				gbuffer->SetLayout(thinGBuffer ? GBufferLayout::THIN : GBufferLayout::LEGACY);
+				m_OffScreenRenderer->OnGBufferLayoutChanged();
+				UpdateScreenDescriptorSet();
+			}
+			ImGui::PopItemWidth();
+			ImGui::NextColumn();
+
 			ImGui::Columns(1);
 			ImGui::Separator();
 			ImGui::PopStyleVar();
@@ -556,6 +643,18 @@ namespace Lumos
 				m_LightUniformBuffer->Init(bufferSize, nullptr);
 			}
 
+			if(m_LightStorageBuffer == nullptr)
+			{
+				m_LightStorageBuffer = Graphics::UniformBuffer::Create();
+				m_LightStorageBuffer->Init(sizeof(Light) * MAX_LIGHTS, nullptr);
+
+				m_LightClusterBuffer = Graphics::UniformBuffer::Create();
+				m_LightClusterBuffer->Init(sizeof(LightClusters::Cluster) * LightClusters::ClusterCount, nullptr);
+
+				m_LightIndexBuffer = Graphics::UniformBuffer::Create();
+				m_LightIndexBuffer->Init(sizeof(uint32_t) * LightClusters::MaxLightIndices, nullptr);
+			}
+
 			std::vector<Graphics::BufferInfo> bufferInfos;
 
 			Graphics::BufferInfo bufferInfo = {};
@@ -569,6 +668,31 @@ namespace Lumos
 
 			bufferInfos.push_back(bufferInfo);
 
+			Graphics::BufferInfo lightBufferInfo = {};
+			lightBufferInfo.name = "LightBuffer";
+			lightBufferInfo.buffer = m_LightStorageBuffer;
+			lightBufferInfo.offset = 0;
+			lightBufferInfo.size = sizeof(Light) * MAX_LIGHTS;
+			lightBufferInfo.type = Graphics::DescriptorType::STORAGE_BUFFER;
+			lightBufferInfo.binding = 1;
+			lightBufferInfo.shaderType = ShaderType::FRAGMENT;
+
+			Graphics::BufferInfo clusterBufferInfo = lightBufferInfo;
+			clusterBufferInfo.name = "LightClusterBuffer";
+			clusterBufferInfo.buffer = m_LightClusterBuffer;
+			clusterBufferInfo.size = sizeof(LightClusters::Cluster) * LightClusters::ClusterCount;
+			clusterBufferInfo.binding = 2;
+
+			Graphics::BufferInfo indexBufferInfo = lightBufferInfo;
+			indexBufferInfo.name = "LightIndexBuffer";
+			indexBufferInfo.buffer = m_LightIndexBuffer;
+			indexBufferInfo.size = sizeof(uint32_t) * LightClusters::MaxLightIndices;
+			indexBufferInfo.binding = 3;
+
+			bufferInfos.push_back(lightBufferInfo);
+			bufferInfos.push_back(clusterBufferInfo);
+			bufferInfos.push_back(indexBufferInfo);
+
 			m_Pipeline->GetDescriptorSet()->Update(bufferInfos);
 		}
 
@@ -658,6 +782,7 @@ namespace Lumos
 				bufferInfos.push_back(imageInfo7);
 			if(shadowRenderer)
 				bufferInfos.push_back(imageInfo8);
+			bufferInfos.push_back(imageInfo9);
 
 			m_DescriptorSet->Update(bufferInfos);
 		}
@@ -18,6 +18,8 @@ namespace Lumos
 		class ShadowRenderer;
 		class Framebuffer;
 		class DeferredOffScreenRenderer;
+		class LightClusters;
+		struct Light;
 
 		class LUMOS_EXPORT DeferredRenderer : public IRenderer
 		{
@@ -68,10 +70,19 @@ namespace Lumos
 			uint32_t m_PSSystemUniformBufferSize;
 
 			Maths::Matrix4 m_BiasMatrix;
+			Maths::Matrix4 m_DepthRemapMatrix;
 
 			UniformBuffer* m_UniformBuffer;
 			UniformBuffer* m_LightUniformBuffer;
 
+			//Storage buffers for clustered lighting
+			UniformBuffer* m_LightStorageBuffer;
+			UniformBuffer* m_LightClusterBuffer;
+			UniformBuffer* m_LightIndexBuffer;
+
+			UniqueRef<LightClusters> m_LightClusters;
+			std::vector<Light> m_Lights;
+
 			CommandBuffer* m_DeferredCommandBuffers;
 
 			Mesh* m_ScreenQuad = nullptr;
@@ -7,6 +7,7 @@
 #include "Graphics/API/UniformBuffer.h"
 #include "Graphics/Mesh.h"
 #include "Graphics/Model.h"
+#include "Graphics/Terrain/ChunkedTerrain.h"
 #include "Graphics/Material.h"
 #include "Graphics/API/Renderer.h"
 #include "Graphics/API/CommandBuffer.h"
@@ -24,6 +25,7 @@
 
 #include "Core/Application.h"
 #include "RenderGraph.h"
+#include "ParallelCommandRecorder.h"
 #include "Graphics/Camera/Camera.h"
 
 namespace Lumos
@@ -57,6 +59,8 @@ namespace Lumos
 
 		void ForwardRenderer::RenderScene()
 		{
+			m_RecordParallel = ParallelCommandRecorder::IsSupported();
+
 			//for (i = 0; i < commandBuffers.size(); i++)
 			{
 				Begin();
@@ -214,7 +218,7 @@ namespace Lumos
 
 			m_DescriptorSet->Update(bufferInfosDefault);
             
-            m_CurrentDescriptorSets.resize(2);
+			m_Recorder = CreateUniqueRef<ParallelCommandRecorder>();
 		}
 
 		void ForwardRenderer::Begin()
@@ -223,7 +227,7 @@ namespace Lumos
 			if(!m_RenderTexture)
 				m_CurrentBufferID = Renderer::GetSwapchain()->GetCurrentBufferId();
 
-			m_RenderPass->BeginRenderpass(m_CommandBuffers[m_CurrentBufferID], m_ClearColour, m_Framebuffers[m_CurrentBufferID].get(), Graphics::INLINE, m_ScreenBufferWidth, m_ScreenBufferHeight);
+			m_RenderPass->BeginRenderpass(m_CommandBuffers[m_CurrentBufferID], m_ClearColour, m_Framebuffers[m_CurrentBufferID].get(), m_RecordParallel ? Graphics::SECONDARY : Graphics::INLINE, m_ScreenBufferWidth, m_ScreenBufferHeight);
 		}
 
 		void ForwardRenderer::BeginScene(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform)
@@ -264,7 +268,8 @@ namespace Lumos
                 
                 for(auto mesh : meshes)
                 {
-                    if(mesh->GetActive())
+                    //Skinned meshes are only drawn by the deferred renderer
+                    if(mesh->GetActive() && !mesh->IsSkinned())
                     {
                         auto& worldTransform = trans.GetWorldMatrix();
 
@@ -297,10 +302,37 @@ namespace Lumos
                     }
                 }
             }
+
+            auto terrainView = registry.view<ChunkedTerrain, Maths::Transform>();
+            for(auto entity : terrainView)
+            {
+                const auto& [terrain, trans] = terrainView.get<ChunkedTerrain, Maths::Transform>(entity);
+                auto& worldTransform = trans.GetWorldMatrix();
+
+                auto textureMatrixTransform = registry.try_get<TextureMatrixComponent>(entity);
+                Maths::Matrix4 textureMatrix = textureMatrixTransform ? textureMatrixTransform->GetMatrix() : Maths::Matrix4();
+
+                for(auto mesh : terrain.GetVisibleChunks())
+                {
+                    auto bbCopy = mesh->GetBoundingBox()->Transformed(worldTransform);
+                    if(m_Frustum.IsInsideFast(bbCopy) == Maths::Intersection::OUTSIDE)
+                        continue;
+
+                    auto material = mesh->GetMaterial();
+                    if(material && (material->GetDescriptorSet() == nullptr || material->GetPipeline() != m_Pipeline.get() || material->GetTexturesUpdated()))
+                    {
+                        material->CreateDescriptorSet(m_Pipeline.get(), 1);
+                        material->SetTexturesUpdated(false);
+                    }
+
+                    SubmitMesh(mesh, material.get(), worldTransform, textureMatrix);
+                }
+            }
 		}
 
 		void ForwardRenderer::BeginScene(const Maths::Matrix4& proj, const Maths::Matrix4& view)
 		{
+			m_CommandQueue.clear();
 			memcpy(m_VSSystemUniformBuffer + m_VSSystemUniformBufferOffsets[VSSystemUniformIndex_ProjectionMatrix], &proj, sizeof(Maths::Matrix4));
 			memcpy(m_VSSystemUniformBuffer + m_VSSystemUniformBufferOffsets[VSSystemUniformIndex_ViewMatrix], &view, sizeof(Maths::Matrix4));
 		}
@@ -351,31 +383,47 @@ namespace Lumos
 
 		void ForwardRenderer::Present()
 		{
-			int index = 0;
+			const uint32_t commandCount = uint32_t(m_CommandQueue.size());
+			Graphics::CommandBuffer* currentCMDBuffer = m_CommandBuffers[m_CurrentBufferID];
 
-			for(auto& command : m_CommandQueue)
+			if(!m_RecordParallel)
+			{
+				RecordCommands(currentCMDBuffer, 0, commandCount);
+				return;
+			}
+
+			m_Recorder->Clear();
+			const uint32_t pass = m_Recorder->AddPass(m_RenderPass.get(), m_Framebuffers[m_CurrentBufferID].get(), m_ScreenBufferWidth, m_ScreenBufferHeight);
+			m_Recorder->Add(pass, commandCount, 64, [this](CommandBuffer* commandBuffer, uint32_t begin, uint32_t end)
 			{
-				Mesh* mesh = command.mesh;
+				RecordCommands(commandBuffer, begin, end);
+			});
+
+			m_Recorder->Record();
+			m_Recorder->Execute(pass, currentCMDBuffer);
+		}
+
+		void ForwardRenderer::RecordCommands(CommandBuffer* commandBuffer, uint32_t begin, uint32_t end)
+		{
+			//Per call so chunks can record on different workers
+			std::vector<DescriptorSet*> descriptorSets = { m_Pipeline->GetDescriptorSet(), m_DescriptorSet.get() };
 
-				Graphics::CommandBuffer* currentCMDBuffer = m_CommandBuffers[m_CurrentBufferID];
+			m_Pipeline->Bind(commandBuffer);
 
-				m_Pipeline->Bind(currentCMDBuffer);
+			for(uint32_t index = begin; index < end; index++)
+			{
+				Mesh* mesh = m_CommandQueue[index].mesh;
 
 				uint32_t dynamicOffset = index * static_cast<uint32_t>(m_DynamicAlignment);
 
-                m_CurrentDescriptorSets[0] = m_Pipeline->GetDescriptorSet();
-                m_CurrentDescriptorSets[1] = m_DescriptorSet.get();
-				
-				mesh->GetVertexBuffer()->Bind(currentCMDBuffer, m_Pipeline.get());
-				mesh->GetIndexBuffer()->Bind(currentCMDBuffer);
+				mesh->GetVertexBuffer()->Bind(commandBuffer, m_Pipeline.get());
+				mesh->GetIndexBuffer()->Bind(commandBuffer);
 
-				Renderer::BindDescriptorSets(m_Pipeline.get(), currentCMDBuffer, dynamicOffset, m_CurrentDescriptorSets);
-				Renderer::DrawIndexed(currentCMDBuffer, DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount());
+				Renderer::BindDescriptorSets(m_Pipeline.get(), commandBuffer, dynamicOffset, descriptorSets);
+				Renderer::DrawIndexed(commandBuffer, DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount());
 
 				mesh->GetVertexBuffer()->Unbind();
 				mesh->GetIndexBuffer()->Unbind();
-
-				index++;
 			}
 		}
 
@@ -11,6 +11,7 @@ namespace Lumos
 	{
 		class DescriptorSet;
 		class TextureDepth;
+		class ParallelCommandRecorder;
 
 		class LUMOS_EXPORT ForwardRenderer : public IRenderer
 		{
@@ -50,6 +51,8 @@ namespace Lumos
 			void SetSystemUniforms(Shader* shader) const;
 
 		private:
+			void RecordCommands(CommandBuffer* commandBuffer, uint32_t begin, uint32_t end);
+
 			Texture2D* m_DefaultTexture;
 
 			UniformBuffer* m_UniformBuffer;
@@ -62,6 +65,9 @@ namespace Lumos
 
 			uint32_t m_CurrentBufferID = 0;
 			bool m_DepthTest = false;
+
+			UniqueRef<ParallelCommandRecorder> m_Recorder;
+			bool m_RecordParallel = false;
 		};
 	}
 }
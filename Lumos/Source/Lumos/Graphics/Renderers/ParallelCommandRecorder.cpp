@@ -0,0 +1,93 @@
+#include "Precompiled.h"
+#include "ParallelCommandRecorder.h"
+#include "Core/JobSystem.h"
+#include "Maths/Maths.h"
+
+#include "Graphics/API/CommandBuffer.h"
+#include "Graphics/API/Renderer.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		ParallelCommandRecorder::~ParallelCommandRecorder()
+		{
+			for(auto commandBuffer : m_CommandBuffers)
+				delete commandBuffer;
+		}
+
+		bool ParallelCommandRecorder::IsSupported()
+		{
+			return Renderer::GetCapabilities().SupportsParallelRecording && System::JobSystem::GetThreadCount() > 1;
+		}
+
+		void ParallelCommandRecorder::Clear()
+		{
+			m_Passes.clear();
+			m_Ranges.clear();
+			m_Chunks.clear();
+		}
+
+		uint32_t ParallelCommandRecorder::AddPass(RenderPass* renderPass, Framebuffer* framebuffer, uint32_t width, uint32_t height)
+		{
+			m_Passes.push_back({ renderPass, framebuffer, width, height });
+			return uint32_t(m_Passes.size() - 1);
+		}
+
+		void ParallelCommandRecorder::Add(uint32_t pass, uint32_t count, uint32_t minChunkSize, const RecordFunc& record)
+		{
+			if(count == 0)
+				return;
+
+			const uint32_t range = uint32_t(m_Ranges.size());
+			m_Ranges.push_back(record);
+
+			const uint32_t minSize = Maths::Max(minChunkSize, 1u);
+			const uint32_t maxChunks = Maths::Max(1u, System::JobSystem::GetThreadCount());
+			const uint32_t chunkCount = Maths::Min(maxChunks, (count + minSize - 1) / minSize);
+			const uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+			for(uint32_t begin = 0; begin < count; begin += chunkSize)
+				m_Chunks.push_back({ pass, range, begin, Maths::Min(begin + chunkSize, count) });
+		}
+
+		void ParallelCommandRecorder::Record()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(m_Chunks.empty())
+				return;
+
+			//Allocated here rather than on the workers, pools are only grown from the main thread
+			while(m_CommandBuffers.size() < m_Chunks.size())
+			{
+				auto commandBuffer = CommandBuffer::Create();
+				commandBuffer->InitSecondary(uint32_t(m_CommandBuffers.size()));
+				m_CommandBuffers.push_back(commandBuffer);
+			}
+
+			System::JobSystem::Dispatch(uint32_t(m_Chunks.size()), 1, [&](JobDispatchArgs args)
+			{
+				LUMOS_PROFILE_SCOPE("Record Chunk");
+				const Chunk& chunk = m_Chunks[args.jobIndex];
+				const Pass& pass = m_Passes[chunk.pass];
+				CommandBuffer* commandBuffer = m_CommandBuffers[args.jobIndex];
+
+				commandBuffer->BeginRecordingSecondary(pass.renderPass, pass.framebuffer);
+				commandBuffer->UpdateViewport(pass.width, pass.height);
+				m_Ranges[chunk.range](commandBuffer, chunk.begin, chunk.end);
+				commandBuffer->EndRecording();
+			});
+			System::JobSystem::Wait();
+		}
+
+		void ParallelCommandRecorder::Execute(uint32_t pass, CommandBuffer* primary)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			for(uint32_t i = 0; i < uint32_t(m_Chunks.size()); i++)
+			{
+				if(m_Chunks[i].pass == pass)
+					m_CommandBuffers[i]->ExecuteSecondary(primary);
+			}
+		}
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		class CommandBuffer;
+		class RenderPass;
+		class Framebuffer;
+
+		//Records ranges of draws into secondary command buffers on job system workers, then executes them from
+		//the primary in the order they were added. Every chunk recorded in one Record call has its own worker slot,
+		//and so its own command pool. Recorders take turns, only one may be between Record and the submit at a time
+		class LUMOS_EXPORT ParallelCommandRecorder
+		{
+		public:
+			//Records the draws [begin, end) of a range into a secondary command buffer
+			using RecordFunc = std::function<void(CommandBuffer* commandBuffer, uint32_t begin, uint32_t end)>;
+
+			ParallelCommandRecorder() = default;
+			~ParallelCommandRecorder();
+
+			//Needs SupportsParallelRecording and more than one worker thread
+			static bool IsSupported();
+
+			void Clear();
+
+			//Returns the pass index used by Add and Execute. The pass must be begun with SECONDARY contents
+			uint32_t AddPass(RenderPass* renderPass, Framebuffer* framebuffer, uint32_t width, uint32_t height);
+
+			//Splits count draws into chunks of at least minChunkSize, at most one per worker
+			void Add(uint32_t pass, uint32_t count, uint32_t minChunkSize, const RecordFunc& record);
+
+			//Records every chunk added since Clear on the workers and waits for them
+			void Record();
+
+			//Executes the chunks of a pass into the primary, in order
+			void Execute(uint32_t pass, CommandBuffer* primary);
+
+			uint32_t GetChunkCount() const { return uint32_t(m_Chunks.size()); }
+
+		private:
+			struct Pass
+			{
+				RenderPass* renderPass;
+				Framebuffer* framebuffer;
+				uint32_t width;
+				uint32_t height;
+			};
+
+			struct Chunk
+			{
+				uint32_t pass;
+				uint32_t range;
+				uint32_t begin;
+				uint32_t end;
+			};
+
+			std::vector<Pass> m_Passes;
+			std::vector<RecordFunc> m_Ranges;
+			std::vector<Chunk> m_Chunks;
+			//Buffer i is allocated from worker slot i
+			std::vector<CommandBuffer*> m_CommandBuffers;
+		};
+	}
+}
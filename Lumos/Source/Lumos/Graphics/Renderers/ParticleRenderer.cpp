@@ -0,0 +1,417 @@
+#include "Precompiled.h"
+#include "ParticleRenderer.h"
+#include "Graphics/API/Shader.h"
+#include "Graphics/API/Framebuffer.h"
+#include "Graphics/API/Texture.h"
+#include "Graphics/API/UniformBuffer.h"
+#include "Graphics/API/VertexBuffer.h"
+#include "Graphics/API/IndexBuffer.h"
+#include "Graphics/API/Renderer.h"
+#include "Graphics/API/CommandBuffer.h"
+#include "Graphics/API/Swapchain.h"
+#include "Graphics/API/RenderPass.h"
+#include "Graphics/API/Pipeline.h"
+#include "Graphics/GBuffer.h"
+#include "Graphics/Particles/ParticleEmitter.h"
+#include "Graphics/Particles/ParticleSystem.h"
+#include "RenderGraph.h"
+#include "Scene/Scene.h"
+#include "Core/Application.h"
+#include "Core/Engine.h"
+#include "Graphics/Camera/Camera.h"
+
+#include <imgui/imgui.h>
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		static const uint32_t MinInstanceCapacity = 16384;
+
+		ParticleRenderer::ParticleRenderer(uint32_t width, uint32_t height)
+		{
+			m_Pipeline = nullptr;
+
+			SetScreenBufferSize(width, height);
+			Init();
+		}
+
+		ParticleRenderer::~ParticleRenderer()
+		{
+			delete m_UniformBuffer;
+			delete m_InstanceBuffer;
+			delete[] m_VSSystemUniformBuffer;
+
+			for(auto& pc : m_PushConstants)
+				delete[] pc.data;
+
+			m_PushConstants.clear();
+			m_TextureSets.clear();
+			m_Framebuffers.clear();
+			m_CommandBuffers.clear();
+		}
+
+		void ParticleRenderer::Init()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_Shader = Application::Get().GetShaderLibrary()->GetResource("/CoreShaders/Particle.shader");
+
+			m_VSSystemUniformBufferSize = sizeof(UniformBufferObject);
+			m_VSSystemUniformBuffer = new uint8_t[m_VSSystemUniformBufferSize];
+			memset(m_VSSystemUniformBuffer, 0, m_VSSystemUniformBufferSize);
+
+			auto pushConstant = Graphics::PushConstant();
+			pushConstant.size = sizeof(EmitterConstants);
+			pushConstant.data = new uint8_t[sizeof(EmitterConstants)];
+			pushConstant.shaderStage = ShaderType::VERTEX;
+			m_PushConstants.push_back(pushConstant);
+
+			//Corners of a unit quad centred on the particle
+			const Maths::Vector2 corners[4] = {
+				Maths::Vector2(-0.5f, -0.5f),
+				Maths::Vector2(0.5f, -0.5f),
+				Maths::Vector2(0.5f, 0.5f),
+				Maths::Vector2(-0.5f, 0.5f)};
+			uint32_t indices[6] = {0, 1, 2, 2, 3, 0};
+
+			m_QuadVertexBuffer = Ref<VertexBuffer>(VertexBuffer::Create(BufferUsage::STATIC));
+			m_QuadVertexBuffer->SetData(sizeof(corners), corners);
+			m_QuadIndexBuffer = Ref<IndexBuffer>(IndexBuffer::Create(indices, 6));
+
+			uint32_t whiteTextureData = 0xffffffff;
+			m_WhiteTexture = Ref<Texture2D>(Texture2D::CreateFromSource(1, 1, &whiteTextureData));
+
+			m_CommandBuffers.resize(Renderer::GetSwapchain()->GetSwapchainBufferCount());
+
+			for(auto& commandBuffer : m_CommandBuffers)
+			{
+				commandBuffer = Ref<Graphics::CommandBuffer>(Graphics::CommandBuffer::Create());
+				commandBuffer->Init(true);
+			}
+
+			AttachmentInfo textureTypes[2] = {
+				{TextureType::COLOUR, TextureFormat::RGBA8},
+				{TextureType::DEPTH, TextureFormat::DEPTH}};
+
+			Graphics::RenderPassInfo renderpassCI{};
+			renderpassCI.attachmentCount = 2;
+			renderpassCI.textureType = textureTypes;
+			renderpassCI.clear = false;
+
+			m_RenderPass = Graphics::RenderPass::Get(renderpassCI);
+
+			CreateGraphicsPipeline();
+			UpdateDescriptorSet();
+			CreateFramebuffers();
+
+			m_CurrentDescriptorSets.resize(2);
+		}
+
+		void ParticleRenderer::BeginScene(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			auto& registry = scene->GetRegistry();
+
+			m_Emitters.clear();
+			m_CulledEmitters = 0;
+			m_ParticleCount = 0;
+
+			if(overrideCamera)
+			{
+				m_Camera = overrideCamera;
+				m_CameraTransform = overrideCameraTransform;
+			}
+			else
+			{
+				auto cameraView = registry.view<Camera>();
+				if(!cameraView.empty())
+				{
+					m_Camera = &cameraView.get<Camera>(cameraView.front());
+					m_CameraTransform = registry.try_get<Maths::Transform>(cameraView.front());
+				}
+			}
+
+			if(!m_Camera || !m_CameraTransform)
+				return;
+
+			auto view = m_CameraTransform->GetWorldMatrix().Inverse();
+			m_Frustum = m_Camera->GetFrustum(view);
+
+			UniformBufferObject ubo;
+			ubo.projView = m_Camera->GetProjectionMatrix() * view;
+			const Maths::Vector3 right = m_CameraTransform->GetRightDirection();
+			const Maths::Vector3 up = m_CameraTransform->GetUpDirection();
+			ubo.cameraRight = Maths::Vector4(right.x, right.y, right.z, 0.0f);
+			ubo.cameraUp = Maths::Vector4(up.x, up.y, up.z, 0.0f);
+			memcpy(m_VSSystemUniformBuffer, &ubo, sizeof(UniformBufferObject));
+
+			auto emitterView = registry.view<ParticleEmitter>();
+			for(auto entity : emitterView)
+			{
+				auto& emitter = emitterView.get<ParticleEmitter>(entity);
+				if(emitter.GetRenderMode() != ParticleEmitter::RenderMode::Billboard || emitter.GetParticleCount() == 0)
+					continue;
+
+				if(m_Frustum.IsInsideFast(emitter.GetBounds()) == Maths::Intersection::OUTSIDE)
+				{
+					m_CulledEmitters++;
+					continue;
+				}
+
+				m_Emitters.push_back(&emitter);
+				m_ParticleCount += emitter.GetParticleCount();
+			}
+
+			m_Instances.resize(m_ParticleCount);
+			ParticleSystem::WriteInstances(m_Emitters.data(), uint32_t(m_Emitters.size()), m_Instances.data());
+		}
+
+		void ParticleRenderer::RenderScene()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(m_Emitters.empty())
+				return;
+
+			if(m_ParticleCount > m_InstanceCapacity)
+			{
+				m_InstanceCapacity = Maths::Max(m_InstanceCapacity, MinInstanceCapacity);
+				while(m_InstanceCapacity < m_ParticleCount)
+					m_InstanceCapacity *= 2;
+
+				delete m_InstanceBuffer;
+				m_InstanceBuffer = nullptr;
+				UpdateDescriptorSet();
+			}
+
+			m_UniformBuffer->SetData(sizeof(UniformBufferObject), m_VSSystemUniformBuffer);
+			m_InstanceBuffer->SetData(uint32_t(m_Instances.size() * sizeof(ParticleInstance)), m_Instances.data());
+
+			m_CurrentBufferID = 0;
+			if(!m_RenderTexture)
+				m_CurrentBufferID = Renderer::GetSwapchain()->GetCurrentBufferId();
+
+			Begin();
+			Present();
+			End();
+
+			if(!m_RenderTexture)
+				Renderer::Present((m_CommandBuffers[m_CurrentBufferID].get()));
+		}
+
+		void ParticleRenderer::Present()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			CommandBuffer* commandBuffer = m_CommandBuffers[m_CurrentBufferID].get();
+			m_Pipeline->Bind(commandBuffer);
+
+			for(auto& textureSet : m_TextureSets)
+				textureSet.second.used = false;
+
+			uint32_t instanceOffset = 0;
+			for(auto emitter : m_Emitters)
+			{
+				EmitterConstants constants;
+				constants.startColour = emitter->GetStartColour();
+				constants.endColour = emitter->GetEndColour();
+				constants.size = Maths::Vector2(emitter->GetStartSize(), emitter->GetEndSize());
+				constants.instanceOffset = instanceOffset;
+				memcpy(m_PushConstants[0].data, &constants, sizeof(EmitterConstants));
+
+				m_CurrentDescriptorSets[0] = m_Pipeline->GetDescriptorSet();
+				m_CurrentDescriptorSets[1] = GetTextureDescriptorSet(emitter->GetTexture() ? emitter->GetTextureRef() : m_WhiteTexture);
+				m_CurrentDescriptorSets[0]->SetPushConstants(m_PushConstants);
+
+				m_QuadVertexBuffer->Bind(commandBuffer, m_Pipeline.get());
+				m_QuadIndexBuffer->Bind(commandBuffer);
+
+				Renderer::BindDescriptorSets(m_Pipeline.get(), commandBuffer, 0, m_CurrentDescriptorSets);
+				Renderer::DrawIndexedInstanced(commandBuffer, DrawType::TRIANGLE, 6, emitter->GetParticleCount());
+
+				m_QuadVertexBuffer->Unbind();
+				m_QuadIndexBuffer->Unbind();
+
+				instanceOffset += emitter->GetParticleCount();
+				Engine::Get().Statistics().NumRenderedObjects++;
+			}
+
+			//Drop sets of textures no emitter uses any more so they can be freed
+			for(auto it = m_TextureSets.begin(); it != m_TextureSets.end();)
+			{
+				if(!it->second.used)
+					it = m_TextureSets.erase(it);
+				else
+					++it;
+			}
+		}
+
+		DescriptorSet* ParticleRenderer::GetTextureDescriptorSet(const Ref<Texture2D>& texture)
+		{
+			auto& textureSet = m_TextureSets[texture.get()];
+			textureSet.used = true;
+
+			if(!textureSet.descriptorSet)
+			{
+				Graphics::DescriptorInfo info{};
+				info.pipeline = m_Pipeline.get();
+				info.layoutIndex = 1;
+				info.shader = m_Shader.get();
+				textureSet.descriptorSet = Ref<DescriptorSet>(DescriptorSet::Create(info));
+				textureSet.texture = texture;
+
+				Graphics::ImageInfo imageInfo = {};
+				imageInfo.texture = texture.get();
+				imageInfo.name = "u_Texture";
+				imageInfo.binding = 0;
+				imageInfo.type = TextureType::COLOUR;
+
+				std::vector<Graphics::ImageInfo> imageInfos = {imageInfo};
+				textureSet.descriptorSet->Update(imageInfos);
+			}
+
+			return textureSet.descriptorSet.get();
+		}
+
+		void ParticleRenderer::Begin()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_RenderPass->BeginRenderpass(m_CommandBuffers[m_CurrentBufferID].get(), Maths::Vector4(0.0f), m_Framebuffers[m_CurrentBufferID].get(), Graphics::INLINE, m_ScreenBufferWidth, m_ScreenBufferHeight);
+		}
+
+		void ParticleRenderer::End()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_RenderPass->EndRenderpass(m_CommandBuffers[m_CurrentBufferID].get());
+
+			if(m_RenderTexture)
+				m_CommandBuffers[m_CurrentBufferID]->Execute(true);
+		}
+
+		void ParticleRenderer::OnResize(uint32_t width, uint32_t height)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_Framebuffers.clear();
+
+			SetScreenBufferSize(width, height);
+
+			CreateFramebuffers();
+		}
+
+		void ParticleRenderer::CreateGraphicsPipeline()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			Graphics::BufferLayout vertexBufferLayout;
+			vertexBufferLayout.Push<Maths::Vector2>("corner");
+
+			//Particles are blended and tested against the scene depth without writing to it, so overlapping
+			//billboards don't cut each other out
+			Graphics::PipelineInfo pipelineCreateInfo{};
+			pipelineCreateInfo.shader = m_Shader;
+			pipelineCreateInfo.renderpass = m_RenderPass;
+			pipelineCreateInfo.vertexBufferLayout = vertexBufferLayout;
+			pipelineCreateInfo.polygonMode = Graphics::PolygonMode::FILL;
+			pipelineCreateInfo.cullMode = Graphics::CullMode::NONE;
+			pipelineCreateInfo.transparencyEnabled = true;
+			pipelineCreateInfo.depthBiasEnabled = false;
+			pipelineCreateInfo.depthWriteEnabled = false;
+
+			m_Pipeline = Graphics::Pipeline::Get(pipelineCreateInfo);
+		}
+
+		void ParticleRenderer::UpdateDescriptorSet()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(m_UniformBuffer == nullptr)
+			{
+				m_UniformBuffer = Graphics::UniformBuffer::Create();
+				m_UniformBuffer->Init(sizeof(UniformBufferObject), nullptr);
+			}
+
+			if(m_InstanceBuffer == nullptr)
+			{
+				m_InstanceCapacity = Maths::Max(m_InstanceCapacity, MinInstanceCapacity);
+				m_InstanceBuffer = Graphics::UniformBuffer::Create();
+				m_InstanceBuffer->Init(m_InstanceCapacity * sizeof(ParticleInstance), nullptr);
+			}
+
+			Graphics::BufferInfo bufferInfo = {};
+			bufferInfo.buffer = m_UniformBuffer;
+			bufferInfo.offset = 0;
+			bufferInfo.size = sizeof(UniformBufferObject);
+			bufferInfo.type = Graphics::DescriptorType::UNIFORM_BUFFER;
+			bufferInfo.binding = 0;
+			bufferInfo.shaderType = ShaderType::VERTEX;
+			bufferInfo.name = "UniformBufferObject";
+
+			Graphics::BufferInfo instanceBufferInfo = {};
+			instanceBufferInfo.buffer = m_InstanceBuffer;
+			instanceBufferInfo.offset = 0;
+			instanceBufferInfo.size = m_InstanceCapacity * sizeof(ParticleInstance);
+			instanceBufferInfo.type = Graphics::DescriptorType::STORAGE_BUFFER;
+			instanceBufferInfo.binding = 1;
+			instanceBufferInfo.shaderType = ShaderType::VERTEX;
+			instanceBufferInfo.name = "ParticleInstances";
+
+			std::vector<Graphics::BufferInfo> bufferInfos = {bufferInfo, instanceBufferInfo};
+			m_Pipeline->GetDescriptorSet()->Update(bufferInfos);
+		}
+
+		void ParticleRenderer::SetRenderTarget(Texture* texture, bool rebuildFramebuffer)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_RenderTexture = texture;
+
+			if(rebuildFramebuffer)
+			{
+				m_Framebuffers.clear();
+
+				CreateFramebuffers();
+			}
+		}
+
+		void ParticleRenderer::CreateFramebuffers()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			TextureType attachmentTypes[2];
+			attachmentTypes[0] = TextureType::COLOUR;
+			attachmentTypes[1] = TextureType::DEPTH;
+
+			Texture* attachments[2];
+			FramebufferInfo bufferInfo{};
+			bufferInfo.width = m_ScreenBufferWidth;
+			bufferInfo.height = m_ScreenBufferHeight;
+			bufferInfo.attachmentCount = 2;
+			bufferInfo.renderPass = m_RenderPass.get();
+			bufferInfo.attachmentTypes = attachmentTypes;
+
+			attachments[1] = dynamic_cast<Texture*>(Application::Get().GetRenderGraph()->GetGBuffer()->GetDepthTexture());
+
+			if(m_RenderTexture)
+			{
+				attachments[0] = m_RenderTexture;
+				bufferInfo.attachments = attachments;
+				bufferInfo.screenFBO = false;
+				m_Framebuffers.emplace_back(Framebuffer::Get(bufferInfo));
+			}
+			else
+			{
+				for(uint32_t i = 0; i < Renderer::GetSwapchain()->GetSwapchainBufferCount(); i++)
+				{
+					bufferInfo.screenFBO = true;
+					attachments[0] = Renderer::GetSwapchain()->GetImage(i);
+					bufferInfo.attachments = attachments;
+
+					m_Framebuffers.emplace_back(Framebuffer::Get(bufferInfo));
+				}
+			}
+		}
+
+		void ParticleRenderer::OnImGui()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			ImGui::TextUnformatted("Particle Renderer");
+			ImGui::Text("Emitters : %u (%u culled)", uint32_t(m_Emitters.size()), m_CulledEmitters);
+			ImGui::Text("Particles : %u", m_ParticleCount);
+			ImGui::Text("Instance Capacity : %u", m_InstanceCapacity);
+		}
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "IRenderer.h"
+#include "Graphics/API/DescriptorSet.h"
+#include "Graphics/Particles/ParticleBuffer.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		class ParticleEmitter;
+		class Texture2D;
+		class VertexBuffer;
+		class IndexBuffer;
+
+		//Draws billboard particle emitters with one instanced draw each. Visible emitters' particles are packed
+		//into a single storage buffer, the vertex shader expands every instance into a camera facing quad
+		class LUMOS_EXPORT ParticleRenderer : public IRenderer
+		{
+		public:
+			ParticleRenderer(uint32_t width, uint32_t height);
+			~ParticleRenderer();
+
+			void Init() override;
+			void BeginScene(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform) override;
+			void OnResize(uint32_t width, uint32_t height) override;
+			void CreateGraphicsPipeline();
+			void UpdateDescriptorSet();
+
+			void Begin() override;
+			void Submit(const RenderCommand& command) override {};
+			void SubmitMesh(Mesh* mesh, Material* material, const Maths::Matrix4& transform, const Maths::Matrix4& textureMatrix) override {};
+			void EndScene() override {};
+			void End() override;
+			void Present() override;
+			void RenderScene() override;
+			void PresentToScreen() override {}
+
+			void CreateFramebuffers();
+
+			struct UniformBufferObject
+			{
+				Maths::Matrix4 projView;
+				Maths::Vector4 cameraRight;
+				Maths::Vector4 cameraUp;
+			};
+
+			//Matches PushConsts in Particle.vert
+			struct EmitterConstants
+			{
+				Maths::Vector4 startColour;
+				Maths::Vector4 endColour;
+				Maths::Vector2 size;
+				uint32_t instanceOffset;
+			};
+
+			void SetRenderTarget(Texture* texture, bool rebuildFramebuffer) override;
+
+			void OnImGui() override;
+
+		private:
+			DescriptorSet* GetTextureDescriptorSet(const Ref<Texture2D>& texture);
+
+			struct TextureSet
+			{
+				Ref<Texture2D> texture;
+				Ref<DescriptorSet> descriptorSet;
+				bool used;
+			};
+
+			UniformBuffer* m_UniformBuffer = nullptr;
+			UniformBuffer* m_InstanceBuffer = nullptr;
+			uint32_t m_InstanceCapacity = 0;
+
+			Ref<VertexBuffer> m_QuadVertexBuffer;
+			Ref<IndexBuffer> m_QuadIndexBuffer;
+			Ref<Texture2D> m_WhiteTexture;
+			std::vector<PushConstant> m_PushConstants;
+
+			std::vector<ParticleEmitter*> m_Emitters;
+			std::vector<ParticleInstance> m_Instances;
+			std::unordered_map<Texture2D*, TextureSet> m_TextureSets;
+
+			uint32_t m_CurrentBufferID = 0;
+			uint32_t m_CulledEmitters = 0;
+			uint32_t m_ParticleCount = 0;
+		};
+	}
+}
@@ -17,6 +17,11 @@ namespace Lumos
 			Maths::Matrix4 transform;
 			Maths::Matrix4 textureMatrix;
             bool animated = false;
+			uint32_t lod = 0;
+			//First joint in the shared bone palette, animated meshes only
+			uint32_t boneOffset = 0;
+			//Slot in the bindless material table, static meshes only
+			uint32_t materialIndex = 0;
 		};
 	}
 }
@@ -3,6 +3,9 @@
 #include "Graphics/GBuffer.h"
 #include "Graphics/Renderers/IRenderer.h"
 #include "Graphics/Renderers/DebugRenderer.h"
+#include "Graphics/Terrain/TerrainStreamer.h"
+#include "Graphics/Camera/Camera.h"
+#include "Maths/Transform.h"
 
 namespace Lumos::Graphics
 {
@@ -11,6 +14,7 @@ namespace Lumos::Graphics
 		SetScreenBufferSize(width, height);
 		
 		m_GBuffer = new GBuffer(width, height);
+		m_TerrainStreamer = CreateUniqueRef<TerrainStreamer>();
 		Reset();
 	}
 	
@@ -42,6 +46,18 @@ namespace Lumos::Graphics
     void RenderGraph::BeginScene(Scene* scene)
     {
 		DebugRenderer::Reset();
+
+		//Terrain chunks are streamed before any renderer collects them
+		Maths::Transform* cameraTransform = m_OverrideCameraTransform;
+		if(!cameraTransform && scene)
+		{
+			auto cameraView = scene->GetRegistry().view<Camera>();
+			if(!cameraView.empty())
+				cameraTransform = scene->GetRegistry().try_get<Maths::Transform>(cameraView.front());
+		}
+
+		if(cameraTransform)
+			m_TerrainStreamer->Update(scene, cameraTransform->GetWorldPosition());
 		
         for(auto renderer: m_Renderers)
         {
@@ -101,6 +117,8 @@ namespace Lumos::Graphics
         {
             renderer->OnImGui();
         }
+
+        m_TerrainStreamer->OnImGui();
     }
 
     void RenderGraph::OnNewScene(Scene* scene)
@@ -127,6 +145,18 @@ namespace Lumos::Graphics
         //SortRenderers();
     }
 
+    void RenderGraph::ClearRenderers()
+    {
+        for(auto renderer : m_Renderers)
+        {
+            delete renderer;
+        }
+
+        m_Renderers.clear();
+        m_ShadowRenderer = nullptr;
+        DebugRenderer::Release();
+    }
+
     void RenderGraph::SortRenderers()
     {
 		std::sort(m_Renderers.begin(), m_Renderers.end(), [](Graphics::IRenderer* a, Graphics::IRenderer* b) { return a->GetRenderPriority() > b->GetRenderPriority(); });
@@ -28,6 +28,7 @@ namespace Lumos
 		class TextureDepthArray;
 		class ShadowRenderer;
 		class SkyboxRenderer;
+		class TerrainStreamer;
 
 		class RenderGraph
 		{
@@ -39,6 +40,7 @@ namespace Lumos
             void AddRenderer(Graphics::IRenderer* renderer, int renderPriority);
 
 			void SortRenderers();
+			void ClearRenderers();
 			void EnableDebugRenderer(bool enable);
 			
 			void Reset();
@@ -62,6 +64,8 @@ namespace Lumos
 			void SetNumShadowMaps(uint32_t num) { m_NumShadowMaps = num; }
 			void SetTextureDepthArray(TextureDepthArray* texture) { m_ShadowTexture = texture; }
 			
+			TerrainStreamer* GetTerrainStreamer() const { return m_TerrainStreamer.get(); }
+
 			ShadowRenderer* GetShadowRenderer() const { return m_ShadowRenderer; };
 			void SetShadowRenderer(ShadowRenderer* renderer) { m_ShadowRenderer = renderer; }
 			
@@ -98,6 +102,7 @@ namespace Lumos
 			GBuffer* m_GBuffer = nullptr;
 			
 			ShadowRenderer* m_ShadowRenderer = nullptr;
+			UniqueRef<TerrainStreamer> m_TerrainStreamer;
             
             Camera* m_OverrideCamera = nullptr;
             Maths::Transform* m_OverrideCameraTransform = nullptr;
@@ -13,6 +13,8 @@
 #include "Graphics/GBuffer.h"
 #include "Graphics/Sprite.h"
 #include "Graphics/AnimatedSprite.h"
+#include "Graphics/TextureAtlas.h"
+#include "Graphics/Particles/ParticleEmitter.h"
 #include "Scene/Scene.h"
 #include "Core/Application.h"
 #include "RenderGraph.h"
@@ -21,11 +23,229 @@
 #include "Graphics/Camera/Camera.h"
 #include "Maths/Transform.h"
 #include "Core/Engine.h"
+#include "Core/JobSystem.h"
+
+#include <imgui/imgui.h>
 
 namespace Lumos
 {
 	namespace Graphics
 	{
+		enum SpriteFlag : uint8_t
+		{
+			SpriteCulled,
+			SpriteVisible,
+			SpriteStatic
+		};
+
+		static const uint32_t SpriteCullGroupSize = 256;
+		static const uint32_t QuadWriteChunkSize = 1024;
+		static const uint32_t StaticBatchMaxQuads = 65536;
+
+		static void GenerateQuadIndices(uint32_t* indices, uint32_t indexCount)
+		{
+			uint32_t offset = 0;
+			for(uint32_t i = 0; i < indexCount; i += 6)
+			{
+				indices[i] = offset + 0;
+				indices[i + 1] = offset + 1;
+				indices[i + 2] = offset + 2;
+
+				indices[i + 3] = offset + 2;
+				indices[i + 4] = offset + 3;
+				indices[i + 5] = offset + 0;
+
+				offset += 4;
+			}
+		}
+
+		static uint64_t HashWords(uint64_t hash, const void* data, size_t size)
+		{
+			const uint32_t* words = static_cast<const uint32_t*>(data);
+			for(size_t i = 0; i < size / sizeof(uint32_t); i++)
+				hash = (hash ^ words[i]) * 1099511628211ull;
+			return hash;
+		}
+
+		//Everything that ends up in a static sprite's vertices
+		static uint64_t HashSprite(const Sprite& sprite, const Maths::Matrix4& transform, uint32_t index)
+		{
+			uint64_t hash = 14695981039346656037ull ^ index;
+			const Texture2D* texture = sprite.GetTexture();
+			const Maths::Vector2 position = sprite.GetPosition();
+			const Maths::Vector2 scale = sprite.GetScale();
+
+			hash = HashWords(hash, &transform, sizeof(Maths::Matrix4));
+			hash = HashWords(hash, &position, sizeof(Maths::Vector2));
+			hash = HashWords(hash, &scale, sizeof(Maths::Vector2));
+			hash = HashWords(hash, &sprite.GetColour(), sizeof(Maths::Vector4));
+			hash = HashWords(hash, sprite.GetUVs().data(), sizeof(Maths::Vector2) * 4);
+			hash = HashWords(hash, &texture, sizeof(texture));
+			return hash;
+		}
+
+		//Flags every sprite in the group as culled, visible or static. Static sprites aren't culled
+		//individually, their hashes are summed per job group to detect changes
+		template<typename T, typename Group>
+		static void CullSprites(Group& group, const Maths::Frustum& frustum, bool allowStatic, std::vector<uint8_t>& flags, std::vector<uint64_t>& groupHashes)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			const uint32_t count = static_cast<uint32_t>(group.size());
+			const auto* entities = group.data();
+
+			flags.resize(count);
+			groupHashes.assign((count + SpriteCullGroupSize - 1) / SpriteCullGroupSize, 0);
+
+			auto cull = [&](uint32_t index, uint32_t groupIndex)
+			{
+				const auto& [sprite, trans] = group.template get<T, Maths::Transform>(entities[index]);
+				const auto& worldMatrix = trans.GetWorldMatrix();
+
+				if(allowStatic && sprite.IsStatic())
+				{
+					flags[index] = SpriteStatic;
+					groupHashes[groupIndex] += HashSprite(sprite, worldMatrix, index);
+					return;
+				}
+
+				auto bb = Maths::BoundingBox(Maths::Rect(sprite.GetPosition(), sprite.GetPosition() + sprite.GetScale()));
+				bb.Transform(worldMatrix);
+				flags[index] = frustum.IsInsideFast(bb) == Maths::Intersection::OUTSIDE ? SpriteCulled : SpriteVisible;
+			};
+
+			if(count > SpriteCullGroupSize)
+			{
+				System::JobSystem::Dispatch(count, SpriteCullGroupSize, [&](JobDispatchArgs args)
+				{
+					cull(args.jobIndex, args.groupIndex);
+				});
+				System::JobSystem::Wait();
+			}
+			else
+			{
+				for(uint32_t i = 0; i < count; i++)
+					cull(i, 0);
+			}
+		}
+
+		static void WriteQuad(VertexData* buffer, const RenderCommand2D& command, float textureSlot)
+		{
+			const Renderable2D* renderable = command.renderable;
+			const Maths::Vector2 min = renderable->GetPosition();
+			const Maths::Vector2 max = min + renderable->GetScale();
+			const Maths::Vector4& colour = renderable->GetColour();
+			const Maths::Vector2 tid(textureSlot, 0.0f);
+
+			//Sprite transforms are affine so the last corner follows from the other three
+			const Maths::Vector3 p0 = command.transform * Maths::Vector3(min.x, min.y, 0.0f);
+			const Maths::Vector3 p1 = command.transform * Maths::Vector3(max.x, min.y, 0.0f);
+			const Maths::Vector3 p3 = command.transform * Maths::Vector3(min.x, max.y, 0.0f);
+			const Maths::Vector3 p2 = p1 + p3 - p0;
+
+			buffer[0] = {p0, command.uvs[0], tid, colour};
+			buffer[1] = {p1, command.uvs[1], tid, colour};
+			buffer[2] = {p2, command.uvs[2], tid, colour};
+			buffer[3] = {p3, command.uvs[3], tid, colour};
+		}
+
+		//Large ranges are split across the job system, each job writing its own range of the buffer
+		static void WriteQuads(const RenderCommand2D* commands, const float* textureSlots, uint32_t count, VertexData* buffer)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(count > QuadWriteChunkSize)
+			{
+				const uint32_t chunkCount = (count + QuadWriteChunkSize - 1) / QuadWriteChunkSize;
+				System::JobSystem::Dispatch(chunkCount, 1, [&](JobDispatchArgs args)
+				{
+					const uint32_t start = args.jobIndex * QuadWriteChunkSize;
+					const uint32_t end = Maths::Min(start + QuadWriteChunkSize, count);
+					for(uint32_t i = start; i < end; i++)
+						WriteQuad(buffer + i * 4, commands[i], textureSlots[i]);
+				});
+				System::JobSystem::Wait();
+			}
+			else
+			{
+				for(uint32_t i = 0; i < count; i++)
+					WriteQuad(buffer + i * 4, commands[i], textureSlots[i]);
+			}
+		}
+
+		//Particles are quads in the xy plane, size and colour follow their age
+		static void WriteParticleQuads(const ParticleEmitter& emitter, uint32_t start, uint32_t end, float textureSlot, VertexData* buffer)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			const ParticleBuffer& particles = emitter.GetBuffer();
+			const float* px = particles.Get(ParticlePositionX);
+			const float* py = particles.Get(ParticlePositionY);
+			const float* pz = particles.Get(ParticlePositionZ);
+			const float* ages = particles.Get(ParticleAge);
+			const auto& uvs = Renderable2D::GetDefaultUVs();
+			const Maths::Vector2 tid(textureSlot, 0.0f);
+
+			auto write = [&](uint32_t i)
+			{
+				const float age = Maths::Clamp(ages[i], 0.0f, 1.0f);
+				const float halfSize = Maths::Lerp(emitter.GetStartSize(), emitter.GetEndSize(), age) * 0.5f;
+				const Maths::Vector4 colour = emitter.GetStartColour().Lerp(emitter.GetEndColour(), age);
+
+				VertexData* quad = buffer + (i - start) * 4;
+				quad[0] = {Maths::Vector3(px[i] - halfSize, py[i] - halfSize, pz[i]), uvs[0], tid, colour};
+				quad[1] = {Maths::Vector3(px[i] + halfSize, py[i] - halfSize, pz[i]), uvs[1], tid, colour};
+				quad[2] = {Maths::Vector3(px[i] + halfSize, py[i] + halfSize, pz[i]), uvs[2], tid, colour};
+				quad[3] = {Maths::Vector3(px[i] - halfSize, py[i] + halfSize, pz[i]), uvs[3], tid, colour};
+			};
+
+			const uint32_t count = end - start;
+			if(count > QuadWriteChunkSize)
+			{
+				const uint32_t chunkCount = (count + QuadWriteChunkSize - 1) / QuadWriteChunkSize;
+				System::JobSystem::Dispatch(chunkCount, 1, [&](JobDispatchArgs args)
+				{
+					const uint32_t chunkStart = start + args.jobIndex * QuadWriteChunkSize;
+					const uint32_t chunkEnd = Maths::Min(chunkStart + QuadWriteChunkSize, end);
+					for(uint32_t i = chunkStart; i < chunkEnd; i++)
+						write(i);
+				});
+				System::JobSystem::Wait();
+			}
+			else
+			{
+				for(uint32_t i = start; i < end; i++)
+					write(i);
+			}
+		}
+
+		//Returns the 1 based slot of the texture or 0 if it isn't in the list
+		static float FindTextureSlot(Texture* const* textures, uint32_t textureCount, const Texture* texture)
+		{
+			for(uint32_t i = 0; i < textureCount; i++)
+			{
+				if(textures[i] == texture)
+					return static_cast<float>(i + 1);
+			}
+			return 0.0f;
+		}
+
+		static void UpdateTextureImages(DescriptorSet* descriptorSet, Texture** textures, uint32_t textureCount)
+		{
+			std::vector<Graphics::ImageInfo> imageInfos;
+
+			Graphics::ImageInfo imageInfo = {};
+
+			imageInfo.binding = 0;
+			imageInfo.name = "textures";
+			if(textureCount > 1)
+				imageInfo.textures = textures;
+			else
+				imageInfo.texture = textures[0];
+			imageInfo.count = textureCount;
+
+			imageInfos.push_back(imageInfo);
+
+			descriptorSet->Update(imageInfos);
+		}
+
 		Renderer2D::Renderer2D(uint32_t width, uint32_t height, bool clear, bool triangleIndicies, bool renderToDepth)
 			: m_IndexCount(0)
 			, m_Buffer(nullptr)
@@ -42,6 +262,8 @@ namespace Lumos
 
 		Renderer2D::~Renderer2D()
 		{
+			ClearStaticBatches();
+			delete m_StaticIndexBuffer;
 			delete m_IndexBuffer;
 			delete m_UniformBuffer;
 
@@ -145,19 +367,7 @@ namespace Lumos
 			}
 			else
 			{
-				uint32_t offset = 0;
-				for(uint32_t i = 0; i < m_Limits.IndiciesSize; i += 6)
-				{
-					indices[i] = offset + 0;
-					indices[i + 1] = offset + 1;
-					indices[i + 2] = offset + 2;
-
-					indices[i + 3] = offset + 2;
-					indices[i + 4] = offset + 3;
-					indices[i + 5] = offset + 0;
-
-					offset += 4;
-				}
+				GenerateQuadIndices(indices, m_Limits.IndiciesSize);
 			}
 			m_IndexBuffer = IndexBuffer::Create(indices, m_Limits.IndiciesSize);
 
@@ -165,6 +375,8 @@ namespace Lumos
             
 			m_ClearColour = Maths::Vector4(0.2f, 0.2f, 0.2f, 1.0f);
             m_CurrentDescriptorSets.resize(2);
+
+			m_TextureAtlas = CreateUniqueRef<TextureAtlas>();
 		}
 
 		void Renderer2D::Submit(Renderable2D* renderable, const Maths::Matrix4& transform)
@@ -230,6 +442,9 @@ namespace Lumos
 			m_TextureCount = 0;
 			m_Triangles.clear();
 
+			//Recorded before the dynamic vertex buffer is mapped, GL maps whatever buffer is bound
+			PresentStaticBatches();
+
             m_VertexBuffers[m_BatchDrawCallIndex]->Bind(m_CommandBuffers[m_CurrentBufferID].get(), m_Pipeline.get());
 			m_Buffer = m_VertexBuffers[m_BatchDrawCallIndex]->GetPointer<VertexData>();
 		}
@@ -272,34 +487,74 @@ namespace Lumos
             m_CommandQueue2D.clear();
             
             auto group = registry.group<Graphics::Sprite>(entt::get<Maths::Transform>);
-            for(auto entity : group)
-            {
-                const auto& [sprite, trans] = group.get<Graphics::Sprite, Maths::Transform>(entity);
+            CullSprites<Graphics::Sprite>(group, m_Frustum, true, m_SpriteFlags, m_StaticGroupHashes);
 
-                auto bb = Maths::BoundingBox(Maths::Rect(sprite.GetPosition(), sprite.GetPosition() + sprite.GetScale()));
-                bb.Transform(trans.GetWorldMatrix());
-                auto inside = m_Frustum.IsInside(bb);
+            uint64_t staticHash = 0;
+            uint32_t staticCount = 0;
+            for(auto hash : m_StaticGroupHashes)
+                staticHash += hash;
 
-                if(inside == Maths::Intersection::OUTSIDE)
+            const auto* entities = group.data();
+            for(uint32_t i = 0; i < uint32_t(group.size()); i++)
+            {
+                if(m_SpriteFlags[i] == SpriteStatic)
+                {
+                    staticCount++;
+                    continue;
+                }
+
+                if(m_SpriteFlags[i] == SpriteCulled)
                     continue;
 
+                const auto& [sprite, trans] = group.get<Graphics::Sprite, Maths::Transform>(entities[i]);
                 Submit(&sprite, trans.GetWorldMatrix());
-            };
+            }
+
+            if(staticCount != m_StaticSpriteCount || staticHash != m_StaticHash)
+            {
+                m_StaticSpriteCount = staticCount;
+                m_StaticHash = staticHash;
+                m_StaticDirty = true;
+                m_StaticCommands.clear();
+
+                for(uint32_t i = 0; i < uint32_t(group.size()); i++)
+                {
+                    if(m_SpriteFlags[i] != SpriteStatic)
+                        continue;
+
+                    const auto& [sprite, trans] = group.get<Graphics::Sprite, Maths::Transform>(entities[i]);
+
+                    RenderCommand2D command;
+                    command.renderable = &sprite;
+                    command.transform = trans.GetWorldMatrix();
+                    m_StaticCommands.push_back(command);
+                }
+            }
             
             auto group2 = registry.group<Graphics::AnimatedSprite>(entt::get<Maths::Transform>);
-            for(auto entity : group2)
+            CullSprites<Graphics::AnimatedSprite>(group2, m_Frustum, false, m_SpriteFlags, m_StaticGroupHashes);
+
+            const auto* animatedEntities = group2.data();
+            for(uint32_t i = 0; i < uint32_t(group2.size()); i++)
             {
-                const auto& [sprite, trans] = group2.get<Graphics::AnimatedSprite, Maths::Transform>(entity);
-                
-                auto bb = Maths::BoundingBox(Maths::Rect(sprite.GetPosition(), sprite.GetPosition() + sprite.GetScale()));
-                bb.Transform(trans.GetWorldMatrix());
-                auto inside = m_Frustum.IsInside(bb);
-                
-                if(inside == Maths::Intersection::OUTSIDE)
+                if(m_SpriteFlags[i] == SpriteCulled)
                     continue;
-                
+
+                const auto& [sprite, trans] = group2.get<Graphics::AnimatedSprite, Maths::Transform>(animatedEntities[i]);
                 Submit(&sprite, trans.GetWorldMatrix());
-            };
+            }
+
+            m_ParticleEmitters.clear();
+            auto emitterView = registry.view<Graphics::ParticleEmitter>();
+            for(auto entity : emitterView)
+            {
+                auto& emitter = emitterView.get<Graphics::ParticleEmitter>(entity);
+                if(emitter.GetRenderMode() != ParticleEmitter::RenderMode::Sprite || emitter.GetParticleCount() == 0)
+                    continue;
+
+                if(m_Frustum.IsInsideFast(emitter.GetBounds()) != Maths::Intersection::OUTSIDE)
+                    m_ParticleEmitters.push_back(&emitter);
+            }
 		}
 
 		void Renderer2D::Present()
@@ -362,66 +617,284 @@ namespace Lumos
     
         void Renderer2D::SubmitQueue()
         {
-            for(auto& command : m_CommandQueue2D)
+            LUMOS_PROFILE_FUNCTION();
+            const uint32_t count = static_cast<uint32_t>(m_CommandQueue2D.size());
+            Engine::Get().Statistics().NumRenderedObjects += count;
+
+            m_TextureSlots.resize(count);
+
+            //Texture slots are assigned serially to find where batches break, then each batch's vertices are written in parallel
+            uint32_t index = 0;
+            while(index < count)
             {
-                Engine::Get().Statistics().NumRenderedObjects++;
-                    
-                if(m_IndexCount >= m_Limits.IndiciesSize)
+                const uint32_t batchStart = index;
+                const uint32_t quadCapacity = (m_Limits.IndiciesSize - m_IndexCount) / 6;
+
+                while(index < count && index - batchStart < quadCapacity)
+                {
+                    Texture* texture = m_CommandQueue2D[index].texture;
+                    float textureSlot = 0.0f;
+
+                    if(texture)
+                    {
+                        textureSlot = FindTextureSlot(m_Textures, m_TextureCount, texture);
+                        if(textureSlot == 0.0f)
+                        {
+                            if(m_TextureCount >= m_Limits.MaxTextures)
+                                break;
+
+                            m_Textures[m_TextureCount++] = texture;
+                            textureSlot = static_cast<float>(m_TextureCount);
+                        }
+                    }
+
+                    m_TextureSlots[index] = textureSlot;
+                    index++;
+                }
+
+                const uint32_t batchCount = index - batchStart;
+                WriteQuads(&m_CommandQueue2D[batchStart], &m_TextureSlots[batchStart], batchCount, m_Buffer);
+
+                m_Buffer += batchCount * 4;
+                m_IndexCount += batchCount * 6;
+
+                if(index < count)
                     FlushAndReset();
-                
-                auto& renderable = command.renderable;
-                auto& transform = command.transform;
-
-                const Maths::Vector2 min = renderable->GetPosition();
-                const Maths::Vector2 max = renderable->GetPosition() + renderable->GetScale();
-
-                const Maths::Vector4 colour = renderable->GetColour();
-                const auto& uv = renderable->GetUVs();
-                const Texture* texture = renderable->GetTexture();
-
-                float textureSlot = 0.0f;
-                if(texture)
-                    textureSlot = SubmitTexture(renderable->GetTexture());
-
-                Maths::Vector3 vertex = transform * Maths::Vector3(min.x, min.y, 0.0f);
-                m_Buffer->vertex = vertex;
-                m_Buffer->uv = uv[0];
-                m_Buffer->tid = Maths::Vector2(textureSlot, 0.0f);
-                m_Buffer->color = colour;
-                m_Buffer++;
-
-                vertex = transform * Maths::Vector3(max.x, min.y, 0.0f);
-                m_Buffer->vertex = vertex;
-                m_Buffer->uv = uv[1];
-                m_Buffer->tid = Maths::Vector2(textureSlot, 0.0f);
-                m_Buffer->color = colour;
-                m_Buffer++;
-
-                vertex = transform * Maths::Vector3(max.x, max.y, 0.0f);
-                m_Buffer->vertex = vertex;
-                m_Buffer->uv = uv[2];
-                m_Buffer->tid = Maths::Vector2(textureSlot, 0.0f);
-                m_Buffer->color = colour;
-                m_Buffer++;
-
-                vertex = transform * Maths::Vector3(min.x, max.y, 0.0f);
-                m_Buffer->vertex = vertex;
-                m_Buffer->uv = uv[3];
-                m_Buffer->tid = Maths::Vector2(textureSlot, 0.0f);
-                m_Buffer->color = colour;
-                m_Buffer++;
-
-                m_IndexCount += 6;
+            }
+        }
+
+        void Renderer2D::SubmitParticles()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            for(auto emitter : m_ParticleEmitters)
+            {
+                const uint32_t count = emitter->GetParticleCount();
+                Engine::Get().Statistics().NumRenderedObjects += count;
+
+                uint32_t start = 0;
+                while(start < count)
+                {
+                    float textureSlot = 0.0f;
+                    if(emitter->GetTexture())
+                    {
+                        textureSlot = FindTextureSlot(m_Textures, m_TextureCount, emitter->GetTexture());
+                        if(textureSlot == 0.0f)
+                        {
+                            if(m_TextureCount >= m_Limits.MaxTextures)
+                                FlushAndReset();
+
+                            m_Textures[m_TextureCount++] = emitter->GetTexture();
+                            textureSlot = static_cast<float>(m_TextureCount);
+                        }
+                    }
+
+                    const uint32_t quadCapacity = (m_Limits.IndiciesSize - m_IndexCount) / 6;
+                    const uint32_t batchCount = Maths::Min(count - start, quadCapacity);
+                    WriteParticleQuads(*emitter, start, start + batchCount, textureSlot, m_Buffer);
+
+                    m_Buffer += batchCount * 4;
+                    m_IndexCount += batchCount * 6;
+                    start += batchCount;
+
+                    if(start < count)
+                        FlushAndReset();
+                }
+            }
+        }
+
+        bool Renderer2D::ResolveCommand(RenderCommand2D& command)
+        {
+            auto renderable = command.renderable;
+            const auto& uvs = renderable->GetUVs();
+
+            command.texture = renderable->GetTexture();
+            command.uvs = uvs;
+
+            if(!m_UseTextureAtlas || !command.texture)
+                return false;
+
+            //Repeating uvs can't be remapped into a page
+            bool inRange = true;
+            for(auto& uv : uvs)
+                inRange &= uv.x >= 0.0f && uv.x <= 1.0f && uv.y >= 0.0f && uv.y <= 1.0f;
+
+            TextureAtlas::Region region;
+            if(!inRange || !m_TextureAtlas->GetRegion(renderable->GetTextureRef(), region))
+                return false;
+
+            command.texture = region.Page;
+            for(uint32_t i = 0; i < 4; i++)
+                command.uvs[i] = region.Remap(uvs[i]);
+
+            return true;
+        }
+
+        void Renderer2D::ResolveTextures()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            if(m_UseTextureAtlas)
+            {
+                m_TextureAtlas->BeginFrame();
+
+                TextureAtlas::Region region;
+                for(auto& texture : m_StaticAtlasTextures)
+                    m_TextureAtlas->GetRegion(texture, region);
+            }
+
+            if(m_StaticDirty)
+                BakeStaticBatches();
+
+            for(auto& command : m_CommandQueue2D)
+                ResolveCommand(command);
+
+            if(m_UseTextureAtlas)
+                m_TextureAtlas->UploadPages();
+        }
+
+        void Renderer2D::ClearStaticBatches()
+        {
+            for(auto& batch : m_StaticBatches)
+            {
+                delete batch.vertexBuffer;
+                delete batch.commandBuffer;
+            }
+
+            m_StaticBatches.clear();
+        }
+
+        void Renderer2D::BakeStaticBatches()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            m_StaticDirty = false;
+
+            ClearStaticBatches();
+            m_StaticAtlasTextures.clear();
+
+            const uint32_t count = static_cast<uint32_t>(m_StaticCommands.size());
+            if(count == 0)
+                return;
+
+            if(!m_StaticIndexBuffer)
+            {
+                std::vector<uint32_t> indices(StaticBatchMaxQuads * 6);
+                GenerateQuadIndices(indices.data(), uint32_t(indices.size()));
+                m_StaticIndexBuffer = IndexBuffer::Create(indices.data(), uint32_t(indices.size()));
+            }
+
+            std::unordered_set<Texture2D*> atlasTextures;
+            for(auto& command : m_StaticCommands)
+            {
+                if(ResolveCommand(command) && atlasTextures.insert(command.renderable->GetTexture()).second)
+                    m_StaticAtlasTextures.push_back(command.renderable->GetTextureRef());
+            }
+
+            m_TextureSlots.resize(count);
+
+            uint32_t index = 0;
+            while(index < count)
+            {
+                StaticBatch batch;
+                const uint32_t batchStart = index;
+
+                while(index < count && index - batchStart < StaticBatchMaxQuads)
+                {
+                    Texture* texture = m_StaticCommands[index].texture;
+                    float textureSlot = 0.0f;
+
+                    if(texture)
+                    {
+                        textureSlot = FindTextureSlot(batch.textures, batch.textureCount, texture);
+                        if(textureSlot == 0.0f)
+                        {
+                            if(batch.textureCount >= m_Limits.MaxTextures)
+                                break;
+
+                            batch.textures[batch.textureCount++] = texture;
+                            textureSlot = static_cast<float>(batch.textureCount);
+                        }
+                    }
+
+                    m_TextureSlots[index] = textureSlot;
+                    index++;
+                }
+
+                batch.quadCount = index - batchStart;
+                m_StaticVertexData.resize(batch.quadCount * 4);
+                WriteQuads(&m_StaticCommands[batchStart], &m_TextureSlots[batchStart], batch.quadCount, m_StaticVertexData.data());
+
+                for(auto& vertex : m_StaticVertexData)
+                    batch.bounds.Merge(vertex.vertex);
+
+                batch.vertexBuffer = VertexBuffer::Create(BufferUsage::STATIC);
+                batch.vertexBuffer->SetData(uint32_t(m_StaticVertexData.size() * sizeof(VertexData)), m_StaticVertexData.data());
+
+                batch.commandBuffer = CommandBuffer::Create();
+                batch.commandBuffer->Init(false);
+
+                if(batch.textureCount > 0)
+                {
+                    Graphics::DescriptorInfo info{};
+                    info.pipeline = m_Pipeline.get();
+                    info.layoutIndex = 1;
+                    info.shader = m_Shader.get();
+                    batch.descriptorSet = Ref<DescriptorSet>(DescriptorSet::Create(info));
+                    UpdateTextureImages(batch.descriptorSet.get(), batch.textures, batch.textureCount);
+                }
+
+                m_StaticBatches.push_back(batch);
+            }
+
+            //Command pointers are only valid for the frame they were gathered in
+            m_StaticCommands.clear();
+            m_StaticVertexData.clear();
+        }
+
+        void Renderer2D::PresentStaticBatches()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            for(auto& batch : m_StaticBatches)
+            {
+                if(m_Frustum.IsInsideFast(batch.bounds) == Maths::Intersection::OUTSIDE)
+                    continue;
+
+                CommandBuffer* commandBuffer = batch.commandBuffer;
+                commandBuffer->BeginRecordingSecondary(m_RenderPass.get(), m_Framebuffers[m_CurrentBufferID].get());
+                commandBuffer->UpdateViewport(m_ScreenBufferWidth, m_ScreenBufferHeight);
+                m_Pipeline->Bind(commandBuffer);
+
+                m_CurrentDescriptorSets[0] = m_Pipeline->GetDescriptorSet();
+                m_CurrentDescriptorSets[1] = batch.descriptorSet.get();
+
+                const uint32_t indexCount = batch.quadCount * 6;
+                m_StaticIndexBuffer->SetCount(indexCount);
+
+                batch.vertexBuffer->Bind(commandBuffer, m_Pipeline.get());
+                m_StaticIndexBuffer->Bind(commandBuffer);
+
+                Renderer::BindDescriptorSets(m_Pipeline.get(), commandBuffer, 0, m_CurrentDescriptorSets);
+                Renderer::DrawIndexed(commandBuffer, DrawType::TRIANGLE, indexCount);
+
+                batch.vertexBuffer->Unbind();
+                m_StaticIndexBuffer->Unbind();
+
+                commandBuffer->EndRecording();
+                commandBuffer->ExecuteSecondary(m_CommandBuffers[m_CurrentBufferID].get());
+
+                Engine::Get().Statistics().NumRenderedObjects += batch.quadCount;
             }
         }
 
 		void Renderer2D::RenderScene()
 		{
 			LUMOS_PROFILE_FUNCTION();
-			Begin();
+			ResolveTextures();
 
+			//Static batches are recorded in Begin
 			SetSystemUniforms(m_Shader.get());
+			Begin();
+
             SubmitQueue();
+            SubmitParticles();
 			Present();
 
 			End();
@@ -471,6 +944,29 @@ namespace Lumos
 			Renderer::Present((m_CommandBuffers[Renderer::GetSwapchain()->GetCurrentBufferId()].get()));
 		}
 
+		void Renderer2D::OnImGui()
+		{
+			ImGui::TextUnformatted("Renderer2D");
+
+			if(ImGui::Checkbox("Texture Atlas", &m_UseTextureAtlas))
+			{
+				if(!m_UseTextureAtlas)
+					m_TextureAtlas->Clear();
+
+				//Rebake so static batches pick up the change
+				m_StaticHash = 0;
+			}
+
+			ImGui::Text("Atlas Pages : %u", m_TextureAtlas->GetPageCount());
+			ImGui::Text("Atlased Textures : %u", m_TextureAtlas->GetEntryCount());
+
+			uint32_t staticQuads = 0;
+			for(auto& batch : m_StaticBatches)
+				staticQuads += batch.quadCount;
+
+			ImGui::Text("Static Batches : %u (%u quads)", uint32_t(m_StaticBatches.size()), staticQuads);
+		}
+
 		void Renderer2D::CreateGraphicsPipeline()
 		{
 			LUMOS_PROFILE_FUNCTION();
@@ -538,34 +1034,15 @@ namespace Lumos
 			if(m_TextureCount == 0)
 				return;
 			
-			if(m_TextureCount != m_PreviousFrameTextureCount)
-			{
-				//When previous frame texture count was less then than the previous frame
-				// and the texture previously used was deleted, there was a crash - maybe moltenvk only
-				Graphics::DescriptorInfo info{};
-				info.pipeline = m_Pipeline.get();
-				info.layoutIndex = 1;
-				info.shader = m_Shader.get();
-				m_DescriptorSet = Graphics::DescriptorSet::Create(info);
-			}
-			
-			std::vector<Graphics::ImageInfo> imageInfos;
-
-			Graphics::ImageInfo imageInfo = {};
-
-			imageInfo.binding = 0;
-			imageInfo.name = "textures";
-            if(m_TextureCount > 1)
-                imageInfo.textures = m_Textures;
-            else
-                imageInfo.texture = m_Textures[0];
-			imageInfo.count = m_TextureCount;
-
-			imageInfos.push_back(imageInfo);
+			//Each batch gets its own set, the ones recorded earlier this frame still point at their textures
+			Graphics::DescriptorInfo info{};
+			info.pipeline = m_Pipeline.get();
+			info.layoutIndex = 1;
+			info.shader = m_Shader.get();
+			info.transient = true;
+			m_DescriptorSet = Graphics::DescriptorSet::Create(info);
 
-			m_DescriptorSet->Update(imageInfos);
-			
-			m_PreviousFrameTextureCount = m_TextureCount;
+			UpdateTextureImages(m_DescriptorSet.get(), m_Textures, m_TextureCount);
 		}
 
 		void Renderer2D::SetRenderTarget(Texture* texture, bool rebuildFramebuffer)
@@ -25,6 +25,8 @@ namespace Lumos
 		class Shader;
 		class IndexBuffer;
 		class VertexBuffer;
+		class TextureAtlas;
+		class ParticleEmitter;
 
 		struct TriangleInfo
 		{
@@ -46,6 +48,10 @@ namespace Lumos
         {
             Renderable2D* renderable = nullptr;
             Maths::Matrix4 transform;
+
+            //Resolved before drawing, points at an atlas page when the texture was packed
+            Texture2D* texture = nullptr;
+            std::array<Maths::Vector2, 4> uvs;
         };
     
         typedef std::vector<RenderCommand2D> CommandQueue2D;
@@ -88,6 +94,7 @@ namespace Lumos
 			virtual void Submit(Renderable2D* renderable, const Maths::Matrix4& transform);
 			virtual void BeginSimple();
 			virtual void PresentToScreen() override;
+			virtual void OnImGui() override;
 
 			float SubmitTexture(Texture* texture);
 
@@ -101,10 +108,30 @@ namespace Lumos
 			void SubmitTriangles();
 
 		private:
+			//Sprites baked into a persistent vertex buffer, drawn without touching the cpu until they change
+			struct StaticBatch
+			{
+				VertexBuffer* vertexBuffer = nullptr;
+				CommandBuffer* commandBuffer = nullptr;
+				Ref<DescriptorSet> descriptorSet;
+				Texture* textures[MAX_BOUND_TEXTURES];
+				uint32_t textureCount = 0;
+				uint32_t quadCount = 0;
+				Maths::BoundingBox bounds;
+			};
+
 			void SubmitInternal(const TriangleInfo& triangle);
             void SubmitQueue();
+            void SubmitParticles();
+            void ResolveTextures();
+            bool ResolveCommand(RenderCommand2D& command);
+            void BakeStaticBatches();
+            void ClearStaticBatches();
+            void PresentStaticBatches();
 
             CommandQueue2D m_CommandQueue2D;
+            //Visible emitters in sprite mode, their particles are written straight into the batch
+            std::vector<ParticleEmitter*> m_ParticleEmitters;
 			std::vector<CommandBuffer*> m_SecondaryCommandBuffers;
 			std::vector<VertexBuffer*> m_VertexBuffers;
 
@@ -132,8 +159,24 @@ namespace Lumos
 			bool m_RenderToDepthTexture;
             bool m_Empty = false;
 			bool m_TriangleIndicies = false;
-			
-			uint32_t m_PreviousFrameTextureCount = 0;
+
+			UniqueRef<TextureAtlas> m_TextureAtlas;
+			bool m_UseTextureAtlas = true;
+
+			//Per sprite cull results and per job group hashes of static sprites, reused between frames
+			std::vector<uint8_t> m_SpriteFlags;
+			std::vector<uint64_t> m_StaticGroupHashes;
+			std::vector<float> m_TextureSlots;
+
+			CommandQueue2D m_StaticCommands;
+			std::vector<StaticBatch> m_StaticBatches;
+			std::vector<VertexData> m_StaticVertexData;
+			//Atlased textures used by static batches, looked up every frame so their pages aren't evicted
+			std::vector<Ref<Texture2D>> m_StaticAtlasTextures;
+			IndexBuffer* m_StaticIndexBuffer = nullptr;
+			uint64_t m_StaticHash = 0;
+			uint32_t m_StaticSpriteCount = 0;
+			bool m_StaticDirty = false;
 		};
 	}
 }
@@ -12,6 +12,7 @@
 #include "Graphics/API/Shader.h"
 
 #include "Graphics/Model.h"
+#include "Graphics/Terrain/ChunkedTerrain.h"
 #include "Graphics/Camera/Camera.h"
 #include "Graphics/Light.h"
 #include "Maths/Transform.h"
@@ -19,7 +20,9 @@
 #include "Scene/Scene.h"
 #include "Maths/Maths.h"
 #include "RenderCommand.h"
+#include "ParallelCommandRecorder.h"
 #include "Core/Application.h"
+#include "Utilities/CombineHash.h"
 
 #include <imgui/imgui.h>
 
@@ -38,6 +41,13 @@ namespace Lumos
 			VSSystemUniformIndex_Size
 		};
 
+		static void HashMatrix(size_t& hash, const Maths::Matrix4& matrix)
+		{
+			const float* data = matrix.Data();
+			for(uint32_t i = 0; i < 16; i++)
+				HashCombine(hash, data[i]);
+		}
+
 		ShadowRenderer::ShadowRenderer(TextureDepthArray* texture, uint32_t shadowMapSize, uint32_t numMaps)
 			: m_ShadowTex(nullptr)
 			, m_ShadowMapNum(numMaps)
@@ -59,6 +69,10 @@ namespace Lumos
             m_CascadeTransitionFade = 1.5f;
             m_InitialBias = 0.0023f;
 
+			//Far cascades change the least, update them on alternate frames by default
+			for(uint32_t i = 0; i < SHADOWMAP_MAX; i++)
+				m_CascadeUpdateInterval[i] = i < 2 ? 1 : 2;
+
 			ShadowRenderer::Init();
 		}
 
@@ -68,9 +82,6 @@ namespace Lumos
 
 			delete[] m_VSSystemUniformBuffer;
             
-            for(auto& pc: m_PushConstants)
-                delete[] pc.data;
-            
             m_PushConstants.clear();
 
 			delete m_UniformBuffer;
@@ -85,9 +96,10 @@ namespace Lumos
 			memset(m_VSSystemUniformBuffer, 0, m_VSSystemUniformBufferSize);
 			m_VSSystemUniformBufferOffsets.resize(VSSystemUniformIndex_Size);
 
+			//Transform followed by the cascade. Data points at each recording chunk's own copy
 			auto pushConstant = Graphics::PushConstant();
             pushConstant.size = sizeof(int32_t) + sizeof(Lumos::Maths::Matrix4);
-            pushConstant.data = new uint8_t[sizeof(int32_t) + sizeof(Lumos::Maths::Matrix4)];
+            pushConstant.data = nullptr;
             pushConstant.shaderStage = ShaderType::VERTEX;
             
             m_PushConstants.push_back(pushConstant);
@@ -110,6 +122,8 @@ namespace Lumos
 			m_CommandBuffer = Graphics::CommandBuffer::Create();
 			m_CommandBuffer->Init(true);
 
+			m_Recorder = CreateUniqueRef<ParallelCommandRecorder>();
+
 			CreateGraphicsPipeline();
 			CreateUniformBuffer();
 			CreateFramebuffers();
@@ -172,24 +186,43 @@ namespace Lumos
             }
             
 			UpdateCascades(scene, overrideCamera, overrideCameraTransform, light);
-                      
-            m_CascadeCommandQueue[0].clear();
-            m_CascadeCommandQueue[1].clear();
-            m_CascadeCommandQueue[2].clear();
-            m_CascadeCommandQueue[3].clear();
-            
+
             auto group = registry.group<Model>(entt::get<Maths::Transform>);
+            auto terrainView = registry.view<ChunkedTerrain, Maths::Transform>();
+            Maths::Vector3 cameraPosition = m_CameraTransform->GetWorldPosition();
+            const Maths::Matrix4& cameraProjection = m_Camera->GetProjectionMatrix();
+
+            //Cheap pass over all casters, cascades are only re-culled when something changed
+            size_t sceneHash = m_CacheShadowCasters ? HashShadowCasters(scene) : 0;
+            m_FrameIndex++;
 
             for(uint32_t i = 0; i < m_ShadowMapNum; ++i)
             {
+                auto& cache = m_CascadeCache[i];
+                m_CascadeDirty[i] = false;
+
+                if(m_CacheShadowCasters && cache.Valid)
+                {
+                    uint32_t interval = uint32_t(Maths::Max(m_CascadeUpdateInterval[i], 1));
+                    if((m_FrameIndex + i) % interval != 0)
+                    {
+                        //Not scheduled this frame, keep sampling the map with the matrix it was rendered with
+                        m_ShadowProjView[i] = cache.ProjView;
+                        continue;
+                    }
+
+                    if(cache.ProjView == m_ShadowProjView[i] && cache.SceneHash == sceneHash)
+                        continue;
+                }
+
                 m_Layer = i;
+                m_CascadeCommandQueue[i].clear();
 
                 Maths::Frustum f;
                 f.Define(m_ShadowProjView[i]);
-                
-                if(group.empty())
-                    continue;
-                
+
+                size_t casterHash = 0;
+
                 for(auto entity : group)
                 {
                     const auto& [model, trans] = group.get<Model, Maths::Transform>(entity);
@@ -197,7 +230,8 @@ namespace Lumos
                                    
                    for(auto mesh : meshes)
                    {
-                        if(mesh->GetActive())
+                        //Skinned meshes need the animated shadow pipeline, not supported yet
+                        if(mesh->GetActive() && !mesh->IsSkinned())
                         {
                             auto& worldTransform = trans.GetWorldMatrix();
 
@@ -208,10 +242,41 @@ namespace Lumos
                             if(inside == Maths::Intersection::OUTSIDE)
                                 continue;
 
-                            SubmitMesh(mesh.get(), nullptr, worldTransform, Maths::Matrix4(), i);
+                            //Lod is picked from the main camera's view, shadows tolerate coarser geometry
+                            uint32_t lod = mesh->SelectLOD(Mesh::GetProjectedScreenSize(bbCopy, cameraPosition, cameraProjection), uint32_t(Maths::Max(m_LODBias, 0)));
+
+                            SubmitMesh(mesh.get(), nullptr, worldTransform, Maths::Matrix4(), i, lod);
+                            HashCombine(casterHash, mesh.get(), entity, lod);
+                            HashMatrix(casterHash, worldTransform);
                         }
                    }
                 }
+
+                for(auto entity : terrainView)
+                {
+                    const auto& [terrain, trans] = terrainView.get<ChunkedTerrain, Maths::Transform>(entity);
+                    auto& worldTransform = trans.GetWorldMatrix();
+
+                    for(auto mesh : terrain.GetVisibleChunks())
+                    {
+                        auto bbCopy = mesh->GetBoundingBox()->Transformed(worldTransform);
+                        if(f.IsInsideFast(bbCopy) == Maths::Intersection::OUTSIDE)
+                            continue;
+
+                        SubmitMesh(mesh, nullptr, worldTransform, Maths::Matrix4(), i, 0);
+                        HashCombine(casterHash, mesh, entity);
+                        HashMatrix(casterHash, worldTransform);
+                    }
+                }
+
+                //The casters inside the cascade and the cascade itself didn't change, the cached map is still valid
+                bool cached = m_CacheShadowCasters && cache.Valid && cache.ProjView == m_ShadowProjView[i] && cache.CasterHash == casterHash;
+                m_CascadeDirty[i] = !cached;
+
+                cache.ProjView = m_ShadowProjView[i];
+                cache.SceneHash = sceneHash;
+                cache.CasterHash = casterHash;
+                cache.Valid = true;
             }
 
             
@@ -232,41 +297,44 @@ namespace Lumos
 		void ShadowRenderer::Present()
 		{
 			LUMOS_PROFILE_FUNCTION();
-			int index = 0;
-
 			m_RenderPass->BeginRenderpass(m_CommandBuffer, Maths::Vector4(0.0f), m_ShadowFramebuffer[m_Layer].get(), Graphics::INLINE, m_ShadowMapSize, m_ShadowMapSize, false);
+			RecordCascade(m_CommandBuffer, m_Layer, 0, uint32_t(m_CascadeCommandQueue[m_Layer].size()));
+			m_RenderPass->EndRenderpass(m_CommandBuffer, false);
+		}
+
+		void ShadowRenderer::RecordCascade(CommandBuffer* commandBuffer, uint32_t cascade, uint32_t begin, uint32_t end)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			//Per call so chunks of the same cascade can record on different workers
+			std::vector<DescriptorSet*> descriptorSets = { m_Pipeline->GetDescriptorSet() };
+			uint8_t pushConstantData[sizeof(Maths::Matrix4) + sizeof(uint32_t)];
+			std::vector<PushConstant> pushConstants = m_PushConstants;
+			pushConstants[0].data = pushConstantData;
 
-			m_Pipeline->Bind(m_CommandBuffer);
+			m_Pipeline->Bind(commandBuffer);
 
-			for(auto& command : m_CascadeCommandQueue[m_Layer])
+			for(uint32_t i = begin; i < end; i++)
 			{
-				Engine::Get().Statistics().NumShadowObjects++;
-				
+				auto& command = m_CascadeCommandQueue[cascade][i];
 				Mesh* mesh = command.mesh;
 
-                m_CurrentDescriptorSets[0] = m_Pipeline->GetDescriptorSet();
+				auto& indexBuffer = mesh->GetIndexBuffer(command.lod);
 
-				mesh->GetVertexBuffer()->Bind(m_CommandBuffer, m_Pipeline.get());
-				mesh->GetIndexBuffer()->Bind(m_CommandBuffer);
-                
-                uint32_t layer = static_cast<uint32_t>(m_Layer);
-                auto trans = command.transform;
-                memcpy(m_PushConstants[0].data, &trans, sizeof(Maths::Matrix4));
-                memcpy(m_PushConstants[0].data + sizeof(Maths::Matrix4), &layer, sizeof(uint32_t));
+				mesh->GetVertexBuffer()->Bind(commandBuffer, m_Pipeline.get());
+				indexBuffer->Bind(commandBuffer);
 
-                m_CurrentDescriptorSets[0]->SetPushConstants(m_PushConstants);
-                
-				Renderer::BindDescriptorSets(m_Pipeline.get(), m_CommandBuffer, 0, m_CurrentDescriptorSets);
-				Renderer::DrawIndexed(m_CommandBuffer, DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount());
+				memcpy(pushConstantData, &command.transform, sizeof(Maths::Matrix4));
+				memcpy(pushConstantData + sizeof(Maths::Matrix4), &cascade, sizeof(uint32_t));
 
-				mesh->GetVertexBuffer()->Unbind();
-				mesh->GetIndexBuffer()->Unbind();
+				Renderer::BindDescriptorSets(m_Pipeline.get(), commandBuffer, 0, descriptorSets);
+				Renderer::PushConstants(m_Pipeline.get(), commandBuffer, pushConstants);
+				Renderer::DrawIndexed(commandBuffer, DrawType::TRIANGLE, indexBuffer->GetCount());
 
-				index++;
+				mesh->GetVertexBuffer()->Unbind();
+				indexBuffer->Unbind();
 			}
 
-			m_RenderPass->EndRenderpass(m_CommandBuffer, false);
-            //m_CommandBuffer->Execute(true);
+			Engine::Get().Statistics().NumShadowObjects += end - begin;
 		}
 
 		void ShadowRenderer::SetShadowMapNum(uint32_t num)
@@ -276,6 +344,7 @@ namespace Lumos
 			{
 				m_ShadowMapNum = num;
 				m_ShadowMapsInvalidated = true;
+				InvalidateCascadeCache();
 			}
 		}
 
@@ -285,9 +354,54 @@ namespace Lumos
 			if(!m_ShadowMapsInvalidated)
 				m_ShadowMapsInvalidated = (size != m_ShadowMapSize);
 
+			if(size != m_ShadowMapSize)
+				InvalidateCascadeCache();
+
 			m_ShadowMapSize = size;
 		}
 
+		void ShadowRenderer::InvalidateCascadeCache()
+		{
+			for(auto& cache : m_CascadeCache)
+				cache.Valid = false;
+		}
+
+		void ShadowRenderer::SetCascadeUpdateInterval(uint32_t cascade, uint32_t interval)
+		{
+			if(cascade < SHADOWMAP_MAX)
+				m_CascadeUpdateInterval[cascade] = int(Maths::Max(interval, 1u));
+		}
+
+		size_t ShadowRenderer::HashShadowCasters(Scene* scene) const
+		{
+			LUMOS_PROFILE_FUNCTION();
+			size_t hash = 0;
+
+			auto group = scene->GetRegistry().group<Model>(entt::get<Maths::Transform>);
+
+			for(auto entity : group)
+			{
+				const auto& [model, trans] = group.get<Model, Maths::Transform>(entity);
+				HashCombine(hash, entity, model.GetMeshes().size());
+				HashMatrix(hash, trans.GetWorldMatrix());
+
+				for(auto& mesh : model.GetMeshes())
+					HashCombine(hash, mesh.get(), mesh->GetActive());
+			}
+
+			auto terrainView = scene->GetRegistry().view<ChunkedTerrain, Maths::Transform>();
+			for(auto entity : terrainView)
+			{
+				const auto& [terrain, trans] = terrainView.get<ChunkedTerrain, Maths::Transform>(entity);
+				HashMatrix(hash, trans.GetWorldMatrix());
+
+				for(auto mesh : terrain.GetVisibleChunks())
+					HashCombine(hash, mesh);
+			}
+
+			return hash;
+		}
+
 		void ShadowRenderer::RenderScene()
 		{
 			LUMOS_PROFILE_FUNCTION();
@@ -297,13 +411,58 @@ namespace Lumos
 
 			memcpy(m_VSSystemUniformBuffer + m_VSSystemUniformBufferOffsets[VSSystemUniformIndex_ProjectionViewMatrix], m_ShadowProjView, sizeof(Maths::Matrix4) * SHADOWMAP_MAX);
 
+			m_CascadesRendered = 0;
+			for(uint32_t i = 0; i < m_ShadowMapNum; ++i)
+			{
+				if(m_CascadeDirty[i])
+					m_CascadesRendered++;
+			}
+
+			if(m_CascadesRendered == 0)
+				return;
+
 			Begin();
+			SetSystemUniforms(m_Shader.get());
 
-			for(uint32_t i = 0; i < m_ShadowMapNum; ++i)
+			if(m_ParallelRecording && ParallelCommandRecorder::IsSupported())
 			{
-                m_Layer = i;
-                SetSystemUniforms(m_Shader.get());
-				Present();
+				m_Recorder->Clear();
+
+				uint32_t passes[SHADOWMAP_MAX];
+				for(uint32_t i = 0; i < m_ShadowMapNum; ++i)
+				{
+					if(!m_CascadeDirty[i])
+						continue;
+
+					passes[i] = m_Recorder->AddPass(m_RenderPass.get(), m_ShadowFramebuffer[i].get(), m_ShadowMapSize, m_ShadowMapSize);
+					m_Recorder->Add(passes[i], uint32_t(m_CascadeCommandQueue[i].size()), 64, [this, i](CommandBuffer* commandBuffer, uint32_t begin, uint32_t end)
+					{
+						RecordCascade(commandBuffer, i, begin, end);
+					});
+				}
+
+				m_Recorder->Record();
+
+				for(uint32_t i = 0; i < m_ShadowMapNum; ++i)
+				{
+					if(!m_CascadeDirty[i])
+						continue;
+
+					m_RenderPass->BeginRenderpass(m_CommandBuffer, Maths::Vector4(0.0f), m_ShadowFramebuffer[i].get(), Graphics::SECONDARY, m_ShadowMapSize, m_ShadowMapSize, false);
+					m_Recorder->Execute(passes[i], m_CommandBuffer);
+					m_RenderPass->EndRenderpass(m_CommandBuffer, false);
+				}
+			}
+			else
+			{
+				for(uint32_t i = 0; i < m_ShadowMapNum; ++i)
+				{
+					if(!m_CascadeDirty[i])
+						continue;
+
+					m_Layer = i;
+					Present();
+				}
 			}
 			End();
 		}
@@ -396,6 +555,14 @@ namespace Lumos
 					Maths::Vector3 lightDir = -light->Direction.ToVector3();
 					lightDir.Normalize();
 					Maths::Matrix4 lightViewMatrix = Maths::Quaternion::LookAt(frustumCenter - lightDir * -minExtents.z, frustumCenter).RotationMatrix4();
+
+					//Snap the centre to whole texels in light space so the cascade matrix only changes when it moves a texel.
+					//Lets the cached shadow maps be reused while the camera moves slowly.
+					float texelSize = 2.0f * radius / float(m_ShadowMapSize);
+					Maths::Vector3 lightSpaceCenter = lightViewMatrix.Inverse() * frustumCenter;
+					lightSpaceCenter = Maths::VectorRound(lightSpaceCenter / texelSize) * texelSize;
+					frustumCenter = lightViewMatrix * lightSpaceCenter;
+
 					lightViewMatrix.SetTranslation(frustumCenter);
 
 					Maths::Matrix4 lightOrthoMatrix = Maths::Matrix4::Orthographic(minExtents.x, maxExtents.x, minExtents.y, maxExtents.y, -(maxExtents.z - minExtents.z), maxExtents.z - minExtents.z);
@@ -541,13 +708,14 @@ namespace Lumos
 			Submit(command);
 		}
     
-        void ShadowRenderer::SubmitMesh(Mesh* mesh, Material* material, const Maths::Matrix4& transform, const Maths::Matrix4& textureMatrix, uint32_t cascadeIndex)
+        void ShadowRenderer::SubmitMesh(Mesh* mesh, Material* material, const Maths::Matrix4& transform, const Maths::Matrix4& textureMatrix, uint32_t cascadeIndex, uint32_t lod)
         {
             LUMOS_PROFILE_FUNCTION();
             RenderCommand command;
             command.mesh = mesh;
             command.transform = transform;
             command.material = material;
+            command.lod = lod;
             Submit(command, cascadeIndex);
         }
 
@@ -586,6 +754,31 @@ namespace Lumos
             ImGui::DragFloat("Cascade Split Lambda", &m_CascadeSplitLambda, 0.005f, 0.0f, 3.0f);
             ImGui::DragFloat("Scene Radius Multiplier", &m_SceneRadiusMultiplier, 0.005f, 0.0f, 5.0f);
 
+            if(ImGui::Checkbox("Cache Shadow Casters", &m_CacheShadowCasters))
+                InvalidateCascadeCache();
+
+            if(ImGui::DragInt("LOD Bias", &m_LODBias, 0.1f, 0, int(Mesh::MaxLODCount) - 1))
+                InvalidateCascadeCache();
+
+            if(ImGui::TreeNode("Cascade Update Interval"))
+            {
+                for(uint32_t i = 0; i < m_ShadowMapNum; i++)
+                {
+                    std::string label = "Cascade " + std::to_string(i);
+                    if(ImGui::DragInt(label.c_str(), &m_CascadeUpdateInterval[i], 0.1f, 1, 16))
+                        m_CascadeUpdateInterval[i] = Maths::Max(m_CascadeUpdateInterval[i], 1);
+                }
+                ImGui::TreePop();
+            }
+
+            ImGui::Text("Cascades Rendered : %u / %u", m_CascadesRendered, m_ShadowMapNum);
+
+			if(ParallelCommandRecorder::IsSupported())
+			{
+				ImGui::Checkbox("Parallel Recording", &m_ParallelRecording);
+				ImGui::Text("Recorded Chunks : %u", m_ParallelRecording ? m_Recorder->GetChunkCount() : 0u);
+			}
+
 		}
 	}
 }
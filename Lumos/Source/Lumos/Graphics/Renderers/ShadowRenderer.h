@@ -25,6 +25,7 @@ namespace Lumos
 		class UniformBuffer;
 		class CommandBuffer;
 		class RenderPass;
+		class ParallelCommandRecorder;
 
 		typedef std::vector<RenderCommand> CommandQueue;
 
@@ -47,7 +48,7 @@ namespace Lumos
 			void Begin() override;
 			void Submit(const RenderCommand& command) override;
             void Submit(const RenderCommand& command, uint32_t cascadeIndex);
-            void SubmitMesh(Mesh* mesh, Material* material, const Maths::Matrix4& transform, const Maths::Matrix4& textureMatrix, uint32_t cascadeIndex);
+            void SubmitMesh(Mesh* mesh, Material* material, const Maths::Matrix4& transform, const Maths::Matrix4& textureMatrix, uint32_t cascadeIndex, uint32_t lod = 0);
             
 			void SubmitMesh(Mesh* mesh, Material* material, const Maths::Matrix4& transform, const Maths::Matrix4& textureMatrix) override;
 			void EndScene() override;
@@ -76,8 +77,15 @@ namespace Lumos
 			inline void SetShadowInvalid()
 			{
 				m_ShadowMapsInvalidated = true;
+				InvalidateCascadeCache();
 			}
 
+			//Forces every cascade to be culled and redrawn next frame
+			void InvalidateCascadeCache();
+
+			//Cascade is only considered for an update every interval frames
+			void SetCascadeUpdateInterval(uint32_t cascade, uint32_t interval);
+
 			inline TextureDepthArray* GetTexture() const
 			{
 				return m_ShadowTex;
@@ -110,6 +118,7 @@ namespace Lumos
 
 		protected:
 			void SetSystemUniforms(Shader* shader);
+			void RecordCascade(CommandBuffer* commandBuffer, uint32_t cascade, uint32_t begin, uint32_t end);
 
 			TextureDepthArray* m_ShadowTex;
 			uint32_t m_ShadowMapNum;
@@ -136,6 +145,28 @@ namespace Lumos
             float m_InitialBias;
             
             std::vector<Graphics::PushConstant> m_PushConstants;
+
+			struct CascadeCache
+			{
+				Maths::Matrix4 ProjView;
+				size_t SceneHash = 0;
+				size_t CasterHash = 0;
+				bool Valid = false;
+			};
+
+			size_t HashShadowCasters(Scene* scene) const;
+
+			CascadeCache m_CascadeCache[SHADOWMAP_MAX];
+			bool m_CascadeDirty[SHADOWMAP_MAX]{};
+			int m_CascadeUpdateInterval[SHADOWMAP_MAX];
+			uint32_t m_FrameIndex = 0;
+			uint32_t m_CascadesRendered = 0;
+			bool m_CacheShadowCasters = true;
+			int m_LODBias = 1;
+
+			//Dirty cascades are recorded on workers at the same time, each split into chunks
+			UniqueRef<ParallelCommandRecorder> m_Recorder;
+			bool m_ParallelRecording = true;
 		};
 	}
 }
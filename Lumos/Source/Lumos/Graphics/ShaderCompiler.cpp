@@ -0,0 +1,297 @@
+#include "Precompiled.h"
+#include "ShaderCompiler.h"
+#include "Core/StringUtilities.h"
+#include "Utilities/CombineHash.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef LUMOS_PLATFORM_WINDOWS
+#define SHADER_COMPILER_NAME "glslangValidator.exe"
+#define SHADER_COMPILER_SDK_PATH "/Bin/"
+#define NULL_OUTPUT " > NUL 2>&1"
+#else
+#define SHADER_COMPILER_NAME "glslangValidator"
+#define SHADER_COMPILER_SDK_PATH "/bin/"
+#define NULL_OUTPUT " > /dev/null 2>&1"
+#endif
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		static int RunCommand(std::string command)
+		{
+#ifdef LUMOS_PLATFORM_IOS
+			return -1;
+#else
+#ifdef LUMOS_PLATFORM_WINDOWS
+			//cmd strips the outer quotes, keeping the ones around the paths
+			command = "\"" + command + "\"";
+#endif
+			return std::system(command.c_str());
+#endif
+		}
+
+		static bool ReadText(const std::string& path, std::string& text)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if(!file)
+				return false;
+
+			std::stringstream stream;
+			stream << file.rdbuf();
+			text = stream.str();
+			return true;
+		}
+
+		static std::string NormalisePath(const std::string& path)
+		{
+			return std::filesystem::path(path).lexically_normal().generic_string();
+		}
+
+		ShaderCompiler::ShaderCompiler(const std::string& cachePath, uint32_t threadCount)
+			: m_CachePath(cachePath)
+		{
+			std::error_code error;
+			std::filesystem::create_directories(m_CachePath, error);
+
+			if(threadCount == 0)
+				threadCount = std::min(4u, std::max(1u, std::thread::hardware_concurrency() / 2));
+
+			for(uint32_t i = 0; i < threadCount; i++)
+				m_Threads.emplace_back(&ShaderCompiler::Run, this);
+		}
+
+		ShaderCompiler::~ShaderCompiler()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Quit = true;
+			}
+			m_Condition.notify_all();
+
+			for(auto& thread : m_Threads)
+			{
+				if(thread.joinable())
+					thread.join();
+			}
+		}
+
+		void ShaderCompiler::Compile(const std::string& sourcePath)
+		{
+			Enqueue(NormalisePath(sourcePath));
+		}
+
+		bool ShaderCompiler::IsStageSource(const std::string& path)
+		{
+			const std::string extension = StringUtilities::GetFilePathExtension(path);
+			return extension == "vert" || extension == "frag" || extension == "comp" || extension == "geom" || extension == "tesc" || extension == "tese";
+		}
+
+		std::string ShaderCompiler::GetOutputPath(const std::string& sourcePath)
+		{
+			const std::filesystem::path path(sourcePath);
+			return (path.parent_path() / "CompiledSPV" / (path.filename().string() + ".spv")).generic_string();
+		}
+
+		void ShaderCompiler::Enqueue(const std::string& sourcePath)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if(m_Active.count(sourcePath))
+				{
+					m_Rerun.insert(sourcePath);
+					return;
+				}
+
+				if(!m_Queued.insert(sourcePath).second)
+					return;
+
+				m_Queue.push_back(sourcePath);
+			}
+			m_Condition.notify_one();
+		}
+
+		void ShaderCompiler::Run()
+		{
+			while(true)
+			{
+				std::string sourcePath;
+				{
+					std::unique_lock<std::mutex> lock(m_Mutex);
+					m_Condition.wait(lock, [this] { return m_Quit || !m_Queue.empty(); });
+					if(m_Quit)
+						return;
+
+					sourcePath = std::move(m_Queue.front());
+					m_Queue.pop_front();
+					m_Queued.erase(sourcePath);
+					m_Active.insert(sourcePath);
+				}
+
+				if(IsStageSource(sourcePath))
+					CompileStage(sourcePath);
+				else
+					CompileDependents(sourcePath);
+
+				bool rerun = false;
+				{
+					std::lock_guard<std::mutex> lock(m_Mutex);
+					m_Active.erase(sourcePath);
+					rerun = m_Rerun.erase(sourcePath) > 0;
+				}
+
+				if(rerun)
+					Enqueue(sourcePath);
+			}
+		}
+
+		bool ShaderCompiler::CompileStage(const std::string& sourcePath)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			std::vector<std::string> visited;
+			const uint64_t hash = HashSource(sourcePath, visited);
+			if(hash == 0)
+			{
+				LUMOS_LOG_ERROR("Could not read shader source {0}", sourcePath);
+				return false;
+			}
+
+			char name[32];
+			snprintf(name, sizeof(name), "%016llx.spv", (unsigned long long)hash);
+			const std::string cacheFile = m_CachePath + "/" + name;
+			const std::string outputPath = GetOutputPath(sourcePath);
+
+			std::error_code error;
+			if(!std::filesystem::exists(cacheFile, error))
+			{
+				if(!FindCompiler())
+					return false;
+
+				//Written under another name first so a failed or interrupted build never leaves a cache entry
+				const std::string tempFile = cacheFile + ".tmp";
+				const std::string logFile = cacheFile + ".log";
+				const std::string command = "\"" + m_CompilerPath + "\" -V \"" + sourcePath + "\" -o \"" + tempFile + "\" > \"" + logFile + "\" 2>&1";
+
+				const int result = RunCommand(command);
+
+				std::string log;
+				ReadText(logFile, log);
+				std::filesystem::remove(logFile, error);
+
+				if(result != 0)
+				{
+					LUMOS_LOG_ERROR("Failed to compile {0}\n{1}", sourcePath, log);
+					std::filesystem::remove(tempFile, error);
+					return false;
+				}
+
+				std::filesystem::rename(tempFile, cacheFile, error);
+				if(error)
+				{
+					LUMOS_LOG_ERROR("Could not write shader cache {0} : {1}", cacheFile, error.message());
+					return false;
+				}
+			}
+
+			std::filesystem::create_directories(std::filesystem::path(outputPath).parent_path(), error);
+			std::filesystem::copy_file(cacheFile, outputPath, std::filesystem::copy_options::overwrite_existing, error);
+			if(error)
+			{
+				LUMOS_LOG_ERROR("Could not write {0} : {1}", outputPath, error.message());
+				return false;
+			}
+
+			LUMOS_LOG_INFO("Compiled shader stage {0}", StringUtilities::GetFileName(sourcePath));
+			return true;
+		}
+
+		void ShaderCompiler::CompileDependents(const std::string& includePath)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			std::error_code error;
+			for(auto& entry : std::filesystem::directory_iterator(std::filesystem::path(includePath).parent_path(), error))
+			{
+				const std::string path = NormalisePath(entry.path().generic_string());
+				if(!entry.is_regular_file() || !IsStageSource(path))
+					continue;
+
+				std::vector<std::string> visited;
+				HashSource(path, visited);
+				if(std::find(visited.begin(), visited.end(), includePath) != visited.end())
+					Enqueue(path);
+			}
+		}
+
+		bool ShaderCompiler::FindCompiler()
+		{
+			std::call_once(m_CompilerSearched, [this]
+			{
+				if(const char* sdk = std::getenv("VULKAN_SDK"))
+				{
+					const std::string path = std::string(sdk) + SHADER_COMPILER_SDK_PATH SHADER_COMPILER_NAME;
+					std::error_code error;
+					if(std::filesystem::exists(path, error))
+					{
+						m_CompilerPath = path;
+						return;
+					}
+				}
+
+				if(RunCommand(SHADER_COMPILER_NAME " --version" NULL_OUTPUT) == 0)
+					m_CompilerPath = SHADER_COMPILER_NAME;
+				else
+					LUMOS_LOG_WARN("Could not find " SHADER_COMPILER_NAME ", set VULKAN_SDK or add it to the path to rebuild shaders from source");
+			});
+
+			return !m_CompilerPath.empty();
+		}
+
+		uint64_t ShaderCompiler::HashSource(const std::string& path, std::vector<std::string>& visited)
+		{
+			visited.push_back(path);
+
+			std::string source;
+			if(!ReadText(path, source))
+				return 0;
+
+			//The extension picks the stage, so identical sources for different stages are kept apart
+			size_t hash = std::hash<std::string>()(source);
+			HashCombine(hash, StringUtilities::GetFilePathExtension(path));
+
+			for(auto& include : GetIncludes(path, source))
+			{
+				if(std::find(visited.begin(), visited.end(), include) == visited.end())
+					HashCombine(hash, HashSource(include, visited));
+			}
+
+			return hash == 0 ? 1 : uint64_t(hash);
+		}
+
+		std::vector<std::string> ShaderCompiler::GetIncludes(const std::string& path, const std::string& source)
+		{
+			std::vector<std::string> includes;
+			const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+
+			std::istringstream stream(source);
+			std::string line;
+			while(std::getline(stream, line))
+			{
+				const size_t directive = line.find("#include");
+				if(directive == std::string::npos || line.find_first_not_of(" \t") != directive)
+					continue;
+
+				const size_t begin = line.find_first_of("\"<", directive);
+				const size_t end = begin == std::string::npos ? std::string::npos : line.find_first_of("\">", begin + 1);
+				if(end == std::string::npos)
+					continue;
+
+				includes.push_back(NormalisePath((directory / line.substr(begin + 1, end - begin - 1)).generic_string()));
+			}
+
+			return includes;
+		}
+	}
+}
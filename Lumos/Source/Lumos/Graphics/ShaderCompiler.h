@@ -0,0 +1,57 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_set>
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		//Compiles GLSL stages to the SPIR-V the .shader files reference, on worker threads with glslangValidator.
+		//Outputs are cached on disk by a hash of the stage source and everything it includes, so a stage that is
+		//unchanged, or changed back, is copied from the cache instead of being compiled again.
+		//Writing the new SPIR-V is the only result, the asset database sees it change and the shader is reloaded from there
+		class LUMOS_EXPORT ShaderCompiler
+		{
+		public:
+			ShaderCompiler(const std::string& cachePath, uint32_t threadCount = 0);
+			~ShaderCompiler();
+
+			//Takes a stage source, or a file stages include, in which case every stage next to it that includes it is rebuilt
+			void Compile(const std::string& sourcePath);
+
+			static bool IsStageSource(const std::string& path);
+
+			//Where the .shader files expect a stage's SPIR-V, CompiledSPV/<name>.spv next to the source
+			static std::string GetOutputPath(const std::string& sourcePath);
+
+		private:
+			void Run();
+			void Enqueue(const std::string& sourcePath);
+			bool CompileStage(const std::string& sourcePath);
+			void CompileDependents(const std::string& includePath);
+			bool FindCompiler();
+
+			static uint64_t HashSource(const std::string& path, std::vector<std::string>& visited);
+			static std::vector<std::string> GetIncludes(const std::string& path, const std::string& source);
+
+			std::string m_CachePath;
+			std::string m_CompilerPath;
+			std::once_flag m_CompilerSearched;
+
+			std::mutex m_Mutex;
+			std::condition_variable m_Condition;
+			std::deque<std::string> m_Queue;
+			std::unordered_set<std::string> m_Queued;
+			//Being compiled, and changed again since it started so it has to run once more
+			std::unordered_set<std::string> m_Active;
+			std::unordered_set<std::string> m_Rerun;
+			bool m_Quit = false;
+
+			std::vector<std::thread> m_Threads;
+		};
+	}
+}
@@ -30,9 +30,13 @@ namespace Lumos
             void SetTexture(const Ref<Texture2D>& texture) { m_Texture = texture; }
         
             void SetTextureFromFile(const std::string& filePath);
+
+			//Static sprites are baked into retained batches by Renderer2D and only rebuilt when they change
+			void SetStatic(bool isStatic) { m_Static = isStatic; }
+			bool IsStatic() const { return m_Static; }
 		
 			template<typename Archive>
-			void save(Archive& archive) const
+			void save(Archive& archive, const std::uint32_t version) const
 			{
                 std::string newPath = "";
                 if(m_Texture)
@@ -44,10 +48,12 @@ namespace Lumos
 						cereal::make_nvp("Position", m_Position),
 						cereal::make_nvp("Scale", m_Scale),
 						cereal::make_nvp("Colour", m_Colour));
+
+				archive(cereal::make_nvp("Static", m_Static));
 			}
 
 			template<typename Archive>
-			void load(Archive& archive)
+			void load(Archive& archive, const std::uint32_t version)
 			{
 				std::string textureFilePath;
 				archive(cereal::make_nvp("TexturePath", textureFilePath),
@@ -55,9 +61,17 @@ namespace Lumos
 					cereal::make_nvp("Scale", m_Scale),
 					cereal::make_nvp("Colour", m_Colour));
 
+				if(version > 0)
+					archive(cereal::make_nvp("Static", m_Static));
+
                 if(!textureFilePath.empty())
                     m_Texture = Ref<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile("sprite", textureFilePath));
 			}
+
+		protected:
+			bool m_Static = false;
 		};
 	}
 }
+
+CEREAL_CLASS_VERSION(Lumos::Graphics::Sprite, 1);
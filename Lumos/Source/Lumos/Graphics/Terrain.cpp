@@ -1,6 +1,7 @@
 #include "Precompiled.h"
 #include "Terrain.h"
 #include "Maths/BoundingBox.h"
+#include "Core/JobSystem.h"
 #include <stb/stb_perlin.h>
 
 namespace Lumos
@@ -30,8 +31,10 @@ namespace Lumos
         uint32_t* indices = new uint32_t[numIndices];
         m_BoundingBox = CreateRef<Maths::BoundingBox>();
 
-        for (int x = 0; x < width; ++x)
+        //Rows are independent, the noise is the expensive part
+        System::JobSystem::Dispatch(uint32_t(width), 8, [&](JobDispatchArgs args)
         {
+            int x = int(args.jobIndex);
             for (int z = 0; z < height; ++z)
             {
                 int offset = (x * width) + z;
@@ -46,7 +49,8 @@ namespace Lumos
 
                 texCoords[offset] = Maths::Vector2(x * texRandX, z * texRandZ);
             }
-        }
+        });
+        System::JobSystem::Wait();
 
 		int indicesCount = 0;
 
@@ -3,6 +3,7 @@
 
 namespace Lumos
 {
+	//Single mesh heightmap built up front, Graphics::ChunkedTerrain streams large terrains in chunks
 	class LUMOS_EXPORT Terrain : public Graphics::Mesh
 	{
 	public:
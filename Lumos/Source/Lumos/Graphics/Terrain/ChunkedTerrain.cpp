@@ -0,0 +1,307 @@
+#include "Precompiled.h"
+#include "ChunkedTerrain.h"
+#include <stb/stb_perlin.h>
+
+namespace Lumos::Graphics
+{
+	//Walks the edge vertices of a chunk (index x * side + z) in a closed loop with the outside on the left,
+	//skirt quads built along it face outwards
+	static void GetPerimeter(uint32_t resolution, std::vector<uint32_t>& perimeter)
+	{
+		const uint32_t side = resolution + 1;
+		perimeter.clear();
+		perimeter.reserve(resolution * 4);
+
+		for(uint32_t x = resolution; x > 0; x--)
+			perimeter.push_back(x * side);
+		for(uint32_t z = 0; z < resolution; z++)
+			perimeter.push_back(z);
+		for(uint32_t x = 0; x < resolution; x++)
+			perimeter.push_back(x * side + resolution);
+		for(uint32_t z = resolution; z > 0; z--)
+			perimeter.push_back(resolution * side + z);
+	}
+
+	float ChunkedTerrain::SampleHeight(float x, float z) const
+	{
+		//Same two octaves as the Terrain primitive
+		const float layer1 = 25.0f;
+		const float layer2 = 180.0f;
+
+		const float xx = x + m_NoiseOffset.x;
+		const float zz = z + m_NoiseOffset.y;
+		const float noise = (((stb_perlin_noise3(xx / layer1, zz / layer1, 0, 0, 0, 0) + 1.0f) / 2.0f) +
+			((stb_perlin_noise3(xx / layer2, zz / layer2, 0, 0, 0, 0) + 1.0f) / 2.0f)) / 2.0f;
+
+		return noise * noise * noise * m_HeightScale;
+	}
+
+	void ChunkedTerrain::Update(const Maths::Vector3& cameraPosition)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_FrameIndex++;
+		m_VisibleChunks.clear();
+		m_Requests.clear();
+
+		if(!m_IndexBuffer)
+			CreateIndexBuffer();
+
+		const uint32_t rootLevel = m_LODLevels - 1;
+		const float rootSize = GetNodeSize(rootLevel);
+		const int32_t minX = int32_t(Maths::Floor((cameraPosition.x - m_ViewDistance) / rootSize));
+		const int32_t maxX = int32_t(Maths::Floor((cameraPosition.x + m_ViewDistance) / rootSize));
+		const int32_t minZ = int32_t(Maths::Floor((cameraPosition.z - m_ViewDistance) / rootSize));
+		const int32_t maxZ = int32_t(Maths::Floor((cameraPosition.z + m_ViewDistance) / rootSize));
+
+		for(int32_t x = minX; x <= maxX; x++)
+		{
+			for(int32_t z = minZ; z <= maxZ; z++)
+			{
+				TerrainChunkKey key = { x, z, rootLevel };
+				if(GetNodeDistance(key, cameraPosition) <= m_ViewDistance)
+					SelectNode(key, cameraPosition);
+			}
+		}
+
+		std::sort(m_Requests.begin(), m_Requests.end(), [](const ChunkRequest& a, const ChunkRequest& b) { return a.Priority < b.Priority; });
+	}
+
+	float ChunkedTerrain::GetNodeDistance(const TerrainChunkKey& key, const Maths::Vector3& cameraPosition) const
+	{
+		const float size = GetNodeSize(key.Level);
+		const float minX = float(key.X) * size;
+		const float minZ = float(key.Z) * size;
+
+		const float dx = Maths::Max(Maths::Max(minX - cameraPosition.x, cameraPosition.x - (minX + size)), 0.0f);
+		const float dz = Maths::Max(Maths::Max(minZ - cameraPosition.z, cameraPosition.z - (minZ + size)), 0.0f);
+		const float minY = Maths::Min(m_HeightScale, 0.0f);
+		const float maxY = Maths::Max(m_HeightScale, 0.0f);
+		const float dy = Maths::Max(Maths::Max(minY - cameraPosition.y, cameraPosition.y - maxY), 0.0f);
+
+		return Maths::Sqrt(dx * dx + dy * dy + dz * dz);
+	}
+
+	void ChunkedTerrain::SelectNode(const TerrainChunkKey& key, const Maths::Vector3& cameraPosition)
+	{
+		const float distance = GetNodeDistance(key, cameraPosition);
+		const float size = GetNodeSize(key.Level);
+
+		if(key.Level > 0 && distance < size * m_LODDistance)
+		{
+			const TerrainChunkKey children[4] = {
+				{ key.X * 2, key.Z * 2, key.Level - 1 },
+				{ key.X * 2 + 1, key.Z * 2, key.Level - 1 },
+				{ key.X * 2, key.Z * 2 + 1, key.Level - 1 },
+				{ key.X * 2 + 1, key.Z * 2 + 1, key.Level - 1 }
+			};
+
+			bool ready = true;
+			for(auto& child : children)
+			{
+				if(m_Chunks.find(child) == m_Chunks.end())
+				{
+					//After this node itself, which stands in until all four are ready
+					m_Requests.push_back({ child, distance / size + 1.0f });
+					ready = false;
+				}
+			}
+
+			if(ready)
+			{
+				//Keep the parent resident so it can stand in again when the camera moves away
+				auto it = m_Chunks.find(key);
+				if(it != m_Chunks.end())
+					it->second.LastUsedFrame = m_FrameIndex;
+
+				for(auto& child : children)
+					SelectNode(child, cameraPosition);
+				return;
+			}
+		}
+
+		if(!UseChunk(key))
+			m_Requests.push_back({ key, distance / size });
+	}
+
+	bool ChunkedTerrain::UseChunk(const TerrainChunkKey& key)
+	{
+		auto it = m_Chunks.find(key);
+		if(it == m_Chunks.end())
+			return false;
+
+		it->second.LastUsedFrame = m_FrameIndex;
+		m_VisibleChunks.push_back(it->second.ChunkMesh.get());
+		return true;
+	}
+
+	void ChunkedTerrain::GenerateChunk(ChunkData& data) const
+	{
+		LUMOS_PROFILE_FUNCTION();
+		const uint32_t resolution = m_ChunkResolution;
+		const uint32_t side = resolution + 1;
+		const float size = GetNodeSize(data.Key.Level);
+		const float spacing = size / float(resolution);
+		const float originX = float(data.Key.X) * size;
+		const float originZ = float(data.Key.Z) * size;
+
+		//One sample of border so normals match the neighbouring chunks of the same level
+		const uint32_t border = side + 2;
+		std::vector<float> heights(border * border);
+		for(uint32_t x = 0; x < border; x++)
+		{
+			for(uint32_t z = 0; z < border; z++)
+				heights[x * border + z] = SampleHeight(originX + (float(x) - 1.0f) * spacing, originZ + (float(z) - 1.0f) * spacing);
+		}
+
+		auto height = [&](int32_t x, int32_t z) { return heights[(x + 1) * int32_t(border) + z + 1]; };
+
+		std::vector<uint32_t> perimeter;
+		GetPerimeter(resolution, perimeter);
+
+		data.Vertices.resize(side * side + perimeter.size());
+		data.Bounds.Clear();
+
+		for(int32_t x = 0; x < int32_t(side); x++)
+		{
+			for(int32_t z = 0; z < int32_t(side); z++)
+			{
+				const float dx = height(x + 1, z) - height(x - 1, z);
+				const float dz = height(x, z + 1) - height(x, z - 1);
+
+				Vertex& vertex = data.Vertices[x * side + z];
+				vertex.Position = Maths::Vector3(originX + float(x) * spacing, height(x, z), originZ + float(z) * spacing);
+				vertex.Colours = Maths::Vector4(0.0f);
+				vertex.TexCoords = Maths::Vector2(vertex.Position.x * m_TextureScale, vertex.Position.z * m_TextureScale);
+				vertex.Normal = Maths::Vector3(-dx, 2.0f * spacing, -dz).Normalized();
+				vertex.Tangent = Maths::Vector3(2.0f * spacing, dx, 0.0f).Normalized();
+
+				data.Bounds.Merge(vertex.Position);
+			}
+		}
+
+		//Skirts hang below the edges, deep enough to cover the gap to a coarser neighbour
+		const float skirtDepth = spacing * 2.0f + 1.0f;
+		for(size_t i = 0; i < perimeter.size(); i++)
+		{
+			Vertex& vertex = data.Vertices[side * side + i];
+			vertex = data.Vertices[perimeter[i]];
+			vertex.Position.y -= skirtDepth;
+			data.Bounds.Merge(vertex.Position);
+		}
+	}
+
+	void ChunkedTerrain::CreateIndexBuffer()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		//Every chunk has the same topology so they all share one index buffer
+		const uint32_t resolution = m_ChunkResolution;
+		const uint32_t side = resolution + 1;
+
+		std::vector<uint32_t> perimeter;
+		GetPerimeter(resolution, perimeter);
+
+		std::vector<uint32_t> indices;
+		indices.reserve(resolution * resolution * 6 + perimeter.size() * 6);
+
+		for(uint32_t x = 0; x < resolution; x++)
+		{
+			for(uint32_t z = 0; z < resolution; z++)
+			{
+				const uint32_t a = x * side + z;
+				const uint32_t b = (x + 1) * side + z;
+				const uint32_t c = (x + 1) * side + z + 1;
+				const uint32_t d = x * side + z + 1;
+
+				indices.push_back(c);
+				indices.push_back(b);
+				indices.push_back(a);
+
+				indices.push_back(a);
+				indices.push_back(d);
+				indices.push_back(c);
+			}
+		}
+
+		const uint32_t perimeterCount = uint32_t(perimeter.size());
+		for(uint32_t i = 0; i < perimeterCount; i++)
+		{
+			const uint32_t next = (i + 1) % perimeterCount;
+			const uint32_t top0 = perimeter[i];
+			const uint32_t top1 = perimeter[next];
+			const uint32_t bottom0 = side * side + i;
+			const uint32_t bottom1 = side * side + next;
+
+			indices.push_back(top0);
+			indices.push_back(bottom0);
+			indices.push_back(top1);
+
+			indices.push_back(top1);
+			indices.push_back(bottom0);
+			indices.push_back(bottom1);
+		}
+
+		m_IndexBuffer = Ref<IndexBuffer>(IndexBuffer::Create(indices.data(), uint32_t(indices.size())));
+	}
+
+	void ChunkedTerrain::AddChunks(std::vector<ChunkData>& chunks)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		for(auto& data : chunks)
+		{
+			const uint32_t memorySize = uint32_t(data.Vertices.size() * sizeof(Vertex));
+
+			Ref<VertexBuffer> vertexBuffer = Ref<VertexBuffer>(VertexBuffer::Create(BufferUsage::STATIC));
+			vertexBuffer->SetData(memorySize, data.Vertices.data());
+
+			Chunk& chunk = m_Chunks[data.Key];
+			if(chunk.ChunkMesh)
+				m_MemoryUsage -= chunk.MemorySize;
+
+			chunk.ChunkMesh = CreateRef<Mesh>(vertexBuffer, m_IndexBuffer, CreateRef<Maths::BoundingBox>(data.Bounds));
+			chunk.ChunkMesh->SetMaterial(m_Material);
+			chunk.LastUsedFrame = m_FrameIndex;
+			chunk.MemorySize = memorySize;
+			m_MemoryUsage += memorySize;
+		}
+
+		const size_t budget = size_t(m_MemoryBudget) * 1024 * 1024;
+		if(m_MemoryUsage <= budget)
+			return;
+
+		//Least recently used first, chunks drawn this frame are never evicted
+		std::vector<std::pair<uint64_t, TerrainChunkKey>> candidates;
+		for(auto& [key, chunk] : m_Chunks)
+		{
+			if(chunk.LastUsedFrame < m_FrameIndex)
+				candidates.push_back({ chunk.LastUsedFrame, key });
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+		for(auto& candidate : candidates)
+		{
+			if(m_MemoryUsage <= budget)
+				break;
+
+			auto it = m_Chunks.find(candidate.second);
+			m_MemoryUsage -= it->second.MemorySize;
+			m_Chunks.erase(it);
+		}
+	}
+
+	void ChunkedTerrain::Invalidate()
+	{
+		m_Chunks.clear();
+		m_VisibleChunks.clear();
+		m_Requests.clear();
+		m_IndexBuffer.reset();
+		m_MemoryUsage = 0;
+	}
+
+	void ChunkedTerrain::SetMaterial(const Ref<Material>& material)
+	{
+		m_Material = material;
+		for(auto& [key, chunk] : m_Chunks)
+			chunk.ChunkMesh->SetMaterial(material);
+	}
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include "Graphics/Mesh.h"
+#include "Maths/Maths.h"
+#include "Utilities/CombineHash.h"
+
+#include <cereal/cereal.hpp>
+
+namespace Lumos::Graphics
+{
+	struct TerrainChunkKey
+	{
+		int32_t X;
+		int32_t Z;
+		uint32_t Level;
+
+		bool operator==(const TerrainChunkKey& other) const { return X == other.X && Z == other.Z && Level == other.Level; }
+	};
+
+	struct TerrainChunkKeyHash
+	{
+		size_t operator()(const TerrainChunkKey& key) const
+		{
+			size_t hash = std::hash<int32_t>()(key.X);
+			HashCombine(hash, key.Z, key.Level);
+			return hash;
+		}
+	};
+
+	//Infinite heightfield split into square chunks. Each frame a quadtree around the camera picks the chunk
+	//levels to draw, level 0 is the finest and every level above doubles the chunk size with the same vertex
+	//count. Missing chunks are requested from TerrainStreamer, which builds them on the job system, and a node
+	//only splits once all four children are ready so there are never holes or overlaps. Chunks carry skirts
+	//to hide cracks between levels and are evicted least recently used once over the memory budget
+	class LUMOS_EXPORT ChunkedTerrain
+	{
+	public:
+		struct Chunk
+		{
+			Ref<Mesh> ChunkMesh;
+			uint64_t LastUsedFrame = 0;
+			uint32_t MemorySize = 0;
+		};
+
+		struct ChunkRequest
+		{
+			TerrainChunkKey Key;
+			float Priority;
+		};
+
+		//CPU side chunk data built on a worker thread
+		struct ChunkData
+		{
+			TerrainChunkKey Key;
+			std::vector<Vertex> Vertices;
+			Maths::BoundingBox Bounds;
+		};
+
+		ChunkedTerrain() = default;
+		~ChunkedTerrain() = default;
+
+		//Selects this frame's chunks around cameraPosition (terrain local space) and fills the request list,
+		//most important first
+		void Update(const Maths::Vector3& cameraPosition);
+
+		//Builds the vertices for a chunk, safe to call from any thread
+		void GenerateChunk(ChunkData& data) const;
+
+		//Uploads generated chunks and evicts old ones until the cache fits the memory budget
+		void AddChunks(std::vector<ChunkData>& chunks);
+
+		//Drops every cached chunk, call after changing generation settings
+		void Invalidate();
+
+		float SampleHeight(float x, float z) const;
+
+		const std::vector<Mesh*>& GetVisibleChunks() const { return m_VisibleChunks; }
+		const std::vector<ChunkRequest>& GetRequests() const { return m_Requests; }
+		uint32_t GetCachedChunkCount() const { return uint32_t(m_Chunks.size()); }
+		size_t GetMemoryUsage() const { return m_MemoryUsage; }
+
+		float GetChunkSize() const { return m_ChunkSize; }
+		void SetChunkSize(float size) { m_ChunkSize = Maths::Max(size, 1.0f); Invalidate(); }
+		uint32_t GetChunkResolution() const { return m_ChunkResolution; }
+		void SetChunkResolution(uint32_t resolution) { m_ChunkResolution = Maths::Clamp(resolution, 2u, 128u); Invalidate(); }
+		uint32_t GetLODLevels() const { return m_LODLevels; }
+		void SetLODLevels(uint32_t levels) { m_LODLevels = Maths::Clamp(levels, 1u, 12u); Invalidate(); }
+		float GetLODDistance() const { return m_LODDistance; }
+		void SetLODDistance(float distance) { m_LODDistance = Maths::Max(distance, 0.5f); }
+		float GetViewDistance() const { return m_ViewDistance; }
+		void SetViewDistance(float distance) { m_ViewDistance = Maths::Max(distance, 1.0f); }
+		float GetHeightScale() const { return m_HeightScale; }
+		void SetHeightScale(float scale) { m_HeightScale = scale; Invalidate(); }
+		float GetTextureScale() const { return m_TextureScale; }
+		void SetTextureScale(float scale) { m_TextureScale = scale; Invalidate(); }
+		const Maths::Vector2& GetNoiseOffset() const { return m_NoiseOffset; }
+		void SetNoiseOffset(const Maths::Vector2& offset) { m_NoiseOffset = offset; Invalidate(); }
+		uint32_t GetMemoryBudget() const { return m_MemoryBudget; }
+		void SetMemoryBudget(uint32_t megabytes) { m_MemoryBudget = Maths::Max(megabytes, 1u); }
+
+		const Ref<Material>& GetMaterial() const { return m_Material; }
+		void SetMaterial(const Ref<Material>& material);
+
+		template<typename Archive>
+		void save(Archive& archive) const
+		{
+			archive(cereal::make_nvp("ChunkSize", m_ChunkSize),
+				cereal::make_nvp("ChunkResolution", m_ChunkResolution),
+				cereal::make_nvp("LODLevels", m_LODLevels),
+				cereal::make_nvp("LODDistance", m_LODDistance),
+				cereal::make_nvp("ViewDistance", m_ViewDistance),
+				cereal::make_nvp("HeightScale", m_HeightScale),
+				cereal::make_nvp("TextureScale", m_TextureScale),
+				cereal::make_nvp("NoiseOffset", m_NoiseOffset),
+				cereal::make_nvp("MemoryBudget", m_MemoryBudget));
+		}
+
+		template<typename Archive>
+		void load(Archive& archive)
+		{
+			archive(cereal::make_nvp("ChunkSize", m_ChunkSize),
+				cereal::make_nvp("ChunkResolution", m_ChunkResolution),
+				cereal::make_nvp("LODLevels", m_LODLevels),
+				cereal::make_nvp("LODDistance", m_LODDistance),
+				cereal::make_nvp("ViewDistance", m_ViewDistance),
+				cereal::make_nvp("HeightScale", m_HeightScale),
+				cereal::make_nvp("TextureScale", m_TextureScale),
+				cereal::make_nvp("NoiseOffset", m_NoiseOffset),
+				cereal::make_nvp("MemoryBudget", m_MemoryBudget));
+
+			Invalidate();
+		}
+
+	private:
+		void SelectNode(const TerrainChunkKey& key, const Maths::Vector3& cameraPosition);
+		bool UseChunk(const TerrainChunkKey& key);
+		float GetNodeSize(uint32_t level) const { return m_ChunkSize * float(1u << level); }
+		float GetNodeDistance(const TerrainChunkKey& key, const Maths::Vector3& cameraPosition) const;
+		void CreateIndexBuffer();
+
+		std::unordered_map<TerrainChunkKey, Chunk, TerrainChunkKeyHash> m_Chunks;
+		std::vector<Mesh*> m_VisibleChunks;
+		std::vector<ChunkRequest> m_Requests;
+		Ref<IndexBuffer> m_IndexBuffer;
+		Ref<Material> m_Material;
+
+		uint64_t m_FrameIndex = 0;
+		size_t m_MemoryUsage = 0;
+
+		float m_ChunkSize = 32.0f;
+		uint32_t m_ChunkResolution = 32;
+		uint32_t m_LODLevels = 6;
+		float m_LODDistance = 2.0f;
+		float m_ViewDistance = 1500.0f;
+		float m_HeightScale = 150.0f;
+		float m_TextureScale = 1.0f / 16.0f;
+		Maths::Vector2 m_NoiseOffset = Maths::Vector2(100.0f, -50.0f);
+		uint32_t m_MemoryBudget = 64;
+	};
+}
@@ -0,0 +1,82 @@
+#include "Precompiled.h"
+#include "TerrainStreamer.h"
+#include "Core/JobSystem.h"
+#include "Maths/Transform.h"
+#include "Scene/Scene.h"
+#include "Utilities/Timer.h"
+
+#include <entt/entity/registry.hpp>
+#include <imgui/imgui.h>
+
+namespace Lumos::Graphics
+{
+	void TerrainStreamer::Update(Scene* scene, const Maths::Vector3& cameraPosition)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_TerrainCount = 0;
+		m_VisibleChunks = 0;
+		m_CachedChunks = 0;
+		m_PendingChunks = 0;
+		m_GeneratedChunks = 0;
+		m_MemoryUsage = 0;
+
+		if(!scene)
+			return;
+
+		Timer timer;
+		timer.GetTimedMS();
+
+		auto& registry = scene->GetRegistry();
+		auto view = registry.view<ChunkedTerrain, Maths::Transform>();
+
+		uint32_t budget = m_MaxChunksPerFrame;
+		for(auto entity : view)
+		{
+			const auto& [terrain, transform] = view.get<ChunkedTerrain, Maths::Transform>(entity);
+
+			//Selection works in the terrain's local space
+			terrain.Update(transform.GetWorldMatrix().Inverse() * cameraPosition);
+
+			const auto& requests = terrain.GetRequests();
+			const uint32_t count = Maths::Min(budget, uint32_t(requests.size()));
+			budget -= count;
+
+			m_Generated.resize(count);
+			for(uint32_t i = 0; i < count; i++)
+				m_Generated[i].Key = requests[i].Key;
+
+			System::JobSystem::Dispatch(count, 1, [&](JobDispatchArgs args)
+				{
+					terrain.GenerateChunk(m_Generated[args.jobIndex]);
+				});
+			System::JobSystem::Wait();
+
+			//Buffers are created on this thread
+			terrain.AddChunks(m_Generated);
+
+			m_TerrainCount++;
+			m_VisibleChunks += uint32_t(terrain.GetVisibleChunks().size());
+			m_CachedChunks += terrain.GetCachedChunkCount();
+			m_PendingChunks += uint32_t(requests.size()) - count;
+			m_GeneratedChunks += count;
+			m_MemoryUsage += terrain.GetMemoryUsage();
+		}
+
+		m_GenerateTime = timer.GetTimedMS();
+	}
+
+	void TerrainStreamer::OnImGui()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		ImGui::TextUnformatted("Terrain Streaming");
+		ImGui::Text("Terrains : %u", m_TerrainCount);
+		ImGui::Text("Visible Chunks : %u", m_VisibleChunks);
+		ImGui::Text("Cached Chunks : %u (%.1f MB)", m_CachedChunks, float(m_MemoryUsage) / (1024.0f * 1024.0f));
+		ImGui::Text("Generated : %u (%u pending)", m_GeneratedChunks, m_PendingChunks);
+		ImGui::Text("Update Time : %.3f ms", m_GenerateTime);
+
+		int maxChunks = int(m_MaxChunksPerFrame);
+		if(ImGui::DragInt("Chunks Per Frame", &maxChunks, 1.0f, 1, 256))
+			SetMaxChunksPerFrame(uint32_t(maxChunks));
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "ChunkedTerrain.h"
+
+namespace Lumos
+{
+	class Scene;
+
+	namespace Graphics
+	{
+		//Streams every ChunkedTerrain in the scene around the camera. Runs from RenderGraph::BeginScene so
+		//terrain keeps streaming while the editor isn't playing, and before any renderer reads the chunk lists.
+		//Requested chunks are generated in parallel on the job system, a fixed number per frame
+		class LUMOS_EXPORT TerrainStreamer
+		{
+		public:
+			TerrainStreamer() = default;
+			~TerrainStreamer() = default;
+
+			void Update(Scene* scene, const Maths::Vector3& cameraPosition);
+			void OnImGui();
+
+			uint32_t GetMaxChunksPerFrame() const { return m_MaxChunksPerFrame; }
+			void SetMaxChunksPerFrame(uint32_t count) { m_MaxChunksPerFrame = Maths::Max(count, 1u); }
+
+		private:
+			std::vector<ChunkedTerrain::ChunkData> m_Generated;
+
+			uint32_t m_MaxChunksPerFrame = 16;
+			uint32_t m_TerrainCount = 0;
+			uint32_t m_VisibleChunks = 0;
+			uint32_t m_CachedChunks = 0;
+			uint32_t m_PendingChunks = 0;
+			uint32_t m_GeneratedChunks = 0;
+			size_t m_MemoryUsage = 0;
+			float m_GenerateTime = 0.0f;
+		};
+	}
+}
@@ -0,0 +1,237 @@
+#include "Precompiled.h"
+#include "TextureAtlas.h"
+#include "Graphics/API/Texture.h"
+#include "Utilities/LoadImage.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		//Border copied from the edge texels around every packed texture to stop filtering bleeding into neighbours
+		static const uint32_t AtlasPadding = 2;
+
+		TextureAtlas::TextureAtlas(uint32_t pageSize, uint32_t maxPages, uint32_t maxTextureSize)
+			: m_PageSize(pageSize)
+			, m_MaxPages(maxPages)
+			, m_MaxTextureSize(maxTextureSize)
+		{
+		}
+
+		TextureAtlas::~TextureAtlas()
+		{
+			Clear();
+		}
+
+		void TextureAtlas::Clear()
+		{
+			m_Entries.clear();
+			m_Rejected.clear();
+			m_Pages.clear();
+		}
+
+		void TextureAtlas::BeginFrame()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_Frame++;
+
+			//Rejected textures are keyed by pointer, forget them now and then in case the memory was reused
+			if(m_Frame % m_EvictionFrames == 0)
+				m_Rejected.clear();
+
+			for(uint32_t i = 0; i < uint32_t(m_Pages.size()); i++)
+			{
+				auto& page = m_Pages[i];
+				if(page.LastUsedFrame + m_EvictionFrames < m_Frame && page.Allocator.GetWidth() > 0)
+					ResetPage(i);
+			}
+		}
+
+		bool TextureAtlas::GetRegion(const Ref<Texture2D>& texture, Region& region)
+		{
+			if(!texture)
+				return false;
+
+			auto it = m_Entries.find(texture.get());
+			if(it == m_Entries.end())
+			{
+				if(m_Rejected.find(texture.get()) != m_Rejected.end())
+					return false;
+
+				Entry entry;
+				if(!Pack(texture, entry))
+				{
+					m_Rejected.insert(texture.get());
+					return false;
+				}
+
+				it = m_Entries.emplace(texture.get(), entry).first;
+			}
+
+			m_Pages[it->second.PageIndex].LastUsedFrame = m_Frame;
+			region = it->second.Area;
+			return true;
+		}
+
+		bool TextureAtlas::Pack(const Ref<Texture2D>& texture, Entry& entry)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(texture->GetWidth() > m_MaxTextureSize || texture->GetHeight() > m_MaxTextureSize)
+				return false;
+
+			//Only file backed textures can be read back
+			const std::string& filePath = texture->GetFilepath();
+			if(filePath.empty() || filePath == "NULL")
+				return false;
+
+			uint32_t width = 0, height = 0, bits = 0;
+			bool isHDR = false;
+			uint8_t* pixels = LoadImageFromFile(filePath, &width, &height, &bits, &isHDR);
+
+			if(!pixels)
+				return false;
+
+			if(isHDR || bits != 32)
+			{
+				delete[] pixels;
+				return false;
+			}
+
+			int x, y;
+			int32_t pageIndex = AllocateArea(width + AtlasPadding * 2, height + AtlasPadding * 2, x, y);
+			if(pageIndex < 0)
+			{
+				delete[] pixels;
+				return false;
+			}
+
+			auto& page = m_Pages[pageIndex];
+
+			//Copy with the edge texels clamped into the padding
+			const int32_t paddedWidth = int32_t(width + AtlasPadding * 2);
+			const int32_t paddedHeight = int32_t(height + AtlasPadding * 2);
+			for(int32_t row = 0; row < paddedHeight; row++)
+			{
+				int32_t srcRow = Maths::Clamp(row - int32_t(AtlasPadding), 0, int32_t(height) - 1);
+				uint8_t* dst = &page.Pixels[((y + row) * m_PageSize + x) * 4];
+				const uint8_t* src = &pixels[srcRow * width * 4];
+
+				for(int32_t column = 0; column < paddedWidth; column++)
+				{
+					int32_t srcColumn = Maths::Clamp(column - int32_t(AtlasPadding), 0, int32_t(width) - 1);
+					memcpy(dst + column * 4, src + srcColumn * 4, 4);
+				}
+			}
+
+			delete[] pixels;
+
+			page.Dirty = true;
+
+			const float invSize = 1.0f / float(m_PageSize);
+			entry.Source = texture;
+			entry.PageIndex = uint32_t(pageIndex);
+			entry.Area.Page = page.Texture.get();
+			entry.Area.UVMin = Maths::Vector2(float(x + AtlasPadding), float(y + AtlasPadding)) * invSize;
+			entry.Area.UVMax = Maths::Vector2(float(x + AtlasPadding + width), float(y + AtlasPadding + height)) * invSize;
+
+			return true;
+		}
+
+		int32_t TextureAtlas::AllocateArea(uint32_t width, uint32_t height, int& x, int& y)
+		{
+			if(width > m_PageSize || height > m_PageSize)
+				return -1;
+
+			for(uint32_t i = 0; i < uint32_t(m_Pages.size()); i++)
+			{
+				auto& page = m_Pages[i];
+				if(page.Allocator.GetWidth() > 0 && page.Allocator.Allocate(int(width), int(height), x, y))
+					return int32_t(i);
+			}
+
+			int32_t pageIndex = -1;
+
+			//Reuse an evicted page before creating a new one
+			for(uint32_t i = 0; i < uint32_t(m_Pages.size()); i++)
+			{
+				if(m_Pages[i].Allocator.GetWidth() == 0)
+				{
+					pageIndex = int32_t(i);
+					break;
+				}
+			}
+
+			if(pageIndex < 0 && m_Pages.size() < m_MaxPages)
+			{
+				pageIndex = int32_t(m_Pages.size());
+				m_Pages.emplace_back();
+			}
+
+			//Full, evict the least recently used page unless it's needed this frame
+			if(pageIndex < 0)
+			{
+				uint64_t oldestFrame = m_Frame;
+				for(uint32_t i = 0; i < uint32_t(m_Pages.size()); i++)
+				{
+					if(m_Pages[i].LastUsedFrame < oldestFrame)
+					{
+						oldestFrame = m_Pages[i].LastUsedFrame;
+						pageIndex = int32_t(i);
+					}
+				}
+
+				if(pageIndex < 0)
+					return -1;
+
+				ResetPage(pageIndex);
+			}
+
+			auto& page = m_Pages[pageIndex];
+			page.Allocator.Reset(m_PageSize, m_PageSize, m_PageSize, m_PageSize, false);
+			page.LastUsedFrame = m_Frame;
+
+			if(page.Pixels.empty())
+				page.Pixels.resize(m_PageSize * m_PageSize * 4, 0);
+
+			if(!page.Texture)
+			{
+				TextureParameters parameters;
+				parameters.wrap = TextureWrap::CLAMP_TO_EDGE;
+				page.Texture = Ref<Texture2D>(Texture2D::CreateFromSource(m_PageSize, m_PageSize, page.Pixels.data(), parameters));
+				page.Texture->SetName("TextureAtlasPage");
+			}
+
+			if(!page.Allocator.Allocate(int(width), int(height), x, y))
+				return -1;
+
+			return pageIndex;
+		}
+
+		void TextureAtlas::ResetPage(uint32_t pageIndex)
+		{
+			for(auto it = m_Entries.begin(); it != m_Entries.end();)
+			{
+				if(it->second.PageIndex == pageIndex)
+					it = m_Entries.erase(it);
+				else
+					++it;
+			}
+
+			//The texture and pixel storage are kept for the next textures packed into this page
+			m_Pages[pageIndex].Allocator.Reset(0, 0);
+			m_Pages[pageIndex].Dirty = false;
+		}
+
+		void TextureAtlas::UploadPages()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			for(auto& page : m_Pages)
+			{
+				if(!page.Dirty)
+					continue;
+
+				page.Texture->SetData(page.Pixels.data());
+				page.Dirty = false;
+			}
+		}
+	}
+}
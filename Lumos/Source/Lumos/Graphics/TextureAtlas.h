@@ -0,0 +1,82 @@
+#pragma once
+#include "Maths/Maths.h"
+#include "Maths/AreaAllocator.h"
+
+#include <unordered_set>
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		class Texture2D;
+
+		//Packs small sprite textures into shared pages so Renderer2D can batch them together.
+		//Pages are rebuilt on the cpu and uploaded once per frame. A page is evicted as a whole
+		//once none of its textures have been used for a while, since AreaAllocator can't free single areas.
+		class LUMOS_EXPORT TextureAtlas
+		{
+		public:
+			struct Region
+			{
+				Texture2D* Page = nullptr;
+				Maths::Vector2 UVMin;
+				Maths::Vector2 UVMax;
+
+				//Maps uvs in the source texture's 0-1 range into the page
+				Maths::Vector2 Remap(const Maths::Vector2& uv) const
+				{
+					return UVMin + (UVMax - UVMin) * uv;
+				}
+			};
+
+			TextureAtlas(uint32_t pageSize = 2048, uint32_t maxPages = 4, uint32_t maxTextureSize = 256);
+			~TextureAtlas();
+
+			void BeginFrame();
+
+			//Returns false if the texture can't be packed and should be bound directly
+			bool GetRegion(const Ref<Texture2D>& texture, Region& region);
+
+			//Uploads pages that changed since the last call. Call before recording draws that use them
+			void UploadPages();
+
+			void Clear();
+
+			uint32_t GetPageCount() const { return uint32_t(m_Pages.size()); }
+			uint32_t GetEntryCount() const { return uint32_t(m_Entries.size()); }
+			void SetEvictionFrames(uint32_t frames) { m_EvictionFrames = Maths::Max(frames, 1u); }
+
+		private:
+			struct Page
+			{
+				Maths::AreaAllocator Allocator;
+				std::vector<uint8_t> Pixels;
+				Ref<Texture2D> Texture;
+				uint64_t LastUsedFrame = 0;
+				bool Dirty = false;
+			};
+
+			struct Entry
+			{
+				Ref<Texture2D> Source;
+				uint32_t PageIndex;
+				Region Area;
+			};
+
+			bool Pack(const Ref<Texture2D>& texture, Entry& entry);
+			int32_t AllocateArea(uint32_t width, uint32_t height, int& x, int& y);
+			void ResetPage(uint32_t pageIndex);
+
+			std::unordered_map<Texture2D*, Entry> m_Entries;
+			//Textures that failed to load or are too large, so they aren't retried every frame
+			std::unordered_set<Texture2D*> m_Rejected;
+			std::vector<Page> m_Pages;
+
+			uint32_t m_PageSize;
+			uint32_t m_MaxPages;
+			uint32_t m_MaxTextureSize;
+			uint32_t m_EvictionFrames = 300;
+			uint64_t m_Frame = 0;
+		};
+	}
+}
@@ -0,0 +1,500 @@
+#include "Precompiled.h"
+#include "BatchMaths.h"
+#include "BatchMathsKernels.h"
+#include "Maths/Matrix3x4.h"
+#include "Utilities/Timer.h"
+
+#if defined(LUMOS_SSE)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace Lumos::Maths
+{
+    namespace BatchKernels
+    {
+        namespace Scalar
+        {
+            void TransformPoints(const float* m, ConstVector3Streams in, Vector3Streams out, uint32_t count)
+            {
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    const float x = in.x[i], y = in.y[i], z = in.z[i];
+                    out.x[i] = m[0] * x + m[1] * y + m[2] * z + m[3];
+                    out.y[i] = m[4] * x + m[5] * y + m[6] * z + m[7];
+                    out.z[i] = m[8] * x + m[9] * y + m[10] * z + m[11];
+                }
+            }
+
+            void TransformBoxes(const float* m, ConstVector3Streams centres, ConstVector3Streams extents, Vector3Streams outCentres, Vector3Streams outExtents, uint32_t count)
+            {
+                const float a0 = Abs(m[0]), a1 = Abs(m[1]), a2 = Abs(m[2]);
+                const float a4 = Abs(m[4]), a5 = Abs(m[5]), a6 = Abs(m[6]);
+                const float a8 = Abs(m[8]), a9 = Abs(m[9]), a10 = Abs(m[10]);
+
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    const float cx = centres.x[i], cy = centres.y[i], cz = centres.z[i];
+                    const float ex = extents.x[i], ey = extents.y[i], ez = extents.z[i];
+                    outCentres.x[i] = m[0] * cx + m[1] * cy + m[2] * cz + m[3];
+                    outCentres.y[i] = m[4] * cx + m[5] * cy + m[6] * cz + m[7];
+                    outCentres.z[i] = m[8] * cx + m[9] * cy + m[10] * cz + m[11];
+                    outExtents.x[i] = a0 * ex + a1 * ey + a2 * ez;
+                    outExtents.y[i] = a4 * ex + a5 * ey + a6 * ez;
+                    outExtents.z[i] = a8 * ex + a9 * ey + a10 * ez;
+                }
+            }
+
+            void TransformBoxesPerObject(const float* matrices, const float* boxes, Vector3Streams outCentres, Vector3Streams outExtents, uint32_t count)
+            {
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    const float* m = matrices + i * MatrixStride;
+                    const float* b = boxes + i * BoxStride;
+
+                    const float cx = (b[0] + b[4]) * 0.5f, cy = (b[1] + b[5]) * 0.5f, cz = (b[2] + b[6]) * 0.5f;
+                    const float ex = b[4] - cx, ey = b[5] - cy, ez = b[6] - cz;
+
+                    outCentres.x[i] = m[0] * cx + m[1] * cy + m[2] * cz + m[3];
+                    outCentres.y[i] = m[4] * cx + m[5] * cy + m[6] * cz + m[7];
+                    outCentres.z[i] = m[8] * cx + m[9] * cy + m[10] * cz + m[11];
+                    outExtents.x[i] = Abs(m[0]) * ex + Abs(m[1]) * ey + Abs(m[2]) * ez;
+                    outExtents.y[i] = Abs(m[4]) * ex + Abs(m[5]) * ey + Abs(m[6]) * ez;
+                    outExtents.z[i] = Abs(m[8]) * ex + Abs(m[9]) * ey + Abs(m[10]) * ez;
+                }
+            }
+
+            void CullBoxes(const FrustumPlanes& planes, ConstVector3Streams centres, ConstVector3Streams extents, uint8_t* visible, uint32_t count)
+            {
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    uint8_t inside = 1;
+                    for(uint32_t p = 0; p < 6; p++)
+                    {
+                        const float dist = planes.NormalX[p] * centres.x[i] + planes.NormalY[p] * centres.y[i] + planes.NormalZ[p] * centres.z[i] + planes.D[p];
+                        const float absDist = planes.AbsNormalX[p] * extents.x[i] + planes.AbsNormalY[p] * extents.y[i] + planes.AbsNormalZ[p] * extents.z[i];
+
+                        if(dist < -absDist)
+                        {
+                            inside = 0;
+                            break;
+                        }
+                    }
+                    visible[i] = inside;
+                }
+            }
+
+            void CullSpheres(const FrustumPlanes& planes, ConstVector3Streams centres, const float* radii, uint8_t* visible, uint32_t count)
+            {
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    uint8_t inside = 1;
+                    for(uint32_t p = 0; p < 6; p++)
+                    {
+                        const float dist = planes.NormalX[p] * centres.x[i] + planes.NormalY[p] * centres.y[i] + planes.NormalZ[p] * centres.z[i] + planes.D[p];
+
+                        if(dist < -radii[i])
+                        {
+                            inside = 0;
+                            break;
+                        }
+                    }
+                    visible[i] = inside;
+                }
+            }
+        }
+
+        void GetScalarKernels(KernelTable& table)
+        {
+            table.TransformPoints = Scalar::TransformPoints;
+            table.TransformBoxes = Scalar::TransformBoxes;
+            table.TransformBoxesPerObject = Scalar::TransformBoxesPerObject;
+            table.CullBoxes = Scalar::CullBoxes;
+            table.CullSpheres = Scalar::CullSpheres;
+        }
+    }
+
+    using namespace BatchKernels;
+
+    void Vector3Stream::Resize(uint32_t count)
+    {
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+    }
+
+    void BoundingBoxStream::Resize(uint32_t count)
+    {
+        Centre.Resize(count);
+        Extent.Resize(count);
+    }
+
+    void BoundingBoxStream::Set(uint32_t index, const BoundingBox& box)
+    {
+        Vector3 centre = box.Center();
+        Centre.Set(index, centre);
+        Extent.Set(index, box.max_ - centre);
+    }
+
+    BoundingBox BoundingBoxStream::Get(uint32_t index) const
+    {
+        Vector3 centre = Centre.Get(index);
+        Vector3 extent = Extent.Get(index);
+        return BoundingBox(centre - extent, centre + extent);
+    }
+
+    void SphereStream::Resize(uint32_t count)
+    {
+        Centre.Resize(count);
+        Radius.resize(count);
+    }
+
+    void SphereStream::Set(uint32_t index, const Sphere& sphere)
+    {
+        Centre.Set(index, sphere.center_);
+        Radius[index] = sphere.radius_;
+    }
+
+    namespace Batch
+    {
+        static bool CPUSupportsAVX2()
+        {
+#if defined(LUMOS_SSE)
+#ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            if(info[0] < 7)
+                return false;
+
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            const bool fma = (info[2] & (1 << 12)) != 0;
+            if(!osxsave || !avx || !fma)
+                return false;
+
+            //The OS has to save the ymm registers too
+            if((_xgetbv(0) & 6) != 6)
+                return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            unsigned int eax, ebx, ecx, edx;
+            if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+                return false;
+
+            const bool osxsave = (ecx & (1 << 27)) != 0;
+            const bool avx = (ecx & (1 << 28)) != 0;
+            const bool fma = (ecx & (1 << 12)) != 0;
+            if(!osxsave || !avx || !fma)
+                return false;
+
+            //The OS has to save the ymm registers too
+            unsigned int xcr0Low, xcr0High;
+            __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            if((xcr0Low & 6) != 6)
+                return false;
+
+            if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+                return false;
+
+            return (ebx & (1 << 5)) != 0;
+#endif
+#else
+            return false;
+#endif
+        }
+
+        struct Dispatcher
+        {
+            Dispatcher()
+            {
+#if defined(LUMOS_SSE)
+                Best = CPUSupportsAVX2() ? InstructionSet::AVX2 : InstructionSet::SSE2;
+#else
+                Best = InstructionSet::Scalar;
+#endif
+                Select(Best);
+            }
+
+            void Select(InstructionSet set)
+            {
+                if(set > Best)
+                    set = Best;
+
+                switch(set)
+                {
+#if defined(LUMOS_SSE)
+                case InstructionSet::AVX2:
+                    GetAVX2Kernels(Kernels);
+                    break;
+                case InstructionSet::SSE2:
+                    GetSSE2Kernels(Kernels);
+                    break;
+#endif
+                default:
+                    set = InstructionSet::Scalar;
+                    GetScalarKernels(Kernels);
+                    break;
+                }
+
+                Current = set;
+            }
+
+            KernelTable Kernels;
+            InstructionSet Best;
+            InstructionSet Current;
+        };
+
+        static Dispatcher& GetDispatcher()
+        {
+            static Dispatcher dispatcher;
+            return dispatcher;
+        }
+
+        static const KernelTable& GetKernels()
+        {
+            return GetDispatcher().Kernels;
+        }
+
+        InstructionSet GetInstructionSet()
+        {
+            return GetDispatcher().Current;
+        }
+
+        InstructionSet GetBestInstructionSet()
+        {
+            return GetDispatcher().Best;
+        }
+
+        void SetInstructionSet(InstructionSet set)
+        {
+            GetDispatcher().Select(set);
+        }
+
+        const char* GetInstructionSetName(InstructionSet set)
+        {
+            switch(set)
+            {
+            case InstructionSet::AVX2:
+                return "AVX2";
+            case InstructionSet::SSE2:
+                return "SSE2";
+            default:
+                return "Scalar";
+            }
+        }
+
+        static ConstVector3Streams ToStreams(const Vector3Stream& stream)
+        {
+            return { stream.x.data(), stream.y.data(), stream.z.data() };
+        }
+
+        static Vector3Streams ToStreams(Vector3Stream& stream)
+        {
+            return { stream.x.data(), stream.y.data(), stream.z.data() };
+        }
+
+        static void GetPlanes(const Frustum& frustum, FrustumPlanes& planes)
+        {
+            for(uint32_t i = 0; i < 6; i++)
+            {
+                const Plane& plane = frustum.planes_[i];
+                planes.NormalX[i] = plane.normal_.x;
+                planes.NormalY[i] = plane.normal_.y;
+                planes.NormalZ[i] = plane.normal_.z;
+                planes.AbsNormalX[i] = plane.absNormal_.x;
+                planes.AbsNormalY[i] = plane.absNormal_.y;
+                planes.AbsNormalZ[i] = plane.absNormal_.z;
+                planes.D[i] = plane.d_;
+            }
+        }
+
+        void TransformPoints(const Matrix4& transform, const Vector3Stream& points, Vector3Stream& out)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            out.Resize(points.Size());
+            GetKernels().TransformPoints(&transform.m00_, ToStreams(points), ToStreams(out), points.Size());
+        }
+
+        void TransformPoints(const Matrix4& transform, const Vector3x4* points, Vector3x4* out, uint32_t blockCount)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            auto kernel = GetKernels().TransformPoints;
+            for(uint32_t i = 0; i < blockCount; i++)
+                kernel(&transform.m00_, { points[i].x, points[i].y, points[i].z }, { out[i].x, out[i].y, out[i].z }, 4);
+        }
+
+        void TransformPoints(const Matrix4& transform, const Vector3x8* points, Vector3x8* out, uint32_t blockCount)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            auto kernel = GetKernels().TransformPoints;
+            for(uint32_t i = 0; i < blockCount; i++)
+                kernel(&transform.m00_, { points[i].x, points[i].y, points[i].z }, { out[i].x, out[i].y, out[i].z }, 8);
+        }
+
+        void TransformBoundingBoxes(const Matrix4& transform, const BoundingBoxStream& boxes, BoundingBoxStream& out)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            out.Resize(boxes.Size());
+            GetKernels().TransformBoxes(&transform.m00_, ToStreams(boxes.Centre), ToStreams(boxes.Extent), ToStreams(out.Centre), ToStreams(out.Extent), boxes.Size());
+        }
+
+        void TransformBoundingBoxes(const Matrix4* transforms, const BoundingBox* boxes, uint32_t count, BoundingBoxStream& out)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            static_assert(sizeof(Matrix4) == MatrixStride * sizeof(float), "Matrix4 layout doesn't match the kernels");
+            static_assert(sizeof(BoundingBox) == BoxStride * sizeof(float), "BoundingBox layout doesn't match the kernels");
+
+            out.Resize(count);
+            if(count == 0)
+                return;
+
+            GetKernels().TransformBoxesPerObject(&transforms[0].m00_, &boxes[0].min_.x, ToStreams(out.Centre), ToStreams(out.Extent), count);
+        }
+
+        void IsInsideFast(const Frustum& frustum, const BoundingBoxStream& boxes, uint8_t* visible)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            FrustumPlanes planes;
+            GetPlanes(frustum, planes);
+            GetKernels().CullBoxes(planes, ToStreams(boxes.Centre), ToStreams(boxes.Extent), visible, boxes.Size());
+        }
+
+        void IsInsideFast(const Frustum& frustum, const SphereStream& spheres, uint8_t* visible)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            FrustumPlanes planes;
+            GetPlanes(frustum, planes);
+            GetKernels().CullSpheres(planes, ToStreams(spheres.Centre), spheres.Radius.data(), visible, spheres.Size());
+        }
+
+        //Deterministic values so runs can be compared
+        static float BenchmarkRandom(uint32_t& state, float min, float max)
+        {
+            state = state * 1664525u + 1013904223u;
+            return min + (max - min) * float(state >> 8) / float(1u << 24);
+        }
+
+        void RunBenchmarks(uint32_t count)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            const uint32_t iterations = 20;
+            uint32_t seed = 12345;
+
+            std::vector<Matrix4> transforms(count);
+            std::vector<BoundingBox> boxes(count);
+            std::vector<Sphere> spheres(count);
+            Vector3Stream points;
+            SphereStream sphereStream;
+            points.Resize(count);
+            sphereStream.Resize(count);
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                Vector3 position(BenchmarkRandom(seed, -100.0f, 100.0f), BenchmarkRandom(seed, -100.0f, 100.0f), BenchmarkRandom(seed, -100.0f, 100.0f));
+                Quaternion rotation(BenchmarkRandom(seed, 0.0f, 360.0f), Vector3(BenchmarkRandom(seed, -1.0f, 1.0f), 1.0f, BenchmarkRandom(seed, -1.0f, 1.0f)).Normalized());
+                Vector3 extent(BenchmarkRandom(seed, 0.1f, 4.0f), BenchmarkRandom(seed, 0.1f, 4.0f), BenchmarkRandom(seed, 0.1f, 4.0f));
+
+                transforms[i] = Matrix3x4(position, rotation, 1.0f).ToMatrix4();
+                boxes[i] = BoundingBox(-extent, extent);
+                spheres[i] = Sphere(position, extent.x);
+                points.Set(i, position);
+                sphereStream.Set(i, spheres[i]);
+            }
+
+            Frustum frustum;
+            frustum.Define(BoundingBox(Vector3(-50.0f, -50.0f, -50.0f), Vector3(50.0f, 50.0f, 50.0f)));
+            const Matrix4& transform = transforms[0];
+
+            //Per object reference results and timings
+            std::vector<BoundingBox> referenceBoxes(count);
+            std::vector<Vector3> referencePoints(count);
+            std::vector<uint8_t> referenceVisible(count);
+            std::vector<uint8_t> referenceSphereVisible(count);
+
+            Timer timer;
+            timer.GetTimedMS();
+            for(uint32_t it = 0; it < iterations; it++)
+                for(uint32_t i = 0; i < count; i++)
+                    referenceBoxes[i] = boxes[i].Transformed(transforms[i]);
+            const float boxReference = timer.GetTimedMS() / iterations;
+
+            const Matrix3x4 affine(transform);
+            timer.GetTimedMS();
+            for(uint32_t it = 0; it < iterations; it++)
+                for(uint32_t i = 0; i < count; i++)
+                    referencePoints[i] = affine * points.Get(i);
+            const float pointReference = timer.GetTimedMS() / iterations;
+
+            timer.GetTimedMS();
+            for(uint32_t it = 0; it < iterations; it++)
+                for(uint32_t i = 0; i < count; i++)
+                    referenceVisible[i] = frustum.IsInsideFast(referenceBoxes[i]) != OUTSIDE;
+            const float cullReference = timer.GetTimedMS() / iterations;
+
+            timer.GetTimedMS();
+            for(uint32_t it = 0; it < iterations; it++)
+                for(uint32_t i = 0; i < count; i++)
+                    referenceSphereVisible[i] = frustum.IsInsideFast(spheres[i]) != OUTSIDE;
+            const float sphereReference = timer.GetTimedMS() / iterations;
+
+            LUMOS_LOG_INFO("Batch maths benchmark, {0} elements, {1} iterations", count, iterations);
+            LUMOS_LOG_INFO("Per object : Transform Boxes {0:.3f}ms, Transform Points {1:.3f}ms, Cull Boxes {2:.3f}ms, Cull Spheres {3:.3f}ms", boxReference, pointReference, cullReference, sphereReference);
+
+            const InstructionSet previous = GetInstructionSet();
+            BoundingBoxStream boxStream;
+            Vector3Stream pointsOut;
+            std::vector<uint8_t> visible(count);
+            std::vector<uint8_t> sphereVisible(count);
+
+            for(uint32_t s = 0; s <= uint32_t(GetBestInstructionSet()); s++)
+            {
+                SetInstructionSet(InstructionSet(s));
+
+                timer.GetTimedMS();
+                for(uint32_t it = 0; it < iterations; it++)
+                    TransformBoundingBoxes(transforms.data(), boxes.data(), count, boxStream);
+                const float boxTime = timer.GetTimedMS() / iterations;
+
+                timer.GetTimedMS();
+                for(uint32_t it = 0; it < iterations; it++)
+                    TransformPoints(transform, points, pointsOut);
+                const float pointTime = timer.GetTimedMS() / iterations;
+
+                timer.GetTimedMS();
+                for(uint32_t it = 0; it < iterations; it++)
+                    IsInsideFast(frustum, boxStream, visible.data());
+                const float cullTime = timer.GetTimedMS() / iterations;
+
+                timer.GetTimedMS();
+                for(uint32_t it = 0; it < iterations; it++)
+                    IsInsideFast(frustum, sphereStream, sphereVisible.data());
+                const float sphereTime = timer.GetTimedMS() / iterations;
+
+                //Results should match the per object functions up to float rounding
+                const float tolerance = 0.001f;
+                uint32_t mismatches = 0;
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    BoundingBox box = boxStream.Get(i);
+                    if(!box.min_.Equals(referenceBoxes[i].min_, tolerance) || !box.max_.Equals(referenceBoxes[i].max_, tolerance))
+                        mismatches++;
+                    if(!pointsOut.Get(i).Equals(referencePoints[i], tolerance))
+                        mismatches++;
+                    if(visible[i] != referenceVisible[i] || sphereVisible[i] != referenceSphereVisible[i])
+                        mismatches++;
+                }
+
+                LUMOS_LOG_INFO("{0} : Transform Boxes {1:.3f}ms, Transform Points {2:.3f}ms, Cull Boxes {3:.3f}ms, Cull Spheres {4:.3f}ms, {5} mismatches",
+                    GetInstructionSetName(InstructionSet(s)), boxTime, pointTime, cullTime, sphereTime, mismatches);
+            }
+
+            SetInstructionSet(previous);
+        }
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include "Maths/Vector3.h"
+#include "Maths/Matrix4.h"
+#include "Maths/BoundingBox.h"
+#include "Maths/Sphere.h"
+#include "Maths/Frustum.h"
+#include "Core/Core.h"
+
+#include <vector>
+
+namespace Lumos::Maths
+{
+    /// Four Vector3s stored component by component, one SSE register per component.
+    struct alignas(16) Vector3x4
+    {
+        float x[4];
+        float y[4];
+        float z[4];
+
+        void Set(uint32_t lane, const Vector3& v) { x[lane] = v.x; y[lane] = v.y; z[lane] = v.z; }
+        Vector3 Get(uint32_t lane) const { return Vector3(x[lane], y[lane], z[lane]); }
+    };
+
+    /// Eight Vector3s stored component by component, one AVX register per component.
+    struct alignas(32) Vector3x8
+    {
+        float x[8];
+        float y[8];
+        float z[8];
+
+        void Set(uint32_t lane, const Vector3& v) { x[lane] = v.x; y[lane] = v.y; z[lane] = v.z; }
+        Vector3 Get(uint32_t lane) const { return Vector3(x[lane], y[lane], z[lane]); }
+    };
+
+    /// Any number of Vector3s as separate x, y and z arrays.
+    struct LUMOS_EXPORT Vector3Stream
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+
+        void Resize(uint32_t count);
+        uint32_t Size() const { return uint32_t(x.size()); }
+        void Set(uint32_t index, const Vector3& v) { x[index] = v.x; y[index] = v.y; z[index] = v.z; }
+        Vector3 Get(uint32_t index) const { return Vector3(x[index], y[index], z[index]); }
+    };
+
+    /// Bounding boxes as centre and half extent streams, the form the transform and frustum kernels work in.
+    struct LUMOS_EXPORT BoundingBoxStream
+    {
+        Vector3Stream Centre;
+        Vector3Stream Extent;
+
+        void Resize(uint32_t count);
+        uint32_t Size() const { return Centre.Size(); }
+        void Set(uint32_t index, const BoundingBox& box);
+        BoundingBox Get(uint32_t index) const;
+    };
+
+    /// Spheres as centre and radius streams.
+    struct LUMOS_EXPORT SphereStream
+    {
+        Vector3Stream Centre;
+        std::vector<float> Radius;
+
+        void Resize(uint32_t count);
+        uint32_t Size() const { return Centre.Size(); }
+        void Set(uint32_t index, const Sphere& sphere);
+    };
+
+    /// Batched versions of the per object transform and frustum functions. The widest instruction set
+    /// the cpu supports is picked the first time any of them is called.
+    namespace Batch
+    {
+        enum class InstructionSet
+        {
+            Scalar,
+            SSE2,
+            AVX2
+        };
+
+        LUMOS_EXPORT InstructionSet GetInstructionSet();
+        LUMOS_EXPORT InstructionSet GetBestInstructionSet();
+        LUMOS_EXPORT const char* GetInstructionSetName(InstructionSet set);
+
+        /// Falls back to the best supported set if the cpu lacks the one requested. Not thread safe,
+        /// meant for benchmarks and debugging.
+        LUMOS_EXPORT void SetInstructionSet(InstructionSet set);
+
+        /// Affine transform of points, only the first three rows of the matrix are used.
+        LUMOS_EXPORT void TransformPoints(const Matrix4& transform, const Vector3Stream& points, Vector3Stream& out);
+        LUMOS_EXPORT void TransformPoints(const Matrix4& transform, const Vector3x4* points, Vector3x4* out, uint32_t blockCount);
+        LUMOS_EXPORT void TransformPoints(const Matrix4& transform, const Vector3x8* points, Vector3x8* out, uint32_t blockCount);
+
+        /// Same result as BoundingBox::Transformed for every box.
+        LUMOS_EXPORT void TransformBoundingBoxes(const Matrix4& transform, const BoundingBoxStream& boxes, BoundingBoxStream& out);
+
+        /// Transforms boxes[i] by transforms[i], out is resized to count.
+        LUMOS_EXPORT void TransformBoundingBoxes(const Matrix4* transforms, const BoundingBox* boxes, uint32_t count, BoundingBoxStream& out);
+
+        /// visible[i] is 1 unless Frustum::IsInsideFast would return OUTSIDE for the box or sphere.
+        LUMOS_EXPORT void IsInsideFast(const Frustum& frustum, const BoundingBoxStream& boxes, uint8_t* visible);
+        LUMOS_EXPORT void IsInsideFast(const Frustum& frustum, const SphereStream& spheres, uint8_t* visible);
+
+        /// Times each batch function with every supported instruction set against the per object
+        /// functions it replaces and logs the results.
+        LUMOS_EXPORT void RunBenchmarks(uint32_t count = 65536);
+    }
+}
@@ -0,0 +1,199 @@
+//Built with AVX2 and FMA enabled and without the precompiled header, see premake5.lua.
+//Only selected at runtime when the cpu supports it, so nothing from the engine headers may be included here.
+#include "BatchMathsKernels.h"
+
+#if defined(LUMOS_SSE)
+#include <immintrin.h>
+
+namespace Lumos::Maths::BatchKernels
+{
+    namespace AVX2
+    {
+        static inline __m256 Abs(__m256 v)
+        {
+            return _mm256_and_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)));
+        }
+
+        //a * x + b * y + c * z + d
+        static inline __m256 Dot(__m256 a, __m256 b, __m256 c, __m256 d, __m256 x, __m256 y, __m256 z)
+        {
+            return _mm256_fmadd_ps(a, x, _mm256_fmadd_ps(b, y, _mm256_fmadd_ps(c, z, d)));
+        }
+
+        //Eight bytes, 1 where the lane of the outside mask is clear
+        static inline void StoreVisible(__m256 outside, uint8_t* visible)
+        {
+            const int mask = _mm256_movemask_ps(outside);
+            for(int lane = 0; lane < 8; lane++)
+                visible[lane] = uint8_t((mask & (1 << lane)) == 0);
+        }
+
+        //Element column of four consecutive rows each for two groups of four objects
+        static inline void LoadTransposed(const float* data, uint32_t stride, __m256& r0, __m256& r1, __m256& r2, __m256& r3)
+        {
+            __m128 a0 = _mm_loadu_ps(data), a1 = _mm_loadu_ps(data + stride), a2 = _mm_loadu_ps(data + stride * 2), a3 = _mm_loadu_ps(data + stride * 3);
+            _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+            const float* high = data + stride * 4;
+            __m128 b0 = _mm_loadu_ps(high), b1 = _mm_loadu_ps(high + stride), b2 = _mm_loadu_ps(high + stride * 2), b3 = _mm_loadu_ps(high + stride * 3);
+            _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+
+            r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(a0), b0, 1);
+            r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(a1), b1, 1);
+            r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(a2), b2, 1);
+            r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(a3), b3, 1);
+        }
+
+        static void TransformPoints(const float* m, ConstVector3Streams in, Vector3Streams out, uint32_t count)
+        {
+            const __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]), m3 = _mm256_set1_ps(m[3]);
+            const __m256 m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]), m6 = _mm256_set1_ps(m[6]), m7 = _mm256_set1_ps(m[7]);
+            const __m256 m8 = _mm256_set1_ps(m[8]), m9 = _mm256_set1_ps(m[9]), m10 = _mm256_set1_ps(m[10]), m11 = _mm256_set1_ps(m[11]);
+
+            uint32_t i = 0;
+            for(; i + 8 <= count; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(in.x + i);
+                const __m256 y = _mm256_loadu_ps(in.y + i);
+                const __m256 z = _mm256_loadu_ps(in.z + i);
+                _mm256_storeu_ps(out.x + i, Dot(m0, m1, m2, m3, x, y, z));
+                _mm256_storeu_ps(out.y + i, Dot(m4, m5, m6, m7, x, y, z));
+                _mm256_storeu_ps(out.z + i, Dot(m8, m9, m10, m11, x, y, z));
+            }
+
+            Scalar::TransformPoints(m, { in.x + i, in.y + i, in.z + i }, { out.x + i, out.y + i, out.z + i }, count - i);
+        }
+
+        static void TransformBoxes(const float* m, ConstVector3Streams centres, ConstVector3Streams extents, Vector3Streams outCentres, Vector3Streams outExtents, uint32_t count)
+        {
+            const __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]), m3 = _mm256_set1_ps(m[3]);
+            const __m256 m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]), m6 = _mm256_set1_ps(m[6]), m7 = _mm256_set1_ps(m[7]);
+            const __m256 m8 = _mm256_set1_ps(m[8]), m9 = _mm256_set1_ps(m[9]), m10 = _mm256_set1_ps(m[10]), m11 = _mm256_set1_ps(m[11]);
+            const __m256 a0 = Abs(m0), a1 = Abs(m1), a2 = Abs(m2);
+            const __m256 a4 = Abs(m4), a5 = Abs(m5), a6 = Abs(m6);
+            const __m256 a8 = Abs(m8), a9 = Abs(m9), a10 = Abs(m10);
+            const __m256 zero = _mm256_setzero_ps();
+
+            uint32_t i = 0;
+            for(; i + 8 <= count; i += 8)
+            {
+                const __m256 cx = _mm256_loadu_ps(centres.x + i);
+                const __m256 cy = _mm256_loadu_ps(centres.y + i);
+                const __m256 cz = _mm256_loadu_ps(centres.z + i);
+                const __m256 ex = _mm256_loadu_ps(extents.x + i);
+                const __m256 ey = _mm256_loadu_ps(extents.y + i);
+                const __m256 ez = _mm256_loadu_ps(extents.z + i);
+                _mm256_storeu_ps(outCentres.x + i, Dot(m0, m1, m2, m3, cx, cy, cz));
+                _mm256_storeu_ps(outCentres.y + i, Dot(m4, m5, m6, m7, cx, cy, cz));
+                _mm256_storeu_ps(outCentres.z + i, Dot(m8, m9, m10, m11, cx, cy, cz));
+                _mm256_storeu_ps(outExtents.x + i, Dot(a0, a1, a2, zero, ex, ey, ez));
+                _mm256_storeu_ps(outExtents.y + i, Dot(a4, a5, a6, zero, ex, ey, ez));
+                _mm256_storeu_ps(outExtents.z + i, Dot(a8, a9, a10, zero, ex, ey, ez));
+            }
+
+            Scalar::TransformBoxes(m, { centres.x + i, centres.y + i, centres.z + i }, { extents.x + i, extents.y + i, extents.z + i },
+                { outCentres.x + i, outCentres.y + i, outCentres.z + i }, { outExtents.x + i, outExtents.y + i, outExtents.z + i }, count - i);
+        }
+
+        static void TransformBoxesPerObject(const float* matrices, const float* boxes, Vector3Streams outCentres, Vector3Streams outExtents, uint32_t count)
+        {
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 zero = _mm256_setzero_ps();
+
+            uint32_t i = 0;
+            for(; i + 8 <= count; i += 8)
+            {
+                const float* m = matrices + i * MatrixStride;
+                const float* b = boxes + i * BoxStride;
+
+                __m256 m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11;
+                LoadTransposed(m, MatrixStride, m0, m1, m2, m3);
+                LoadTransposed(m + 4, MatrixStride, m4, m5, m6, m7);
+                LoadTransposed(m + 8, MatrixStride, m8, m9, m10, m11);
+
+                __m256 minX, minY, minZ, minW, maxX, maxY, maxZ, maxW;
+                LoadTransposed(b, BoxStride, minX, minY, minZ, minW);
+                LoadTransposed(b + 4, BoxStride, maxX, maxY, maxZ, maxW);
+
+                const __m256 cx = _mm256_mul_ps(_mm256_add_ps(minX, maxX), half);
+                const __m256 cy = _mm256_mul_ps(_mm256_add_ps(minY, maxY), half);
+                const __m256 cz = _mm256_mul_ps(_mm256_add_ps(minZ, maxZ), half);
+                const __m256 ex = _mm256_sub_ps(maxX, cx);
+                const __m256 ey = _mm256_sub_ps(maxY, cy);
+                const __m256 ez = _mm256_sub_ps(maxZ, cz);
+
+                _mm256_storeu_ps(outCentres.x + i, Dot(m0, m1, m2, m3, cx, cy, cz));
+                _mm256_storeu_ps(outCentres.y + i, Dot(m4, m5, m6, m7, cx, cy, cz));
+                _mm256_storeu_ps(outCentres.z + i, Dot(m8, m9, m10, m11, cx, cy, cz));
+                _mm256_storeu_ps(outExtents.x + i, Dot(Abs(m0), Abs(m1), Abs(m2), zero, ex, ey, ez));
+                _mm256_storeu_ps(outExtents.y + i, Dot(Abs(m4), Abs(m5), Abs(m6), zero, ex, ey, ez));
+                _mm256_storeu_ps(outExtents.z + i, Dot(Abs(m8), Abs(m9), Abs(m10), zero, ex, ey, ez));
+            }
+
+            Scalar::TransformBoxesPerObject(matrices + i * MatrixStride, boxes + i * BoxStride,
+                { outCentres.x + i, outCentres.y + i, outCentres.z + i }, { outExtents.x + i, outExtents.y + i, outExtents.z + i }, count - i);
+        }
+
+        static void CullBoxes(const FrustumPlanes& planes, ConstVector3Streams centres, ConstVector3Streams extents, uint8_t* visible, uint32_t count)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+
+            uint32_t i = 0;
+            for(; i + 8 <= count; i += 8)
+            {
+                const __m256 cx = _mm256_loadu_ps(centres.x + i);
+                const __m256 cy = _mm256_loadu_ps(centres.y + i);
+                const __m256 cz = _mm256_loadu_ps(centres.z + i);
+                const __m256 ex = _mm256_loadu_ps(extents.x + i);
+                const __m256 ey = _mm256_loadu_ps(extents.y + i);
+                const __m256 ez = _mm256_loadu_ps(extents.z + i);
+
+                __m256 outside = zero;
+                for(uint32_t p = 0; p < 6; p++)
+                {
+                    const __m256 dist = Dot(_mm256_set1_ps(planes.NormalX[p]), _mm256_set1_ps(planes.NormalY[p]), _mm256_set1_ps(planes.NormalZ[p]), _mm256_set1_ps(planes.D[p]), cx, cy, cz);
+                    const __m256 absDist = Dot(_mm256_set1_ps(planes.AbsNormalX[p]), _mm256_set1_ps(planes.AbsNormalY[p]), _mm256_set1_ps(planes.AbsNormalZ[p]), zero, ex, ey, ez);
+                    outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, _mm256_sub_ps(zero, absDist), _CMP_LT_OQ));
+                }
+
+                StoreVisible(outside, visible + i);
+            }
+
+            Scalar::CullBoxes(planes, { centres.x + i, centres.y + i, centres.z + i }, { extents.x + i, extents.y + i, extents.z + i }, visible + i, count - i);
+        }
+
+        static void CullSpheres(const FrustumPlanes& planes, ConstVector3Streams centres, const float* radii, uint8_t* visible, uint32_t count)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+
+            uint32_t i = 0;
+            for(; i + 8 <= count; i += 8)
+            {
+                const __m256 cx = _mm256_loadu_ps(centres.x + i);
+                const __m256 cy = _mm256_loadu_ps(centres.y + i);
+                const __m256 cz = _mm256_loadu_ps(centres.z + i);
+                const __m256 negRadius = _mm256_sub_ps(zero, _mm256_loadu_ps(radii + i));
+
+                __m256 outside = zero;
+                for(uint32_t p = 0; p < 6; p++)
+                {
+                    const __m256 dist = Dot(_mm256_set1_ps(planes.NormalX[p]), _mm256_set1_ps(planes.NormalY[p]), _mm256_set1_ps(planes.NormalZ[p]), _mm256_set1_ps(planes.D[p]), cx, cy, cz);
+                    outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, negRadius, _CMP_LT_OQ));
+                }
+
+                StoreVisible(outside, visible + i);
+            }
+
+            Scalar::CullSpheres(planes, { centres.x + i, centres.y + i, centres.z + i }, radii + i, visible + i, count - i);
+        }
+    }
+
+    void GetAVX2Kernels(KernelTable& table)
+    {
+        table.TransformPoints = AVX2::TransformPoints;
+        table.TransformBoxes = AVX2::TransformBoxes;
+        table.TransformBoxesPerObject = AVX2::TransformBoxesPerObject;
+        table.CullBoxes = AVX2::CullBoxes;
+        table.CullSpheres = AVX2::CullSpheres;
+    }
+}
+#endif
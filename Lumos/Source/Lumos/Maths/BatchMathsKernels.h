@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+
+//Kernels behind the Maths::Batch functions. Only plain types cross this boundary so the AVX2
+//translation unit, which is built with wider instruction set flags, never emits inline engine code
+//that the linker could pick over the baseline version.
+namespace Lumos::Maths::BatchKernels
+{
+    //Separate x, y, z arrays
+    struct Vector3Streams
+    {
+        float* x;
+        float* y;
+        float* z;
+    };
+
+    struct ConstVector3Streams
+    {
+        const float* x;
+        const float* y;
+        const float* z;
+    };
+
+    //Frustum planes split by component so each can be broadcast
+    struct FrustumPlanes
+    {
+        float NormalX[6], NormalY[6], NormalZ[6];
+        float AbsNormalX[6], AbsNormalY[6], AbsNormalZ[6];
+        float D[6];
+    };
+
+    struct KernelTable
+    {
+        //matrix is a row major 3x4 affine transform (the first three rows of a Matrix4)
+        void (*TransformPoints)(const float* matrix, ConstVector3Streams in, Vector3Streams out, uint32_t count);
+
+        //Centre / half extent boxes by a single transform
+        void (*TransformBoxes)(const float* matrix, ConstVector3Streams centres, ConstVector3Streams extents, Vector3Streams outCentres, Vector3Streams outExtents, uint32_t count);
+
+        //Min / max boxes laid out like BoundingBox (8 floats apart) each by its own Matrix4 (16 floats apart)
+        void (*TransformBoxesPerObject)(const float* matrices, const float* boxes, Vector3Streams outCentres, Vector3Streams outExtents, uint32_t count);
+
+        //Writes 1 for boxes that are at least partially inside, 0 otherwise
+        void (*CullBoxes)(const FrustumPlanes& planes, ConstVector3Streams centres, ConstVector3Streams extents, uint8_t* visible, uint32_t count);
+        void (*CullSpheres)(const FrustumPlanes& planes, ConstVector3Streams centres, const float* radii, uint8_t* visible, uint32_t count);
+    };
+
+    //The SIMD versions use these for the elements left over after the last full register
+    namespace Scalar
+    {
+        void TransformPoints(const float* matrix, ConstVector3Streams in, Vector3Streams out, uint32_t count);
+        void TransformBoxes(const float* matrix, ConstVector3Streams centres, ConstVector3Streams extents, Vector3Streams outCentres, Vector3Streams outExtents, uint32_t count);
+        void TransformBoxesPerObject(const float* matrices, const float* boxes, Vector3Streams outCentres, Vector3Streams outExtents, uint32_t count);
+        void CullBoxes(const FrustumPlanes& planes, ConstVector3Streams centres, ConstVector3Streams extents, uint8_t* visible, uint32_t count);
+        void CullSpheres(const FrustumPlanes& planes, ConstVector3Streams centres, const float* radii, uint8_t* visible, uint32_t count);
+    }
+
+    void GetScalarKernels(KernelTable& table);
+    void GetSSE2Kernels(KernelTable& table);
+    void GetAVX2Kernels(KernelTable& table);
+
+    //Matrix4 and BoundingBox strides in floats
+    static constexpr uint32_t MatrixStride = 16;
+    static constexpr uint32_t BoxStride = 8;
+}
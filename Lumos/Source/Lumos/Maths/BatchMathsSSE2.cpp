@@ -0,0 +1,184 @@
+#include "Precompiled.h"
+#include "BatchMathsKernels.h"
+
+#if defined(LUMOS_SSE)
+#include <emmintrin.h>
+
+namespace Lumos::Maths::BatchKernels
+{
+    namespace SSE2
+    {
+        static inline __m128 Abs(__m128 v)
+        {
+            return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)));
+        }
+
+        //a * x + b * y + c * z
+        static inline __m128 Dot(__m128 a, __m128 b, __m128 c, __m128 x, __m128 y, __m128 z)
+        {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x), _mm_mul_ps(b, y)), _mm_mul_ps(c, z));
+        }
+
+        //Four bytes, 1 where the lane of the outside mask is clear
+        static inline void StoreVisible(__m128 outside, uint8_t* visible)
+        {
+            const int mask = _mm_movemask_ps(outside);
+            visible[0] = uint8_t((mask & 1) == 0);
+            visible[1] = uint8_t((mask & 2) == 0);
+            visible[2] = uint8_t((mask & 4) == 0);
+            visible[3] = uint8_t((mask & 8) == 0);
+        }
+
+        static void TransformPoints(const float* m, ConstVector3Streams in, Vector3Streams out, uint32_t count)
+        {
+            const __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]), m3 = _mm_set1_ps(m[3]);
+            const __m128 m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]), m6 = _mm_set1_ps(m[6]), m7 = _mm_set1_ps(m[7]);
+            const __m128 m8 = _mm_set1_ps(m[8]), m9 = _mm_set1_ps(m[9]), m10 = _mm_set1_ps(m[10]), m11 = _mm_set1_ps(m[11]);
+
+            uint32_t i = 0;
+            for(; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(in.x + i);
+                const __m128 y = _mm_loadu_ps(in.y + i);
+                const __m128 z = _mm_loadu_ps(in.z + i);
+                _mm_storeu_ps(out.x + i, _mm_add_ps(Dot(m0, m1, m2, x, y, z), m3));
+                _mm_storeu_ps(out.y + i, _mm_add_ps(Dot(m4, m5, m6, x, y, z), m7));
+                _mm_storeu_ps(out.z + i, _mm_add_ps(Dot(m8, m9, m10, x, y, z), m11));
+            }
+
+            Scalar::TransformPoints(m, { in.x + i, in.y + i, in.z + i }, { out.x + i, out.y + i, out.z + i }, count - i);
+        }
+
+        static void TransformBoxes(const float* m, ConstVector3Streams centres, ConstVector3Streams extents, Vector3Streams outCentres, Vector3Streams outExtents, uint32_t count)
+        {
+            const __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]), m3 = _mm_set1_ps(m[3]);
+            const __m128 m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]), m6 = _mm_set1_ps(m[6]), m7 = _mm_set1_ps(m[7]);
+            const __m128 m8 = _mm_set1_ps(m[8]), m9 = _mm_set1_ps(m[9]), m10 = _mm_set1_ps(m[10]), m11 = _mm_set1_ps(m[11]);
+            const __m128 a0 = Abs(m0), a1 = Abs(m1), a2 = Abs(m2);
+            const __m128 a4 = Abs(m4), a5 = Abs(m5), a6 = Abs(m6);
+            const __m128 a8 = Abs(m8), a9 = Abs(m9), a10 = Abs(m10);
+
+            uint32_t i = 0;
+            for(; i + 4 <= count; i += 4)
+            {
+                const __m128 cx = _mm_loadu_ps(centres.x + i);
+                const __m128 cy = _mm_loadu_ps(centres.y + i);
+                const __m128 cz = _mm_loadu_ps(centres.z + i);
+                const __m128 ex = _mm_loadu_ps(extents.x + i);
+                const __m128 ey = _mm_loadu_ps(extents.y + i);
+                const __m128 ez = _mm_loadu_ps(extents.z + i);
+                _mm_storeu_ps(outCentres.x + i, _mm_add_ps(Dot(m0, m1, m2, cx, cy, cz), m3));
+                _mm_storeu_ps(outCentres.y + i, _mm_add_ps(Dot(m4, m5, m6, cx, cy, cz), m7));
+                _mm_storeu_ps(outCentres.z + i, _mm_add_ps(Dot(m8, m9, m10, cx, cy, cz), m11));
+                _mm_storeu_ps(outExtents.x + i, Dot(a0, a1, a2, ex, ey, ez));
+                _mm_storeu_ps(outExtents.y + i, Dot(a4, a5, a6, ex, ey, ez));
+                _mm_storeu_ps(outExtents.z + i, Dot(a8, a9, a10, ex, ey, ez));
+            }
+
+            Scalar::TransformBoxes(m, { centres.x + i, centres.y + i, centres.z + i }, { extents.x + i, extents.y + i, extents.z + i },
+                { outCentres.x + i, outCentres.y + i, outCentres.z + i }, { outExtents.x + i, outExtents.y + i, outExtents.z + i }, count - i);
+        }
+
+        static void TransformBoxesPerObject(const float* matrices, const float* boxes, Vector3Streams outCentres, Vector3Streams outExtents, uint32_t count)
+        {
+            const __m128 half = _mm_set1_ps(0.5f);
+
+            uint32_t i = 0;
+            for(; i + 4 <= count; i += 4)
+            {
+                const float* m = matrices + i * MatrixStride;
+                const float* b = boxes + i * BoxStride;
+
+                //Transpose four objects' rows so each register holds one matrix element for all four
+                __m128 m0 = _mm_loadu_ps(m), m1 = _mm_loadu_ps(m + MatrixStride), m2 = _mm_loadu_ps(m + MatrixStride * 2), m3 = _mm_loadu_ps(m + MatrixStride * 3);
+                _MM_TRANSPOSE4_PS(m0, m1, m2, m3);
+                __m128 m4 = _mm_loadu_ps(m + 4), m5 = _mm_loadu_ps(m + MatrixStride + 4), m6 = _mm_loadu_ps(m + MatrixStride * 2 + 4), m7 = _mm_loadu_ps(m + MatrixStride * 3 + 4);
+                _MM_TRANSPOSE4_PS(m4, m5, m6, m7);
+                __m128 m8 = _mm_loadu_ps(m + 8), m9 = _mm_loadu_ps(m + MatrixStride + 8), m10 = _mm_loadu_ps(m + MatrixStride * 2 + 8), m11 = _mm_loadu_ps(m + MatrixStride * 3 + 8);
+                _MM_TRANSPOSE4_PS(m8, m9, m10, m11);
+
+                __m128 minX = _mm_loadu_ps(b), minY = _mm_loadu_ps(b + BoxStride), minZ = _mm_loadu_ps(b + BoxStride * 2), minW = _mm_loadu_ps(b + BoxStride * 3);
+                _MM_TRANSPOSE4_PS(minX, minY, minZ, minW);
+                __m128 maxX = _mm_loadu_ps(b + 4), maxY = _mm_loadu_ps(b + BoxStride + 4), maxZ = _mm_loadu_ps(b + BoxStride * 2 + 4), maxW = _mm_loadu_ps(b + BoxStride * 3 + 4);
+                _MM_TRANSPOSE4_PS(maxX, maxY, maxZ, maxW);
+
+                const __m128 cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+                const __m128 cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+                const __m128 cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+                const __m128 ex = _mm_sub_ps(maxX, cx);
+                const __m128 ey = _mm_sub_ps(maxY, cy);
+                const __m128 ez = _mm_sub_ps(maxZ, cz);
+
+                _mm_storeu_ps(outCentres.x + i, _mm_add_ps(Dot(m0, m1, m2, cx, cy, cz), m3));
+                _mm_storeu_ps(outCentres.y + i, _mm_add_ps(Dot(m4, m5, m6, cx, cy, cz), m7));
+                _mm_storeu_ps(outCentres.z + i, _mm_add_ps(Dot(m8, m9, m10, cx, cy, cz), m11));
+                _mm_storeu_ps(outExtents.x + i, Dot(Abs(m0), Abs(m1), Abs(m2), ex, ey, ez));
+                _mm_storeu_ps(outExtents.y + i, Dot(Abs(m4), Abs(m5), Abs(m6), ex, ey, ez));
+                _mm_storeu_ps(outExtents.z + i, Dot(Abs(m8), Abs(m9), Abs(m10), ex, ey, ez));
+            }
+
+            Scalar::TransformBoxesPerObject(matrices + i * MatrixStride, boxes + i * BoxStride,
+                { outCentres.x + i, outCentres.y + i, outCentres.z + i }, { outExtents.x + i, outExtents.y + i, outExtents.z + i }, count - i);
+        }
+
+        static void CullBoxes(const FrustumPlanes& planes, ConstVector3Streams centres, ConstVector3Streams extents, uint8_t* visible, uint32_t count)
+        {
+            uint32_t i = 0;
+            for(; i + 4 <= count; i += 4)
+            {
+                const __m128 cx = _mm_loadu_ps(centres.x + i);
+                const __m128 cy = _mm_loadu_ps(centres.y + i);
+                const __m128 cz = _mm_loadu_ps(centres.z + i);
+                const __m128 ex = _mm_loadu_ps(extents.x + i);
+                const __m128 ey = _mm_loadu_ps(extents.y + i);
+                const __m128 ez = _mm_loadu_ps(extents.z + i);
+
+                __m128 outside = _mm_setzero_ps();
+                for(uint32_t p = 0; p < 6; p++)
+                {
+                    const __m128 dist = _mm_add_ps(Dot(_mm_set1_ps(planes.NormalX[p]), _mm_set1_ps(planes.NormalY[p]), _mm_set1_ps(planes.NormalZ[p]), cx, cy, cz), _mm_set1_ps(planes.D[p]));
+                    const __m128 absDist = Dot(_mm_set1_ps(planes.AbsNormalX[p]), _mm_set1_ps(planes.AbsNormalY[p]), _mm_set1_ps(planes.AbsNormalZ[p]), ex, ey, ez);
+
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_sub_ps(_mm_setzero_ps(), absDist)));
+                }
+
+                StoreVisible(outside, visible + i);
+            }
+
+            Scalar::CullBoxes(planes, { centres.x + i, centres.y + i, centres.z + i }, { extents.x + i, extents.y + i, extents.z + i }, visible + i, count - i);
+        }
+
+        static void CullSpheres(const FrustumPlanes& planes, ConstVector3Streams centres, const float* radii, uint8_t* visible, uint32_t count)
+        {
+            uint32_t i = 0;
+            for(; i + 4 <= count; i += 4)
+            {
+                const __m128 cx = _mm_loadu_ps(centres.x + i);
+                const __m128 cy = _mm_loadu_ps(centres.y + i);
+                const __m128 cz = _mm_loadu_ps(centres.z + i);
+                const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radii + i));
+
+                __m128 outside = _mm_setzero_ps();
+                for(uint32_t p = 0; p < 6; p++)
+                {
+                    const __m128 dist = _mm_add_ps(Dot(_mm_set1_ps(planes.NormalX[p]), _mm_set1_ps(planes.NormalY[p]), _mm_set1_ps(planes.NormalZ[p]), cx, cy, cz), _mm_set1_ps(planes.D[p]));
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, negRadius));
+                }
+
+                StoreVisible(outside, visible + i);
+            }
+
+            Scalar::CullSpheres(planes, { centres.x + i, centres.y + i, centres.z + i }, radii + i, visible + i, count - i);
+        }
+    }
+
+    void GetSSE2Kernels(KernelTable& table)
+    {
+        table.TransformPoints = SSE2::TransformPoints;
+        table.TransformBoxes = SSE2::TransformBoxes;
+        table.TransformBoxesPerObject = SSE2::TransformBoxesPerObject;
+        table.CullBoxes = SSE2::CullBoxes;
+        table.CullSpheres = SSE2::CullSpheres;
+    }
+}
+#endif
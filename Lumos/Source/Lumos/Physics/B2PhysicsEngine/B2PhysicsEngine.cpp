@@ -3,6 +3,7 @@
 #include "RigidBody2D.h"
 
 #include "Utilities/TimeStep.h"
+#include "Utilities/Timer.h"
  
 #include "Scene/Component/Physics2DComponent.h"
 
@@ -38,12 +39,14 @@ namespace Lumos
 
 	B2PhysicsEngine::~B2PhysicsEngine()
 	{
+		SyncStep();
 		if(m_Listener)
 			delete m_Listener;
 	}
 
 	void B2PhysicsEngine::SetDefaults()
 	{
+		SyncStep();
 		m_UpdateTimestep = 1.0f / 60.f;
 		m_UpdateAccum = 0.0f;
 	}
@@ -51,45 +54,89 @@ namespace Lumos
 	void B2PhysicsEngine::OnUpdate(const TimeStep& timeStep, Scene* scene)
 	{
 		LUMOS_PROFILE_FUNCTION();
-		const int max_updates_per_frame = 5;
+		SyncStep();
 
-		if(!m_Paused)
+		if(m_Paused)
+			return;
+
+		//Rendering runs up to a step behind the simulation, blending the states either side of the last step
+		const float alpha = Maths::Min(m_UpdateAccum / m_UpdateTimestep, 1.0f);
+
+		auto& registry = scene->GetRegistry();
+		auto group = registry.group<Physics2DComponent>(entt::get<Maths::Transform>);
+
+		for(auto entity : group)
 		{
-			if(m_MultipleUpdates)
-			{
-				m_UpdateAccum += timeStep.GetSeconds();
-				for(int i = 0; (m_UpdateAccum >= m_UpdateTimestep) && i < max_updates_per_frame; ++i)
-				{
-					m_UpdateAccum -= m_UpdateTimestep;
-					m_B2DWorld->Step(m_UpdateTimestep, 6, 2);
-				}
-
-				if(m_UpdateAccum >= m_UpdateTimestep)
-				{
-					LUMOS_LOG_ERROR("Physics too slow to run in real time!");
-					//Drop Time in the hope that it can continue to run in real-time
-					m_UpdateAccum = 0.0f;
-				}
-			}
-			else
-				m_B2DWorld->Step(m_UpdateTimestep, 6, 2);
+			const auto& [phys, trans] = group.get<Physics2DComponent, Maths::Transform>(entity);
+			auto rigidBody = phys.GetRigidBody();
 
-			auto& registry = scene->GetRegistry();
+			const Maths::Vector2 position = rigidBody->GetPreviousPosition().Lerp(rigidBody->GetPosition(), alpha);
+			const float angle = Maths::Lerp(rigidBody->GetPreviousAngle(), rigidBody->GetAngle(), alpha);
 
-			auto group = registry.group<Physics2DComponent>(entt::get<Maths::Transform>);
+			trans.SetLocalPosition(Maths::Vector3(position, 0.0f));
+			trans.SetLocalOrientation(Maths::Quaternion::EulerAnglesToQuaternion(0.0f, 0.0f, angle * Maths::M_RADTODEG));
+			trans.SetWorldMatrix(Maths::Matrix4()); // temp
+		};
+	}
 
-			for(auto entity : group)
-			{
-				const auto& [phys, trans] = group.get<Physics2DComponent, Maths::Transform>(entity);
+	void B2PhysicsEngine::OnLateUpdate(const TimeStep& timeStep, Scene* scene)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		if(m_Paused)
+			return;
 
-				// if (!phys.GetRigidBody()->GetB2Body()->IsAwake())
-				//     break;
+		SyncStep();
+		const uint32_t maxStepsPerFrame = 5;
 
-				trans.SetLocalPosition(Maths::Vector3(phys.GetRigidBody()->GetPosition(), 0.0f));
-				trans.SetLocalOrientation(Maths::Quaternion::EulerAnglesToQuaternion(0.0f, 0.0f, phys.GetRigidBody()->GetAngle() * Maths::M_RADTODEG));
-				trans.SetWorldMatrix(Maths::Matrix4()); // temp
-			};
+		m_StepCount = 0;
+		m_UpdateAccum += timeStep.GetSeconds();
+		while(m_UpdateAccum >= m_UpdateTimestep && m_StepCount < maxStepsPerFrame)
+		{
+			m_UpdateAccum -= m_UpdateTimestep;
+			m_StepCount++;
 		}
+
+		if(m_UpdateAccum >= m_UpdateTimestep)
+		{
+			LUMOS_LOG_ERROR("Physics too slow to run in real time!");
+			//Drop Time in the hope that it can continue to run in real-time
+			m_UpdateAccum = 0.0f;
+		}
+
+		if(m_StepCount == 0)
+			return;
+
+		m_RigidBodys.clear();
+		auto group = scene->GetRegistry().group<Physics2DComponent>(entt::get<Maths::Transform>);
+		for(auto entity : group)
+			m_RigidBodys.push_back(group.get<Physics2DComponent>(entity).GetRigidBody());
+
+		//Contact listeners call back into scripts, which can't run off the main thread
+		const uint32_t steps = m_StepCount;
+		if(m_Listener)
+			StepPhysics(steps);
+		else
+			m_StepThread.Kick([this, steps]() { StepPhysics(steps); });
+	}
+
+	void B2PhysicsEngine::StepPhysics(uint32_t steps)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		Timer timer;
+
+		for(uint32_t i = 0; i < steps; i++)
+		{
+			//Interpolation only needs the state from before the last step
+			if(i == steps - 1)
+			{
+				for(auto& body : m_RigidBodys)
+					body->StorePreviousState();
+			}
+
+			m_B2DWorld->Step(m_UpdateTimestep, 6, 2);
+		}
+
+		m_StepTime = timer.GetElapsedMS();
 	}
 
 	void B2PhysicsEngine::OnImGui()
@@ -116,6 +163,14 @@ namespace Lumos
 		ImGui::PopItemWidth();
 		ImGui::NextColumn();
 
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Step Time (ms)");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Text("%5.3f (%u steps)", m_StepTime, m_StepCount);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+
 		ImGui::AlignTextToFramePadding();
 		ImGui::TextUnformatted("Paused");
 		ImGui::NextColumn();
@@ -139,8 +194,9 @@ namespace Lumos
 		ImGui::PopStyleVar();
 	}
 
-	b2Body* B2PhysicsEngine::CreateB2Body(b2BodyDef* bodyDef) const
+	b2Body* B2PhysicsEngine::CreateB2Body(b2BodyDef* bodyDef)
 	{
+		SyncStep();
 		return m_B2DWorld->CreateBody(bodyDef);
 	}
 
@@ -151,6 +207,11 @@ namespace Lumos
 
 	void B2PhysicsEngine::OnDebugDraw()
 	{
+		if(!m_DebugDraw->GetFlags())
+			return;
+
+		//Reads the world the physics thread is stepping
+		SyncStep();
 		m_B2DWorld->DebugDraw();
 	}
 
@@ -161,6 +222,7 @@ namespace Lumos
 	
 	void B2PhysicsEngine::SetGravity(const Maths::Vector2& gravity)
 	{
+		SyncStep();
 		m_B2DWorld->SetGravity({ gravity.x, gravity.y });
 	}
 
@@ -171,6 +233,7 @@ namespace Lumos
 
 	void B2PhysicsEngine::SetContactListener(b2ContactListener* listener)
 	{
+		SyncStep();
 		if(m_Listener)
 			delete m_Listener;
 
@@ -2,6 +2,7 @@
 
 #include "Utilities/TSingleton.h"
 #include "Scene/ISystem.h"
+#include "Physics/PhysicsThread.h"
 
 class b2World;
 class b2Body;
@@ -13,6 +14,7 @@ namespace Lumos
 {
 	class TimeStep;
 	class B2DebugDraw;
+	class RigidBody2D;
 
 	class LUMOS_EXPORT B2PhysicsEngine : public ISystem
 	{
@@ -23,20 +25,33 @@ namespace Lumos
 		~B2PhysicsEngine();
 		void SetDefaults();
 
+		//Finishes the steps started last frame and writes the interpolated body state to the transforms
 		void OnUpdate(const TimeStep& timeStep, Scene* scene) override;
+
+		//Starts this frame's fixed steps, on the physics thread unless a contact listener is set
+		void OnLateUpdate(const TimeStep& timeStep, Scene* scene) override;
+
 		void OnInit() override{};
 		void OnImGui() override;
 
-		b2World* GetB2World() const
+		//Waits for the steps in flight, the world can't be touched while it is stepping
+		void SyncStep()
 		{
+			m_StepThread.Wait();
+		}
+
+		b2World* GetB2World()
+		{
+			SyncStep();
 			return m_B2DWorld.get();
 		}
-		b2Body* CreateB2Body(b2BodyDef* bodyDef) const;
+		b2Body* CreateB2Body(b2BodyDef* bodyDef);
 
 		static void CreateFixture(b2Body* body, const b2FixtureDef* fixtureDef);
 
 		void SetPaused(bool paused)
 		{
+			SyncStep();
 			m_Paused = paused;
 		}
 		bool IsPaused() const
@@ -53,12 +68,18 @@ namespace Lumos
 		void SetContactListener(b2ContactListener* listener);
 
 	private:
+		void StepPhysics(uint32_t steps);
+
 		UniqueRef<b2World> m_B2DWorld;
 		UniqueRef<B2DebugDraw> m_DebugDraw;
 
 		float m_UpdateTimestep, m_UpdateAccum;
 		bool m_Paused = true;
-		bool m_MultipleUpdates = true;
+
+		std::vector<Ref<RigidBody2D>> m_RigidBodys;
+		PhysicsThread m_StepThread;
+		float m_StepTime = 0.0f;
+		uint32_t m_StepCount = 0;
 
 		b2ContactListener* m_Listener;
 	};
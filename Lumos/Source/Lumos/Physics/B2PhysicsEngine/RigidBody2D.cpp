@@ -128,6 +128,8 @@ namespace Lumos
 		{
 			LUMOS_LOG_ERROR("Shape Not Supported");
 		}
+
+		StorePreviousState();
 	}
 
 	Maths::Vector2 RigidBody2D::GetPosition() const
@@ -141,6 +143,12 @@ namespace Lumos
 		return m_B2Body->GetAngle();
 	}
 
+	void RigidBody2D::StorePreviousState()
+	{
+		m_PreviousPosition = GetPosition();
+		m_PreviousAngle = GetAngle();
+	}
+
     const Maths::Vector2 RigidBody2D::GetLinearVelocity() const
     {
         return Maths::Vector2(m_B2Body->GetLinearVelocity().x, m_B2Body->GetLinearVelocity().y);
@@ -46,6 +46,17 @@ namespace Lumos
 
 		Maths::Vector2 GetPosition() const;
 		float GetAngle() const;
+
+		//State before the last physics step, rendering interpolates from it towards the current state
+		const Maths::Vector2& GetPreviousPosition() const
+		{
+			return m_PreviousPosition;
+		}
+		float GetPreviousAngle() const
+		{
+			return m_PreviousAngle;
+		}
+		void StorePreviousState();
         Shape GetShapeType() const { return m_ShapeType; }
 
         void SetShape(Shape shape, const std::vector<Maths::Vector2>& customPositions = {} );
@@ -69,6 +80,7 @@ namespace Lumos
             params.position = Maths::Vector3(pos, 1.0f);
 			Init(params);
 			SetOrientation(angle);
+			StorePreviousState();
 		}
 
 	protected:
@@ -78,5 +90,8 @@ namespace Lumos
 		float m_Angle;
 		Maths::Vector3 m_Scale;
         std::vector<Maths::Vector2> m_CustomShapePositions;
+
+		Maths::Vector2 m_PreviousPosition;
+		float m_PreviousAngle = 0.0f;
 	};
 }
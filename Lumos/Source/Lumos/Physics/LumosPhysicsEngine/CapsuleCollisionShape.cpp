@@ -63,6 +63,13 @@ namespace Lumos
 			*out_max = pos + axis * m_Radius;
 	}
 
+	Maths::Vector3 CapsuleCollisionShape::GetLocalSupportPoint(const Maths::Vector3& localAxis) const
+	{
+		//Treated as a sphere, the same as its other collision queries
+		//Unit sphere, m_LocalTransform scales it by the radius
+		return localAxis.NormalizedOrDefault(Maths::Vector3(0.0f, 1.0f, 0.0f), Maths::M_EPSILON);
+	}
+
 	void CapsuleCollisionShape::GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                             const Maths::Vector3& axis,
                                                             ReferencePolygon& refPolygon) const
@@ -2,6 +2,7 @@
 #include "CollisionDetection.h"
 
 #include "SphereCollisionShape.h"
+#include "GJK.h"
 
 namespace Lumos
 {
@@ -19,15 +20,16 @@ namespace Lumos
         m_CollisionCheckFunctions[CollisionHull] = &CollisionDetection::CheckPolyhedronCollision;
 
 		m_CollisionCheckFunctions[CollisionSphere | CollisionCuboid] = &CollisionDetection::CheckPolyhedronSphereCollision;
+		m_CollisionCheckFunctions[CollisionSphere | CollisionHull] = &CollisionDetection::CheckPolyhedronSphereCollision;
 	}
 	
-	bool CollisionDetection::InvalidCheckCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+	bool CollisionDetection::InvalidCheckCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Maths::Vector3* axisCache)
 	{
 		LUMOS_LOG_CRITICAL("Invalid Collision type specified");
 		return false;
 	}
 	
-	bool CollisionDetection::CheckSphereCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+	bool CollisionDetection::CheckSphereCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Maths::Vector3* axisCache)
 	{
 		LUMOS_PROFILE_FUNCTION();
 		CollisionData colData;
@@ -61,9 +63,13 @@ namespace Lumos
 		possible_collision_axes->push_back(axis);
 	}
 	
-	bool CollisionDetection::CheckPolyhedronSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+	bool CollisionDetection::CheckPolyhedronSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Maths::Vector3* axisCache)
 	{
 		LUMOS_PROFILE_FUNCTION();
+		//Shares a slot in the lookup table with polyhedron pairs (Sphere | Cuboid == Pyramid, Sphere | Hull == Pyramid | Hull)
+		if(shape1->GetType() != CollisionSphere && shape2->GetType() != CollisionSphere)
+			return CheckPolyhedronCollision(obj1, obj2, shape1, shape2, out_coldata, axisCache);
+
         CollisionShape* complexShape;
         RigidBody3D* complexObj;
         RigidBody3D* sphereObj;
@@ -85,7 +91,8 @@ namespace Lumos
 		CollisionData best_colData;
 		best_colData.penetration = -FLT_MAX;
 		
-        std::vector<Maths::Vector3>& possibleCollisionAxes = complexShape->GetCollisionAxes(complexObj);
+        //Copied, adding the sphere axis to the shape's own list would grow it on every call
+        std::vector<Maths::Vector3> possibleCollisionAxes = complexShape->GetCollisionAxes(complexObj);
         std::vector<CollisionEdge>& complex_shape_edges = complexShape->GetEdges(complexObj);
 		
 		Maths::Vector3 p = GetClosestPointOnEdges(sphereObj->GetPosition(), complex_shape_edges);
@@ -108,47 +115,40 @@ namespace Lumos
 		return true;
 	}
 	
-	bool CollisionDetection::CheckPolyhedronCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+	bool CollisionDetection::CheckPolyhedronCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Maths::Vector3* axisCache)
 	{
 		LUMOS_PROFILE_FUNCTION();
-		CollisionData cur_colData;
-		CollisionData best_colData;
-		best_colData.penetration = -FLT_MAX;
-		
-        std::vector<Maths::Vector3>& possibleCollisionAxes = shape1->GetCollisionAxes(obj1);
-        std::vector<Maths::Vector3>& tempPossibleCollisionAxes = shape2->GetCollisionAxes(obj2);
-		for(Maths::Vector3& temp : tempPossibleCollisionAxes)
-			AddPossibleCollisionAxis(temp, &possibleCollisionAxes);
-		
-        std::vector<CollisionEdge>& shape1_edges = shape1->GetEdges(obj1);
-        std::vector<CollisionEdge>& shape2_edges = shape2->GetEdges(obj2);
-		
-		for(const CollisionEdge& edge1 : shape1_edges)
+		//GJK on the support mappings of both shapes, only vertex searches in each shape's own space and
+		//no edge/edge axis pairs, then EPA for the contact normal and depth
+		const ConvexSupport support1(obj1, shape1);
+		const ConvexSupport support2(obj2, shape2);
+
+		Maths::Vector3 searchAxis = axisCache ? *axisCache : Maths::Vector3(0.0f);
+		Maths::Vector3 simplex[4];
+
+		if(!GJK::Intersect(support1, support2, searchAxis, simplex))
 		{
-			for(const CollisionEdge& edge2 : shape2_edges)
-			{
-				Maths::Vector3 e1 = edge1.posB - edge1.posA;
-				Maths::Vector3 e2 = edge2.posB - edge2.posA;
-				e1.Normalize();
-				e2.Normalize();
-				
-				Maths::Vector3 temp = e1.CrossProduct(e2);
-				AddPossibleCollisionAxis(temp, &possibleCollisionAxes);
-			}
+			if(axisCache)
+				*axisCache = searchAxis;
+			return false;
 		}
-		
-		for(const Maths::Vector3& axis : possibleCollisionAxes)
+
+		Maths::Vector3 normal;
+		float depth;
+		if(!GJK::Penetration(support1, support2, simplex, normal, depth))
+			return false;
+
+		//Start from the contact normal next frame, still the best guess if they separate
+		if(axisCache)
+			*axisCache = normal;
+
+		if(out_coldata)
 		{
-			if(!CheckCollisionAxis(axis, obj1, obj2, shape1, shape2, &cur_colData))
-				return false;
-			
-			if(cur_colData.penetration >= best_colData.penetration)
-				best_colData = cur_colData;
+			out_coldata->normal = normal;
+			out_coldata->penetration = -depth;
+			out_coldata->pointOnPlane = support1.Support(normal) + normal * out_coldata->penetration;
 		}
-		
-		if(out_coldata)
-			*out_coldata = best_colData;
-		
+
 		return true;
 	}
 	
@@ -19,7 +19,7 @@ namespace Lumos
 	class LUMOS_EXPORT CollisionDetection : public ThreadSafeSingleton<CollisionDetection>
 	{
 		friend class TSingleton<CollisionDetection>;
-		typedef bool (CollisionDetection::*CollisionCheckFunc)( RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata);
+		typedef bool (CollisionDetection::*CollisionCheckFunc)( RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Maths::Vector3* axisCache);
 
 		CollisionCheckFunc* m_CollisionCheckFunctions;
 
@@ -31,10 +31,12 @@ namespace Lumos
 				delete[] m_CollisionCheckFunctions;
 		}
 
-		inline bool CheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr)
+		// axisCache holds the last axis found for this pair, polyhedron pairs start their search from it and
+		//   return without further work while it still separates them
+		inline bool CheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Maths::Vector3* axisCache = nullptr)
 		{
             LUMOS_PROFILE_FUNCTION();
-			return CALL_MEMBER_FN(*this, m_CollisionCheckFunctions[shape1->GetType() | shape2->GetType()])(obj1, obj2, shape1, shape2, out_coldata);
+			return CALL_MEMBER_FN(*this, m_CollisionCheckFunctions[shape1->GetType() | shape2->GetType()])(obj1, obj2, shape1, shape2, out_coldata, axisCache);
 		}
 
 		bool BuildCollisionManifold(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2,   CollisionData& coldata, Manifold* out_manifold);
@@ -126,10 +128,10 @@ namespace Lumos
 		}
 
 	protected:
-		bool CheckPolyhedronCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
-		bool CheckPolyhedronSphereCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
-		bool CheckSphereCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
-		bool InvalidCheckCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
+		bool CheckPolyhedronCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Maths::Vector3* axisCache = nullptr);
+		bool CheckPolyhedronSphereCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Maths::Vector3* axisCache = nullptr);
+		bool CheckSphereCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Maths::Vector3* axisCache = nullptr);
+		bool InvalidCheckCollision(  RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Maths::Vector3* axisCache = nullptr);
 		static bool CheckCollisionAxis(const Maths::Vector3& axis,   RigidBody3D* obj1,   RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata);
 
 		static Maths::Vector3 GetClosestPointOnEdges(const Maths::Vector3& target, const std::vector<CollisionEdge>& edges);
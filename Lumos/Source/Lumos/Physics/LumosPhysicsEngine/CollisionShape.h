@@ -84,11 +84,25 @@ namespace Lumos
 			const Maths::Vector3& axis,
             ReferencePolygon& refPolygon) const = 0;
 
+		// Get the furthest point of the shape along an axis
+		//	- Support mapping used by GJK/EPA. Both the axis and the result are in the shape's own space,
+		//    before m_LocalTransform and the body transform, so it only searches the untransformed shape.
+		//    The default is a single point at the origin.
+		virtual Maths::Vector3 GetLocalSupportPoint(const Maths::Vector3& localAxis) const
+		{
+			return Maths::Vector3(0.0f);
+		}
+
 		void SetLocalTransform(const Maths::Matrix4& transform)
 		{
 			m_LocalTransform = transform;
 		}
 
+		const Maths::Matrix4& GetLocalTransform() const
+		{
+			return m_LocalTransform;
+		}
+
 		inline CollisionShapeType GetType() const
 		{
 			return m_Type;
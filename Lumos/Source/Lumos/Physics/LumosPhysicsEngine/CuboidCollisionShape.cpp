@@ -102,6 +102,11 @@ namespace Lumos
 			*out_max = wsTransform * m_CubeHull->GetVertex(vMax).pos;
 	}
 
+	Maths::Vector3 CuboidCollisionShape::GetLocalSupportPoint(const Maths::Vector3& localAxis) const
+	{
+		return m_CubeHull->GetVertex(m_CubeHull->GetSupportVertex(localAxis)).pos;
+	}
+
 	void CuboidCollisionShape::GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                            const Maths::Vector3& axis,
                                                            ReferencePolygon& refPolygon) const
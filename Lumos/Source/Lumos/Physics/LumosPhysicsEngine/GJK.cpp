@@ -0,0 +1,310 @@
+#include "Precompiled.h"
+#include "GJK.h"
+#include "RigidBody3D.h"
+#include "CollisionShape.h"
+
+#define GJK_MAX_ITERATIONS 64
+#define EPA_MAX_ITERATIONS 64
+#define EPA_MAX_FACES 64
+#define EPA_MAX_LOOSE_EDGES 32
+#define EPA_TOLERANCE 0.0001f
+
+//Search directions aren't normalised and scale with the cube of the shape size, so zero checks use a tiny epsilon
+#define GJK_EPSILON 1e-12f
+
+namespace Lumos
+{
+	ConvexSupport::ConvexSupport(const RigidBody3D* body, const CollisionShape* shape)
+		: Shape(shape)
+	{
+		Transform = body->GetWorldSpaceTransform() * shape->GetLocalTransform();
+
+		//Transpose of the linear part, the support of M * x along d is M * (support of x along M^T * d)
+		AxisToLocal = Transform.ToMatrix3().Transpose();
+	}
+
+	Maths::Vector3 ConvexSupport::Support(const Maths::Vector3& direction) const
+	{
+		return Transform * Shape->GetLocalSupportPoint(AxisToLocal * direction);
+	}
+
+	bool GJK::Intersect(const ConvexSupport& a, const ConvexSupport& b, Maths::Vector3& searchAxis, Maths::Vector3* simplex)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		//simplex[0] is always the newest point
+		Maths::Vector3 direction = searchAxis;
+		if(direction.LengthSquared() < GJK_EPSILON)
+			direction = a.Transform.Translation() - b.Transform.Translation();
+		if(direction.LengthSquared() < GJK_EPSILON)
+			direction = Maths::Vector3(1.0f, 0.0f, 0.0f);
+
+		simplex[2] = MinkowskiSupport(a, b, direction);
+		if(simplex[2].DotProduct(direction) < 0.0f)
+		{
+			searchAxis = direction;
+			return false;
+		}
+
+		direction = -simplex[2];
+		simplex[1] = MinkowskiSupport(a, b, direction);
+		if(simplex[1].DotProduct(direction) < 0.0f)
+		{
+			searchAxis = direction;
+			return false;
+		}
+
+		const Maths::Vector3 line = simplex[2] - simplex[1];
+		direction = line.CrossProduct(-simplex[1]).CrossProduct(line);
+		if(direction.LengthSquared() < GJK_EPSILON)
+		{
+			//Origin is on the line, any perpendicular will do
+			direction = line.CrossProduct(Maths::Vector3(1.0f, 0.0f, 0.0f));
+			if(direction.LengthSquared() < GJK_EPSILON)
+				direction = line.CrossProduct(Maths::Vector3(0.0f, 0.0f, -1.0f));
+		}
+
+		uint32_t count = 2;
+		for(uint32_t iteration = 0; iteration < GJK_MAX_ITERATIONS; iteration++)
+		{
+			//Origin on the simplex boundary, the shapes only touch
+			if(direction.LengthSquared() < GJK_EPSILON)
+				return false;
+
+			simplex[0] = MinkowskiSupport(a, b, direction);
+			if(simplex[0].DotProduct(direction) < 0.0f)
+			{
+				searchAxis = direction;
+				return false;
+			}
+
+			count++;
+			if(count == 3)
+				UpdateTriangle(simplex, count, direction);
+			else if(UpdateTetrahedron(simplex, count, direction))
+				return true;
+		}
+
+		return false;
+	}
+
+	void GJK::UpdateTriangle(Maths::Vector3* simplex, uint32_t& count, Maths::Vector3& direction)
+	{
+		Maths::Vector3& a = simplex[0];
+		Maths::Vector3& b = simplex[1];
+		Maths::Vector3& c = simplex[2];
+		Maths::Vector3& d = simplex[3];
+
+		const Maths::Vector3 ab = b - a;
+		const Maths::Vector3 ac = c - a;
+		const Maths::Vector3 ao = -a;
+		const Maths::Vector3 normal = ab.CrossProduct(ac);
+
+		count = 2;
+
+		//Closest to edge AB
+		if(ab.CrossProduct(normal).DotProduct(ao) > 0.0f)
+		{
+			c = a;
+			direction = ab.CrossProduct(ao).CrossProduct(ab);
+			return;
+		}
+
+		//Closest to edge AC
+		if(normal.CrossProduct(ac).DotProduct(ao) > 0.0f)
+		{
+			b = a;
+			direction = ac.CrossProduct(ao).CrossProduct(ac);
+			return;
+		}
+
+		//Above or below the triangle, wound so the next point is added on the origin's side
+		count = 3;
+		if(normal.DotProduct(ao) > 0.0f)
+		{
+			d = c;
+			c = b;
+			b = a;
+			direction = normal;
+			return;
+		}
+
+		d = b;
+		b = a;
+		direction = -normal;
+	}
+
+	bool GJK::UpdateTetrahedron(Maths::Vector3* simplex, uint32_t& count, Maths::Vector3& direction)
+	{
+		Maths::Vector3& a = simplex[0];
+		Maths::Vector3& b = simplex[1];
+		Maths::Vector3& c = simplex[2];
+		Maths::Vector3& d = simplex[3];
+
+		const Maths::Vector3 abc = (b - a).CrossProduct(c - a);
+		const Maths::Vector3 acd = (c - a).CrossProduct(d - a);
+		const Maths::Vector3 adb = (d - a).CrossProduct(b - a);
+		const Maths::Vector3 ao = -a;
+
+		//BCD was checked when the triangle was built, so the origin can only be outside the faces around A
+		count = 3;
+
+		if(abc.DotProduct(ao) > 0.0f)
+		{
+			d = c;
+			c = b;
+			b = a;
+			direction = abc;
+			return false;
+		}
+
+		if(acd.DotProduct(ao) > 0.0f)
+		{
+			b = a;
+			direction = acd;
+			return false;
+		}
+
+		if(adb.DotProduct(ao) > 0.0f)
+		{
+			c = d;
+			d = b;
+			b = a;
+			direction = adb;
+			return false;
+		}
+
+		return true;
+	}
+
+	bool GJK::Penetration(const ConvexSupport& a, const ConvexSupport& b, const Maths::Vector3* simplex, Maths::Vector3& normal, float& depth)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		struct Face
+		{
+			Maths::Vector3 Points[3];
+			Maths::Vector3 Normal;
+		};
+
+		Face faces[EPA_MAX_FACES];
+		uint32_t faceCount = 0;
+
+		//Faces are kept wound with their normals pointing away from the origin, which is inside the polytope
+		auto addFace = [&](const Maths::Vector3& p0, const Maths::Vector3& p1, const Maths::Vector3& p2)
+		{
+			Maths::Vector3 faceNormal = (p1 - p0).CrossProduct(p2 - p0);
+			const float length = faceNormal.Length();
+			if(length < GJK_EPSILON || faceCount >= EPA_MAX_FACES)
+				return;
+
+			faceNormal = faceNormal / length;
+			Face& face = faces[faceCount++];
+			if(faceNormal.DotProduct(p0) < 0.0f)
+			{
+				face.Points[0] = p1;
+				face.Points[1] = p0;
+				faceNormal = -faceNormal;
+			}
+			else
+			{
+				face.Points[0] = p0;
+				face.Points[1] = p1;
+			}
+			face.Points[2] = p2;
+			face.Normal = faceNormal;
+		};
+
+		addFace(simplex[0], simplex[1], simplex[2]);
+		addFace(simplex[0], simplex[2], simplex[3]);
+		addFace(simplex[0], simplex[3], simplex[1]);
+		addFace(simplex[1], simplex[3], simplex[2]);
+
+		if(faceCount < 4)
+			return false;
+
+		uint32_t closest = 0;
+		for(uint32_t iteration = 0; iteration < EPA_MAX_ITERATIONS; iteration++)
+		{
+			float minDistance = FLT_MAX;
+			for(uint32_t i = 0; i < faceCount; i++)
+			{
+				const float distance = faces[i].Points[0].DotProduct(faces[i].Normal);
+				if(distance < minDistance)
+				{
+					minDistance = distance;
+					closest = i;
+				}
+			}
+
+			const Maths::Vector3 searchNormal = faces[closest].Normal;
+			const Maths::Vector3 point = MinkowskiSupport(a, b, searchNormal);
+			const float pointDistance = point.DotProduct(searchNormal);
+
+			//Can't expand any further towards this face, it is on the boundary of A - B
+			if(pointDistance - minDistance < EPA_TOLERANCE)
+			{
+				normal = searchNormal;
+				depth = pointDistance;
+				return true;
+			}
+
+			//Remove every face the new point can see, keeping the edges of the hole they leave
+			Maths::Vector3 looseEdges[EPA_MAX_LOOSE_EDGES][2];
+			uint32_t looseEdgeCount = 0;
+
+			for(uint32_t i = 0; i < faceCount; i++)
+			{
+				if(faces[i].Normal.DotProduct(point - faces[i].Points[0]) <= 0.0f)
+					continue;
+
+				for(uint32_t j = 0; j < 3; j++)
+				{
+					const Maths::Vector3& edgeStart = faces[i].Points[j];
+					const Maths::Vector3& edgeEnd = faces[i].Points[(j + 1) % 3];
+
+					//An edge shared with another removed face is interior to the hole
+					bool shared = false;
+					for(uint32_t k = 0; k < looseEdgeCount; k++)
+					{
+						if(looseEdges[k][1] == edgeStart && looseEdges[k][0] == edgeEnd)
+						{
+							looseEdges[k][0] = looseEdges[looseEdgeCount - 1][0];
+							looseEdges[k][1] = looseEdges[looseEdgeCount - 1][1];
+							looseEdgeCount--;
+							shared = true;
+							break;
+						}
+					}
+
+					if(!shared && looseEdgeCount < EPA_MAX_LOOSE_EDGES)
+					{
+						looseEdges[looseEdgeCount][0] = edgeStart;
+						looseEdges[looseEdgeCount][1] = edgeEnd;
+						looseEdgeCount++;
+					}
+				}
+
+				faces[i] = faces[faceCount - 1];
+				faceCount--;
+				i--;
+			}
+
+			for(uint32_t i = 0; i < looseEdgeCount; i++)
+				addFace(looseEdges[i][0], looseEdges[i][1], point);
+
+			if(faceCount == 0)
+				return false;
+		}
+
+		//Out of iterations, the closest face found so far is close enough
+		closest = 0;
+		for(uint32_t i = 1; i < faceCount; i++)
+		{
+			if(faces[i].Points[0].DotProduct(faces[i].Normal) < faces[closest].Points[0].DotProduct(faces[closest].Normal))
+				closest = i;
+		}
+
+		normal = faces[closest].Normal;
+		depth = faces[closest].Points[0].DotProduct(normal);
+		return true;
+	}
+}
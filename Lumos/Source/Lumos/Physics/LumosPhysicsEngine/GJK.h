@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Maths/Maths.h"
+
+namespace Lumos
+{
+	class RigidBody3D;
+	class CollisionShape;
+
+	//World space support mapping of one convex shape. Search directions are taken back to the shape's own space
+	//so each query only scans the untransformed hull vertices
+	struct LUMOS_EXPORT ConvexSupport
+	{
+		ConvexSupport(const RigidBody3D* body, const CollisionShape* shape);
+
+		Maths::Vector3 Support(const Maths::Vector3& direction) const;
+
+		const CollisionShape* Shape;
+		Maths::Matrix4 Transform;
+		Maths::Matrix3 AxisToLocal;
+	};
+
+	//Gilbert-Johnson-Keerthi intersection test with Expanding Polytope penetration depth, both run on the
+	//Minkowski difference A - B of two convex shapes
+	class LUMOS_EXPORT GJK
+	{
+	public:
+		//Returns true if the shapes overlap. searchAxis seeds the first search direction, pass last frame's
+		//separating axis for the pair to exit after a single support query while it still separates them.
+		//When the shapes are apart it receives the axis that separated them
+		static bool Intersect(const ConvexSupport& a, const ConvexSupport& b, Maths::Vector3& searchAxis, Maths::Vector3* simplex);
+
+		//Expands the tetrahedron from Intersect to the face of A - B closest to the origin. normal points from A to B
+		static bool Penetration(const ConvexSupport& a, const ConvexSupport& b, const Maths::Vector3* simplex, Maths::Vector3& normal, float& depth);
+
+	private:
+		static Maths::Vector3 MinkowskiSupport(const ConvexSupport& a, const ConvexSupport& b, const Maths::Vector3& direction)
+		{
+			return a.Support(direction) - b.Support(-direction);
+		}
+
+		static void UpdateTriangle(Maths::Vector3* simplex, uint32_t& count, Maths::Vector3& direction);
+		static bool UpdateTetrahedron(Maths::Vector3* simplex, uint32_t& count, Maths::Vector3& direction);
+	};
+}
@@ -161,6 +161,25 @@ namespace Lumos
 		if (out_max_vert) *out_max_vert = maxVertex;
 	}
 
+	int Hull::GetSupportVertex(const Maths::Vector3& local_axis) const
+	{
+		int maxVertex = 0;
+		float maxCorrelation = -FLT_MAX;
+
+		for (size_t i = 0; i < m_Vertices.size(); ++i)
+		{
+			const float cCorrelation = Maths::Vector3::Dot(local_axis, m_Vertices[i].pos);
+
+			if (cCorrelation > maxCorrelation)
+			{
+				maxCorrelation = cCorrelation;
+				maxVertex = static_cast<int>(i);
+			}
+		}
+
+		return maxVertex;
+	}
+
 	void Hull::DebugDraw(const Maths::Matrix4& transform)
 	{
         //Draw all Hull Polygons
@@ -57,6 +57,9 @@ namespace Lumos
 
 		void GetMinMaxVerticesInAxis(const Maths::Vector3& local_axis, int* out_min_vert, int* out_max_vert);
 
+		//Index of the vertex furthest along local_axis
+		int GetSupportVertex(const Maths::Vector3& local_axis) const;
+
 		void DebugDraw(const Maths::Matrix4& transform);
 
 	protected:
@@ -115,6 +115,11 @@ namespace Lumos
 			*out_max = wsTransform * m_Hull->GetVertex(vMax).pos;
 	}
 
+	Maths::Vector3 HullCollisionShape::GetLocalSupportPoint(const Maths::Vector3& localAxis) const
+	{
+		return m_Hull->GetVertex(m_Hull->GetSupportVertex(localAxis)).pos;
+	}
+
 	void HullCollisionShape::GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                            const Maths::Vector3& axis,
                                                            ReferencePolygon& refPolygon) const
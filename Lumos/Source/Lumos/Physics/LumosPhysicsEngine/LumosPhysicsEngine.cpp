@@ -8,6 +8,8 @@
 #include "Constraint.h"
 #include "Utilities/TimeStep.h"
 #include "Core/JobSystem.h"
+#include "Utilities/CombineHash.h"
+#include "Utilities/Timer.h"
  
 #include "Core/Application.h"
 #include "Scene/Component/Physics3DComponent.h"
@@ -37,6 +39,9 @@ namespace Lumos
 	
 	void LumosPhysicsEngine::SetDefaults()
 	{
+		SyncStep();
+		SetScene(nullptr);
+		m_MovedEntities.clear();
 		m_IsPaused = true;
 		s_UpdateTimestep = 1.0f / 60.f;
 		m_UpdateAccum = 0.0f;
@@ -47,6 +52,7 @@ namespace Lumos
 	
 	LumosPhysicsEngine::~LumosPhysicsEngine()
 	{
+		SyncStep();
 		m_RigidBodys.clear();
 		m_Constraints.clear();
 		m_Manifolds.clear();
@@ -57,114 +63,240 @@ namespace Lumos
 	void LumosPhysicsEngine::OnUpdate(const TimeStep& timeStep, Scene* scene)
 	{
 		LUMOS_PROFILE_FUNCTION();
-		m_RigidBodys.clear();
-		
+		SyncStep();
+		SetScene(scene);
+
+		if(m_BodyListDirty)
+			RebuildBodyList();
+
+		m_MovedEntities.clear();
+
 		if(!m_IsPaused)
+			WriteTransforms(scene);
+	}
+
+	void LumosPhysicsEngine::WriteTransforms(Scene* scene)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		auto& registry = scene->GetRegistry();
+
+		//Rendering runs up to a step behind the simulation, blending the states either side of the last step
+		const float alpha = Maths::Min(m_UpdateAccum / s_UpdateTimestep, 1.0f);
+
+		for(size_t i = 0; i < m_RigidBodys.size(); i++)
 		{
-			auto& registry = scene->GetRegistry();
-			auto group = registry.group<Physics3DComponent>(entt::get<Maths::Transform>);
-			
+			const auto& body = m_RigidBodys[i];
+			auto& writeback = m_BodyWritebacks[i];
+
+			//Static and sleeping bodies stay where they were last written, leaving their transforms clean
+			const bool settled = body->GetPreviousPosition() == body->GetPosition() && body->GetPreviousOrientation() == body->GetOrientation();
+			if(settled && writeback.Written && writeback.Position == body->GetPosition() && writeback.Orientation == body->GetOrientation())
+				continue;
+
+			auto transform = registry.try_get<Maths::Transform>(writeback.Entity);
+			if(!transform)
+				continue;
+
+			if(settled)
 			{
-				LUMOS_PROFILE_SCOPE("Physics::Get Rigid Bodies");
-                for(auto entity : group)
-                {
-                    const auto& phys = group.get<Physics3DComponent>(entity);
-                    auto& physicsObj = phys.GetRigidBody();
-                    m_RigidBodys.push_back(physicsObj);
-				};
+				writeback.Position = body->GetPosition();
+				writeback.Orientation = body->GetOrientation();
 			}
-            
-            if(m_RigidBodys.empty())
-            {
-                return;
-            }
-			
+			else
 			{
-				LUMOS_PROFILE_SCOPE("Physics::Get Spring Constraints");
-                m_Constraints.clear();
-                
-                auto viewSpring = registry.view<SpringConstraintComponent>();
-                
-                for(auto entity : viewSpring)
-                {
-                    const auto& constraint = viewSpring.get<SpringConstraintComponent>(entity).GetConstraint();
-                    m_Constraints.push_back(constraint.get());
-				}
+				writeback.Position = body->GetPreviousPosition().Lerp(body->GetPosition(), alpha);
+				writeback.Orientation = body->GetPreviousOrientation().Slerp(body->GetOrientation(), alpha);
 			}
-            
-            {
-                LUMOS_PROFILE_SCOPE("Physics::Get Axis Constraints");
-                
-                auto viewAxis = registry.view<AxisConstraintComponent>();
-                
-                for(auto entity : viewAxis)
-                {
-                    const auto& constraint = viewAxis.get<AxisConstraintComponent>(entity).GetConstraint();
-                    m_Constraints.push_back(constraint.get());
-                }
-            }
-			
+
+			writeback.Written = true;
+			transform->SetLocalPosition(writeback.Position);
+			transform->SetLocalOrientation(writeback.Orientation);
+			m_MovedEntities.push_back(writeback.Entity);
+		}
+	}
+
+	void LumosPhysicsEngine::OnLateUpdate(const TimeStep& timeStep, Scene* scene)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		if(m_IsPaused)
+			return;
+
+		SyncStep();
+		SetScene(scene);
+
+		if(m_BodyListDirty)
+			RebuildBodyList();
+
+		if(m_RigidBodys.empty())
+			return;
+
+		const uint32_t maxStepsPerFrame = 5;
+
+		m_StepCount = 0;
+		m_UpdateAccum += timeStep.GetSeconds();
+		while(m_UpdateAccum >= s_UpdateTimestep && m_StepCount < maxStepsPerFrame)
+		{
+			m_UpdateAccum -= s_UpdateTimestep;
+			m_StepCount++;
+		}
+
+		if(m_UpdateAccum >= s_UpdateTimestep)
+		{
+			LUMOS_LOG_WARN("Physics too slow to run in real time!");
+			//Drop Time in the hope that it can continue to run in real-time
+			m_UpdateAccum = 0.0f;
+		}
+
+		if(m_StepCount == 0)
+			return;
+
+		const uint32_t steps = m_StepCount;
+		m_StepThread.Kick([this, steps, scene]() { StepPhysics(steps, scene); });
+	}
+
+	template<typename Component, auto Callback>
+	void LumosPhysicsEngine::ConnectSignals(entt::registry& registry)
+	{
+		registry.on_construct<Component>().template connect<Callback>(*this);
+		registry.on_update<Component>().template connect<Callback>(*this);
+		registry.on_destroy<Component>().template connect<Callback>(*this);
+	}
+
+	template<typename Component>
+	void LumosPhysicsEngine::DisconnectSignals(entt::registry& registry)
+	{
+		registry.on_construct<Component>().disconnect(*this);
+		registry.on_update<Component>().disconnect(*this);
+		registry.on_destroy<Component>().disconnect(*this);
+	}
+
+	void LumosPhysicsEngine::SetScene(Scene* scene)
+	{
+		if(scene == m_Scene)
+			return;
+
+		//Scenes live until the scene manager is destroyed, so the old registry is still valid here
+		if(m_Scene)
+		{
+			auto& registry = m_Scene->GetRegistry();
+			DisconnectSignals<Physics3DComponent>(registry);
+			DisconnectSignals<SpringConstraintComponent>(registry);
+			DisconnectSignals<AxisConstraintComponent>(registry);
+			DisconnectSignals<DistanceConstraintComponent>(registry);
+			DisconnectSignals<WeldConstraintComponent>(registry);
+		}
+
+		m_Scene = scene;
+		m_BodyListDirty = true;
+
+		if(m_Scene)
+		{
+			auto& registry = m_Scene->GetRegistry();
+			ConnectSignals<Physics3DComponent, &LumosPhysicsEngine::OnBodiesChanged>(registry);
+			ConnectSignals<SpringConstraintComponent, &LumosPhysicsEngine::OnConstraintsChanged>(registry);
+			ConnectSignals<AxisConstraintComponent, &LumosPhysicsEngine::OnConstraintsChanged>(registry);
+			ConnectSignals<DistanceConstraintComponent, &LumosPhysicsEngine::OnConstraintsChanged>(registry);
+			ConnectSignals<WeldConstraintComponent, &LumosPhysicsEngine::OnConstraintsChanged>(registry);
+		}
+	}
+
+	void LumosPhysicsEngine::OnBodiesChanged(entt::registry& registry, entt::entity entity)
+	{
+		SyncStep();
+		m_BodyListDirty = true;
+	}
+
+	void LumosPhysicsEngine::OnConstraintsChanged(entt::registry& registry, entt::entity entity)
+	{
+		SyncStep();
+		m_BodyListDirty = true;
+
+		//Constraints are owned by their components, drop them now rather than keep dangling pointers until the rebuild
+		m_Constraints.clear();
+	}
+
+	void LumosPhysicsEngine::RebuildBodyList()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_RigidBodys.clear();
+		m_BodyWritebacks.clear();
+		m_Constraints.clear();
+		m_BodyListDirty = false;
+
+		if(!m_Scene)
+			return;
+
+		auto& registry = m_Scene->GetRegistry();
+
+		{
+			LUMOS_PROFILE_SCOPE("Physics::Get Rigid Bodies");
+			auto view = registry.view<Physics3DComponent>();
+			for(auto entity : view)
 			{
-				LUMOS_PROFILE_SCOPE("Physics::Get Distance Constraints");
-                auto viewDis = registry.view<DistanceConstraintComponent>();
-                
-                for(auto entity : viewDis)
-                {
-                    const auto& constraint = viewDis.get<DistanceConstraintComponent>(entity).GetConstraint();
-                    m_Constraints.push_back(constraint.get());
-                }
+				m_RigidBodys.push_back(view.get<Physics3DComponent>(entity).GetRigidBody());
+				m_BodyWritebacks.emplace_back().Entity = entity;
 			}
-			
+		}
+
+		{
+			LUMOS_PROFILE_SCOPE("Physics::Get Spring Constraints");
+			auto viewSpring = registry.view<SpringConstraintComponent>();
+			for(auto entity : viewSpring)
 			{
-				LUMOS_PROFILE_SCOPE("Physics::Get Weld Constraints");
-                auto viewWeld = registry.view<WeldConstraintComponent>();
-                
-                for(auto entity : viewWeld)
-                {
-                    const auto& constraint = viewWeld.get<WeldConstraintComponent>(entity).GetConstraint();
-                    m_Constraints.push_back(constraint.get());
-				}
+				const auto& constraint = viewSpring.get<SpringConstraintComponent>(entity).GetConstraint();
+				m_Constraints.push_back(constraint.get());
 			}
-			
+		}
+
+		{
+			LUMOS_PROFILE_SCOPE("Physics::Get Axis Constraints");
+			auto viewAxis = registry.view<AxisConstraintComponent>();
+			for(auto entity : viewAxis)
 			{
-				LUMOS_PROFILE_SCOPE("Physics::UpdatePhysics");
-			if(m_MultipleUpdates)
+				const auto& constraint = viewAxis.get<AxisConstraintComponent>(entity).GetConstraint();
+				m_Constraints.push_back(constraint.get());
+			}
+		}
+
+		{
+			LUMOS_PROFILE_SCOPE("Physics::Get Distance Constraints");
+			auto viewDis = registry.view<DistanceConstraintComponent>();
+			for(auto entity : viewDis)
 			{
-				const int max_updates_per_frame = 5;
-				
-				m_UpdateAccum += timeStep.GetSeconds();
-				for(int i = 0; (m_UpdateAccum >= s_UpdateTimestep) && i < max_updates_per_frame; ++i)
-				{
-					m_UpdateAccum -= s_UpdateTimestep;
-					UpdatePhysics(scene);
-				}
-				
-				if(m_UpdateAccum >= s_UpdateTimestep)
-				{
-					LUMOS_LOG_WARN("Physics too slow to run in real time!");
-					//Drop Time in the hope that it can continue to run in real-time
-					m_UpdateAccum = 0.0f;
-				}
+				const auto& constraint = viewDis.get<DistanceConstraintComponent>(entity).GetConstraint();
+				m_Constraints.push_back(constraint.get());
 			}
-			else
+		}
+
+		{
+			LUMOS_PROFILE_SCOPE("Physics::Get Weld Constraints");
+			auto viewWeld = registry.view<WeldConstraintComponent>();
+			for(auto entity : viewWeld)
 			{
-				s_UpdateTimestep = timeStep.GetSeconds();
-				UpdatePhysics(scene);
-				}
+				const auto& constraint = viewWeld.get<WeldConstraintComponent>(entity).GetConstraint();
+				m_Constraints.push_back(constraint.get());
 			}
-			
+		}
+	}
+
+	void LumosPhysicsEngine::StepPhysics(uint32_t steps, Scene* scene)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		Timer timer;
+
+		for(uint32_t i = 0; i < steps; i++)
+		{
+			//Interpolation only needs the state from before the last step
+			if(i == steps - 1)
 			{
-				LUMOS_PROFILE_SCOPE("Physics::Set Transforms");
-                for(auto entity : group)
-                {
-                    const auto& [phys, trans] = group.get<Physics3DComponent, Maths::Transform>(entity);
-                    
-                    trans.SetLocalPosition(phys.GetRigidBody()->GetPosition());
-                    trans.SetLocalOrientation(phys.GetRigidBody()->GetOrientation());
-                };
-            }
-            m_Constraints.clear();
-        }
+				for(auto& body : m_RigidBodys)
+					body->StorePreviousState();
+			}
+
+			UpdatePhysics(scene);
+		}
+
+		m_StepTime = timer.GetElapsedMS();
 	}
 	
 	void LumosPhysicsEngine::UpdatePhysics(Scene* scene)
@@ -319,13 +451,44 @@ namespace Lumos
 	{
 		LUMOS_PROFILE_FUNCTION();
 		m_BroadphaseCollisionPairs.clear();
+		UpdateWorldSpaceAABBs();
 		if(m_BroadphaseDetection)
 			m_BroadphaseDetection->FindPotentialCollisionPairs(m_RigidBodys.data(),(uint32_t)m_RigidBodys.size(), m_BroadphaseCollisionPairs);
 	}
+
+	void LumosPhysicsEngine::UpdateWorldSpaceAABBs()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_AABBUpdateBodies.clear();
+		m_AABBUpdateTransforms.clear();
+		m_AABBUpdateLocalBounds.clear();
+
+		for(auto& obj : m_RigidBodys)
+		{
+			if(!obj->m_wsAabbInvalidated)
+				continue;
+
+			m_AABBUpdateBodies.push_back(obj.get());
+			m_AABBUpdateTransforms.push_back(obj->GetWorldSpaceTransform());
+			m_AABBUpdateLocalBounds.push_back(obj->m_localBoundingBox);
+		}
+
+		const uint32_t count = uint32_t(m_AABBUpdateBodies.size());
+		Maths::Batch::TransformBoundingBoxes(m_AABBUpdateTransforms.data(), m_AABBUpdateLocalBounds.data(), count, m_AABBUpdateWorldBounds);
+
+		for(uint32_t i = 0; i < count; i++)
+		{
+			m_AABBUpdateBodies[i]->m_wsAabb = m_AABBUpdateWorldBounds.Get(i);
+			m_AABBUpdateBodies[i]->m_wsAabbInvalidated = false;
+		}
+	}
 	
 	void LumosPhysicsEngine::NarrowPhaseCollisions()
 	{
 		LUMOS_PROFILE_FUNCTION();
+		Timer timer;
+		m_StepIndex++;
+
 		if(!m_BroadphaseCollisionPairs.empty())
 		{
 			CollisionData colData;
@@ -340,8 +503,14 @@ namespace Lumos
 				
 				if(shapeA && shapeB)
 				{
-					// Detects if the objects are colliding - Seperating Axis Theorem
-					if(CollisionDetection::Get().CheckCollision(cp.pObjectA, cp.pObjectB, shapeA.get(), shapeB.get(), &colData))
+					size_t pairHash = std::hash<RigidBody3D*>()(cp.pObjectA);
+					HashCombine(pairHash, cp.pObjectB);
+
+					CachedAxis& cachedAxis = m_PairAxisCache[pairHash];
+					cachedAxis.LastStep = m_StepIndex;
+
+					// Detects if the objects are colliding - GJK/EPA for convex pairs, Seperating Axis Theorem with spheres
+					if(CollisionDetection::Get().CheckCollision(cp.pObjectA, cp.pObjectB, shapeA.get(), shapeB.get(), &colData, &cachedAxis.Axis))
 					{
 						// Check to see if any of the objects have collision callbacks that dont
 						// want the objects to physically collide
@@ -373,6 +542,17 @@ namespace Lumos
 			
 			//System::JobSystem::Wait();
 		}
+
+		//Forget pairs the broadphase no longer reports
+		for(auto it = m_PairAxisCache.begin(); it != m_PairAxisCache.end();)
+		{
+			if(it->second.LastStep != m_StepIndex)
+				it = m_PairAxisCache.erase(it);
+			else
+				++it;
+		}
+
+		m_NarrowphaseTime = timer.GetElapsedMS();
 	}
 	
 	void LumosPhysicsEngine::SolveConstraints()
@@ -412,6 +592,7 @@ namespace Lumos
 	
 	void LumosPhysicsEngine::ClearConstraints()
 	{
+		SyncStep();
 		m_Constraints.clear();
 	}
 	
@@ -449,6 +630,22 @@ namespace Lumos
 		ImGui::PopItemWidth();
 		ImGui::NextColumn();
 		
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Narrowphase Time (ms)");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Text("%5.3f", m_NarrowphaseTime);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+		
+		ImGui::AlignTextToFramePadding();
+		ImGui::TextUnformatted("Step Time (ms)");
+		ImGui::NextColumn();
+		ImGui::PushItemWidth(-1);
+		ImGui::Text("%5.3f (%u steps)", m_StepTime, m_StepCount);
+		ImGui::PopItemWidth();
+		ImGui::NextColumn();
+		
 		ImGui::AlignTextToFramePadding();
 		ImGui::TextUnformatted("Number Of Rigid Bodys");
 		ImGui::NextColumn();
@@ -525,6 +722,12 @@ namespace Lumos
 	void LumosPhysicsEngine::OnDebugDraw()
 	{
 		LUMOS_PROFILE_FUNCTION();
+		if(!m_DebugDrawFlags)
+			return;
+
+		//Reads the state the physics thread is stepping
+		SyncStep();
+
 		if(m_DebugDrawFlags & PhysicsDebugFlags::MANIFOLD)
 		{
 			for(Manifold& m : m_Manifolds)
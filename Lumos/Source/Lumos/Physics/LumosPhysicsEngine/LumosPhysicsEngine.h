@@ -7,6 +7,8 @@
 #include "Broadphase.h"
 #include "Scene/ISystem.h"
 #include "Scene/Scene.h"
+#include "Maths/BatchMaths.h"
+#include "Physics/PhysicsThread.h"
 
 namespace Lumos
 {
@@ -53,9 +55,19 @@ namespace Lumos
 		}
 
 		void OnInit() override{};
-		//Update Physics Engine
+		//Finishes the steps started last frame and writes the interpolated body state to the transforms
 		void OnUpdate(const TimeStep& timeStep, Scene* scene) override;
 
+		//Starts this frame's fixed steps on the physics thread, they run while the frame renders
+		void OnLateUpdate(const TimeStep& timeStep, Scene* scene) override;
+
+		//Waits for the steps in flight. Anything touching bodies, constraints or manifolds outside of the
+		//update (between OnLateUpdate and the next OnUpdate) must call this first
+		void SyncStep()
+		{
+			m_StepThread.Wait();
+		}
+
 		//Getters / Setters
 		bool IsPaused() const
 		{
@@ -63,6 +75,7 @@ namespace Lumos
 		}
 		void SetPaused(bool paused)
 		{
+			SyncStep();
 			m_IsPaused = paused;
 		}
 
@@ -107,6 +120,13 @@ namespace Lumos
 			return static_cast<int>(m_RigidBodys.size());
 		}
 
+		//Entities whose Transform was written this frame. Static and sleeping bodies are skipped, so renderers
+		//and culling structures only need to refit these
+		const std::vector<entt::entity>& GetMovedEntities() const
+		{
+			return m_MovedEntities;
+		}
+
 		IntegrationType GetIntegrationType() const
 		{
 			return m_IntegrationType;
@@ -131,12 +151,32 @@ namespace Lumos
 		}
 
 	protected:
+		//Body and constraint lists are kept between frames and only rebuilt when the registry signals a change
+		void SetScene(Scene* scene);
+		void RebuildBodyList();
+		void OnBodiesChanged(entt::registry& registry, entt::entity entity);
+		void OnConstraintsChanged(entt::registry& registry, entt::entity entity);
+
+		template<typename Component, auto Callback>
+		void ConnectSignals(entt::registry& registry);
+		template<typename Component>
+		void DisconnectSignals(entt::registry& registry);
+
+		//Writes interpolated state to the transforms of bodies that moved since their last write
+		void WriteTransforms(Scene* scene);
+
+		//Runs on the physics thread
+		void StepPhysics(uint32_t steps, Scene* scene);
+
 		//The actual time-independant update function
 		void UpdatePhysics(Scene* scene);
 
 		//Handles broadphase collision detection
 		void BroadPhaseCollisions();
 
+		//Recomputes every invalidated world space AABB in one batch before the broadphase reads them
+		void UpdateWorldSpaceAABBs();
+
 		//Handles narrowphase collision detection
 		void NarrowPhaseCollisions();
 
@@ -154,8 +194,41 @@ namespace Lumos
 		float m_DampingFactor;
 
 		std::vector<Ref<RigidBody3D>> m_RigidBodys;
+
+		//Entity and last written state of each body in m_RigidBodys
+		struct BodyWriteback
+		{
+			entt::entity Entity;
+			Maths::Vector3 Position;
+			Maths::Quaternion Orientation;
+			bool Written = false;
+		};
+		std::vector<BodyWriteback> m_BodyWritebacks;
+		std::vector<entt::entity> m_MovedEntities;
+		Scene* m_Scene = nullptr;
+		bool m_BodyListDirty = true;
 		std::vector<CollisionPair> m_BroadphaseCollisionPairs;
 
+		//Last separating axis or contact normal of each pair, seeds GJK next step. Keyed by a hash of the two
+		//bodies, a collision only costs a worse starting axis
+		struct CachedAxis
+		{
+			Maths::Vector3 Axis;
+			uint64_t LastStep = 0;
+		};
+		std::unordered_map<size_t, CachedAxis> m_PairAxisCache;
+		uint64_t m_StepIndex = 0;
+		float m_NarrowphaseTime = 0.0f;
+		float m_StepTime = 0.0f;
+		uint32_t m_StepCount = 0;
+
+		PhysicsThread m_StepThread;
+
+		std::vector<RigidBody3D*> m_AABBUpdateBodies;
+		std::vector<Maths::Matrix4> m_AABBUpdateTransforms;
+		std::vector<Maths::BoundingBox> m_AABBUpdateLocalBounds;
+		Maths::BoundingBoxStream m_AABBUpdateWorldBounds;
+
 		std::vector<Constraint*> m_Constraints; // Misc constraints between pairs of objects
 		std::vector<Manifold> m_Manifolds; // Contact constraints between pairs of objects
 		std::mutex m_ManifoldsMutex;
@@ -165,7 +238,6 @@ namespace Lumos
 
 		uint32_t m_DebugDrawFlags = 0;
 
-		bool m_MultipleUpdates = false;
 		static float s_UpdateTimestep;
 	};
 }
@@ -117,6 +117,11 @@ namespace Lumos
 			*out_max = wsTransform * m_PyramidHull->GetVertex(vMax).pos;
 	}
 
+	Maths::Vector3 PyramidCollisionShape::GetLocalSupportPoint(const Maths::Vector3& localAxis) const
+	{
+		return m_PyramidHull->GetVertex(m_PyramidHull->GetSupportVertex(localAxis)).pos;
+	}
+
 	void PyramidCollisionShape::GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                             const Maths::Vector3& axis,
                                                             ReferencePolygon& refPolygon) const
@@ -23,6 +23,8 @@ namespace Lumos
 		, m_AngularVelocity(properties.AngularVelocity)
 		, m_Torque(properties.Torque)
 		, m_InvInertia(Maths::Matrix3::ZERO)
+		, m_PreviousPosition(properties.Position)
+		, m_PreviousOrientation(properties.Orientation)
 		, m_OnCollisionCallback(nullptr)
 	{
 		LUMOS_ASSERT(properties.Mass > 0.0f, "Mass <= 0");
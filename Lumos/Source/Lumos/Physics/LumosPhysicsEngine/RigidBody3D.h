@@ -29,6 +29,7 @@ namespace Lumos
 	class Manifold;
 
 	//Callback function called whenever a collision is detected between two objects
+	//Runs on the physics thread, see LumosPhysicsEngine::SyncStep
 	//Params:
 	//	RigidBody3D* this_obj			- The current object class that contains the callback
 	//	RigidBody3D* colliding_obj	- The object that is colliding with the given object
@@ -98,6 +99,21 @@ namespace Lumos
 		}
 		const Maths::Matrix4& GetWorldSpaceTransform() const; //Built from scratch or returned from cached value
 
+		//State before the last physics step, rendering interpolates from it towards the current state
+		const Maths::Vector3& GetPreviousPosition() const
+		{
+			return m_PreviousPosition;
+		}
+		const Maths::Quaternion& GetPreviousOrientation() const
+		{
+			return m_PreviousOrientation;
+		}
+		void StorePreviousState()
+		{
+			m_PreviousPosition = m_Position;
+			m_PreviousOrientation = m_Orientation;
+		}
+
 		Maths::BoundingBox GetWorldSpaceAABB();
 
 		void WakeUp() override;
@@ -263,6 +279,7 @@ namespace Lumos
 			m_CollisionShape = Ref<CollisionShape>(shape.get());
 			CollisionShapeUpdated();
 			shape.release();
+			StorePreviousState();
 		}
 
 	protected:
@@ -288,6 +305,9 @@ namespace Lumos
 		Maths::Vector3 m_Torque;
 		Maths::Matrix3 m_InvInertia;
 
+		Maths::Vector3 m_PreviousPosition;
+		Maths::Quaternion m_PreviousOrientation;
+
 		//<----------COLLISION------------>
 		Ref<CollisionShape> m_CollisionShape;
 		PhysicsCollisionCallback m_OnCollisionCallback;
@@ -65,6 +65,12 @@ namespace Lumos
 			*out_max = pos + axis * m_Radius;
 	}
 
+	Maths::Vector3 SphereCollisionShape::GetLocalSupportPoint(const Maths::Vector3& localAxis) const
+	{
+		//Unit sphere, m_LocalTransform scales it by the radius
+		return localAxis.NormalizedOrDefault(Maths::Vector3(0.0f, 1.0f, 0.0f), Maths::M_EPSILON);
+	}
+
 	void SphereCollisionShape::GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                            const Maths::Vector3& axis,
                                                            ReferencePolygon& refPolygon) const
@@ -20,6 +20,7 @@ namespace Lumos
         virtual std::vector<CollisionEdge>& GetEdges(const RigidBody3D* currentObject) override;
 
 		virtual void GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Maths::Vector3& axis, Maths::Vector3* out_min, Maths::Vector3* out_max) const override;
+		virtual Maths::Vector3 GetLocalSupportPoint(const Maths::Vector3& localAxis) const override;
 		virtual void GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                  const Maths::Vector3& axis,
                                                  ReferencePolygon& refPolygon) const override;
@@ -0,0 +1,69 @@
+#include "Precompiled.h"
+#include "PhysicsThread.h"
+
+namespace Lumos
+{
+	PhysicsThread::~PhysicsThread()
+	{
+		if(!m_Thread.joinable())
+			return;
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this] { return !m_Busy; });
+			m_Quit = true;
+		}
+
+		m_Condition.notify_all();
+		m_Thread.join();
+	}
+
+	void PhysicsThread::Kick(const std::function<void()>& step)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this] { return !m_Busy; });
+			m_Step = step;
+			m_Busy = true;
+		}
+
+		//Started on first use so engines that never step don't own a thread
+		if(!m_Thread.joinable())
+			m_Thread = std::thread([this] { Run(); });
+
+		m_Condition.notify_all();
+	}
+
+	void PhysicsThread::Wait()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this] { return !m_Busy; });
+	}
+
+	bool PhysicsThread::IsBusy()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Busy;
+	}
+
+	void PhysicsThread::Run()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		while(true)
+		{
+			m_Condition.wait(lock, [this] { return m_Busy || m_Quit; });
+			if(m_Quit)
+				return;
+
+			lock.unlock();
+			m_Step();
+			lock.lock();
+
+			m_Step = nullptr;
+			m_Busy = false;
+			m_Condition.notify_all();
+		}
+	}
+}
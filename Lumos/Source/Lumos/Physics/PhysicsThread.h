@@ -0,0 +1,37 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Lumos
+{
+	//Runs physics steps on a dedicated thread so they overlap the rest of the frame. Kept out of the job system
+	//because JobSystem::Wait waits on every job, a long step would stall anyone else dispatching work.
+	//One step is in flight at a time, the owner calls Wait before touching anything the step uses
+	class LUMOS_EXPORT PhysicsThread
+	{
+	public:
+		PhysicsThread() = default;
+		~PhysicsThread();
+
+		//Starts step on the physics thread, waiting for the previous one first
+		void Kick(const std::function<void()>& step);
+
+		//Blocks until the step in flight has finished
+		void Wait();
+
+		bool IsBusy();
+
+	private:
+		void Run();
+
+		std::thread m_Thread;
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		std::function<void()> m_Step;
+		bool m_Busy = false;
+		bool m_Quit = false;
+	};
+}
@@ -18,6 +18,11 @@ namespace Lumos
 			return true;
 		}
 
+		bool GLCommandBuffer::InitSecondary(uint32_t workerIndex)
+		{
+			return Init(false);
+		}
+
 		void GLCommandBuffer::Unload()
 		{
 		}
@@ -13,6 +13,7 @@ namespace Lumos
 			~GLCommandBuffer();
 
 			bool Init(bool primary) override;
+			bool InitSecondary(uint32_t workerIndex) override;
 			void Unload() override;
 			void BeginRecording() override;
 			void BeginRecordingSecondary(RenderPass* renderPass, Framebuffer* framebuffer) override;
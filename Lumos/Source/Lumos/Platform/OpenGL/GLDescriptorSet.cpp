@@ -126,6 +126,16 @@ namespace Lumos
                     //buffer->SetData(size, data);
                     auto bufferHandle = static_cast<GLUniformBuffer*>(buffer)->GetHandle();
                     auto slot = bufferInfo.binding;
+
+					if(bufferInfo.type == DescriptorType::STORAGE_BUFFER)
+					{
+#ifdef GL_SHADER_STORAGE_BUFFER
+						LUMOS_PROFILE_SCOPE("glBindBufferBase");
+						GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, slot, bufferHandle));
+#endif
+						continue;
+					}
+
 					{
 						LUMOS_PROFILE_SCOPE("glBindBufferBase");
 						GLCall(glBindBufferBase(GL_UNIFORM_BUFFER, slot, bufferHandle));
@@ -71,6 +71,7 @@ namespace Lumos
             info.shader = pipelineCreateInfo.shader.get();
 			m_DescriptorSet = new GLDescriptorSet(info);
             m_TransparencyEnabled = pipelineCreateInfo.transparencyEnabled;
+            m_DepthWriteEnabled = pipelineCreateInfo.depthWriteEnabled;
 
             GLCall(glGenVertexArrays(1, &m_VertexArray));
 
@@ -102,6 +103,8 @@ namespace Lumos
             else
                 glDisable(GL_BLEND);
 
+            glDepthMask(m_DepthWriteEnabled ? GL_TRUE : GL_FALSE);
+
             m_Shader->Bind();
         }
 
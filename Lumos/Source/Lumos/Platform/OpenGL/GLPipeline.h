@@ -33,6 +33,7 @@ namespace Lumos
             GLRenderPass* m_RenderPass;
             std::string pipelineName;
             bool m_TransparencyEnabled = false;
+            bool m_DepthWriteEnabled = true;
             uint32_t m_VertexArray = -1;
             BufferLayout m_VertexBufferLayout;
         };
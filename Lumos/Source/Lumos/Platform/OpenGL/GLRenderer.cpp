@@ -9,6 +9,7 @@
 #include "GLTools.h"
 #include "Graphics/Mesh.h"
 #include "GLDescriptorSet.h"
+#include "GLShader.h"
 #include "Graphics/Material.h"
 
 namespace Lumos
@@ -225,6 +226,23 @@ namespace Lumos
 			//GLCall(glDrawArrays(GLTools::DrawTypeToGL(type), start, count));
 		}
 
+		void GLRenderer::DrawIndexedInstancedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount) const
+		{
+			LUMOS_PROFILE_FUNCTION();
+			Engine::Get().Statistics().NumDrawCalls++;
+			GLCall(glDrawElementsInstanced(GLTools::DrawTypeToGL(type), count, GLTools::DataTypeToGL(DataType::UNSIGNED_INT), nullptr, instanceCount));
+		}
+
+		void GLRenderer::DrawIndexedIndirectInternal(CommandBuffer* commandBuffer, DrawType type, UniformBuffer* argumentBuffer, uint32_t offset, uint32_t drawCount, uint32_t stride) const
+		{
+			//Not supported by the GL 4.1 backend, SupportsIndirectDraw is false
+		}
+
+		void GLRenderer::DispatchInternal(CommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const
+		{
+			//Not supported by the GL 4.1 backend, SupportsIndirectDraw is false
+		}
+
 		void GLRenderer::BindDescriptorSetsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, uint32_t dynamicOffset, std::vector<Graphics::DescriptorSet*>& descriptorSets)
 		{
 			LUMOS_PROFILE_FUNCTION();
@@ -235,6 +253,13 @@ namespace Lumos
 			}
 		}
 
+		void GLRenderer::PushConstantsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, std::vector<Graphics::PushConstant>& pushConstants)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			for(auto& pc : pushConstants)
+				static_cast<GLShader*>(pipeline->GetShader())->SetUserUniformBuffer(pc.shaderStage, pc.data, pc.size);
+		}
+
 		void GLRenderer::MakeDefault()
 		{
 			CreateFunc = CreateFuncGL;
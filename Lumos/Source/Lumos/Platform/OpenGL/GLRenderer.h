@@ -31,8 +31,12 @@ namespace Lumos
 			void InitInternal() override;
 
 			void BindDescriptorSetsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, uint32_t dynamicOffset, std::vector<Graphics::DescriptorSet*>& descriptorSets) override;
+			void PushConstantsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, std::vector<Graphics::PushConstant>& pushConstants) override;
 			void DrawInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, DataType dataType, void* indices) const override;
 			void DrawIndexedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start) const override;
+			void DrawIndexedInstancedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount) const override;
+			void DrawIndexedIndirectInternal(CommandBuffer* commandBuffer, DrawType type, UniformBuffer* argumentBuffer, uint32_t offset, uint32_t drawCount, uint32_t stride) const override;
+			void DispatchInternal(CommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const override;
 			void SetRenderModeInternal(RenderMode mode);
 			void OnResize(uint32_t width, uint32_t height) override;
 			void PresentInternal() override;
@@ -69,6 +69,13 @@ namespace Lumos
 			{
 				auto fileSize = FileSystem::GetFileSize(m_Path + file.second); //TODO: once process
 				uint32_t* source = reinterpret_cast<uint32_t*>(FileSystem::ReadFile(m_Path + file.second));
+				if(!source)
+				{
+					LUMOS_LOG_ERROR("Failed to load shader stage {0}", m_Path + file.second);
+					delete sources;
+					return;
+				}
+
 				std::vector<unsigned int> spv(source, source + fileSize / sizeof(unsigned int));
 
 				spirv_cross::CompilerGLSL* glsl = new spirv_cross::CompilerGLSL(std::move(spv));
@@ -126,7 +133,8 @@ namespace Lumos
 				}
 
 				spirv_cross::CompilerGLSL::Options options;
-				options.version = 410;
+				//Storage buffers need 4.3
+				options.version = resources.storage_buffers.empty() ? 410 : 430;
 				options.es = false;
 				options.vulkan_semantics = false;
 				options.separate_shader_objects = false;
@@ -494,6 +502,37 @@ namespace Lumos
 			s_CurrentlyBound = nullptr;
 		}
 
+		ShaderReloadResult GLShader::Reload()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			std::string physicalPath;
+			if(!VFS::Get()->ResolvePhysicalPath(m_Path, physicalPath))
+				return ShaderReloadResult::FAILED;
+
+			GLShader shader(physicalPath, m_LoadSPV);
+			if(!shader.m_Handle)
+				return ShaderReloadResult::FAILED;
+
+			//Descriptor sets look uniforms up by name when they are bound, so the layout is free to change.
+			//The old program is deleted with the temporary, GL keeps it alive while it is still in use
+			std::swap(m_Handle, shader.m_Handle);
+			std::swap(m_Source, shader.m_Source);
+			std::swap(m_UniformBuffers, shader.m_UniformBuffers);
+			std::swap(m_UserUniformBuffers, shader.m_UserUniformBuffers);
+			std::swap(m_ShaderTypes, shader.m_ShaderTypes);
+			std::swap(m_Resources, shader.m_Resources);
+			std::swap(m_Structs, shader.m_Structs);
+			std::swap(m_names, shader.m_names);
+			std::swap(m_uniformBlockLocations, shader.m_uniformBlockLocations);
+			std::swap(m_sampledImageLocations, shader.m_sampledImageLocations);
+			std::swap(m_pShaderCompilers, shader.m_pShaderCompilers);
+
+			//Either may have been bound while building, the next Bind has to switch to the new program
+			s_CurrentlyBound = nullptr;
+
+			return ShaderReloadResult::RELOADED;
+		}
+
 		void GLShader::Parse(std::map<ShaderType, std::string>* sources)
 		{
 			for(auto& source : *sources)
@@ -28,7 +28,7 @@ namespace Lumos
 			friend class ShaderManager;
 
 		private:
-			uint32_t m_Handle;
+			uint32_t m_Handle = 0;
 			std::string m_Name, m_Path;
 			std::string m_Source;
 
@@ -63,6 +63,7 @@ namespace Lumos
 			void Shutdown() const;
 			void Bind() const override;
 			void Unbind() const override;
+			ShaderReloadResult Reload() override;
 
 			void SetUserUniformBuffer(ShaderType type, uint8_t* data, uint32_t size);
 			void SetUniform(const std::string& name, uint8_t* data);
@@ -20,6 +20,7 @@ namespace Lumos
             case TextureFormat::RGBA8:			    return srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
             case TextureFormat::RGB16:              return GL_RGB16F;
 			case TextureFormat::RGBA16:             return GL_RGBA16F;
+			case TextureFormat::RG16:               return GL_RG16F;
 			case TextureFormat::RGB32:              return GL_RGB32F;
 			case TextureFormat::RGBA32:             return GL_RGBA32F;
 			case TextureFormat::DEPTH:              return GL_DEPTH24_STENCIL8;
@@ -61,6 +62,7 @@ namespace Lumos
 			case GL_RGB16:              return GL_RGB;
 			case GL_RGBA16:             return GL_RGBA;
             case GL_RGBA16F:            return GL_RGBA;
+            case GL_RG16F:              return GL_RG;
             case GL_RGB32F:             return GL_RGB;
             case GL_RGBA32F:            return GL_RGBA;
             case GL_SRGB:               return GL_RGB;
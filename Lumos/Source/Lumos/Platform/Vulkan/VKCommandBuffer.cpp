@@ -11,7 +11,7 @@ namespace Lumos
 {
 	namespace Graphics
 	{
-		VKCommandBuffer::VKCommandBuffer(): m_CommandBuffer(nullptr), m_Fence(VK_NULL_HANDLE), m_Primary(false)
+		VKCommandBuffer::VKCommandBuffer(): m_CommandBuffer(nullptr), m_CommandPool(VK_NULL_HANDLE), m_Fence(VK_NULL_HANDLE), m_Primary(false)
 		{
 		}
 
@@ -21,14 +21,25 @@ namespace Lumos
 		}
 
 		bool VKCommandBuffer::Init(bool primary)
+		{
+			return Init(primary, VKDevice::Get().GetCommandPool()->GetCommandPool());
+		}
+
+		bool VKCommandBuffer::InitSecondary(uint32_t workerIndex)
+		{
+			return Init(false, VKDevice::Get().GetWorkerCommandPool(workerIndex)->GetCommandPool());
+		}
+
+		bool VKCommandBuffer::Init(bool primary, VkCommandPool commandPool)
 		{
 			LUMOS_PROFILE_FUNCTION();
 			m_Primary = primary;
+			m_CommandPool = commandPool;
 
 			VkCommandBufferAllocateInfo cmdBufferCI{};
 
 			cmdBufferCI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            cmdBufferCI.commandPool = VKDevice::Get().GetCommandPool()->GetCommandPool();
+            cmdBufferCI.commandPool = m_CommandPool;
 			cmdBufferCI.commandBufferCount = 1;
 			cmdBufferCI.level = primary ? VK_COMMAND_BUFFER_LEVEL_PRIMARY : VK_COMMAND_BUFFER_LEVEL_SECONDARY;
 
@@ -46,7 +57,7 @@ namespace Lumos
 		{
 			LUMOS_PROFILE_FUNCTION();
 			vkDestroyFence(VKDevice::Get().GetDevice(), m_Fence, nullptr);
-			vkFreeCommandBuffers(VKDevice::Get().GetDevice(), VKDevice::Get().GetCommandPool()->GetCommandPool(),1, &m_CommandBuffer);
+			vkFreeCommandBuffers(VKDevice::Get().GetDevice(), m_CommandPool, 1, &m_CommandBuffer);
 		}
 
 		void VKCommandBuffer::BeginRecording()
@@ -96,6 +107,10 @@ namespace Lumos
 			LUMOS_PROFILE_FUNCTION();
             LUMOS_ASSERT(m_Primary, "Used Execute on secondary command buffer!");
 		
+            //Textures uploaded since the last submit have to be acquired on the graphics queue first
+            if(auto uploadQueue = VKDevice::Get().GetUploadQueue())
+                uploadQueue->Flush();
+
             uint32_t waitSemaphoreCount = waitSemaphore ? 1 : 0, signalSemaphoreCount = signalSemaphore ? 1 : 0;
 
             VkSubmitInfo submitInfo = {};
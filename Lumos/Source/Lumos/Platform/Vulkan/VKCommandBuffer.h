@@ -13,6 +13,7 @@ namespace Lumos
 			~VKCommandBuffer();
 
 			bool Init(bool primary) override;
+			bool InitSecondary(uint32_t workerIndex) override;
 			void Unload() override;
 			void BeginRecording() override;
 			void BeginRecordingSecondary(RenderPass* renderPass, Framebuffer* framebuffer) override;
@@ -31,7 +32,10 @@ namespace Lumos
         protected:
             static CommandBuffer* CreateFuncVulkan();
 		private:
+			bool Init(bool primary, VkCommandPool commandPool);
+
 			VkCommandBuffer m_CommandBuffer;
+			VkCommandPool m_CommandPool;
 			VkFence m_Fence;
 			bool m_Primary;
 		};
@@ -8,7 +8,12 @@ namespace Lumos
 	{
 		VKCommandPool::VKCommandPool()
 		{
-			Init();
+			Init(VKDevice::Get().GetPhysicalDevice()->GetGraphicsQueueFamilyIndex());
+		}
+
+		VKCommandPool::VKCommandPool(uint32_t queueFamilyIndex)
+		{
+			Init(queueFamilyIndex);
 		}
 
 		VKCommandPool::~VKCommandPool()
@@ -16,11 +21,11 @@ namespace Lumos
 			vkDestroyCommandPool(VKDevice::Get().GetDevice(), m_CommandPool, nullptr);
 		}
 
-		void VKCommandPool::Init()
+		void VKCommandPool::Init(uint32_t queueFamilyIndex)
 		{
 			VkCommandPoolCreateInfo cmdPoolCI{};
 
-			cmdPoolCI.queueFamilyIndex = VKDevice::Get().GetPhysicalDevice()-> GetGraphicsQueueFamilyIndex();
+			cmdPoolCI.queueFamilyIndex = queueFamilyIndex;
 			cmdPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 			cmdPoolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
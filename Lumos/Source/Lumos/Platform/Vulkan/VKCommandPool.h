@@ -10,9 +10,10 @@ namespace Lumos
 		{
 		public:
 			VKCommandPool();
+			VKCommandPool(uint32_t queueFamilyIndex);
 			~VKCommandPool();
 
-			void Init();
+			void Init(uint32_t queueFamilyIndex);
 
 			const VkCommandPool& GetCommandPool() const { return m_CommandPool; }
             
@@ -0,0 +1,189 @@
+#include "Precompiled.h"
+#include "VKDescriptorAllocator.h"
+#include "VKDevice.h"
+#include "VKTools.h"
+#include "Graphics/API/Renderer.h"
+
+namespace Lumos
+{
+	static constexpr uint32_t DESCRIPTOR_POOL_SET_COUNT = 512;
+
+	namespace Graphics
+	{
+		VKDescriptorAllocator::VKDescriptorAllocator(bool transient)
+			: m_Transient(transient)
+		{
+		}
+
+		VKDescriptorAllocator::~VKDescriptorAllocator()
+		{
+			for(auto pool : m_Pools)
+				vkDestroyDescriptorPool(VKDevice::Get().GetDevice(), pool, VK_NULL_HANDLE);
+
+			for(auto pool : m_FullPools)
+				vkDestroyDescriptorPool(VKDevice::Get().GetDevice(), pool, VK_NULL_HANDLE);
+		}
+
+		VkDescriptorPool VKDescriptorAllocator::Allocate(VkDescriptorSetLayout layout, VkDescriptorSet& set)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			VkDescriptorSetAllocateInfo allocateInfo = {};
+			allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocateInfo.descriptorSetCount = 1;
+			allocateInfo.pSetLayouts = &layout;
+
+			while(true)
+			{
+				if(m_Pools.empty())
+					m_Pools.push_back(CreatePool());
+
+				allocateInfo.descriptorPool = m_Pools.back();
+				const VkResult result = vkAllocateDescriptorSets(VKDevice::Get().GetDevice(), &allocateInfo, &set);
+
+				if(result == VK_SUCCESS)
+					return allocateInfo.descriptorPool;
+
+				if(result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+				{
+					VK_CHECK_RESULT(result);
+					set = VK_NULL_HANDLE;
+					return VK_NULL_HANDLE;
+				}
+
+				m_FullPools.push_back(m_Pools.back());
+				m_Pools.pop_back();
+			}
+		}
+
+		void VKDescriptorAllocator::Free(VkDescriptorPool pool, VkDescriptorSet set)
+		{
+			if(m_Transient || pool == VK_NULL_HANDLE)
+				return;
+
+			vkFreeDescriptorSets(VKDevice::Get().GetDevice(), pool, 1, &set);
+
+			auto it = std::find(m_FullPools.begin(), m_FullPools.end(), pool);
+			if(it != m_FullPools.end())
+			{
+				m_FullPools.erase(it);
+				m_Pools.insert(m_Pools.begin(), pool);
+			}
+		}
+
+		void VKDescriptorAllocator::Reset()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			m_Pools.insert(m_Pools.end(), m_FullPools.begin(), m_FullPools.end());
+			m_FullPools.clear();
+
+			for(auto pool : m_Pools)
+				vkResetDescriptorPool(VKDevice::Get().GetDevice(), pool, 0);
+		}
+
+		VkDescriptorPool VKDescriptorAllocator::CreatePool() const
+		{
+			LUMOS_PROFILE_FUNCTION();
+			//Per set ratios, most sets are a few textures and a uniform buffer
+			std::array<VkDescriptorPoolSize, 6> poolSizes =
+			{
+				VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,    DESCRIPTOR_POOL_SET_COUNT * 4 },
+				VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,             DESCRIPTOR_POOL_SET_COUNT / 2 },
+				VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,             DESCRIPTOR_POOL_SET_COUNT / 2 },
+				VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,            DESCRIPTOR_POOL_SET_COUNT * 2 },
+				VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,    DESCRIPTOR_POOL_SET_COUNT },
+				VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,            DESCRIPTOR_POOL_SET_COUNT }
+			};
+
+			VkDescriptorPoolCreateInfo poolCreateInfo = {};
+			poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			poolCreateInfo.flags = m_Transient ? 0 : VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+			poolCreateInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+			poolCreateInfo.pPoolSizes = poolSizes.data();
+			poolCreateInfo.maxSets = DESCRIPTOR_POOL_SET_COUNT;
+
+			VkDescriptorPool pool;
+			VK_CHECK_RESULT(vkCreateDescriptorPool(VKDevice::Get().GetDevice(), &poolCreateInfo, VK_NULL_HANDLE, &pool));
+			return pool;
+		}
+
+		VKDescriptorLayoutCache::~VKDescriptorLayoutCache()
+		{
+			for(auto& entry : m_Layouts)
+				vkDestroyDescriptorSetLayout(VKDevice::Get().GetDevice(), entry.Layout, VK_NULL_HANDLE);
+		}
+
+		static bool BindingsMatch(const std::vector<VkDescriptorSetLayoutBinding>& a, const std::vector<VkDescriptorSetLayoutBinding>& b)
+		{
+			if(a.size() != b.size())
+				return false;
+
+			for(size_t i = 0; i < a.size(); i++)
+			{
+				if(a[i].binding != b[i].binding || a[i].descriptorType != b[i].descriptorType || a[i].descriptorCount != b[i].descriptorCount || a[i].stageFlags != b[i].stageFlags)
+					return false;
+			}
+
+			return true;
+		}
+
+		VkDescriptorSetLayout VKDescriptorLayoutCache::Acquire(const std::vector<VkDescriptorSetLayoutBinding>& bindings)
+		{
+			for(auto& entry : m_Layouts)
+			{
+				if(BindingsMatch(entry.Bindings, bindings))
+				{
+					entry.RefCount++;
+					return entry.Layout;
+				}
+			}
+
+			//With descriptor indexing texture arrays are partially bound, only the slots that are sampled have to be written
+			std::vector<VkDescriptorBindingFlagsEXT> bindingFlags(bindings.size(), 0);
+			bool partiallyBound = false;
+			if(Renderer::GetCapabilities().SupportsBindless)
+			{
+				for(size_t i = 0; i < bindings.size(); i++)
+				{
+					if(bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER && bindings[i].descriptorCount > 1)
+					{
+						bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+						partiallyBound = true;
+					}
+				}
+			}
+
+			VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo{};
+			bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+			bindingFlagsCreateInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+			bindingFlagsCreateInfo.pBindingFlags = bindingFlags.data();
+
+			VkDescriptorSetLayoutCreateInfo layoutCreateInfo{};
+			layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutCreateInfo.pNext = partiallyBound ? &bindingFlagsCreateInfo : nullptr;
+			layoutCreateInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+			layoutCreateInfo.pBindings = bindings.data();
+
+			VkDescriptorSetLayout layout;
+			VK_CHECK_RESULT(vkCreateDescriptorSetLayout(VKDevice::Get().GetDevice(), &layoutCreateInfo, VK_NULL_HANDLE, &layout));
+
+			m_Layouts.push_back({ bindings, layout, 1 });
+			return layout;
+		}
+
+		void VKDescriptorLayoutCache::Release(VkDescriptorSetLayout layout)
+		{
+			for(auto it = m_Layouts.begin(); it != m_Layouts.end(); ++it)
+			{
+				if(it->Layout != layout)
+					continue;
+
+				if(--it->RefCount == 0)
+				{
+					vkDestroyDescriptorSetLayout(VKDevice::Get().GetDevice(), it->Layout, VK_NULL_HANDLE);
+					m_Layouts.erase(it);
+				}
+				return;
+			}
+		}
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "VK.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		//Hands out descriptor sets from a list of pools that grows whenever the existing ones run out.
+		//Persistent allocators free sets back to the pool they came from, transient ones never free single sets
+		//and instead reset every pool at once at the start of the next frame
+		class VKDescriptorAllocator
+		{
+		public:
+			VKDescriptorAllocator(bool transient);
+			~VKDescriptorAllocator();
+
+			//Returns the pool the set came from, which it is freed back to
+			VkDescriptorPool Allocate(VkDescriptorSetLayout layout, VkDescriptorSet& set);
+			void Free(VkDescriptorPool pool, VkDescriptorSet set);
+
+			//Transient only, every set handed out since the last reset becomes invalid
+			void Reset();
+
+			bool IsTransient() const { return m_Transient; }
+
+		private:
+			VkDescriptorPool CreatePool() const;
+
+			//Pools are moved to the full list when an allocation fails, and back once a set from them is freed
+			std::vector<VkDescriptorPool> m_Pools;
+			std::vector<VkDescriptorPool> m_FullPools;
+			bool m_Transient;
+		};
+
+		//Set layouts shared between every pipeline that declares the same bindings, so sets made for one
+		//pipeline can be bound with another and the set cache can match them
+		class VKDescriptorLayoutCache
+		{
+		public:
+			~VKDescriptorLayoutCache();
+
+			VkDescriptorSetLayout Acquire(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+			void Release(VkDescriptorSetLayout layout);
+
+		private:
+			struct Entry
+			{
+				std::vector<VkDescriptorSetLayoutBinding> Bindings;
+				VkDescriptorSetLayout Layout;
+				uint32_t RefCount;
+			};
+
+			std::vector<Entry> m_Layouts;
+		};
+	}
+}
@@ -1,41 +1,59 @@
 #include "Precompiled.h"
 #include "VKDescriptorSet.h"
+#include "VKDescriptorAllocator.h"
 #include "VKPipeline.h"
 #include "VKTools.h"
 #include "VKUniformBuffer.h"
 #include "VKTexture.h"
 #include "VKDevice.h"
-
-#define MAX_BUFFER_INFOS 32
-#define MAX_IMAGE_INFOS 32
-#define MAX_WRITE_DESCTIPTORS 32
+#include "Utilities/CombineHash.h"
 
 namespace Lumos
 {
 	namespace Graphics
 	{
+		namespace
+		{
+			struct CachedSet
+			{
+				VkDescriptorSet Set;
+				VkDescriptorPool Pool;
+				uint32_t RefCount;
+			};
+
+			struct CacheKeyHash
+			{
+				size_t operator()(const std::vector<uint64_t>& key) const
+				{
+					size_t hash = 0;
+					for(auto value : key)
+						HashCombine(hash, value);
+					return hash;
+				}
+			};
+
+			std::unordered_map<std::vector<uint64_t>, CachedSet, CacheKeyHash> s_SetCache;
+		}
+
 		VKDescriptorSet::VKDescriptorSet(const DescriptorInfo& info)
 		{
 			LUMOS_PROFILE_FUNCTION();
-			VkDescriptorSetAllocateInfo descriptorSetAllocateInfo;
-			descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-			descriptorSetAllocateInfo.descriptorPool = static_cast<Graphics::VKPipeline*>(info.pipeline)->GetDescriptorPool();
-			descriptorSetAllocateInfo.pSetLayouts = static_cast<Graphics::VKPipeline*>(info.pipeline)->GetDescriptorLayout(info.layoutIndex);
-			descriptorSetAllocateInfo.descriptorSetCount = info.count;
-			descriptorSetAllocateInfo.pNext = nullptr;
-
-			VK_CHECK_RESULT(vkAllocateDescriptorSets(VKDevice::Device(), &descriptorSetAllocateInfo, &m_DescriptorSet));
-
-			m_BufferInfoPool = new VkDescriptorBufferInfo[MAX_BUFFER_INFOS];
-			m_ImageInfoPool = new VkDescriptorImageInfo[MAX_IMAGE_INFOS];
-			m_WriteDescriptorSetPool = new VkWriteDescriptorSet[MAX_WRITE_DESCTIPTORS];
+			m_Shader = info.shader;
+			m_Layout = *static_cast<Graphics::VKPipeline*>(info.pipeline)->GetDescriptorLayout(info.layoutIndex);
+			m_Allocator = info.transient ? VKDevice::Get().GetTransientDescriptorAllocator() : VKDevice::Get().GetDescriptorAllocator();
 		}
 
 		VKDescriptorSet::~VKDescriptorSet()
 		{
-			delete[] m_BufferInfoPool;
-			delete[] m_ImageInfoPool;
-			delete[] m_WriteDescriptorSetPool;
+			Release();
+		}
+
+		VkDescriptorSet VKDescriptorSet::GetDescriptorSet()
+		{
+			if(m_DescriptorSet == VK_NULL_HANDLE)
+				Allocate();
+
+			return m_DescriptorSet;
 		}
 
 		void VKDescriptorSet::Update(std::vector<BufferInfo>& bufferInfos)
@@ -75,80 +93,180 @@ namespace Lumos
 		{
 			return new VKDescriptorSet(info);
 		}
+
+		void VKDescriptorSet::Allocate()
+		{
+			m_DescriptorPool = m_Allocator->Allocate(m_Layout, m_DescriptorSet);
+		}
+
+		void VKDescriptorSet::Release()
+		{
+			if(m_DescriptorSet == VK_NULL_HANDLE)
+				return;
+
+			if(!m_CacheKey.empty())
+			{
+				auto it = s_SetCache.find(m_CacheKey);
+				m_CacheKey.clear();
+
+				if(it != s_SetCache.end() && --it->second.RefCount > 0)
+				{
+					m_DescriptorSet = VK_NULL_HANDLE;
+					m_DescriptorPool = VK_NULL_HANDLE;
+					return;
+				}
+
+				if(it != s_SetCache.end())
+					s_SetCache.erase(it);
+			}
+
+			m_Allocator->Free(m_DescriptorPool, m_DescriptorSet);
+			m_DescriptorSet = VK_NULL_HANDLE;
+			m_DescriptorPool = VK_NULL_HANDLE;
+		}
     
         void VKDescriptorSet::UpdateInternal(std::vector<ImageInfo>* imageInfos, std::vector<BufferInfo>* bufferInfos)
         {
 			LUMOS_PROFILE_FUNCTION();
-            m_Dynamic = false;
-			int descriptorWritesCount = 0;
-
             if(imageInfos != nullptr)
             {
-				int imageIndex = 0;
-
                 for (auto& imageInfo : *imageInfos)
                 {
-                    if(imageInfo.count == 1)
-                    {
-                        VkDescriptorImageInfo& des = *static_cast<VkDescriptorImageInfo*>(imageInfo.texture->GetHandle());
-                        m_ImageInfoPool[imageIndex].imageLayout = des.imageLayout;
-                        m_ImageInfoPool[imageIndex].imageView = des.imageView;
-                        m_ImageInfoPool[imageIndex].sampler = des.sampler;
-                    }
-                    else
-                    {
-                        for (int i = 0; i < imageInfo.count; i++)
-                        {
-                            VkDescriptorImageInfo& des = *static_cast<VkDescriptorImageInfo*>(imageInfo.textures[i]->GetHandle());
-                            m_ImageInfoPool[i + imageIndex].imageLayout = des.imageLayout;
-                            m_ImageInfoPool[i + imageIndex].imageView = des.imageView;
-                            m_ImageInfoPool[i + imageIndex].sampler = des.sampler;
-                        }
-                    }
-
-					VkWriteDescriptorSet writeDescriptorSet{};
-					writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-					writeDescriptorSet.dstSet = m_DescriptorSet;
-					writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-					writeDescriptorSet.dstBinding = imageInfo.binding;
-					writeDescriptorSet.pImageInfo = &m_ImageInfoPool[imageIndex];
-					writeDescriptorSet.descriptorCount = imageInfo.count;
-
-					m_WriteDescriptorSetPool[descriptorWritesCount] = writeDescriptorSet;
-					imageIndex++;
-					descriptorWritesCount++;
+					Binding& binding = m_Bindings[imageInfo.binding];
+					binding.Type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+					binding.Images.resize(imageInfo.count);
+
+					for (int i = 0; i < imageInfo.count; i++)
+					{
+						Texture* texture = imageInfo.count == 1 ? imageInfo.texture : imageInfo.textures[i];
+						binding.Images[i] = *static_cast<VkDescriptorImageInfo*>(texture->GetHandle());
+					}
                 }
             }
       
             if(bufferInfos != nullptr)
             {
-                int index = 0;
-                
                 for (auto& bufferInfo : *bufferInfos)
                 {
-					m_BufferInfoPool[index].buffer = *dynamic_cast<VKUniformBuffer*>(bufferInfo.buffer)->GetBuffer();
-					m_BufferInfoPool[index].offset = bufferInfo.offset;
-					m_BufferInfoPool[index].range = bufferInfo.size;
-    
-                    VkWriteDescriptorSet writeDescriptorSet{};
-					writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    writeDescriptorSet.dstSet = m_DescriptorSet;
-                    writeDescriptorSet.descriptorType = VKTools::DescriptorTypeToVK(bufferInfo.type);
-                    writeDescriptorSet.dstBinding = bufferInfo.binding;
-                    writeDescriptorSet.pBufferInfo = &m_BufferInfoPool[index];
-                    writeDescriptorSet.descriptorCount = 1;
-    
-					m_WriteDescriptorSetPool[descriptorWritesCount] = writeDescriptorSet;
-                    index++;
-					descriptorWritesCount++;
-    
-                    if (bufferInfo.type == DescriptorType::UNIFORM_BUFFER_DYNAMIC)
-                        m_Dynamic = true;
+					Binding& binding = m_Bindings[bufferInfo.binding];
+					binding.Type = VKTools::DescriptorTypeToVK(bufferInfo.type);
+					binding.Images.clear();
+					binding.Buffer.buffer = *dynamic_cast<VKUniformBuffer*>(bufferInfo.buffer)->GetBuffer();
+					binding.Buffer.offset = bufferInfo.offset;
+					binding.Buffer.range = bufferInfo.size;
                 }
             }
-            
-			vkUpdateDescriptorSets(VKDevice::Get().GetDevice(), descriptorWritesCount,
-				m_WriteDescriptorSetPool, 0, nullptr);
+
+			m_Dynamic = false;
+			for(auto& binding : m_Bindings)
+			{
+				if(binding.second.Type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+					m_Dynamic = true;
+			}
+
+			if(m_Allocator->IsTransient())
+			{
+				if(m_DescriptorSet == VK_NULL_HANDLE)
+					Allocate();
+
+				Write();
+				return;
+			}
+
+			std::vector<uint64_t> key = GetCacheKey();
+			if(m_DescriptorSet != VK_NULL_HANDLE && key == m_CacheKey)
+				return;
+
+			auto cached = s_SetCache.find(key);
+			if(cached != s_SetCache.end())
+			{
+				Release();
+				cached->second.RefCount++;
+				m_DescriptorSet = cached->second.Set;
+				m_DescriptorPool = cached->second.Pool;
+				m_CacheKey = std::move(key);
+				return;
+			}
+
+			//Rewritten in place unless another set shares it
+			auto current = m_CacheKey.empty() ? s_SetCache.end() : s_SetCache.find(m_CacheKey);
+			if(current != s_SetCache.end() && current->second.RefCount > 1)
+			{
+				current->second.RefCount--;
+				m_DescriptorSet = VK_NULL_HANDLE;
+				m_DescriptorPool = VK_NULL_HANDLE;
+			}
+			else if(current != s_SetCache.end())
+				s_SetCache.erase(current);
+
+			if(m_DescriptorSet == VK_NULL_HANDLE)
+				Allocate();
+
+			Write();
+
+			m_CacheKey = std::move(key);
+			s_SetCache[m_CacheKey] = { m_DescriptorSet, m_DescriptorPool, 1 };
         }
+
+		void VKDescriptorSet::Write()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			std::vector<VkWriteDescriptorSet> writes;
+			writes.reserve(m_Bindings.size());
+
+			for(auto& binding : m_Bindings)
+			{
+				VkWriteDescriptorSet writeDescriptorSet{};
+				writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writeDescriptorSet.dstSet = m_DescriptorSet;
+				writeDescriptorSet.descriptorType = binding.second.Type;
+				writeDescriptorSet.dstBinding = binding.first;
+
+				if(binding.second.Type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+				{
+					writeDescriptorSet.pImageInfo = binding.second.Images.data();
+					writeDescriptorSet.descriptorCount = static_cast<uint32_t>(binding.second.Images.size());
+				}
+				else
+				{
+					writeDescriptorSet.pBufferInfo = &binding.second.Buffer;
+					writeDescriptorSet.descriptorCount = 1;
+				}
+
+				writes.push_back(writeDescriptorSet);
+			}
+
+			vkUpdateDescriptorSets(VKDevice::Get().GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+		}
+
+		std::vector<uint64_t> VKDescriptorSet::GetCacheKey() const
+		{
+			std::vector<uint64_t> key;
+			key.push_back(uint64_t(m_Layout));
+
+			for(auto& binding : m_Bindings)
+			{
+				key.push_back(binding.first);
+				key.push_back(uint64_t(binding.second.Type));
+
+				if(binding.second.Type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+				{
+					for(auto& image : binding.second.Images)
+					{
+						key.push_back(uint64_t(image.sampler));
+						key.push_back(uint64_t(image.imageView));
+						key.push_back(uint64_t(image.imageLayout));
+					}
+				}
+				else
+				{
+					key.push_back(uint64_t(binding.second.Buffer.buffer));
+					key.push_back(binding.second.Buffer.offset);
+					key.push_back(binding.second.Buffer.range);
+				}
+			}
+
+			return key;
+		}
     }
 }
@@ -2,17 +2,24 @@
 #include "Graphics/API/DescriptorSet.h"
 #include "VK.h"
 
+#include <map>
+
 namespace Lumos
 {
 	namespace Graphics
 	{
+		class VKDescriptorAllocator;
+
+		//Persistent sets are cached by layout and everything bound to them, sets that end up with the same
+		//contents share one VkDescriptorSet and updating a set to contents it already has writes nothing.
+		//Transient sets come from the per frame allocator and are only valid until the next frame starts
 		class VKDescriptorSet : public DescriptorSet
 		{
 		public:
 			VKDescriptorSet(const DescriptorInfo& info);
 			~VKDescriptorSet();
 
-			VkDescriptorSet GetDescriptorSet() const { return m_DescriptorSet; }
+			VkDescriptorSet GetDescriptorSet();
 
 			void Update(std::vector<ImageInfo>& imageInfos, std::vector<BufferInfo>& bufferInfos) override;
 			void Update(std::vector<BufferInfo>& bufferInfos) override;
@@ -33,14 +40,30 @@ namespace Lumos
             
 			static DescriptorSet* CreateFuncVulkan(const DescriptorInfo&);
 		private:
-			VkDescriptorSet m_DescriptorSet;
+			//Everything written so far, partial updates are merged so the cache key always covers the whole set
+			struct Binding
+			{
+				VkDescriptorType Type;
+				std::vector<VkDescriptorImageInfo> Images;
+				VkDescriptorBufferInfo Buffer;
+			};
+
+			void Allocate();
+			void Release();
+			void Write();
+			std::vector<uint64_t> GetCacheKey() const;
+
+			VkDescriptorSet m_DescriptorSet = VK_NULL_HANDLE;
+			VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
+			VkDescriptorSetLayout m_Layout = VK_NULL_HANDLE;
+			VKDescriptorAllocator* m_Allocator = nullptr;
+			std::map<uint32_t, Binding> m_Bindings;
+			std::vector<uint64_t> m_CacheKey;
+
 			uint32_t m_DynamicOffset = 0;
 			Shader* m_Shader = nullptr;
 			bool m_Dynamic = false;
 			std::vector<PushConstant> m_PushConstants;
-			VkDescriptorBufferInfo* m_BufferInfoPool = nullptr;
-			VkDescriptorImageInfo* m_ImageInfoPool = nullptr;
-			VkWriteDescriptorSet* m_WriteDescriptorSetPool = nullptr;
 		};
 	}
 }
@@ -7,6 +7,7 @@
 #include "VKDevice.h"
 #include "VKRenderer.h"
 #include "VKCommandPool.h"
+#include "Graphics/MaterialTable.h"
 
 namespace Lumos
 {
@@ -60,6 +61,7 @@ namespace Lumos
 			
 			vkGetPhysicalDeviceProperties(m_PhysicalDevice, &m_PhysicalDeviceProperties);
 			vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
+			vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &m_Features);
 			
 			LUMOS_LOG_INFO("Vulkan : {0}.{1}.{2}", VK_VERSION_MAJOR(m_PhysicalDeviceProperties.apiVersion), VK_VERSION_MINOR(m_PhysicalDeviceProperties.apiVersion), VK_VERSION_PATCH(m_PhysicalDeviceProperties.apiVersion));
 			LUMOS_LOG_INFO("GPU : {0}", std::string(m_PhysicalDeviceProperties.deviceName));
@@ -111,8 +113,14 @@ namespace Lumos
 			
 			static const float defaultQueuePriority(0.0f);
 			
-            int requestedQueueTypes = VK_QUEUE_GRAPHICS_BIT;// | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
+            int requestedQueueTypes = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
 			m_QueueFamilyIndices = GetQueueFamilyIndices(requestedQueueTypes);
+
+			// Share the graphics family when none reports the capability, graphics queues can always transfer
+			if (m_QueueFamilyIndices.Compute == -1)
+				m_QueueFamilyIndices.Compute = m_QueueFamilyIndices.Graphics;
+			if (m_QueueFamilyIndices.Transfer == -1)
+				m_QueueFamilyIndices.Transfer = m_QueueFamilyIndices.Graphics;
 			
 			// Graphics queue
 			if (requestedQueueTypes & VK_QUEUE_GRAPHICS_BIT)
@@ -250,7 +258,12 @@ namespace Lumos
 
 		VKDevice::~VKDevice()
 		{
+			m_UploadQueue.reset();
 			m_CommandPool.reset();
+			m_WorkerCommandPools.clear();
+			m_DescriptorAllocator.reset();
+			m_TransientDescriptorAllocator.reset();
+			m_DescriptorLayoutCache.reset();
 			vkDestroyPipelineCache(m_Device, m_PipelineCache, VK_NULL_HANDLE);
 			
 #ifdef USE_VMA_ALLOCATOR
@@ -274,6 +287,13 @@ namespace Lumos
 			deviceFeatures.fillModeNonSolid = VK_TRUE;
 			deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+			//Gpu driven rendering, instance data is looked up with gl_InstanceIndex
+			const auto& supportedFeatures = m_PhysicalDevice->m_Features;
+			deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+			deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+			Renderer::GetCapabilities().SupportsIndirectDraw = supportedFeatures.drawIndirectFirstInstance == VK_TRUE;
+			Renderer::GetCapabilities().SupportsParallelRecording = true;
+
             std::vector<const char*> deviceExtensions =
             {
 				VK_KHR_SWAPCHAIN_EXTENSION_NAME
@@ -286,8 +306,64 @@ namespace Lumos
 				m_EnableDebugMarkers = true;
 			}
 			
+			//Bindless materials, one partially bound texture array indexed with a per material slot
+			VkPhysicalDeviceDescriptorIndexingFeaturesEXT supportedIndexing{};
+			supportedIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+			//Uploads on the transfer queue are ordered against the graphics queue with one timeline semaphore
+			VkPhysicalDeviceTimelineSemaphoreFeaturesKHR supportedTimeline{};
+			supportedTimeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+
+			void* supportedChain = nullptr;
+			if(m_PhysicalDevice->IsExtensionSupported(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME))
+			{
+				supportedIndexing.pNext = supportedChain;
+				supportedChain = &supportedIndexing;
+			}
+			if(m_PhysicalDevice->IsExtensionSupported(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+			{
+				supportedTimeline.pNext = supportedChain;
+				supportedChain = &supportedTimeline;
+			}
+
+			if(supportedChain && vkGetPhysicalDeviceFeatures2 && m_PhysicalDevice->m_PhysicalDeviceProperties.apiVersion >= VK_API_VERSION_1_1)
+			{
+				VkPhysicalDeviceFeatures2 features2{};
+				features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+				features2.pNext = supportedChain;
+				vkGetPhysicalDeviceFeatures2(m_PhysicalDevice->GetVulkanPhysicalDevice(), &features2);
+			}
+
+			const auto& limits = m_PhysicalDevice->m_PhysicalDeviceProperties.limits;
+			const bool bindless = supportedIndexing.descriptorBindingPartiallyBound && supportedIndexing.shaderSampledImageArrayNonUniformIndexing
+				&& limits.maxPerStageDescriptorSamplers >= MAX_BINDLESS_TEXTURES && limits.maxPerStageDescriptorSampledImages >= MAX_BINDLESS_TEXTURES;
+			Renderer::GetCapabilities().SupportsBindless = bindless;
+
+			void* enabledChain = nullptr;
+			VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+			indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+			if(bindless)
+			{
+				indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+				indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+				indexingFeatures.pNext = enabledChain;
+				enabledChain = &indexingFeatures;
+				deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+			}
+
+			m_TimelineSemaphores = supportedTimeline.timelineSemaphore == VK_TRUE;
+			VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures{};
+			timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+			if(m_TimelineSemaphores)
+			{
+				timelineFeatures.timelineSemaphore = VK_TRUE;
+				timelineFeatures.pNext = enabledChain;
+				enabledChain = &timelineFeatures;
+				deviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+			}
+
 			// Device
 			VkDeviceCreateInfo deviceCI{};
+			deviceCI.pNext = enabledChain;
 			deviceCI.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 			deviceCI.queueCreateInfoCount = static_cast<uint32_t>(m_PhysicalDevice->m_QueueCreateInfos.size());;
 			deviceCI.pQueueCreateInfos = m_PhysicalDevice->m_QueueCreateInfos.data();
@@ -303,8 +379,12 @@ namespace Lumos
 				return false;
 			}
 
+			m_EnabledFeatures = deviceFeatures;
+
 			vkGetDeviceQueue(m_Device, m_PhysicalDevice->m_QueueFamilyIndices.Graphics, 0, &m_GraphicsQueue);
 			vkGetDeviceQueue(m_Device, m_PhysicalDevice->m_QueueFamilyIndices.Graphics, 0, &m_PresentQueue);
+			vkGetDeviceQueue(m_Device, m_PhysicalDevice->m_QueueFamilyIndices.Compute, 0, &m_ComputeQueue);
+			vkGetDeviceQueue(m_Device, m_PhysicalDevice->m_QueueFamilyIndices.Transfer, 0, &m_TransferQueue);
 			
 #ifdef USE_VMA_ALLOCATOR
 			VmaAllocatorCreateInfo allocatorInfo = {};
@@ -345,12 +425,31 @@ namespace Lumos
 			}
 #endif
             m_CommandPool = CreateRef<VKCommandPool>();
+			m_DescriptorAllocator = CreateUniqueRef<VKDescriptorAllocator>(false);
+			m_TransientDescriptorAllocator = CreateUniqueRef<VKDescriptorAllocator>(true);
+			m_DescriptorLayoutCache = CreateUniqueRef<VKDescriptorLayoutCache>();
+
+			//Without a separate family the copies would only queue up behind the frame on the same hardware queue
+			const auto& queueFamilies = m_PhysicalDevice->m_QueueFamilyIndices;
+			if(m_TimelineSemaphores && queueFamilies.Transfer != queueFamilies.Graphics)
+			{
+				m_UploadQueue = CreateUniqueRef<VKUploadQueue>();
+				LUMOS_LOG_INFO("[VULKAN] Uploading on transfer queue family {0}", queueFamilies.Transfer);
+			}
             
 			CreateTracyContext();
             CreatePipelineCache();
 			return VK_SUCCESS;
 		}
 
+		VKCommandPool* VKDevice::GetWorkerCommandPool(uint32_t index)
+		{
+			while(m_WorkerCommandPools.size() <= index)
+				m_WorkerCommandPools.push_back(CreateUniqueRef<VKCommandPool>());
+
+			return m_WorkerCommandPools[index].get();
+		}
+
 		void VKDevice::CreatePipelineCache()
 		{
 			VkPipelineCacheCreateInfo pipelineCacheCI{};
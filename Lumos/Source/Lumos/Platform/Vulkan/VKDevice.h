@@ -3,6 +3,8 @@
 #include "VK.h"
 #include "VKContext.h"
 #include "VKCommandPool.h"
+#include "VKDescriptorAllocator.h"
+#include "VKUploadQueue.h"
 
 #ifdef USE_VMA_ALLOCATOR
 #ifdef LUMOS_DEBUG
@@ -30,6 +32,8 @@ namespace Lumos
 			
 			VkPhysicalDevice GetVulkanPhysicalDevice() const { return m_PhysicalDevice; }
 			int32_t GetGraphicsQueueFamilyIndex() { return m_QueueFamilyIndices.Graphics; }
+			int32_t GetComputeQueueFamilyIndex() { return m_QueueFamilyIndices.Compute; }
+			int32_t GetTransferQueueFamilyIndex() { return m_QueueFamilyIndices.Transfer; }
 			VkPhysicalDeviceProperties GetProperties() const { return m_PhysicalDeviceProperties; };
 			
 			private:
@@ -74,10 +78,24 @@ namespace Lumos
 			
 			VkQueue GetGraphicsQueue() const { return m_GraphicsQueue; };
 			VkQueue GetPresentQueue() const { return m_PresentQueue; };
+			//Same as the graphics queue when the device has no separate family for them
+			VkQueue GetComputeQueue() const { return m_ComputeQueue; };
+			VkQueue GetTransferQueue() const { return m_TransferQueue; };
             
             const Ref<VKCommandPool>& GetCommandPool() const { return m_CommandPool; }
+			//One pool per worker slot so secondary buffers can be recorded in parallel. Created on first use, main thread only
+			VKCommandPool* GetWorkerCommandPool(uint32_t index);
+
+			//Null unless the device has a dedicated transfer family and timeline semaphores
+			VKUploadQueue* GetUploadQueue() const { return m_UploadQueue.get(); }
+			bool SupportsTimelineSemaphores() const { return m_TimelineSemaphores; }
+
+			VKDescriptorAllocator* GetDescriptorAllocator() const { return m_DescriptorAllocator.get(); }
+			VKDescriptorAllocator* GetTransientDescriptorAllocator() const { return m_TransientDescriptorAllocator.get(); }
+			VKDescriptorLayoutCache* GetDescriptorLayoutCache() const { return m_DescriptorLayoutCache.get(); }
 
 			VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
+			const VkPhysicalDeviceFeatures& GetEnabledFeatures() const { return m_EnabledFeatures; }
 			
 			tracy::VkCtx* GetTracyContext() { return m_TracyContext; }
             
@@ -92,14 +110,21 @@ namespace Lumos
 			
 			VkQueue m_GraphicsQueue;
 			VkQueue m_PresentQueue;
+			VkQueue m_ComputeQueue;
+			VkQueue m_TransferQueue;
 			VkPipelineCache m_PipelineCache;
-			VkDescriptorPool m_DescriptorPool;
 			VkPhysicalDeviceFeatures m_EnabledFeatures;
             
             Ref<VKCommandPool> m_CommandPool;
+			std::vector<UniqueRef<VKCommandPool>> m_WorkerCommandPools;
+			UniqueRef<VKUploadQueue> m_UploadQueue;
+			UniqueRef<VKDescriptorAllocator> m_DescriptorAllocator;
+			UniqueRef<VKDescriptorAllocator> m_TransientDescriptorAllocator;
+			UniqueRef<VKDescriptorLayoutCache> m_DescriptorLayoutCache;
 			Ref<VKPhysicalDevice> m_PhysicalDevice;
 
 			bool m_EnableDebugMarkers = false;
+			bool m_TimelineSemaphores = false;
 			
             static uint32_t s_GraphicsQueueFamilyIndex;
 			
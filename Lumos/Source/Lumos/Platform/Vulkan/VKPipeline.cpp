@@ -10,8 +10,6 @@
 
 namespace Lumos
 {
-    static constexpr uint32_t MAX_DESCRIPTOR_SET_COUNT = 1500;
-
 	namespace Graphics
 	{
 		VKPipeline::VKPipeline(const PipelineInfo& pipelineCreateInfo)
@@ -29,6 +27,7 @@ namespace Lumos
 		bool VKPipeline::Init(const PipelineInfo& pipelineCreateInfo)
 		{
 			m_Shader = pipelineCreateInfo.shader;
+			m_Description = pipelineCreateInfo;
 
             std::vector<std::vector<Graphics::DescriptorLayoutInfo>> layouts;
             
@@ -60,16 +59,7 @@ namespace Lumos
                     setLayoutBindings.push_back(setLayoutBinding);
                 }
 
-                // Pipeline layout
-                VkDescriptorSetLayoutCreateInfo descriptorLayoutCI{};
-                descriptorLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-                descriptorLayoutCI.bindingCount = static_cast<uint32_t>(setLayoutBindings.size());
-                descriptorLayoutCI.pBindings = setLayoutBindings.data();
-
-                VkDescriptorSetLayout layout;
-                vkCreateDescriptorSetLayout(VKDevice::Get().GetDevice(), &descriptorLayoutCI, VK_NULL_HANDLE, &layout);
-
-                m_DescriptorLayouts.push_back(layout);
+                m_DescriptorLayouts.push_back(VKDevice::Get().GetDescriptorLayoutCache()->Acquire(setLayoutBindings));
             }
             
             const auto& pushConsts = m_Shader.As<VKShader>()->GetPushConstant();
@@ -90,27 +80,6 @@ namespace Lumos
 
 			VK_CHECK_RESULT(vkCreatePipelineLayout(VKDevice::Get().GetDevice(), &pipelineLayoutCreateInfo, VK_NULL_HANDLE, &m_PipelineLayout));
 
-            // Pool sizes
-            std::array<VkDescriptorPoolSize, 5> pool_sizes =
-            {
-                VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_SAMPLER,                   10 },
-                VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,             10 },
-                VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,             10 },
-                VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,            10 },
-                VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,    10 }
-            };
-
-            // Create info
-            VkDescriptorPoolCreateInfo pool_create_info = {};
-            pool_create_info.sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-            pool_create_info.flags          = 0;
-            pool_create_info.poolSizeCount  = static_cast<uint32_t>(pool_sizes.size());
-            pool_create_info.pPoolSizes     = pool_sizes.data();
-            pool_create_info.maxSets        = MAX_DESCRIPTOR_SET_COUNT;
-
-            // Pool
-            VK_CHECK_RESULT(vkCreateDescriptorPool(VKDevice::Get().GetDevice(), &pool_create_info, nullptr, &m_DescriptorPool));
-
 			DescriptorInfo info;
 			info.pipeline = this;
 			info.layoutIndex = 0;
@@ -118,6 +87,32 @@ namespace Lumos
 
 			m_DescriptorSet = new VKDescriptorSet(info);
 
+            CreatePipeline(pipelineCreateInfo);
+
+			return true;
+		}
+
+		void VKPipeline::CreatePipeline(const PipelineInfo& pipelineCreateInfo)
+		{
+            auto vkshader = pipelineCreateInfo.shader.As<VKShader>();
+
+            //Compute shaders only need the layout, renderpass and fixed function state are ignored
+            if(vkshader->GetStageCount() == 1 && vkshader->GetShaderStages()[0].stage == VK_SHADER_STAGE_COMPUTE_BIT)
+            {
+                m_BindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
+
+                VkComputePipelineCreateInfo computePipelineCreateInfo{};
+                computePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+                computePipelineCreateInfo.layout = m_PipelineLayout;
+                computePipelineCreateInfo.stage = vkshader->GetShaderStages()[0];
+                computePipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+                computePipelineCreateInfo.basePipelineIndex = -1;
+
+                VK_CHECK_RESULT(vkCreateComputePipelines(VKDevice::Get().GetDevice(), VKDevice::Get().GetPipelineCache(), 1, &computePipelineCreateInfo, VK_NULL_HANDLE, &m_Pipeline));
+
+                return;
+            }
+
 			// Pipeline
 			std::vector<VkDynamicState> dynamicStateDescriptors;
 			VkPipelineDynamicStateCreateInfo dynamicStateCI{};
@@ -232,7 +227,7 @@ namespace Lumos
 			ds.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
 			ds.pNext = NULL;
 			ds.depthTestEnable = VK_TRUE;
-			ds.depthWriteEnable = VK_TRUE;
+			ds.depthWriteEnable = pipelineCreateInfo.depthWriteEnabled ? VK_TRUE : VK_FALSE;
 			ds.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
 			ds.depthBoundsTestEnable = VK_FALSE;
 			ds.stencilTestEnable = VK_FALSE;
@@ -260,7 +255,6 @@ namespace Lumos
 			dynamicStateCI.dynamicStateCount = uint32_t(dynamicStateDescriptors.size());
 			dynamicStateCI.pDynamicStates = dynamicStateDescriptors.data();
 
-            auto vkshader = pipelineCreateInfo.shader.As<VKShader>();
 			VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo{};
 			graphicsPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 			graphicsPipelineCreateInfo.pNext = NULL;
@@ -282,39 +276,42 @@ namespace Lumos
 			graphicsPipelineCreateInfo.subpass = 0;
 
 			VK_CHECK_RESULT(vkCreateGraphicsPipelines(VKDevice::Get().GetDevice(), VKDevice::Get().GetPipelineCache(), 1, &graphicsPipelineCreateInfo, VK_NULL_HANDLE, &m_Pipeline));
+		}
 
-			return true;
+		void VKPipeline::OnShaderReloaded()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			//Submissions wait for the gpu to finish, so between frames nothing still uses the old pipeline.
+			//It keeps being used if the new one fails to build
+			VkPipeline previous = m_Pipeline;
+			m_Pipeline = VK_NULL_HANDLE;
+			CreatePipeline(m_Description);
+
+			if(m_Pipeline == VK_NULL_HANDLE)
+			{
+				LUMOS_LOG_ERROR("Failed to rebuild pipeline for shader {0}", m_Shader->GetName());
+				m_Pipeline = previous;
+				return;
+			}
+
+			vkDestroyPipeline(VKDevice::Get().GetDevice(), previous, VK_NULL_HANDLE);
 		}
 
 		void VKPipeline::Unload() const
 		{
-			vkDestroyDescriptorPool(VKDevice::Get().GetDevice(), m_DescriptorPool, VK_NULL_HANDLE);
 			vkDestroyPipelineLayout(VKDevice::Get().GetDevice(), m_PipelineLayout, VK_NULL_HANDLE);
 
 			for (auto& descriptorLayout : m_DescriptorLayouts)
-				vkDestroyDescriptorSetLayout(VKDevice::Get().GetDevice(), descriptorLayout, VK_NULL_HANDLE);
+				VKDevice::Get().GetDescriptorLayoutCache()->Release(descriptorLayout);
 
 			vkDestroyPipeline(VKDevice::Get().GetDevice(), m_Pipeline, VK_NULL_HANDLE);
 		}
 
 		void VKPipeline::Bind(CommandBuffer* cmdBuffer)
 		{
-			vkCmdBindPipeline(static_cast<VKCommandBuffer*>(cmdBuffer)->GetCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+			vkCmdBindPipeline(static_cast<VKCommandBuffer*>(cmdBuffer)->GetCommandBuffer(), m_BindPoint, m_Pipeline);
 		}
 
-		VkDescriptorSet VKPipeline::CreateDescriptorSet()
-		{
-			VkDescriptorSet set;
-			VkDescriptorSetAllocateInfo descSetAllocInfo[1];
-			descSetAllocInfo[0].sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-			descSetAllocInfo[0].pNext = NULL;
-			descSetAllocInfo[0].descriptorPool = m_DescriptorPool;
-			descSetAllocInfo[0].descriptorSetCount = 1;
-			descSetAllocInfo[0].pSetLayouts = m_DescriptorLayouts.data();
-			VK_CHECK_RESULT(vkAllocateDescriptorSets(VKDevice::Get().GetDevice(), descSetAllocInfo, &set));
-			return set;
-		}
-        
         void VKPipeline::MakeDefault()
         {
             CreateFunc = CreateFuncVulkan;
@@ -21,18 +21,13 @@ namespace Lumos
 
 			void Unload() const;
             void Bind(CommandBuffer* cmdBuffer) override;
-
-            VkDescriptorSet CreateDescriptorSet();
+			void OnShaderReloaded() override;
 
 			VkDescriptorSetLayout* GetDescriptorLayout(int id)
 			{
 				return &m_DescriptorLayouts[id];
 			};
 
-			const VkDescriptorPool& GetDescriptorPool() const
-			{
-				return m_DescriptorPool;
-			};
 			const VkPipelineLayout& GetPipelineLayout() const
 			{
 				return m_PipelineLayout;
@@ -41,6 +36,10 @@ namespace Lumos
 			{
 				return m_Pipeline;
 			}
+			VkPipelineBindPoint GetBindPoint() const
+			{
+				return m_BindPoint;
+			}
 
 			DescriptorSet* GetDescriptorSet() const override
 			{
@@ -57,15 +56,17 @@ namespace Lumos
 			static Pipeline* CreateFuncVulkan(const PipelineInfo& pipelineCreateInfo);
 
 		private:
-			
+			void CreatePipeline(const PipelineInfo& pipelineCreateInfo);
+
+			PipelineInfo m_Description;
 			VkVertexInputBindingDescription m_VertexBindingDescription;
 			std::vector<VkDescriptorSetLayout> m_DescriptorLayouts;
-			VkDescriptorPool m_DescriptorPool;
 			DescriptorSet* m_DescriptorSet = nullptr;
 			Ref<Shader> m_Shader;
 			
 			VkPipelineLayout m_PipelineLayout;
 			VkPipeline m_Pipeline;
+			VkPipelineBindPoint m_BindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 		};
 	}
 }
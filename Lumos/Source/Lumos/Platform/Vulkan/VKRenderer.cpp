@@ -103,6 +103,9 @@ namespace Lumos
 		{
 			LUMOS_PROFILE_FUNCTION();
 			m_CurrentSemaphoreIndex = 0;
+
+			//Every submit waits for the gpu, so nothing from last frame still reads the transient sets
+			VKDevice::Get().GetTransientDescriptorAllocator()->Reset();
             auto m_Swapchain = VKContext::Get()->GetSwapchain();
 			auto result = m_Swapchain->AcquireNextImage(m_ImageAvailableSemaphore[m_CurrentSemaphoreIndex]);
 			if(result == VK_ERROR_OUT_OF_DATE_KHR)
@@ -130,6 +133,8 @@ namespace Lumos
 			LUMOS_PROFILE_FUNCTION();
 			uint32_t numDynamicDescriptorSets = 0;
 			uint32_t numDesciptorSets = 0;
+			//On the stack, sets are bound from several workers at once
+			VkDescriptorSet descriptorSetPool[16];
 
 			for(auto descriptorSet : descriptorSets)
 			{
@@ -139,7 +144,7 @@ namespace Lumos
                     if(vkDesSet->GetIsDynamic())
                         numDynamicDescriptorSets++;
 
-                    m_DescriptorSetPool[numDesciptorSets] = vkDesSet->GetDescriptorSet();
+                    descriptorSetPool[numDesciptorSets] = vkDesSet->GetDescriptorSet();
 
                     uint32_t index = 0;
                     for(auto& pc : vkDesSet->GetPushConstants())
@@ -151,7 +156,17 @@ namespace Lumos
                 }
 			}
 
-			vkCmdBindDescriptorSets(static_cast<Graphics::VKCommandBuffer*>(cmdBuffer)->GetCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, static_cast<Graphics::VKPipeline*>(pipeline)->GetPipelineLayout(), 0, numDesciptorSets, m_DescriptorSetPool, numDynamicDescriptorSets, &dynamicOffset);
+			auto vkPipeline = static_cast<Graphics::VKPipeline*>(pipeline);
+			vkCmdBindDescriptorSets(static_cast<Graphics::VKCommandBuffer*>(cmdBuffer)->GetCommandBuffer(), vkPipeline->GetBindPoint(), vkPipeline->GetPipelineLayout(), 0, numDesciptorSets, descriptorSetPool, numDynamicDescriptorSets, &dynamicOffset);
+		}
+
+		void VKRenderer::PushConstantsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, std::vector<Graphics::PushConstant>& pushConstants)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			for(auto& pc : pushConstants)
+			{
+				vkCmdPushConstants(static_cast<Graphics::VKCommandBuffer*>(cmdBuffer)->GetCommandBuffer(), static_cast<Graphics::VKPipeline*>(pipeline)->GetPipelineLayout(), VKTools::ShaderTypeToVK(pc.shaderStage), 0, pc.size, pc.data);
+			}
 		}
 
 		void VKRenderer::DrawIndexedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start) const
@@ -161,6 +176,13 @@ namespace Lumos
 			vkCmdDrawIndexed(static_cast<VKCommandBuffer*>(commandBuffer)->GetCommandBuffer(), count, 1, 0, 0, 0);
 		}
 
+		void VKRenderer::DrawIndexedInstancedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount) const
+		{
+			LUMOS_PROFILE_FUNCTION();
+			Engine::Get().Statistics().NumDrawCalls++;
+			vkCmdDrawIndexed(static_cast<VKCommandBuffer*>(commandBuffer)->GetCommandBuffer(), count, instanceCount, 0, 0, 0);
+		}
+
 		void VKRenderer::DrawInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, DataType datayType, void* indices) const
 		{
 			LUMOS_PROFILE_FUNCTION();
@@ -168,6 +190,43 @@ namespace Lumos
 			vkCmdDraw(static_cast<VKCommandBuffer*>(commandBuffer)->GetCommandBuffer(), count, 1, 0, 0);
 		}
 
+		void VKRenderer::DrawIndexedIndirectInternal(CommandBuffer* commandBuffer, DrawType type, UniformBuffer* argumentBuffer, uint32_t offset, uint32_t drawCount, uint32_t stride) const
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(drawCount == 0)
+				return;
+
+			VkCommandBuffer cmd = static_cast<VKCommandBuffer*>(commandBuffer)->GetCommandBuffer();
+			VkBuffer buffer = *static_cast<VKUniformBuffer*>(argumentBuffer)->GetBuffer();
+
+			if(VKDevice::Get().GetEnabledFeatures().multiDrawIndirect)
+			{
+				Engine::Get().Statistics().NumDrawCalls++;
+				vkCmdDrawIndexedIndirect(cmd, buffer, offset, drawCount, stride);
+				return;
+			}
+
+			for(uint32_t i = 0; i < drawCount; i++)
+			{
+				Engine::Get().Statistics().NumDrawCalls++;
+				vkCmdDrawIndexedIndirect(cmd, buffer, offset + i * stride, 1, stride);
+			}
+		}
+
+		void VKRenderer::DispatchInternal(CommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const
+		{
+			LUMOS_PROFILE_FUNCTION();
+			VkCommandBuffer cmd = static_cast<VKCommandBuffer*>(commandBuffer)->GetCommandBuffer();
+			vkCmdDispatch(cmd, groupCountX, groupCountY, groupCountZ);
+
+			VkMemoryBarrier barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+		}
+
 		void VKRenderer::MakeDefault()
 		{
 			CreateFunc = CreateFuncVulkan;
@@ -45,8 +45,12 @@ namespace Lumos
 			const std::string& GetTitleInternal() const override;
 
 			void BindDescriptorSetsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, uint32_t dynamicOffset, std::vector<Graphics::DescriptorSet*>& descriptorSets) override;
+			void PushConstantsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, std::vector<Graphics::PushConstant>& pushConstants) override;
 			void DrawIndexedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start) const override;
+			void DrawIndexedInstancedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount) const override;
 			void DrawInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, DataType datayType, void* indices) const override;
+			void DrawIndexedIndirectInternal(CommandBuffer* commandBuffer, DrawType type, UniformBuffer* argumentBuffer, uint32_t offset, uint32_t drawCount, uint32_t stride) const override;
+			void DispatchInternal(CommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const override;
 
 			void CreateSemaphores();
 
@@ -63,8 +67,6 @@ namespace Lumos
 
 			std::string m_RendererTitle;
 			uint32_t m_Width, m_Height;
-
-			VkDescriptorSet m_DescriptorSetPool[16];
 		};
 	}
 }
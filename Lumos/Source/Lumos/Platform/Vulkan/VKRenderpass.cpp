@@ -39,8 +39,9 @@ namespace Lumos
 			}
 			else if(info.textureType == TextureType::DEPTH)
 			{
+				//GBuffer depth is sampled by the deferred lighting pass
 				attachment.format = VKTools::FindDepthFormat();
-				attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+				attachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 			}
 			else if(info.textureType == TextureType::DEPTHARRAY)
 			{
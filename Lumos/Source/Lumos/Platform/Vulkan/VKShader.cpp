@@ -32,7 +32,7 @@ namespace Lumos
             m_FilePath = StringUtilities::GetFileLocation(filePath);
 			m_Source = VFS::Get()->ReadTextFile(filePath);
 
-			Init();
+			m_Compiled = Init();
 		}
 
 		VKShader::~VKShader()
@@ -67,6 +67,11 @@ namespace Lumos
 			{
 				uint32_t fileSize = uint32_t(FileSystem::GetFileSize(m_FilePath + file.second));
                 uint32_t* source = reinterpret_cast<uint32_t*>(FileSystem::ReadFile(m_FilePath + file.second));
+				if(!source)
+				{
+					LUMOS_LOG_ERROR("Failed to load shader stage {0}", m_FilePath + file.second);
+					return false;
+				}
 
 				VkShaderModuleCreateInfo shaderCreateInfo{};
                 shaderCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -90,6 +95,15 @@ namespace Lumos
                     m_DescriptorLayoutInfo.push_back({Graphics::DescriptorType::UNIFORM_BUFFER, file.first, binding, set, type.array.size() ? uint32_t(type.array[0]) : 1});
 
                 }
+
+                for (auto &u : resources.storage_buffers)
+                {
+                    uint32_t set = comp.get_decoration(u.id, spv::DecorationDescriptorSet);
+                    uint32_t binding = comp.get_decoration(u.id, spv::DecorationBinding);
+
+                    SHADER_LOG(LUMOS_LOG_INFO("Found SSBO {0} at set = {1}, binding = {2}", u.name.c_str(), set, binding));
+                    m_DescriptorLayoutInfo.push_back({Graphics::DescriptorType::STORAGE_BUFFER, file.first, binding, set, 1});
+                }
                 
                 for (auto &u : resources.push_constant_buffers)
                 {
@@ -141,6 +155,54 @@ namespace Lumos
 			return true;
 		}
 
+		static bool SameLayout(const std::vector<DescriptorLayoutInfo>& a, const std::vector<DescriptorLayoutInfo>& b)
+		{
+			if(a.size() != b.size())
+				return false;
+
+			for(size_t i = 0; i < a.size(); i++)
+			{
+				if(a[i].type != b[i].type || a[i].stage != b[i].stage || a[i].binding != b[i].binding || a[i].setID != b[i].setID || a[i].count != b[i].count)
+					return false;
+			}
+
+			return true;
+		}
+
+		static bool SamePushConstants(const std::vector<PushConstant>& a, const std::vector<PushConstant>& b)
+		{
+			if(a.size() != b.size())
+				return false;
+
+			for(size_t i = 0; i < a.size(); i++)
+			{
+				if(a[i].size != b[i].size || a[i].shaderStage != b[i].shaderStage || a[i].offset != b[i].offset)
+					return false;
+			}
+
+			return true;
+		}
+
+		ShaderReloadResult VKShader::Reload()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			VKShader shader(m_FilePath + m_Name);
+			if(!shader.m_Compiled || shader.m_StageCount == 0)
+				return ShaderReloadResult::FAILED;
+
+			const bool layoutChanged = !SameLayout(m_DescriptorLayoutInfo, shader.m_DescriptorLayoutInfo) || !SamePushConstants(m_PushConstants, shader.m_PushConstants);
+
+			//Pipelines already built from the old modules do not need them, they are destroyed with the temporary
+			std::swap(m_ShaderStages, shader.m_ShaderStages);
+			std::swap(m_StageCount, shader.m_StageCount);
+			std::swap(m_Source, shader.m_Source);
+			std::swap(m_ShaderTypes, shader.m_ShaderTypes);
+			std::swap(m_PushConstants, shader.m_PushConstants);
+			std::swap(m_DescriptorLayoutInfo, shader.m_DescriptorLayoutInfo);
+
+			return layoutChanged ? ShaderReloadResult::LAYOUT_CHANGED : ShaderReloadResult::RELOADED;
+		}
+
 		void VKShader::Unload() const
 		{
 			for(uint32_t i = 0; i < m_StageCount; i++)
@@ -50,12 +50,15 @@ namespace Lumos
 				return nullptr;
 			}
 
+			ShaderReloadResult Reload() override;
+
 		protected:
 			static Shader* CreateFuncVulkan(const std::string&);
 
 		private:
 			VkPipelineShaderStageCreateInfo* m_ShaderStages;
 			uint32_t m_StageCount;
+			bool m_Compiled = false;
 			std::string m_Name;
 			std::string m_FilePath;
 			std::string m_Source;
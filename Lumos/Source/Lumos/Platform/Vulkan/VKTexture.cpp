@@ -9,6 +9,25 @@ namespace Lumos
 {
 	namespace Graphics
 	{
+		static void CheckLinearBlit(VkFormat imageFormat)
+		{
+			VkFormatProperties formatProperties;
+			vkGetPhysicalDeviceFormatProperties(VKDevice::Get().GetGPU(), imageFormat, &formatProperties);
+
+			if(!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+			{
+				LUMOS_LOG_ERROR("Texture image format does not support linear blitting!");
+			}
+		}
+
+		//Images still being uploaded are used by a pending transfer batch
+		static void WaitForUpload(uint64_t uploadValue)
+		{
+			auto uploadQueue = VKDevice::Get().GetUploadQueue();
+			if(uploadQueue && uploadValue)
+				uploadQueue->Wait(uploadValue);
+		}
+
 		static VkImageView CreateImageView(VkImage image, VkFormat format, uint32_t mipLevels, VkImageViewType viewType, VkImageAspectFlags aspectMask, uint32_t layerCount, uint32_t baseArrayLayer = 0)
 		{
 			VkImageViewCreateInfo viewInfo = {};
@@ -187,6 +206,8 @@ namespace Lumos
 
 		VKTexture2D::~VKTexture2D()
 		{
+			WaitForUpload(m_UploadValue);
+
 			if(m_TextureSampler)
 				vkDestroySampler(VKDevice::Device(), m_TextureSampler, nullptr);
 
@@ -210,6 +231,8 @@ namespace Lumos
 
 		void VKTexture2D::BuildTexture(TextureFormat internalformat, uint32_t width, uint32_t height, bool srgb, bool depth, bool samplerShadow)
 		{
+			WaitForUpload(m_UploadValue);
+			m_UploadValue = 0;
 
 			if(m_TextureSampler)
 				vkDestroySampler(VKDevice::Device(), m_TextureSampler, nullptr);
@@ -258,109 +281,11 @@ namespace Lumos
 
 		void GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels)
 		{
-			VkFormatProperties formatProperties;
-			vkGetPhysicalDeviceFormatProperties(VKDevice::Get().GetGPU(), imageFormat, &formatProperties);
-
-			if(!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
-			{
-				LUMOS_LOG_ERROR("Texture image format does not support linear blitting!");
-			}
+			CheckLinearBlit(imageFormat);
 
 			VkCommandBuffer commandBuffer = VKTools::BeginSingleTimeCommands();
 
-			VkImageMemoryBarrier barrier{};
-			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-			barrier.image = image;
-			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			barrier.subresourceRange.baseArrayLayer = 0;
-			barrier.subresourceRange.layerCount = 1;
-			barrier.subresourceRange.levelCount = 1;
-
-			int32_t mipWidth = texWidth;
-			int32_t mipHeight = texHeight;
-
-			for(uint32_t i = 1; i < mipLevels; i++)
-			{
-				barrier.subresourceRange.baseMipLevel = i - 1;
-				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-				barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-				barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-				vkCmdPipelineBarrier(commandBuffer,
-					VK_PIPELINE_STAGE_TRANSFER_BIT,
-					VK_PIPELINE_STAGE_TRANSFER_BIT,
-					0,
-					0,
-					nullptr,
-					0,
-					nullptr,
-					1,
-					&barrier);
-
-				VkImageBlit blit{};
-				blit.srcOffsets[0] = {0, 0, 0};
-				blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
-				blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-				blit.srcSubresource.mipLevel = i - 1;
-				blit.srcSubresource.baseArrayLayer = 0;
-				blit.srcSubresource.layerCount = 1;
-				blit.dstOffsets[0] = {0, 0, 0};
-				blit.dstOffsets[1] = {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1};
-				blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-				blit.dstSubresource.mipLevel = i;
-				blit.dstSubresource.baseArrayLayer = 0;
-				blit.dstSubresource.layerCount = 1;
-
-				vkCmdBlitImage(commandBuffer,
-					image,
-					VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-					image,
-					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-					1,
-					&blit,
-					VK_FILTER_LINEAR);
-
-				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-				barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-				barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-				vkCmdPipelineBarrier(commandBuffer,
-					VK_PIPELINE_STAGE_TRANSFER_BIT,
-					VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-					0,
-					0,
-					nullptr,
-					0,
-					nullptr,
-					1,
-					&barrier);
-
-				if(mipWidth > 1)
-					mipWidth /= 2;
-				if(mipHeight > 1)
-					mipHeight /= 2;
-			}
-
-			barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-			vkCmdPipelineBarrier(commandBuffer,
-				VK_PIPELINE_STAGE_TRANSFER_BIT,
-				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-				0,
-				0,
-				nullptr,
-				0,
-				nullptr,
-				1,
-				&barrier);
+			VKTools::GenerateMipmaps(commandBuffer, image, texWidth, texHeight, mipLevels);
 
 			VKTools::EndSingleTimeCommands(commandBuffer);
 		}
@@ -402,17 +327,46 @@ namespace Lumos
 			Graphics::CreateImage(m_Width, m_Height, m_MipLevels, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory, 1, 0);
 #endif
 
-			VKTools::TransitionImageLayout(m_TextureImage, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_MipLevels);
+			const VkFormat format = VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb);
+			if(auto uploadQueue = VKDevice::Get().GetUploadQueue())
+			{
+				CheckLinearBlit(format);
+
+				VkBufferImageCopy region{};
+				region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+				region.imageExtent = { m_Width, m_Height, 1 };
+
+				m_UploadValue = uploadQueue->UploadImage(stagingBuffer, m_TextureImage, { region }, { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels, 0, 1 }, m_Width, m_Height, true);
+				return true;
+			}
+
+			//Every level stays in TRANSFER_DST_OPTIMAL for the mip blits
+			VKTools::TransitionImageLayout(m_TextureImage, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_MipLevels);
 			VKTools::CopyBufferToImage(stagingBuffer->GetBuffer(), m_TextureImage, static_cast<uint32_t>(m_Width), static_cast<uint32_t>(m_Height));
-			VKTools::TransitionImageLayout(m_TextureImage, VKTools::TextureFormatToVK(m_Parameters.format), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_MipLevels);
 
 			delete stagingBuffer;
 
-			GenerateMipmaps(m_TextureImage, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), m_Width, m_Height, m_MipLevels);
+			GenerateMipmaps(m_TextureImage, format, m_Width, m_Height, m_MipLevels);
 
 			return true;
 		}
 
+		void VKTexture2D::SetData(const void* pixels)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			VkDeviceSize imageSize = VkDeviceSize(m_Width * m_Height * GetStrideFromFormat(m_Parameters.format));
+			VKBuffer* stagingBuffer = new VKBuffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, static_cast<uint32_t>(imageSize), pixels);
+
+			VkFormat format = VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb);
+			VKTools::TransitionImageLayout(m_TextureImage, format, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_MipLevels);
+			VKTools::CopyBufferToImage(stagingBuffer->GetBuffer(), m_TextureImage, m_Width, m_Height);
+
+			delete stagingBuffer;
+
+			//Leaves every mip in SHADER_READ_ONLY_OPTIMAL
+			GenerateMipmaps(m_TextureImage, format, m_Width, m_Height, m_MipLevels);
+		}
+
 		VKTextureCube::VKTextureCube(uint32_t size)
 			: m_ImageLayout()
 		{
@@ -452,6 +406,8 @@ namespace Lumos
 
 		VKTextureCube::~VKTextureCube()
 		{
+			WaitForUpload(m_UploadValue);
+
 			if(m_TextureSampler)
 				vkDestroySampler(VKDevice::Device(), m_TextureSampler, nullptr);
 
@@ -566,8 +522,6 @@ namespace Lumos
 			Graphics::CreateImage(faceWidths[0], faceHeights[0], m_NumMips, VKTools::TextureFormatToVK(m_Parameters.format,m_Parameters.srgb), VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory, 6, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
 #endif
 
-			VkCommandBuffer cmdBuffer = VKTools::BeginSingleTimeCommands();
-
 			//// Setup buffer copy regions for each face including all of it's miplevels
 			std::vector<VkBufferImageCopy> bufferCopyRegions;
 			uint32_t offset = 0;
@@ -601,33 +555,44 @@ namespace Lumos
 			subresourceRange.levelCount = m_NumMips;
 			subresourceRange.layerCount = 6;
 
-			VKTools::SetImageLayout(
-				cmdBuffer,
-				m_TextureImage,
-				VK_IMAGE_LAYOUT_UNDEFINED,
-				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				subresourceRange);
-
-			// Copy the cube map faces from the staging buffer to the optimal tiled image
-			vkCmdCopyBufferToImage(
-				cmdBuffer,
-				stagingBuffer->GetBuffer(),
-				m_TextureImage,
-				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				static_cast<uint32_t>(bufferCopyRegions.size()),
-				bufferCopyRegions.data());
-
 			// Change texture image layout to shader read after all faces have been copied
 			m_ImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-			VKTools::SetImageLayout(
-				cmdBuffer,
-				m_TextureImage,
-				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				m_ImageLayout,
-				subresourceRange);
+			if(auto uploadQueue = VKDevice::Get().GetUploadQueue())
+			{
+				//Every level is in the file, nothing to blit
+				m_UploadValue = uploadQueue->UploadImage(stagingBuffer, m_TextureImage, bufferCopyRegions, subresourceRange, faceWidths[0], faceHeights[0], false);
+				stagingBuffer = nullptr;
+			}
+			else
+			{
+				VkCommandBuffer cmdBuffer = VKTools::BeginSingleTimeCommands();
 
-			VKTools::EndSingleTimeCommands(cmdBuffer);
+				VKTools::SetImageLayout(
+					cmdBuffer,
+					m_TextureImage,
+					VK_IMAGE_LAYOUT_UNDEFINED,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					subresourceRange);
+
+				// Copy the cube map faces from the staging buffer to the optimal tiled image
+				vkCmdCopyBufferToImage(
+					cmdBuffer,
+					stagingBuffer->GetBuffer(),
+					m_TextureImage,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					static_cast<uint32_t>(bufferCopyRegions.size()),
+					bufferCopyRegions.data());
+
+				VKTools::SetImageLayout(
+					cmdBuffer,
+					m_TextureImage,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					m_ImageLayout,
+					subresourceRange);
+
+				VKTools::EndSingleTimeCommands(cmdBuffer);
+			}
 
 			m_TextureSampler = Graphics::CreateTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR, 0.0f, static_cast<float>(m_NumMips), true, VKDevice::Get().GetPhysicalDevice()->GetProperties().limits.maxSamplerAnisotropy, VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLER_ADDRESS_MODE_REPEAT);
 			m_TextureImageView = Graphics::CreateImageView(m_TextureImage, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), m_NumMips, VK_IMAGE_VIEW_TYPE_CUBE, VK_IMAGE_ASPECT_COLOR_BIT, 6);
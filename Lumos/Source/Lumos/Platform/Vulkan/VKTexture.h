@@ -24,7 +24,7 @@ namespace Lumos
 			void Bind(uint32_t slot = 0) const override{};
 			void Unbind(uint32_t slot = 0) const override{};
 
-			virtual void SetData(const void* pixels) override{};
+			void SetData(const void* pixels) override;
 
 			virtual void* GetHandle() const override
 			{
@@ -117,6 +117,8 @@ namespace Lumos
 #endif
 
 			bool m_DeleteImage = true;
+			//Timeline value of the upload batch that fills the image, zero when it was uploaded synchronously
+			uint64_t m_UploadValue = 0;
 		};
 
 		class VKTextureCube : public TextureCube
@@ -211,6 +213,8 @@ namespace Lumos
 #endif
 
 			bool m_DeleteImage = true;
+			//Timeline value of the upload batch that fills the image, zero when it was uploaded synchronously
+			uint64_t m_UploadValue = 0;
 		};
 
 		class VKTextureDepth : public TextureDepth
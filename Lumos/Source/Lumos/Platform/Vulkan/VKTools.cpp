@@ -91,6 +91,10 @@ namespace Lumos
         {
             VK_CHECK_RESULT(vkEndCommandBuffer(commandBuffer));
 
+			//Textures uploaded since the last submit have to be acquired on the graphics queue first
+			if(auto uploadQueue = VKDevice::Get().GetUploadQueue())
+				uploadQueue->Flush();
+
             VkSubmitInfo submitInfo;
 			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
             submitInfo.commandBufferCount = 1;
@@ -199,6 +203,14 @@ namespace Lumos
 				sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
 				destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 			}
+			else if (oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+			{
+				barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+				barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+				sourceStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+				destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			}
 			else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
 			{
 				barrier.srcAccessMask = 0;
@@ -224,6 +236,103 @@ namespace Lumos
             EndSingleTimeCommands(commandBuffer);
         }
 
+        void VKTools::GenerateMipmaps(VkCommandBuffer commandBuffer, VkImage image, int32_t width, int32_t height, uint32_t mipLevels)
+        {
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.image = image;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = 1;
+			barrier.subresourceRange.levelCount = 1;
+
+			int32_t mipWidth = width;
+			int32_t mipHeight = height;
+
+			for(uint32_t i = 1; i < mipLevels; i++)
+			{
+				barrier.subresourceRange.baseMipLevel = i - 1;
+				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+				vkCmdPipelineBarrier(commandBuffer,
+					VK_PIPELINE_STAGE_TRANSFER_BIT,
+					VK_PIPELINE_STAGE_TRANSFER_BIT,
+					0,
+					0,
+					nullptr,
+					0,
+					nullptr,
+					1,
+					&barrier);
+
+				VkImageBlit blit{};
+				blit.srcOffsets[0] = {0, 0, 0};
+				blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
+				blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				blit.srcSubresource.mipLevel = i - 1;
+				blit.srcSubresource.baseArrayLayer = 0;
+				blit.srcSubresource.layerCount = 1;
+				blit.dstOffsets[0] = {0, 0, 0};
+				blit.dstOffsets[1] = {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1};
+				blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				blit.dstSubresource.mipLevel = i;
+				blit.dstSubresource.baseArrayLayer = 0;
+				blit.dstSubresource.layerCount = 1;
+
+				vkCmdBlitImage(commandBuffer,
+					image,
+					VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					image,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					1,
+					&blit,
+					VK_FILTER_LINEAR);
+
+				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+				barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+				vkCmdPipelineBarrier(commandBuffer,
+					VK_PIPELINE_STAGE_TRANSFER_BIT,
+					VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+					0,
+					0,
+					nullptr,
+					0,
+					nullptr,
+					1,
+					&barrier);
+
+				if(mipWidth > 1)
+					mipWidth /= 2;
+				if(mipHeight > 1)
+					mipHeight /= 2;
+			}
+
+			barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_TRANSFER_BIT,
+				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+				0,
+				0,
+				nullptr,
+				0,
+				nullptr,
+				1,
+				&barrier);
+        }
+
         VkFormat VKTools::FindSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling,
                                         VkFormatFeatureFlags features)
         {
@@ -339,6 +448,7 @@ namespace Lumos
             case DescriptorType::UNIFORM_BUFFER		    : return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
             case DescriptorType::UNIFORM_BUFFER_DYNAMIC : return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
             case DescriptorType::IMAGE_SAMPLER			: return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            case DescriptorType::STORAGE_BUFFER			: return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
             }
 
             return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -528,6 +638,7 @@ namespace Lumos
                     case TextureFormat::RGBA8:              return VK_FORMAT_R8G8B8A8_SRGB;
                     case TextureFormat::RGB16:              return VK_FORMAT_R16G16B16_SFLOAT;
                     case TextureFormat::RGBA16:             return VK_FORMAT_R16G16B16A16_SFLOAT;
+                    case TextureFormat::RG16:               return VK_FORMAT_R16G16_SFLOAT;
                     case TextureFormat::RGB32:              return VK_FORMAT_R32G32B32_SFLOAT;
                     case TextureFormat::RGBA32:             return VK_FORMAT_R32G32B32A32_SFLOAT;
                     default: LUMOS_LOG_CRITICAL("[Texture] Unsupported image bit-depth!");  return VK_FORMAT_R8G8B8A8_SRGB;
@@ -545,6 +656,7 @@ namespace Lumos
                     case TextureFormat::RGBA8:              return VK_FORMAT_R8G8B8A8_UNORM;
                     case TextureFormat::RGB16:              return VK_FORMAT_R16G16B16_SFLOAT;
                     case TextureFormat::RGBA16:             return VK_FORMAT_R16G16B16A16_SFLOAT;
+                    case TextureFormat::RG16:               return VK_FORMAT_R16G16_SFLOAT;
                     case TextureFormat::RGB32:              return VK_FORMAT_R32G32B32_SFLOAT;
                     case TextureFormat::RGBA32:             return VK_FORMAT_R32G32B32A32_SFLOAT;
                     default: LUMOS_LOG_CRITICAL("[Texture] Unsupported image bit-depth!");  return VK_FORMAT_R8G8B8A8_UNORM;
@@ -40,6 +40,8 @@ namespace Lumos
 			bool HasStencilComponent(VkFormat format);
 
 			void TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels = 1);
+			//Expects every level in TRANSFER_DST_OPTIMAL, leaves them all in SHADER_READ_ONLY_OPTIMAL
+			void GenerateMipmaps(VkCommandBuffer commandBuffer, VkImage image, int32_t width, int32_t height, uint32_t mipLevels);
 
 			uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 			VkFormat FindSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
@@ -7,9 +7,10 @@ namespace Lumos
 {
 	namespace Graphics
 	{
+		//Also usable as a storage buffer (DescriptorType::STORAGE_BUFFER) and as indirect draw arguments
 		VKUniformBuffer::VKUniformBuffer(uint32_t size, const void* data)
 		{
-			VKBuffer::Init(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, size, data);
+			VKBuffer::Init(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, size, data);
 		}
 
 		VKUniformBuffer::VKUniformBuffer()
@@ -25,7 +26,7 @@ namespace Lumos
 
 		void VKUniformBuffer::Init(uint32_t size, const void* data)
 		{
-			VKBuffer::Init(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, size, data);
+			VKBuffer::Init(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, size, data);
 		}
 
 		void VKUniformBuffer::SetData(uint32_t size, const void* data)
@@ -0,0 +1,236 @@
+#include "Precompiled.h"
+#include "VKUploadQueue.h"
+#include "VKDevice.h"
+#include "VKBuffer.h"
+#include "VKTools.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		VKUploadQueue::VKUploadQueue()
+		{
+			VkDevice device = VKDevice::Get().GetDevice();
+			m_CommandPool = CreateUniqueRef<VKCommandPool>(uint32_t(VKDevice::Get().GetPhysicalDevice()->GetTransferQueueFamilyIndex()));
+
+			VkSemaphoreTypeCreateInfoKHR typeInfo{};
+			typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+			typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+			typeInfo.initialValue = 0;
+
+			VkSemaphoreCreateInfo semaphoreInfo{};
+			semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			semaphoreInfo.pNext = &typeInfo;
+			VK_CHECK_RESULT(vkCreateSemaphore(device, &semaphoreInfo, nullptr, &m_Semaphore));
+
+			//Loaded here rather than called directly so builds linked against a 1.0 loader still resolve them
+			m_GetSemaphoreCounterValue = (PFN_vkGetSemaphoreCounterValueKHR)vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR");
+			m_WaitSemaphores = (PFN_vkWaitSemaphoresKHR)vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR");
+		}
+
+		VKUploadQueue::~VKUploadQueue()
+		{
+			Wait(m_Value + (m_TransferCommands ? 2 : 0));
+			vkDestroySemaphore(VKDevice::Get().GetDevice(), m_Semaphore, nullptr);
+		}
+
+		VkCommandBuffer VKUploadQueue::BeginCommands(VkCommandPool pool) const
+		{
+			VkCommandBufferAllocateInfo allocInfo = {};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandPool = pool;
+			allocInfo.commandBufferCount = 1;
+
+			VkCommandBuffer commandBuffer;
+			VK_CHECK_RESULT(vkAllocateCommandBuffers(VKDevice::Get().GetDevice(), &allocInfo, &commandBuffer));
+
+			VkCommandBufferBeginInfo beginInfo = {};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+			return commandBuffer;
+		}
+
+		uint64_t VKUploadQueue::UploadImage(VKBuffer* stagingBuffer, VkImage image, const std::vector<VkBufferImageCopy>& regions, const VkImageSubresourceRange& range, int32_t width, int32_t height, bool generateMips)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(!m_TransferCommands)
+				m_TransferCommands = BeginCommands(m_CommandPool->GetCommandPool());
+
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.image = image;
+			barrier.subresourceRange = range;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			vkCmdPipelineBarrier(m_TransferCommands, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			vkCmdCopyBufferToImage(m_TransferCommands, stagingBuffer->GetBuffer(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+
+			//Release to the graphics family, the matching acquire is recorded on the graphics side in Flush
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = 0;
+			barrier.srcQueueFamilyIndex = uint32_t(VKDevice::Get().GetPhysicalDevice()->GetTransferQueueFamilyIndex());
+			barrier.dstQueueFamilyIndex = uint32_t(VKDevice::Get().GetPhysicalDevice()->GetGraphicsQueueFamilyIndex());
+			vkCmdPipelineBarrier(m_TransferCommands, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			m_Images.push_back({ image, range, width, height, generateMips });
+			m_StagingBuffers.push_back(stagingBuffer);
+
+			return m_Value + 2;
+		}
+
+		void VKUploadQueue::Flush()
+		{
+			LUMOS_PROFILE_FUNCTION();
+			Collect();
+
+			if(!m_TransferCommands)
+				return;
+
+			auto& device = VKDevice::Get();
+			const uint32_t transferFamily = uint32_t(device.GetPhysicalDevice()->GetTransferQueueFamilyIndex());
+			const uint32_t graphicsFamily = uint32_t(device.GetPhysicalDevice()->GetGraphicsQueueFamilyIndex());
+
+			VkCommandBuffer graphicsCommands = BeginCommands(device.GetCommandPool()->GetCommandPool());
+			for(auto& pending : m_Images)
+			{
+				VkImageMemoryBarrier barrier{};
+				barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				barrier.image = pending.Image;
+				barrier.subresourceRange = pending.Range;
+				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+				barrier.srcQueueFamilyIndex = transferFamily;
+				barrier.dstQueueFamilyIndex = graphicsFamily;
+				vkCmdPipelineBarrier(graphicsCommands, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+				if(pending.GenerateMips)
+				{
+					VKTools::GenerateMipmaps(graphicsCommands, pending.Image, pending.Width, pending.Height, pending.Range.levelCount);
+				}
+				else
+				{
+					barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+					barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+					barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+					barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+					barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+					vkCmdPipelineBarrier(graphicsCommands, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+				}
+			}
+
+			VK_CHECK_RESULT(vkEndCommandBuffer(m_TransferCommands));
+			VK_CHECK_RESULT(vkEndCommandBuffer(graphicsCommands));
+
+			const uint64_t copiedValue = m_Value + 1;
+			const uint64_t readyValue = m_Value + 2;
+
+			VkTimelineSemaphoreSubmitInfoKHR transferTimeline{};
+			transferTimeline.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+			transferTimeline.signalSemaphoreValueCount = 1;
+			transferTimeline.pSignalSemaphoreValues = &copiedValue;
+
+			VkSubmitInfo transferSubmit{};
+			transferSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			transferSubmit.pNext = &transferTimeline;
+			transferSubmit.commandBufferCount = 1;
+			transferSubmit.pCommandBuffers = &m_TransferCommands;
+			transferSubmit.signalSemaphoreCount = 1;
+			transferSubmit.pSignalSemaphores = &m_Semaphore;
+
+			{
+				LUMOS_PROFILE_SCOPE("vkQueueSubmit Transfer");
+				VK_CHECK_RESULT(vkQueueSubmit(device.GetTransferQueue(), 1, &transferSubmit, VK_NULL_HANDLE));
+			}
+
+			//Later graphics submits are ordered after the acquire barriers by the queue itself
+			const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			VkTimelineSemaphoreSubmitInfoKHR graphicsTimeline{};
+			graphicsTimeline.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+			graphicsTimeline.waitSemaphoreValueCount = 1;
+			graphicsTimeline.pWaitSemaphoreValues = &copiedValue;
+			graphicsTimeline.signalSemaphoreValueCount = 1;
+			graphicsTimeline.pSignalSemaphoreValues = &readyValue;
+
+			VkSubmitInfo graphicsSubmit{};
+			graphicsSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			graphicsSubmit.pNext = &graphicsTimeline;
+			graphicsSubmit.waitSemaphoreCount = 1;
+			graphicsSubmit.pWaitSemaphores = &m_Semaphore;
+			graphicsSubmit.pWaitDstStageMask = &waitStage;
+			graphicsSubmit.commandBufferCount = 1;
+			graphicsSubmit.pCommandBuffers = &graphicsCommands;
+			graphicsSubmit.signalSemaphoreCount = 1;
+			graphicsSubmit.pSignalSemaphores = &m_Semaphore;
+
+			{
+				LUMOS_PROFILE_SCOPE("vkQueueSubmit Acquire");
+				VK_CHECK_RESULT(vkQueueSubmit(device.GetGraphicsQueue(), 1, &graphicsSubmit, VK_NULL_HANDLE));
+			}
+
+			m_Value = readyValue;
+			m_Batches.push_back({ m_Value, m_TransferCommands, graphicsCommands, std::move(m_StagingBuffers) });
+
+			m_TransferCommands = VK_NULL_HANDLE;
+			m_StagingBuffers.clear();
+			m_Images.clear();
+		}
+
+		void VKUploadQueue::Wait(uint64_t value)
+		{
+			LUMOS_PROFILE_FUNCTION();
+			if(value > m_Value)
+				Flush();
+
+			if(m_Batches.empty())
+				return;
+
+			uint64_t completed = 0;
+			VK_CHECK_RESULT(m_GetSemaphoreCounterValue(VKDevice::Get().GetDevice(), m_Semaphore, &completed));
+			if(completed < value)
+			{
+				VkSemaphoreWaitInfoKHR waitInfo{};
+				waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+				waitInfo.semaphoreCount = 1;
+				waitInfo.pSemaphores = &m_Semaphore;
+				waitInfo.pValues = &value;
+				VK_CHECK_RESULT(m_WaitSemaphores(VKDevice::Get().GetDevice(), &waitInfo, UINT64_MAX));
+			}
+
+			Collect();
+		}
+
+		void VKUploadQueue::Collect()
+		{
+			if(m_Batches.empty())
+				return;
+
+			uint64_t completed = 0;
+			VK_CHECK_RESULT(m_GetSemaphoreCounterValue(VKDevice::Get().GetDevice(), m_Semaphore, &completed));
+
+			auto& device = VKDevice::Get();
+			auto it = m_Batches.begin();
+			for(; it != m_Batches.end() && it->Value <= completed; ++it)
+			{
+				vkFreeCommandBuffers(device.GetDevice(), m_CommandPool->GetCommandPool(), 1, &it->TransferCommands);
+				vkFreeCommandBuffers(device.GetDevice(), device.GetCommandPool()->GetCommandPool(), 1, &it->GraphicsCommands);
+
+				for(auto stagingBuffer : it->StagingBuffers)
+					delete stagingBuffer;
+			}
+
+			m_Batches.erase(m_Batches.begin(), it);
+		}
+	}
+}
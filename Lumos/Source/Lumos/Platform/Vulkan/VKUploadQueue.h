@@ -0,0 +1,70 @@
+#pragma once
+
+#include "VK.h"
+
+namespace Lumos
+{
+	namespace Graphics
+	{
+		class VKBuffer;
+		class VKCommandPool;
+
+		//Batches staging copies onto the dedicated transfer queue so loading textures does not stall the graphics queue.
+		//A flush submits the copies, which release the images to the graphics family, then a graphics submit that
+		//acquires them and generates their mips. The two are ordered on the gpu with one timeline semaphore, the cpu
+		//never waits for them. Pending uploads are flushed before every graphics submit. Main thread only
+		class VKUploadQueue
+		{
+		public:
+			VKUploadQueue();
+			~VKUploadQueue();
+
+			//Takes ownership of the staging buffer. The image's previous contents are discarded, once the batch has run
+			//it is in SHADER_READ_ONLY_OPTIMAL with the levels after the first blitted from it when generateMips is set.
+			//Returns the value to pass to Wait before the image can be destroyed
+			uint64_t UploadImage(VKBuffer* stagingBuffer, VkImage image, const std::vector<VkBufferImageCopy>& regions, const VkImageSubresourceRange& range, int32_t width, int32_t height, bool generateMips);
+
+			//Submits everything uploaded since the last flush
+			void Flush();
+
+			//Flushes if needed and blocks until the batch that signals value has finished
+			void Wait(uint64_t value);
+
+		private:
+			struct PendingImage
+			{
+				VkImage Image;
+				VkImageSubresourceRange Range;
+				int32_t Width;
+				int32_t Height;
+				bool GenerateMips;
+			};
+
+			struct Batch
+			{
+				uint64_t Value;
+				VkCommandBuffer TransferCommands;
+				VkCommandBuffer GraphicsCommands;
+				std::vector<VKBuffer*> StagingBuffers;
+			};
+
+			VkCommandBuffer BeginCommands(VkCommandPool pool) const;
+
+			//Frees the command buffers and staging buffers of every batch the gpu has finished
+			void Collect();
+
+			UniqueRef<VKCommandPool> m_CommandPool;
+			VkSemaphore m_Semaphore = VK_NULL_HANDLE;
+			//Each batch signals two values, the copies finishing and then the graphics side finishing
+			uint64_t m_Value = 0;
+
+			VkCommandBuffer m_TransferCommands = VK_NULL_HANDLE;
+			std::vector<PendingImage> m_Images;
+			std::vector<VKBuffer*> m_StagingBuffers;
+			std::vector<Batch> m_Batches;
+
+			PFN_vkGetSemaphoreCounterValueKHR m_GetSemaphoreCounterValue = nullptr;
+			PFN_vkWaitSemaphoresKHR m_WaitSemaphores = nullptr;
+		};
+	}
+}
@@ -4,6 +4,17 @@
 
 namespace Lumos
 {
+	EntityManager::EntityManager(Scene* scene)
+		: m_Scene(scene)
+	{
+		m_Registry.on_construct<NameComponent>().connect<&EntityManager::OnNameConstruct>(*this);
+		m_Registry.on_destroy<NameComponent>().connect<&EntityManager::OnNameDestroy>(*this);
+		m_Registry.on_update<NameComponent>().connect<&EntityManager::OnNameUpdate>(*this);
+
+		//Lets free functions given only the registry (e.g. the Lua bindings) reach the index
+		m_Registry.set<EntityManager*>(this);
+	}
+
 	Entity EntityManager::Create()
 	{
 		return Entity(m_Registry.create(), m_Scene);
@@ -23,5 +34,65 @@ namespace Lumos
 		});
 
 		m_Registry.clear();
+		m_NameIndex.clear();
+		m_NameIndexDirty = false;
+	}
+
+	entt::entity EntityManager::GetEntityByName(const std::string& name)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		if(m_NameIndexDirty)
+			RebuildNameIndex();
+
+		//Names edited in place don't fire a signal, so check an entry is still right before trusting it
+		auto range = m_NameIndex.equal_range(name);
+		for(auto it = range.first; it != range.second; ++it)
+		{
+			auto nameComponent = m_Registry.valid(it->second) ? m_Registry.try_get<NameComponent>(it->second) : nullptr;
+			if(nameComponent && nameComponent->name == name)
+				return it->second;
+		}
+
+		if(range.first == range.second)
+			return entt::null;
+
+		RebuildNameIndex();
+		auto it = m_NameIndex.find(name);
+		return it != m_NameIndex.end() ? it->second : entt::null;
+	}
+
+	void EntityManager::OnNameConstruct(entt::registry& registry, entt::entity entity)
+	{
+		m_NameIndex.emplace(registry.get<NameComponent>(entity).name, entity);
+	}
+
+	void EntityManager::OnNameDestroy(entt::registry& registry, entt::entity entity)
+	{
+		auto range = m_NameIndex.equal_range(registry.get<NameComponent>(entity).name);
+		for(auto it = range.first; it != range.second; ++it)
+		{
+			if(it->second == entity)
+			{
+				m_NameIndex.erase(it);
+				return;
+			}
+		}
+	}
+
+	void EntityManager::OnNameUpdate(entt::registry& registry, entt::entity entity)
+	{
+		//The old name isn't known here
+		m_NameIndexDirty = true;
+	}
+
+	void EntityManager::RebuildNameIndex()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_NameIndex.clear();
+		m_Registry.view<NameComponent>().each([&](entt::entity entity, const NameComponent& component)
+			{
+				m_NameIndex.emplace(component.name, entity);
+			});
+		m_NameIndexDirty = false;
 	}
 }
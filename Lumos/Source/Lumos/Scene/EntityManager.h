@@ -124,14 +124,15 @@ namespace Lumos
 	class EntityManager
 	{
 	public:
-		EntityManager(Scene* scene)
-			: m_Scene(scene)
-		{
-		}
+		EntityManager(Scene* scene);
 
 		Entity Create();
 		Entity Create(const std::string& name);
 
+		//Hashed lookup, the index follows NameComponent construction and destruction. Rename through
+		//registry.patch/replace so the new name is indexed, a name edited in place is only found by its old one
+		entt::entity GetEntityByName(const std::string& name);
+
 		template<typename... Components>
 		auto GetEntitiesWithTypes()
 		{
@@ -158,7 +159,15 @@ namespace Lumos
 		void Clear();
 
 	private:
+		void OnNameConstruct(entt::registry& registry, entt::entity entity);
+		void OnNameDestroy(entt::registry& registry, entt::entity entity);
+		void OnNameUpdate(entt::registry& registry, entt::entity entity);
+		void RebuildNameIndex();
+
 		Scene* m_Scene = nullptr;
 		entt::registry m_Registry;
+
+		std::unordered_multimap<std::string, entt::entity> m_NameIndex;
+		bool m_NameIndexDirty = false;
 	};
 }
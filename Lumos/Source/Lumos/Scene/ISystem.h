@@ -17,6 +17,10 @@ namespace Lumos
 		virtual void OnImGui() = 0;
 		virtual void OnDebugDraw() = 0;
 
+		//Called once game and editor code are done with the scene for the frame, work started here can
+		//run alongside rendering
+		virtual void OnLateUpdate(const TimeStep& dt, Scene* scene) {}
+
 		inline const std::string& GetName() const
 		{
 			return m_DebugName;
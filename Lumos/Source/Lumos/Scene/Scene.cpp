@@ -7,6 +7,9 @@
 #include "Graphics/Camera/Camera.h"
 #include "Graphics/Sprite.h"
 #include "Graphics/AnimatedSprite.h"
+#include "Graphics/Animation/Animator.h"
+#include "Graphics/Particles/ParticleEmitter.h"
+#include "Graphics/Terrain/ChunkedTerrain.h"
 #include "Utilities/TimeStep.h"
 #include "Audio/AudioManager.h"
 #include "Physics/LumosPhysicsEngine/SortAndSweepBroadphase.h"
@@ -168,6 +171,9 @@ namespace Lumos
 	
 #define ALL_COMPONENTSV2 ALL_COMPONENTSV1 , Graphics::AnimatedSprite
 #define ALL_COMPONENTSV3 ALL_COMPONENTSV2 , SoundComponent
+#define ALL_COMPONENTSV4 ALL_COMPONENTSV3 , Graphics::Animator
+#define ALL_COMPONENTSV5 ALL_COMPONENTSV4 , Graphics::ParticleEmitter
+#define ALL_COMPONENTSV6 ALL_COMPONENTSV5 , Graphics::ChunkedTerrain
 	
 	void Scene::Serialise(const std::string& filePath, bool binary)
 	{
@@ -184,7 +190,7 @@ namespace Lumos
 				// output finishes flushing its contents when it goes out of scope
 				cereal::BinaryOutputArchive output{file};
                 output(*this);
-					entt::snapshot{m_EntityManager->GetRegistry()}.entities(output).component<ALL_COMPONENTSV3>(output);
+					entt::snapshot{m_EntityManager->GetRegistry()}.entities(output).component<ALL_COMPONENTSV6>(output);
 			}
 			file.close();
 		}
@@ -197,7 +203,7 @@ namespace Lumos
 				// output finishes flushing its contents when it goes out of scope
 				cereal::JSONOutputArchive output{storage};
                 output(*this);
-				entt::snapshot{m_EntityManager->GetRegistry()}.entities(output).component<ALL_COMPONENTSV3>(output);
+				entt::snapshot{m_EntityManager->GetRegistry()}.entities(output).component<ALL_COMPONENTSV6>(output);
 			}
 			FileSystem::WriteTextFile(path, storage.str());
 		}
@@ -230,6 +236,12 @@ namespace Lumos
 				entt::snapshot_loader{m_EntityManager->GetRegistry()}.entities(input).component<ALL_COMPONENTSV2>(input);
 			else if(m_SceneSerialisationVersion == 4)
 				entt::snapshot_loader{m_EntityManager->GetRegistry()}.entities(input).component<ALL_COMPONENTSV3>(input);
+			else if(m_SceneSerialisationVersion == 5)
+				entt::snapshot_loader{m_EntityManager->GetRegistry()}.entities(input).component<ALL_COMPONENTSV4>(input);
+			else if(m_SceneSerialisationVersion == 6)
+				entt::snapshot_loader{m_EntityManager->GetRegistry()}.entities(input).component<ALL_COMPONENTSV5>(input);
+			else if(m_SceneSerialisationVersion == 7)
+				entt::snapshot_loader{m_EntityManager->GetRegistry()}.entities(input).component<ALL_COMPONENTSV6>(input);
 		}
 		else
 		{
@@ -252,11 +264,98 @@ namespace Lumos
 				entt::snapshot_loader{m_EntityManager->GetRegistry()}.entities(input).component<ALL_COMPONENTSV2>(input);
 			else if(m_SceneSerialisationVersion == 4)
 				entt::snapshot_loader{m_EntityManager->GetRegistry()}.entities(input).component<ALL_COMPONENTSV3>(input);
+			else if(m_SceneSerialisationVersion == 5)
+				entt::snapshot_loader{m_EntityManager->GetRegistry()}.entities(input).component<ALL_COMPONENTSV4>(input);
+			else if(m_SceneSerialisationVersion == 6)
+				entt::snapshot_loader{m_EntityManager->GetRegistry()}.entities(input).component<ALL_COMPONENTSV5>(input);
+			else if(m_SceneSerialisationVersion == 7)
+				entt::snapshot_loader{m_EntityManager->GetRegistry()}.entities(input).component<ALL_COMPONENTSV6>(input);
 		}
         
         m_SceneGraph->DisableOnConstruct(false, m_EntityManager->GetRegistry());
 	}
 
+	//Components holding live engine state (Box2D bodies, sound sources, script environments) are rebuilt through
+	//their serialisation, everything else is copied and keeps sharing its resources
+#define SNAPSHOT_ARCHIVED_COMPONENTS Physics2DComponent, SoundComponent, LuaScriptComponent
+#define SNAPSHOT_COPIED_COMPONENTS Maths::Transform, NameComponent, ActiveComponent, Hierarchy, Camera, Graphics::Model, Graphics::Light, Physics3DComponent, Graphics::Environment, Graphics::Sprite, DefaultCameraController, Graphics::AnimatedSprite, Graphics::Animator, Graphics::ParticleEmitter, Graphics::ChunkedTerrain
+
+	template<typename T>
+	static T CloneComponent(const T& component)
+	{
+		return component;
+	}
+
+	//The rigid body is stepped during play so it can't be shared with the snapshot
+	static Physics3DComponent CloneComponent(const Physics3DComponent& component)
+	{
+		auto rigidBody = CreateRef<RigidBody3D>(*component.GetRigidBody());
+		return Physics3DComponent(rigidBody);
+	}
+
+	static DefaultCameraController CloneComponent(const DefaultCameraController& component)
+	{
+		return DefaultCameraController(component.GetType());
+	}
+
+	template<typename T>
+	static void CopyComponentStorage(entt::registry& dst, const entt::registry& src)
+	{
+		auto view = src.view<const T>();
+		dst.reserve<T>(view.size());
+		for(auto entity : view)
+			dst.emplace<T>(entity, CloneComponent(view.get(entity)));
+	}
+
+	template<typename... T>
+	static void CopyComponentStorages(entt::registry& dst, const entt::registry& src)
+	{
+		(CopyComponentStorage<T>(dst, src), ...);
+	}
+
+	UniqueRef<SceneSnapshot> Scene::CreateSnapshot()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		auto& registry = m_EntityManager->GetRegistry();
+		auto snapshot = CreateUniqueRef<SceneSnapshot>();
+
+		std::stringstream storage;
+		{
+			cereal::BinaryOutputArchive output(storage);
+			entt::snapshot{registry}.entities(output).component<SNAPSHOT_ARCHIVED_COMPONENTS>(output);
+		}
+		snapshot->SceneName = m_SceneName;
+		snapshot->Archive = storage.str();
+
+		//Same identifiers as the scene so the copies line up with the archived entities
+		registry.each([&](auto entity)
+			{
+				snapshot->Registry.create(entity);
+			});
+		CopyComponentStorages<SNAPSHOT_COPIED_COMPONENTS>(snapshot->Registry, registry);
+
+		return snapshot;
+	}
+
+	void Scene::RestoreSnapshot(const SceneSnapshot& snapshot)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_EntityManager->Clear();
+		auto& registry = m_EntityManager->GetRegistry();
+		m_SceneGraph->DisableOnConstruct(true, registry);
+
+		std::istringstream storage(snapshot.Archive);
+		cereal::BinaryInputArchive input(storage);
+		entt::snapshot_loader loader{registry};
+		loader.entities(input);
+
+		//Copied again so the snapshot can be restored more than once. Scripts are loaded last so they see the full entity
+		CopyComponentStorages<SNAPSHOT_COPIED_COMPONENTS>(registry, snapshot.Registry);
+		loader.component<SNAPSHOT_ARCHIVED_COMPONENTS>(input);
+
+		m_SceneGraph->DisableOnConstruct(false, registry);
+	}
+
 	void Scene::UpdateSceneGraph()
 	{
 		LUMOS_PROFILE_FUNCTION();
@@ -31,6 +31,14 @@ namespace Lumos
 		class Material;
 	}
 
+	//In memory copy of a scene's entities, used to restore the editor scene when play mode stops
+	struct SceneSnapshot
+	{
+		std::string SceneName;
+		entt::registry Registry;
+		std::string Archive;
+	};
+
 	class LUMOS_EXPORT Scene
 	{
 	public:
@@ -120,10 +128,14 @@ namespace Lumos
 		virtual void Serialise(const std::string& filePath, bool binary = false);
 		virtual void Deserialise(const std::string& filePath, bool binary = false);
 
+		//Captures the entities without going through the scene file, restoring replaces every entity in the scene
+		UniqueRef<SceneSnapshot> CreateSnapshot();
+		void RestoreSnapshot(const SceneSnapshot& snapshot);
+
 		template<typename Archive>
 		void save(Archive& archive) const
 		{
-			archive(cereal::make_nvp("Version", 4));
+			archive(cereal::make_nvp("Version", 7));
 			archive(cereal::make_nvp("Scene Name", m_SceneName));
 		}
 		
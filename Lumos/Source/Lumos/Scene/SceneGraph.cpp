@@ -94,17 +94,11 @@ namespace Lumos
 	void Hierarchy::Reparent(entt::entity entity, entt::entity parent, entt::registry& registry, Hierarchy& hierarchy)
 	{
 		LUMOS_PROFILE_FUNCTION();
-		Hierarchy::OnDestroy(registry, entity);
-        
-        hierarchy.m_Parent = entt::null;
-        hierarchy.m_Next = entt::null;
-        hierarchy.m_Prev = entt::null;
-
-        if(parent != entt::null)
-        {
-            hierarchy.m_Parent = parent;
-            Hierarchy::OnConstruct(registry, entity);
-        }
+		//Replaced rather than relinked in place so on_destroy/on_construct listeners see the move.
+		//The children still point at entity and are carried over
+		auto first = hierarchy.m_First;
+		registry.remove<Hierarchy>(entity);
+		registry.emplace<Hierarchy>(entity, parent).m_First = first;
 	}
 
 	bool Hierarchy::Compare(const entt::registry& registry, const entt::entity rhs) const
@@ -122,7 +122,7 @@ namespace Lumos
 			SetControllerType(m_Type);
 		}
 
-		ControllerType GetType() 
+		ControllerType GetType() const
 		{
 			return m_Type;
 		}
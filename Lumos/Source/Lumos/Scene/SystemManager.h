@@ -70,6 +70,12 @@ namespace Lumos
 				system.second->OnUpdate(dt, scene);
 		}
 
+		void OnLateUpdate(const TimeStep& dt, Scene* scene)
+		{
+			for(auto& system : m_Systems)
+				system.second->OnLateUpdate(dt, scene);
+		}
+
 		void OnImGui()
 		{
 			for(auto& system : m_Systems)
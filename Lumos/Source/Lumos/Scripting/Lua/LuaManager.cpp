@@ -21,6 +21,7 @@
 #include "Graphics/API/Texture.h"
 #include "Graphics/Model.h"
 #include "Utilities/RandomNumberGenerator.h"
+#include "Utilities/Timer.h"
 #include "Scene/Entity.h"
 #include "Scene/EntityManager.h"
 #include "Scene/EntityFactory.h"
@@ -113,6 +114,21 @@ namespace Lumos
 		BindLogLua(m_State);
 		BindSceneLua(m_State);
 		BindPhysicsLua(m_State);
+
+		//Runs every OnUpdate of a batch from inside Lua so a script type costs one call from C++, not one per entity
+		m_BatchUpdate = m_State.script(R"(
+			return function(functions, count, dt)
+				local errors
+				for i = 1, count do
+					local ok, err = pcall(functions[i], dt)
+					if not ok then
+						errors = errors or {}
+						errors[#errors + 1] = err
+					end
+				end
+				return errors
+			end
+		)");
 	}
 
 	LuaManager::~LuaManager()
@@ -139,25 +155,117 @@ namespace Lumos
 	void LuaManager::OnUpdate(Scene* scene)
 	{
 		LUMOS_PROFILE_FUNCTION();
-		auto& registry = scene->GetRegistry();
+		if(scene != m_BatchScene || LuaScriptComponent::GetGeneration() != m_BatchGeneration)
+			RebuildScriptBatches(scene);
 
-		auto view = registry.view<LuaScriptComponent>();
-
-		if(view.empty())
+		m_ScriptTime = 0.0f;
+		if(m_ScriptBatches.empty())
 			return;
 
 		float dt = Engine::Get().GetTimeStep().GetElapsedMillis();
 
+		for(auto& [fileName, batch] : m_ScriptBatches)
+		{
+			TimeStamp start = Timer::Now();
+
+			sol::protected_function_result result = m_BatchUpdate(batch.UpdateFunctions, batch.Count, dt);
+			if(!result.valid())
+			{
+				sol::error err = result;
+				LUMOS_LOG_ERROR("Failed to Execute Script Lua OnUpdate");
+				LUMOS_LOG_ERROR("Error : {0}", err.what());
+			}
+			else if(result.get_type() == sol::type::table)
+			{
+				sol::table errors = result;
+				for(auto& error : errors)
+				{
+					LUMOS_LOG_ERROR("Failed to Execute Script Lua OnUpdate : {0}", fileName);
+					LUMOS_LOG_ERROR("Error : {0}", error.second.as<std::string>());
+				}
+			}
+
+			const float time = Timer::Duration(start, Timer::Now(), 1000.0f);
+			batch.UpdateTime = Maths::Lerp(batch.UpdateTime, time, 0.1f);
+			batch.PeakTime = Maths::Max(batch.PeakTime, time);
+			m_ScriptTime += time;
+		}
+	}
+
+	void LuaManager::RebuildScriptBatches(Scene* scene)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		m_ScriptBatches.clear();
+		m_BatchScene = scene;
+		m_BatchGeneration = LuaScriptComponent::GetGeneration();
+
+		if(!scene)
+			return;
+
+		auto view = scene->GetRegistry().view<LuaScriptComponent>();
 		for(auto entity : view)
 		{
-			auto& luaScript = registry.get<LuaScriptComponent>(entity);
-			luaScript.OnUpdate(dt);
+			const auto& updateFunc = view.get<LuaScriptComponent>(entity).GetUpdateFunction();
+			if(!updateFunc)
+				continue;
+
+			auto& batch = m_ScriptBatches[view.get<LuaScriptComponent>(entity).GetFilePath()];
+			if(!batch.UpdateFunctions.valid())
+				batch.UpdateFunctions = m_State.create_table();
+
+			batch.UpdateFunctions[++batch.Count] = *updateFunc;
+		}
+	}
+
+	void LuaManager::OnImGui()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		ImGui::Text("Script Update Time : %.3f ms", m_ScriptTime);
+
+		ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(2, 2));
+		ImGui::Columns(4);
+		ImGui::Separator();
+
+		ImGui::TextUnformatted("Script");
+		ImGui::NextColumn();
+		ImGui::TextUnformatted("Instances");
+		ImGui::NextColumn();
+		ImGui::TextUnformatted("Time (ms)");
+		ImGui::NextColumn();
+		ImGui::TextUnformatted("Peak (ms)");
+		ImGui::NextColumn();
+		ImGui::Separator();
+
+		for(auto& [fileName, batch] : m_ScriptBatches)
+		{
+			ImGui::TextUnformatted(fileName.c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%u", batch.Count);
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", batch.UpdateTime);
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", batch.PeakTime);
+			ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+		ImGui::Separator();
+		ImGui::PopStyleVar();
+
+		if(ImGui::Button("Reset Peaks"))
+		{
+			for(auto& [fileName, batch] : m_ScriptBatches)
+				batch.PeakTime = 0.0f;
 		}
 	}
 
 	entt::entity GetEntityByName(entt::registry& registry, const std::string& name)
 	{
 		LUMOS_PROFILE_FUNCTION();
+		auto entityManager = registry.try_ctx<EntityManager*>();
+		if(entityManager)
+			return (*entityManager)->GetEntityByName(name);
+
 		entt::entity e = entt::null;
 		registry.view<NameComponent>().each([&](const entt::entity& entity, const NameComponent& component) {
 			if(name == component.name)
@@ -384,6 +492,8 @@ namespace Lumos
 		using namespace Graphics;
 		sol::usertype<Sprite> sprite_type = state.new_usertype<Sprite>("Sprite", sol::constructors<sol::types<Maths::Vector2, Maths::Vector2, Maths::Vector4>, Sprite(const Ref<Graphics::Texture2D>&, const Maths::Vector2&, const Maths::Vector2&, const Maths::Vector4&)>());
 		sprite_type.set_function("SetTexture", &Sprite::SetTexture);
+		sprite_type.set_function("SetStatic", &Sprite::SetStatic);
+		sprite_type.set_function("IsStatic", &Sprite::IsStatic);
 
 		REGISTER_COMPONENT_WITH_ECS(state, Sprite, static_cast<Sprite& (Entity::*)(const Vector2&, const Vector2&, const Vector4&)>(&Entity::AddComponent<Sprite, const Vector2&, const Vector2&, const Vector4&>));
 
@@ -56,6 +56,7 @@ namespace Lumos
 		void OnInit();
 		void OnInit(Scene* scene);
 		void OnUpdate(Scene* scene);
+		void OnImGui();
 
 		void BindECSLua(sol::state& state);
 		void BindLogLua(sol::state& state);
@@ -69,6 +70,23 @@ namespace Lumos
 		}
 
 	private:
+		//Every instance of one script file, updated by a single call into Lua
+		struct ScriptBatch
+		{
+			sol::table UpdateFunctions;
+			uint32_t Count = 0;
+			float UpdateTime = 0.0f;
+			float PeakTime = 0.0f;
+		};
+
+		void RebuildScriptBatches(Scene* scene);
+
 		sol::state m_State;
+
+		sol::protected_function m_BatchUpdate;
+		std::unordered_map<std::string, ScriptBatch> m_ScriptBatches;
+		Scene* m_BatchScene = nullptr;
+		uint64_t m_BatchGeneration = 0;
+		float m_ScriptTime = 0.0f;
 	};
 }
@@ -6,6 +6,8 @@
 
 namespace Lumos
 {
+	uint64_t LuaScriptComponent::s_Generation = 0;
+
 	LuaScriptComponent::LuaScriptComponent()
 	{
 		m_Scene = nullptr;
@@ -27,6 +29,7 @@ namespace Lumos
 
 	LuaScriptComponent::~LuaScriptComponent()
 	{        
+		s_Generation++;
 		if(m_Env)
 		{
         sol::protected_function releaseFunc = (*m_Env)["OnRelease"];
@@ -37,6 +40,7 @@ namespace Lumos
 
 	void LuaScriptComponent::LoadScript(const std::string& fileName)
 	{
+		s_Generation++;
         m_FileName = fileName;
 		std::string physicalPath;
 		if(!VFS::Get()->ResolvePhysicalPath(fileName, physicalPath))
@@ -54,6 +54,17 @@ namespace Lumos
 			return m_Env.get() != nullptr;
 		}
 
+		const Ref<sol::protected_function>& GetUpdateFunction() const
+		{
+			return m_UpdateFunc;
+		}
+
+		//Bumped whenever any script is loaded or released, LuaManager rebuilds its update batches when it changes
+		static uint64_t GetGeneration()
+		{
+			return s_Generation;
+		}
+
 		template<typename Archive>
 		void save(Archive& archive) const
 		{
@@ -71,6 +82,8 @@ namespace Lumos
 		}
 
 	private:
+		static uint64_t s_Generation;
+
 		Scene* m_Scene = nullptr;
 		std::string m_FileName;
 
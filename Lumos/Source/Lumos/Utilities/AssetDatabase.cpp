@@ -0,0 +1,490 @@
+#include "Precompiled.h"
+#include "AssetDatabase.h"
+#include "Core/OS/FileSystem.h"
+#include "Core/StringUtilities.h"
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/types/string.hpp>
+#include <filesystem>
+#include <fstream>
+
+#ifdef LUMOS_PLATFORM_LINUX
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#define ASSET_CACHE_VERSION 1
+
+//Seconds between rescans on platforms without file system notifications
+#define ASSET_RESCAN_INTERVAL 2
+
+namespace Lumos
+{
+	AssetDatabase::AssetDatabase(const std::vector<std::string>& roots, const std::string& cachePath)
+		: m_CachePath(cachePath)
+		, m_Random(RandomNumberGenerator64::RandSeed())
+	{
+		for(auto& root : roots)
+			m_Roots.push_back(NormalisePath(root));
+
+		LoadCache();
+		m_Thread = std::thread(&AssetDatabase::Run, this);
+	}
+
+	AssetDatabase::~AssetDatabase()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_QuitMutex);
+			m_Quit = true;
+		}
+		m_QuitCondition.notify_one();
+
+		if(m_Thread.joinable())
+			m_Thread.join();
+
+		SaveCache();
+	}
+
+	void AssetDatabase::Update()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		std::vector<AssetRecord> changed;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			changed.swap(m_Changed);
+		}
+
+		if(!m_ChangedCallback)
+			return;
+
+		for(auto& record : changed)
+			m_ChangedCallback(record);
+	}
+
+	bool AssetDatabase::GetRecord(const std::string& path, AssetRecord& record)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Records.find(NormalisePath(path));
+		if(it == m_Records.end())
+			return false;
+
+		record = it->second;
+		return true;
+	}
+
+	std::vector<AssetRecord> AssetDatabase::GetDirectory(const std::string& path)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		const std::string directory = NormalisePath(path);
+		std::vector<AssetRecord> contents;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for(auto& [recordPath, record] : m_Records)
+			{
+				if(record.Parent == directory)
+					contents.push_back(record);
+			}
+		}
+
+		//Folders first, then by name
+		std::sort(contents.begin(), contents.end(), [](const AssetRecord& a, const AssetRecord& b)
+			{
+				if((a.Type == AssetType::Directory) != (b.Type == AssetType::Directory))
+					return a.Type == AssetType::Directory;
+				return a.Name < b.Name;
+			});
+
+		return contents;
+	}
+
+	std::vector<AssetRecord> AssetDatabase::Search(const std::string& query)
+	{
+		LUMOS_PROFILE_FUNCTION();
+		const std::string lowerQuery = StringUtilities::ToLower(query);
+		std::vector<AssetRecord> results;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for(auto& [path, record] : m_Records)
+			{
+				if(StringUtilities::ToLower(record.Name).find(lowerQuery) != std::string::npos)
+					results.push_back(record);
+			}
+		}
+
+		std::sort(results.begin(), results.end(), [](const AssetRecord& a, const AssetRecord& b) { return a.Name < b.Name; });
+		return results;
+	}
+
+	AssetType AssetDatabase::GetAssetType(const std::string& extension)
+	{
+		const std::string lower = StringUtilities::ToLower(extension);
+
+		if(lower == "shader" || lower == "spv" || lower == "vert" || lower == "frag" || lower == "comp" || lower == "glsl")
+			return AssetType::Shader;
+		if(lower == "png" || lower == "jpg" || lower == "jpeg" || lower == "tga" || lower == "bmp" || lower == "hdr" || lower == "psd" || lower == "gif")
+			return AssetType::Texture;
+		if(lower == "obj" || lower == "fbx" || lower == "gltf" || lower == "glb" || lower == "blend")
+			return AssetType::Model;
+		if(lower == "wav" || lower == "ogg" || lower == "mp3")
+			return AssetType::Audio;
+		if(lower == "lua")
+			return AssetType::Script;
+		if(lower == "lsn")
+			return AssetType::Scene;
+		if(lower == "ttf" || lower == "otf")
+			return AssetType::Font;
+
+		return AssetType::Unknown;
+	}
+
+	std::string AssetDatabase::NormalisePath(const std::string& path)
+	{
+		std::error_code error;
+		std::filesystem::path absolute = std::filesystem::absolute(path, error);
+		if(error)
+			absolute = path;
+
+		std::string normalised = absolute.lexically_normal().generic_string();
+		while(normalised.size() > 1 && normalised.back() == '/')
+			normalised.pop_back();
+		return normalised;
+	}
+
+	void AssetDatabase::Run()
+	{
+		Scan();
+		m_Ready = true;
+		Watch();
+	}
+
+	void AssetDatabase::Scan()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		std::vector<std::string> seen;
+		for(auto& root : m_Roots)
+			ScanDirectory(root, &seen);
+
+		if(m_Quit)
+			return;
+
+		std::sort(seen.begin(), seen.end());
+
+		std::vector<std::string> removed;
+		for(auto& [path, record] : m_Records)
+		{
+			if(!std::binary_search(seen.begin(), seen.end(), path))
+				removed.push_back(path);
+		}
+
+		for(auto& path : removed)
+			RemoveRecord(path);
+	}
+
+	void AssetDatabase::ScanDirectory(const std::string& path, std::vector<std::string>* seen)
+	{
+		std::error_code error;
+		for(auto it = std::filesystem::recursive_directory_iterator(path, std::filesystem::directory_options::skip_permission_denied, error);
+			it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+		{
+			if(m_Quit || error)
+				return;
+
+			const std::string entryPath = it->path().generic_string();
+			if(seen)
+				seen->push_back(entryPath);
+			UpdateRecord(entryPath);
+		}
+	}
+
+	void AssetDatabase::UpdateRecord(const std::string& path, uint64_t guid)
+	{
+		//Gone again before it could be read, the removal is reported separately
+		std::error_code error;
+		const bool directory = std::filesystem::is_directory(path, error);
+		const uint64_t size = directory || error ? 0 : uint64_t(std::filesystem::file_size(path, error));
+		const int64_t modifiedTime = error ? 0 : int64_t(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+		if(error)
+			return;
+
+		//This thread is the only writer so reading without the lock is safe
+		auto it = m_Records.find(path);
+		if(it != m_Records.end() && it->second.Size == size && it->second.ModifiedTime == modifiedTime)
+			return;
+
+		AssetRecord record;
+		if(it != m_Records.end())
+			record = it->second;
+		else
+		{
+			const std::filesystem::path filePath(path);
+			record.GUID = guid ? guid : m_Random(uint64_t(1), UINT64_MAX);
+			record.Path = path;
+			record.Name = filePath.filename().string();
+			record.Parent = filePath.parent_path().generic_string();
+			record.Type = directory ? AssetType::Directory : GetAssetType(StringUtilities::GetFilePathExtension(record.Name));
+		}
+
+		const uint64_t hash = directory ? 0 : HashFile(path);
+		const bool contentChanged = it != m_Records.end() && hash != record.Hash;
+
+		record.Size = size;
+		record.ModifiedTime = modifiedTime;
+		record.Hash = hash;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Records[path] = record;
+		m_Version++;
+
+		if(contentChanged && m_Ready && !directory)
+			m_Changed.push_back(record);
+	}
+
+	AssetRecord AssetDatabase::RemoveRecord(const std::string& path)
+	{
+		AssetRecord removed;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Records.find(path);
+		if(it == m_Records.end())
+			return removed;
+
+		removed = it->second;
+		m_Records.erase(it);
+		m_Version++;
+
+		if(removed.Type == AssetType::Directory)
+		{
+			const std::string prefix = path + "/";
+			for(auto child = m_Records.begin(); child != m_Records.end();)
+			{
+				if(child->first.compare(0, prefix.size(), prefix) == 0)
+					child = m_Records.erase(child);
+				else
+					++child;
+			}
+		}
+
+		return removed;
+	}
+
+	void AssetDatabase::Watch()
+	{
+#ifdef LUMOS_PLATFORM_LINUX
+		const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if(fd >= 0)
+		{
+			const uint32_t mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+			std::unordered_map<int, std::string> watches;
+
+			//inotify isn't recursive, every directory gets its own watch
+			auto watchDirectory = [&](const std::string& path)
+			{
+				int wd = inotify_add_watch(fd, path.c_str(), mask);
+				if(wd >= 0)
+					watches[wd] = path;
+
+				std::error_code error;
+				for(auto it = std::filesystem::recursive_directory_iterator(path, std::filesystem::directory_options::skip_permission_denied, error);
+					it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+				{
+					if(error)
+						break;
+
+					if(it->is_directory(error))
+					{
+						wd = inotify_add_watch(fd, it->path().c_str(), mask);
+						if(wd >= 0)
+							watches[wd] = it->path().generic_string();
+					}
+				}
+			};
+
+			auto unwatchDirectory = [&](const std::string& path)
+			{
+				const std::string prefix = path + "/";
+				for(auto it = watches.begin(); it != watches.end();)
+				{
+					if(it->second == path || it->second.compare(0, prefix.size(), prefix) == 0)
+					{
+						inotify_rm_watch(fd, it->first);
+						it = watches.erase(it);
+					}
+					else
+						++it;
+				}
+			};
+
+			for(auto& root : m_Roots)
+				watchDirectory(root);
+
+			//GUIDs of files that left with IN_MOVED_FROM, a matching IN_MOVED_TO is a rename and keeps it
+			std::unordered_map<uint32_t, uint64_t> movedGUIDs;
+
+			alignas(inotify_event) char buffer[16 * 1024];
+			while(!m_Quit)
+			{
+				pollfd descriptor = { fd, POLLIN, 0 };
+				if(poll(&descriptor, 1, 250) <= 0)
+					continue;
+
+				const ssize_t length = read(fd, buffer, sizeof(buffer));
+				for(ssize_t offset = 0; offset < length;)
+				{
+					const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+					offset += sizeof(inotify_event) + event->len;
+
+					//Events were dropped, fall back to a full scan
+					if(event->mask & IN_Q_OVERFLOW)
+					{
+						Scan();
+						for(auto& root : m_Roots)
+							watchDirectory(root);
+						continue;
+					}
+
+					auto watch = watches.find(event->wd);
+					if(watch == watches.end())
+						continue;
+
+					if(event->mask & IN_IGNORED)
+					{
+						watches.erase(watch);
+						continue;
+					}
+
+					if(event->len == 0)
+						continue;
+
+					const std::string path = watch->second + "/" + event->name;
+
+					if(event->mask & (IN_DELETE | IN_MOVED_FROM))
+					{
+						const AssetRecord removed = RemoveRecord(path);
+						if(event->mask & IN_MOVED_FROM)
+							movedGUIDs[event->cookie] = removed.GUID;
+						if(event->mask & IN_ISDIR)
+							unwatchDirectory(path);
+						continue;
+					}
+
+					uint64_t guid = 0;
+					if(event->mask & IN_MOVED_TO)
+					{
+						auto moved = movedGUIDs.find(event->cookie);
+						if(moved != movedGUIDs.end())
+						{
+							guid = moved->second;
+							movedGUIDs.erase(moved);
+						}
+					}
+
+					if(event->mask & IN_ISDIR)
+					{
+						UpdateRecord(path, guid);
+						watchDirectory(path);
+						ScanDirectory(path, nullptr);
+					}
+					else if(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+					{
+						//New files are picked up once they have been written
+						UpdateRecord(path, guid);
+					}
+				}
+
+				//Anything still here was moved out of the watched directories
+				if(movedGUIDs.size() > 256)
+					movedGUIDs.clear();
+			}
+
+			for(auto& [wd, path] : watches)
+				inotify_rm_watch(fd, wd);
+			close(fd);
+			return;
+		}
+
+		LUMOS_LOG_WARN("Asset database : inotify unavailable, rescanning every {0} seconds", ASSET_RESCAN_INTERVAL);
+#endif
+
+		while(!m_Quit)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_QuitMutex);
+				m_QuitCondition.wait_for(lock, std::chrono::seconds(ASSET_RESCAN_INTERVAL), [this] { return m_Quit.load(); });
+			}
+
+			if(!m_Quit)
+				Scan();
+		}
+	}
+
+	void AssetDatabase::LoadCache()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		if(m_CachePath.empty() || !FileSystem::FileExists(m_CachePath))
+			return;
+
+		std::ifstream file(m_CachePath, std::ios::binary);
+		cereal::BinaryInputArchive input(file);
+
+		uint32_t version = 0;
+		input(version);
+		if(version != ASSET_CACHE_VERSION)
+			return;
+
+		std::vector<AssetRecord> records;
+		input(records);
+
+		for(auto& record : records)
+			m_Records[record.Path] = record;
+	}
+
+	void AssetDatabase::SaveCache()
+	{
+		LUMOS_PROFILE_FUNCTION();
+		if(m_CachePath.empty())
+			return;
+
+		std::vector<AssetRecord> records;
+		records.reserve(m_Records.size());
+		for(auto& [path, record] : m_Records)
+			records.push_back(record);
+
+		//Written aside and renamed over the old cache so a crash never leaves a truncated file
+		const std::string tempPath = m_CachePath + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary);
+			if(!file)
+				return;
+
+			cereal::BinaryOutputArchive output(file);
+			output(uint32_t(ASSET_CACHE_VERSION));
+			output(records);
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, m_CachePath, error);
+	}
+
+	uint64_t AssetDatabase::HashFile(const std::string& path)
+	{
+		//64 bit FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+
+		std::ifstream file(path, std::ios::binary);
+		std::vector<char> buffer(64 * 1024);
+		while(file)
+		{
+			file.read(buffer.data(), std::streamsize(buffer.size()));
+			const std::streamsize count = file.gcount();
+			for(std::streamsize i = 0; i < count; i++)
+			{
+				hash ^= uint8_t(buffer[i]);
+				hash *= 1099511628211ull;
+			}
+		}
+
+		return hash;
+	}
+}
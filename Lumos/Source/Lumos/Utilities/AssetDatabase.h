@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Utilities/RandomNumberGenerator.h"
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <unordered_map>
+
+namespace Lumos
+{
+	enum class AssetType : uint8_t
+	{
+		Unknown = 0,
+		Directory,
+		Shader,
+		Texture,
+		Model,
+		Audio,
+		Script,
+		Scene,
+		Font
+	};
+
+	struct AssetRecord
+	{
+		uint64_t GUID = 0;
+		std::string Path; //Absolute, '/' separated
+		std::string Name;
+		std::string Parent;
+		AssetType Type = AssetType::Unknown;
+		uint64_t Size = 0;
+		int64_t ModifiedTime = 0;
+		uint64_t Hash = 0;
+
+		template<typename Archive>
+		void serialize(Archive& archive)
+		{
+			archive(GUID, Path, Name, Parent, Type, Size, ModifiedTime, Hash);
+		}
+	};
+
+	//Index of every file under a set of root directories. Built on a background thread, reusing the hashes and
+	//GUIDs saved to the cache file for anything whose size and modified time are unchanged, then kept up to date
+	//with inotify on Linux and a periodic rescan elsewhere. Files are only reported as changed when their content hash changes
+	class LUMOS_EXPORT AssetDatabase
+	{
+	public:
+		typedef std::function<void(const AssetRecord&)> ChangedCallback;
+
+		AssetDatabase(const std::vector<std::string>& roots, const std::string& cachePath);
+		~AssetDatabase();
+
+		//Reports the files that changed since the last call, on the calling thread
+		void Update();
+
+		void SetChangedCallback(const ChangedCallback& callback)
+		{
+			m_ChangedCallback = callback;
+		}
+
+		//Set once the first scan has finished
+		bool IsReady() const
+		{
+			return m_Ready;
+		}
+
+		//Bumped whenever a record is added, changed or removed
+		uint64_t GetVersion() const
+		{
+			return m_Version;
+		}
+
+		bool GetRecord(const std::string& path, AssetRecord& record);
+		std::vector<AssetRecord> GetDirectory(const std::string& path);
+		std::vector<AssetRecord> Search(const std::string& query);
+
+		static AssetType GetAssetType(const std::string& extension);
+		static std::string NormalisePath(const std::string& path);
+
+	private:
+		void Run();
+		void Scan();
+		void ScanDirectory(const std::string& path, std::vector<std::string>* seen);
+		void UpdateRecord(const std::string& path, uint64_t guid = 0);
+		AssetRecord RemoveRecord(const std::string& path);
+		void Watch();
+
+		void LoadCache();
+		void SaveCache();
+
+		static uint64_t HashFile(const std::string& path);
+
+		std::vector<std::string> m_Roots;
+		std::string m_CachePath;
+		ChangedCallback m_ChangedCallback;
+
+		//Only the background thread writes records, readers on other threads take the lock
+		std::mutex m_Mutex;
+		std::unordered_map<std::string, AssetRecord> m_Records;
+		std::vector<AssetRecord> m_Changed;
+
+		std::thread m_Thread;
+		std::mutex m_QuitMutex;
+		std::condition_variable m_QuitCondition;
+		std::atomic<bool> m_Quit = { false };
+		std::atomic<bool> m_Ready = { false };
+		std::atomic<uint64_t> m_Version = { 0 };
+
+		RandomNumberGenerator64 m_Random;
+	};
+}
@@ -111,6 +111,21 @@ namespace Lumos
 			}
 			return true;
 		}
+
+		bool ReloadResource(const IDType& name)
+		{
+			typename MapType::iterator itr = m_nameResourceMap.find(name);
+			if(itr == m_nameResourceMap.end())
+				return false;
+
+			itr->second.timeSinceReload = 0;
+			if(!m_reloadFunc(itr->first, (itr->second.data)))
+			{
+				LUMOS_LOG_ERROR("Resource Manager could not reload resource name {0} of type {1}", itr->first, typeid(T).name());
+				return false;
+			}
+			return true;
+		}
         
         bool ResourceExists(const IDType& name)
         {
@@ -126,6 +141,7 @@ namespace Lumos
         LoadFunc& LoadFunction() { return m_loadFunc; }
         ReleaseFunc& ReleaseFunction() { return m_releaseFunc; }
         ReloadFunc& ReloadFunction() { return m_reloadFunc; }
+        const MapType& GetResources() const { return m_nameResourceMap; }
 
 
 	protected:
@@ -142,6 +158,7 @@ namespace Lumos
         ShaderLibrary()
         {
             m_loadFunc = Load;
+            m_reloadFunc = Load;
         }
         
         ~ShaderLibrary()
@@ -37,6 +37,7 @@
 #include "Graphics/Sprite.h"
 #include "Graphics/GBuffer.h"
 #include "Graphics/Terrain.h"
+#include "Graphics/Terrain/ChunkedTerrain.h"
 #include "Graphics/Light.h"
 #include "Graphics/Environment.h"
 #include "Graphics/MeshFactory.h"
@@ -360,6 +360,14 @@ project "Lumos"
 				"-msse4.1",
 			}
 
+	-- AVX2 batch maths kernels are picked at runtime, only this file is built for AVX2
+	filter {'files:Source/Lumos/Maths/BatchMathsAVX2.cpp', 'architecture:x86_64'}
+		flags { 'NoPCH' }
+	filter {'files:Source/Lumos/Maths/BatchMathsAVX2.cpp', 'architecture:x86_64', 'action:not vs*'}
+		buildoptions { "-mavx2", "-mfma" }
+	filter {'files:Source/Lumos/Maths/BatchMathsAVX2.cpp', 'architecture:x86_64', 'action:vs*'}
+		buildoptions { "/arch:AVX2" }
+
 	filter "configurations:Debug"
 		defines { "LUMOS_DEBUG", "_DEBUG" }
 		symbols "On"
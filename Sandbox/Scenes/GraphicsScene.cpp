@@ -48,11 +48,10 @@ void GraphicsScene::LoadModels()
 	Entity terrianEntity = m_EntityManager->Create("HeightMap");
     terrianEntity.AddComponent<Maths::Transform>(Matrix4::Translation(Maths::Vector3(-100.0f, -60.0f,-318.0f)));
     terrianEntity.AddComponent<TextureMatrixComponent>(Matrix4::Scale(Maths::Vector3(1.0f, 1.0f, 1.0f)));
-	Lumos::Ref<Graphics::Mesh> terrain = Lumos::Ref<Graphics::Mesh>(new Terrain());
 
 	auto material = Lumos::CreateRef<Graphics::Material>();
 	material->LoadMaterial("checkerboard", "//TextuAssets/checkerboard.tga");
 
-	terrain->SetMaterial(material);
-    terrianEntity.AddComponent<Graphics::Model>(terrain, Graphics::PrimitiveType::Terrain);
+	auto& terrain = terrianEntity.AddComponent<Graphics::ChunkedTerrain>();
+	terrain.SetMaterial(material);
 }